@@ -46,6 +46,7 @@
 #   -nr_radiation        turn on non-relativistic radiation transport
 #   -implicit_radiation  implicit radiation transport module
 #   -cr                  enable cosmic ray transport
+#   -crfloat             store the CR opacity and B angle arrays in single precision
 #   -crdiff              enable cosmic ray diffusion with Multigrid
 # ----------------------------------------------------------------------------------------
 
@@ -266,6 +267,12 @@ parser.add_argument('-cr',
                     default=False,
                     help='enable cosmic ray transport')
 
+# -cosmic ray single precision coefficients argument
+parser.add_argument('-crfloat',
+                    action='store_true',
+                    default=False,
+                    help='store the cosmic ray coefficient arrays in single precision')
+
 # -cosmic ray diffusion argument
 parser.add_argument('-crdiff',
                     action='store_true',
@@ -563,6 +570,12 @@ if args['cr']:
 else:
     definitions['CR_ENABLED'] = '0'
 
+# -crfloat argument
+if args['crfloat']:
+    definitions['CR_FLOAT_COEFFICIENTS'] = '1'
+else:
+    definitions['CR_FLOAT_COEFFICIENTS'] = '0'
+
 # -crdiff argument
 if args['crdiff']:
     definitions['CRDIFFUSION_ENABLED'] = '1'
@@ -1036,6 +1049,9 @@ output_config('General relativity', ('ON' if args['g'] else 'OFF'), flog)
 output_config('Radiative Transfer', ('ON' if args['nr_radiation'] else 'OFF'), flog)
 output_config('Implicit Radiation', ('ON' if args['implicit_radiation'] else 'OFF'), flog)
 output_config('Cosmic Ray Transport', ('ON' if args['cr'] else 'OFF'), flog)
+if args['cr']:
+    output_config('CR coefficient precision',
+                  ('single' if args['crfloat'] or args['float'] else 'double'), flog)
 output_config('Cosmic Ray Diffusion', ('ON' if args['crdiff'] else 'OFF'), flog)
 output_config('Frame transformations', ('ON' if args['t'] else 'OFF'), flog)
 output_config('Self-Gravity', self_grav_string, flog)
@@ -31,6 +31,14 @@ using Real = double;
 #endif
 #endif
 
+// storage type of the cosmic ray coefficient arrays (opacities, streaming velocity and
+// B angles); the transport arithmetic itself is always done in Real
+#if CR_FLOAT_COEFFICIENTS
+using CRReal = float;
+#else
+using CRReal = Real;
+#endif
+
 // for OpenMP 4.0 SIMD vectorization, control width of SIMD lanes
 #if defined(__AVX512F__)
 #define SIMD_WIDTH 8
@@ -169,12 +177,14 @@ enum CoordinateDirection {X1DIR=0, X2DIR=1, X3DIR=2};
 enum class BoundaryQuantity {cc, fc, cc_flcor, fc_flcor, mg, mg_faceonly, mg_coeff,
                              orbital_cc, orbital_fc};
 enum class HydroBoundaryQuantity {cons, prim};
-enum class BoundaryCommSubset {mesh_init, gr_amr, all, orbital, radiation, radhydro};
+enum class BoundaryCommSubset {mesh_init, gr_amr, all, orbital, radiation, radhydro,
+                                cosmicray};
 // TODO(felker): consider generalizing/renaming to QuantityFormulation
 // TODO(Gong): currently disabled=background (with passive scalar advection),
 // and fixed is without passive scalar advection.
 enum class FluidFormulation {evolve, background, fixed, disabled};
 enum class TaskType {op_split_before, main_int, op_split_after};
+enum class TaskScheduler {polling, stealing, pinned};
 enum class UserHistoryOperation {sum, max, min};
 
 //----------------------------------------------------------------------------------------
@@ -192,6 +202,7 @@ using SrcTermFunc = void (*)(
     AthenaArray<Real> &cons, AthenaArray<Real> &cons_scalar);
 using TimeStepFunc = Real (*)(MeshBlock *pmb);
 using HistoryOutputFunc = Real (*)(MeshBlock *pmb, int iout);
+using HistoryBlockFunc = void (*)(MeshBlock *pmb, Real *usr_data);
 using MetricFunc = void (*)(
     Real x1, Real x2, Real x3, ParameterInput *pin,
     AthenaArray<Real> &g, AthenaArray<Real> &g_inv,
@@ -230,6 +241,9 @@ using CROpacityFunc = void (*)(MeshBlock *pmb, AthenaArray<Real> &u_cr,
 using CRStreamingFunc = void (*)(MeshBlock *pmb, AthenaArray<Real> &u_cr,
                       AthenaArray<Real> &prim, AthenaArray<Real> &bcc,
                       AthenaArray<Real> &grad_pc, int k, int j, int is, int ie);
+using CROpacityScaleFunc = void (*)(MeshBlock *pmb, AthenaArray<Real> &prim,
+                      AthenaArray<Real> &bcc, int k, int j, int il, int iu,
+                      AthenaArray<Real> &scale);
 using SRJFunc = void (*)(IMRadiation *pimrad);
 
 using CRBoundaryFunc = void (*)(
@@ -399,6 +399,7 @@ void BoundaryValues::StartReceivingSubset(BoundaryCommSubset phase,
       case BoundaryCommSubset::mesh_init:
         break;
       case BoundaryCommSubset::radiation:
+      case BoundaryCommSubset::cosmicray:
         break;
       case BoundaryCommSubset::radhydro:
       case BoundaryCommSubset::all:
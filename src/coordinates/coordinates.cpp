@@ -25,7 +25,7 @@
 //! Coordinates constructor: sets coordinates and coordinate spacing of cell FACES
 
 Coordinates::Coordinates(MeshBlock *pmb, ParameterInput *pin, bool flag) :
-    pmy_block(pmb), coarse_flag(flag), pm(pmb->pmy_mesh) {
+    pmy_block(pmb), geometry_cached(false), coarse_flag(flag), pm(pmb->pmy_mesh) {
   RegionSize& mesh_size  = pmy_block->pmy_mesh->mesh_size;
   RegionSize& block_size = pmy_block->block_size;
 
@@ -330,6 +330,53 @@ Coordinates::Coordinates(MeshBlock *pmb, ParameterInput *pin, bool flag) :
 __attribute__((weak)) Coordinates::~Coordinates() {}
 
 
+//----------------------------------------------------------------------------------------
+//! \fn void Coordinates::CacheGeometry()
+//! \brief stores the center widths, face areas and cell volumes of the whole block, so
+//!        that the CR and diffusion kernels read them instead of recomputing each row.
+//!        The grid is static for the lifetime of a MeshBlock (refinement creates new
+//!        ones), so this is called once from the MeshBlock constructors.
+
+void Coordinates::CacheGeometry() {
+  center_width1.NewAthenaArray(nc3, nc2, nc1);
+  center_width2.NewAthenaArray(nc3, nc2, nc1);
+  center_width3.NewAthenaArray(nc3, nc2, nc1);
+  face1_area.NewAthenaArray(nc3, nc2, nc1+1);
+  face2_area.NewAthenaArray(nc3, nc2+1, nc1);
+  face3_area.NewAthenaArray(nc3+1, nc2, nc1);
+  cell_volume.NewAthenaArray(nc3, nc2, nc1);
+
+  // the functions fill rows of the caches through pencil views
+  AthenaArray<Real> row;
+  for (int k=0; k<=nc3; ++k) {
+    for (int j=0; j<=nc2; ++j) {
+      if (k < nc3 && j < nc2) {
+        row.ShallowSlice3DToPencil(center_width1, k, j, 0, nc1);
+        CenterWidth1(k, j, 0, nc1-1, row);
+        row.ShallowSlice3DToPencil(center_width2, k, j, 0, nc1);
+        CenterWidth2(k, j, 0, nc1-1, row);
+        row.ShallowSlice3DToPencil(center_width3, k, j, 0, nc1);
+        CenterWidth3(k, j, 0, nc1-1, row);
+        row.ShallowSlice3DToPencil(face1_area, k, j, 0, nc1+1);
+        Face1Area(k, j, 0, nc1, row);
+        row.ShallowSlice3DToPencil(cell_volume, k, j, 0, nc1);
+        CellVolume(k, j, 0, nc1-1, row);
+      }
+      if (k < nc3) {
+        row.ShallowSlice3DToPencil(face2_area, k, j, 0, nc1);
+        Face2Area(k, j, 0, nc1-1, row);
+      }
+      if (j < nc2) {
+        row.ShallowSlice3DToPencil(face3_area, k, j, 0, nc1);
+        Face3Area(k, j, 0, nc1-1, row);
+      }
+    }
+  }
+  geometry_cached = true;
+  return;
+}
+
+
 //----------------------------------------------------------------------------------------
 // EdgeXLength functions: compute physical length at cell edge-X as vector
 // Edge1(i,j,k) located at (i,j-1/2,k-1/2), i.e. (x1v(i), x2f(j), x3f(k))
@@ -42,6 +42,7 @@ class Coordinates {
   ~Coordinates();
 
   void Initialize(ParameterInput *pin);
+  void CacheGeometry();
 
   // data
   MeshBlock *pmy_block;  // ptr to MeshBlock containing this Coordinates
@@ -51,6 +52,11 @@ class Coordinates {
   // geometry coefficients (only used in SphericalPolar, Cylindrical, Cartesian)
   AthenaArray<Real> h2f, dh2fd1, h31f, h32f, dh31fd1, dh32fd2;
   AthenaArray<Real> h2v, dh2vd1, h31v, h32v, dh31vd1, dh32vd2;
+  // center widths, face areas and cell volumes of the whole block, filled by
+  // CacheGeometry() when the MeshBlock is created (only if geometry_cached)
+  bool geometry_cached;
+  AthenaArray<Real> center_width1, center_width2, center_width3;
+  AthenaArray<Real> face1_area, face2_area, face3_area, cell_volume;
 
   // functions...
   // ...to compute length of edges
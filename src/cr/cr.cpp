@@ -20,10 +20,12 @@
 // C headers
 
 // C++ headers
+#include <cstddef>  // size_t
 #include <cstdio>  // fopen and fwrite
 #include <iostream>  // cout
 #include <sstream>  // msg
 #include <stdexcept> // runtime erro
+#include <string>
 
 // Athena++ headers
 #include "../athena.hpp"
@@ -45,6 +47,7 @@ inline void DefaultOpacity(MeshBlock *pmb, AthenaArray<Real> &u_cr,
               AthenaArray<Real> &prim, AthenaArray<Real> &bcc) {
   // set the default opacity to be a large value in the default hydro case
   CosmicRay *pcr=pmb->pcr;
+  Coordinates *pco=pmb->pcoord;
   int kl=pmb->ks, ku=pmb->ke;
   int jl=pmb->js, ju=pmb->je;
   int il=pmb->is-1, iu=pmb->ie+1;
@@ -78,37 +81,42 @@ inline void DefaultOpacity(MeshBlock *pmb, AthenaArray<Real> &u_cr,
       // Use a simple estimate of Grad Pc
 
         // x component
-        pmb->pcoord->CenterWidth1(k,j,il-1,iu+1,pcr->cwidth);
+        const Real *dx1 = &(pco->center_width1(k,j,0));
         for(int i=il; i<=iu; ++i) {
-          Real distance = 0.5*(pcr->cwidth(i-1) + pcr->cwidth(i+1))
-                         + pcr->cwidth(i);
+          Real distance = 0.5*(dx1[i-1] + dx1[i+1]) + dx1[i];
           Real dprdx=(u_cr(CRE,k,j,i+1) - u_cr(CRE,k,j,i-1))/3.0;
           dprdx /= distance;
           pcr->sigma_adv(0,k,j,i) = dprdx;
         }
         // y component
-        pmb->pcoord->CenterWidth2(k,j-1,il,iu,pcr->cwidth1);
-        pmb->pcoord->CenterWidth2(k,j,il,iu,pcr->cwidth);
-        pmb->pcoord->CenterWidth2(k,j+1,il,iu,pcr->cwidth2);
-
-        for(int i=il; i<=iu; ++i) {
-          Real distance = 0.5*(pcr->cwidth1(i) + pcr->cwidth2(i))
-                         + pcr->cwidth(i);
-          Real dprdy=(u_cr(CRE,k,j+1,i) - u_cr(CRE,k,j-1,i))/3.0;
-          dprdy /= distance;
-          pcr->sigma_adv(1,k,j,i) = dprdy;
+        if (pmb->block_size.nx2 > 1) {
+          const Real *dx2 = &(pco->center_width2(k,j,0)),
+                     *dx2_m1 = &(pco->center_width2(k,j-1,0)),
+                     *dx2_p1 = &(pco->center_width2(k,j+1,0));
+          for(int i=il; i<=iu; ++i) {
+            Real distance = 0.5*(dx2_m1[i] + dx2_p1[i]) + dx2[i];
+            Real dprdy=(u_cr(CRE,k,j+1,i) - u_cr(CRE,k,j-1,i))/3.0;
+            dprdy /= distance;
+            pcr->sigma_adv(1,k,j,i) = dprdy;
+          }
+        } else {
+          for(int i=il; i<=iu; ++i)
+            pcr->sigma_adv(1,k,j,i) = 0.0;
         }
         // z component
-        pmb->pcoord->CenterWidth3(k-1,j,il,iu,pcr->cwidth1);
-        pmb->pcoord->CenterWidth3(k,j,il,iu,pcr->cwidth);
-        pmb->pcoord->CenterWidth3(k+1,j,il,iu,pcr->cwidth2);
-
-        for(int i=il; i<=iu; ++i) {
-          Real distance = 0.5*(pcr->cwidth1(i) + pcr->cwidth2(i))
-                          + pcr->cwidth(i);
-          Real dprdz=(u_cr(CRE,k+1,j,i) -  u_cr(CRE,k-1,j,i))/3.0;
-          dprdz /= distance;
-          pcr->sigma_adv(2,k,j,i) = dprdz;
+        if (pmb->block_size.nx3 > 1) {
+          const Real *dx3 = &(pco->center_width3(k,j,0)),
+                     *dx3_m1 = &(pco->center_width3(k-1,j,0)),
+                     *dx3_p1 = &(pco->center_width3(k+1,j,0));
+          for(int i=il; i<=iu; ++i) {
+            Real distance = 0.5*(dx3_m1[i] + dx3_p1[i]) + dx3[i];
+            Real dprdz=(u_cr(CRE,k+1,j,i) -  u_cr(CRE,k-1,j,i))/3.0;
+            dprdz /= distance;
+            pcr->sigma_adv(2,k,j,i) = dprdz;
+          }
+        } else {
+          for(int i=il; i<=iu; ++i)
+            pcr->sigma_adv(2,k,j,i) = 0.0;
         }
 
         for(int i=il; i<=iu; ++i) {
@@ -234,7 +242,7 @@ CosmicRay::CosmicRay(MeshBlock *pmb, ParameterInput *pin):
         AthenaArray<Real>::DataStatus::empty)}
     },
     cr_bvar(pmb, &u_cr, &coarse_cr_, flux, true),
-    UserSourceTerm_{} {
+    UserSourceTerm_{}, UserOpacityScale_{} {
   Mesh *pm = pmy_block->pmy_mesh;
   pmb->RegisterMeshBlockData(u_cr);
   // "Enroll" in S/AMR by adding to vector of tuples of pointers in MeshRefinement class
@@ -251,18 +259,68 @@ CosmicRay::CosmicRay(MeshBlock *pmb, ParameterInput *pin):
   max_opacity = pin->GetOrAddReal("cr", "max_opacity", BIG_NUMBER);
   stream_flag = pin->GetOrAddInteger("cr", "vs_flag", 1);
   src_flag = pin->GetOrAddInteger("cr", "src_flag", 1);
+  nsubcycle = pin->GetOrAddInteger("cr", "nsubcycle", 1);
+  if (nsubcycle < 1) {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in CosmicRay constructor" << std::endl
+        << "nsubcycle=" << nsubcycle << " must be at least 1" << std::endl;
+    ATHENA_ERROR(msg);
+  }
+  implicit = pin->GetOrAddBoolean("cr", "implicit", false);
+  if (implicit && nsubcycle > 1) {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in CosmicRay constructor" << std::endl
+        << "nsubcycle=" << nsubcycle << " cannot be used with implicit transport"
+        << std::endl;
+    ATHENA_ERROR(msg);
+  }
+  sum_diff = 0.0;
+  sum_full = 0.0;
+  hybrid_tau = pin->GetOrAddReal("cr", "hybrid_tau", 0.0);
+  if (hybrid_tau > 0.0 && (!CRDIFFUSION_ENABLED || implicit)) {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in CosmicRay constructor" << std::endl
+        << "hybrid_tau=" << hybrid_tau << " needs the CR diffusion solver (-crdiff) "
+        << "and the explicit transport" << std::endl;
+    ATHENA_ERROR(msg);
+  }
+  all_thick = false;
+  max_vdiff = vmax;
 
   int nc1 = pmb->ncells1, nc2 = pmb->ncells2, nc3 = pmb->ncells3;
+  if (nsubcycle > 1)
+    u_hydro_sub.NewAthenaArray(NHYDRO, nc3, nc2, nc1);
+  if (implicit)
+    u_cr_old.NewAthenaArray(NCR, nc3, nc2, nc1);
   b_grad_pc.NewAthenaArray(nc3, nc2, nc1);
   b_angle.NewAthenaArray(4, nc3, nc2, nc1);
+  if (hybrid_tau > 0.0)
+    thick.NewAthenaArray(nc3, nc2, nc1);
 
   cwidth.NewAthenaArray(nc1);
   cwidth1.NewAthenaArray(nc1);
   cwidth2.NewAthenaArray(nc1);
 
-  // set a default opacity function
-  UpdateOpacity = DefaultOpacity;
-  UpdateStreaming = DefaultStreaming;
+  // set the opacity function, either the default or a built-in one selected in <cr>.
+  // Problem generators can still enroll their own in InitUserMeshBlockData
+  std::string opacity = pin->GetOrAddString("cr", "opacity", "default");
+  if (opacity == "default") {
+    UpdateOpacity = DefaultOpacity;
+    UpdateStreaming = DefaultStreaming;
+  } else if (opacity == "anisotropic") {
+    InitAnisotropicOpacity(pin);
+    UpdateOpacity = AnisotropicOpacity;
+    UpdateStreaming = AnisotropicStreaming;
+  } else {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in CosmicRay constructor" << std::endl
+        << "opacity=" << opacity << " not valid cosmic ray opacity" << std::endl;
+    ATHENA_ERROR(msg);
+  }
+
+  amr_refine = pin->GetOrAddBoolean("cr", "amr_refine", false) && pm->adaptive;
+  if (amr_refine)
+    InitRefinement(pin);
   pcrintegrator = new CRIntegrator(this, pin);
 }
 
@@ -278,3 +336,12 @@ void CosmicRay::EnrollUserCRSource(CRSrcTermFunc my_func) {
   UserSourceTerm_ = my_func;
   cr_source_defined = true;
 }
+
+void CosmicRay::EnrollOpacityScaleFunction(CROpacityScaleFunc my_func) {
+  UserOpacityScale_ = my_func;
+}
+
+std::size_t CosmicRay::CoefficientBytes() const {
+  return sigma_diff.GetSizeInBytes() + sigma_adv.GetSizeInBytes()
+       + v_adv.GetSizeInBytes() + b_grad_pc.GetSizeInBytes() + b_angle.GetSizeInBytes();
+}
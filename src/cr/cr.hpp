@@ -12,6 +12,7 @@
 // C headers
 
 // C++ headers
+#include <cstddef>  // size_t
 #include <string>
 
 // Athena++ classes headers
@@ -34,12 +35,14 @@ class CosmicRay {
 
   MeshBlock* pmy_block;
   AthenaArray<Real> u_cr, u_cr1, u_cr2;  // cosmic ray energy density and flux
+  AthenaArray<Real> u_cr_old; // previous iterate of the implicit transport
   AthenaArray<Real> coarse_cr_;
 
   // diffusion coefficients for both normal diffusion term, and advection term
-  AthenaArray<Real> sigma_diff, sigma_adv;
+  // (CRReal is float with -crfloat; the same holds for v_adv, b_grad_pc and b_angle)
+  AthenaArray<CRReal> sigma_diff, sigma_adv;
 
-  AthenaArray<Real> v_adv;  // streaming velocity
+  AthenaArray<CRReal> v_adv;  // streaming velocity
   AthenaArray<Real> v_diff; // the diffuion velocity, need to calculate the flux
 
   int refinement_idx{-1};
@@ -49,6 +52,13 @@ class CosmicRay {
   Real vmax; // the maximum velocity (effective speed of light)
   Real vlim;
   Real max_opacity;
+  int nsubcycle; // number of CR transport substeps per hydro stage
+  bool implicit;  // transport solved iteratively by IMCosmicRay instead of explicitly
+  Real sum_diff, sum_full; // residual sums of the implicit iteration
+
+  // hydro conserved variables coupled to the CR substeps of a stage; once the substeps
+  // are done it holds their accumulated momentum and energy exchange (nsubcycle > 1)
+  AthenaArray<Real> u_hydro_sub;
 
   CellCenteredBoundaryVariable cr_bvar;
   CRIntegrator *pcrintegrator;
@@ -57,6 +67,8 @@ class CosmicRay {
   void EnrollOpacityFunction(CROpacityFunc MyOpacityFunction);
   void EnrollStreamingFunction(CRStreamingFunc MyStreamingFunction);
   void EnrollUserCRSource(CRSrcTermFunc my_func);
+  // scale factor applied to the built-in anisotropic opacity, one row at a time
+  void EnrollOpacityScaleFunction(CROpacityScaleFunc my_func);
   bool cr_source_defined;
 
   // The function pointer for the diffusion coefficient
@@ -66,14 +78,50 @@ class CosmicRay {
   AthenaArray<Real> cwidth;
   AthenaArray<Real> cwidth1;
   AthenaArray<Real> cwidth2;
-  AthenaArray<Real> b_grad_pc; // array to store B\dot Grad Pc
-  AthenaArray<Real> b_angle; //sin\theta,cos\theta,sin\phi,cos\phi of B direction
+  AthenaArray<CRReal> b_grad_pc; // array to store B\dot Grad Pc
+  AthenaArray<CRReal> b_angle; //sin\theta,cos\theta,sin\phi,cos\phi of B direction
 
   int stream_flag; // flag to include streaming or not
   int src_flag;    // flag to include CR source term or not
 
+  // hybrid transport (<cr> hybrid_tau > 0, needs -crdiff): in cells with an optical
+  // depth taucell*sigma*dx above hybrid_tau the CR energy is diffused by the CR diffusion
+  // Multigrid solver, and the two-moment scheme only advects it
+  Real hybrid_tau;
+  AthenaArray<Real> thick;  // 1 in the optically thick cells, 0 elsewhere
+  bool all_thick;           // every cell of the MeshBlock, ghost zones included, is thick
+  Real max_vdiff;           // largest v_diff: the CFL speed of an all_thick MeshBlock
+
+  // built-in refinement criterion (<cr> amr_refine = true on an adaptive mesh)
+  bool amr_refine;
+  int CheckRefinement();
+
+  // bytes of the coefficient arrays (sigma_diff, sigma_adv, v_adv, b_grad_pc, b_angle)
+  std::size_t CoefficientBytes() const;
+
  private:
   CRSrcTermFunc UserSourceTerm_;
+
+  // built-in anisotropic opacity and streaming (<cr> opacity = anisotropic)
+  void InitAnisotropicOpacity(ParameterInput *pin);
+  static void AnisotropicOpacity(MeshBlock *pmb, AthenaArray<Real> &u_cr,
+                                 AthenaArray<Real> &prim, AthenaArray<Real> &bcc);
+  static void AnisotropicStreaming(MeshBlock *pmb, AthenaArray<Real> &u_cr,
+                                   AthenaArray<Real> &prim, AthenaArray<Real> &bcc,
+                                   AthenaArray<Real> &grad_pc,
+                                   int k, int j, int is, int ie);
+  Real sigma_parl_, sigma_perp_; // diffusion opacities parallel/perpendicular to B
+  Real f_ion_, t_ion_, dt_ion_;  // ion fraction and its tanh temperature limiter
+  Real a_decouple_;              // reduction of the streaming opacity
+  CROpacityScaleFunc UserOpacityScale_;
+  AthenaArray<Real> opacity_scale_;
+  // 1/(3*stencil width) of the centered Ec gradient in each direction
+  AthenaArray<Real> inv_gradpc_dx_[3];
+
+  void InitRefinement(ParameterInput *pin);
+  Real amr_grad_refine_, amr_grad_derefine_; // thresholds of the relative Ec jump
+  Real amr_flux_refine_, amr_flux_derefine_; // thresholds of |Fc|/(vmax*Ec)
+  Real amr_ec_floor_;                        // floor of Ec in both normalizations
 };
 
 #endif // CR_CR_HPP_
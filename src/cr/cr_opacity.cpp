@@ -0,0 +1,282 @@
+//======================================================================================
+// Athena++ astrophysical MHD code
+// Copyright (C) 2014 James M. Stone  <jmstone@princeton.edu>
+//
+// This program is free software: you can redistribute and/or modify it under the terms
+// of the GNU General Public License (GPL) as published by the Free Software Foundation,
+// either version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+// PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+//
+// You should have received a copy of GNU GPL in the file LICENSE included in the code
+// distribution.  If not see <http://www.gnu.org/licenses/>.
+//======================================================================================
+//! \file cr_opacity.cpp
+//  \brief built-in anisotropic opacity and Alfvenic streaming for cosmic rays
+//
+//  Selected with <cr> opacity = anisotropic. The diffusion opacity is sigma_parl along
+//  and sigma_perp across the local magnetic field, optionally multiplied by a user
+//  enrolled scale factor. CRs stream down their pressure gradient at the Alfven speed
+//  of the ions, rho*f_ion, where f_ion can be switched to one above T_ion with a tanh
+//  limiter of width dT_ion. The streaming opacity is reduced by a_decouple.
+//======================================================================================
+
+// C headers
+
+// C++ headers
+#include <cmath>      // sqrt, tanh, abs
+
+// Athena++ headers
+#include "../athena.hpp"
+#include "../athena_arrays.hpp"
+#include "../coordinates/coordinates.hpp"
+#include "../mesh/mesh.hpp"
+#include "../parameter_input.hpp"
+#include "cr.hpp"
+
+namespace {
+//! \fn Real IonFraction(Real temp, Real f_ion, Real t_ion, Real dt_ion)
+//  \brief fraction of the density that is coupled to the CRs, rising from f_ion to one
+//         above the temperature t_ion
+
+inline Real IonFraction(const Real temp, const Real f_ion, const Real t_ion,
+                        const Real dt_ion) {
+  Real switch_func = 0.5*(1.0 + std::tanh((temp - t_ion)/dt_ion));
+  return (1.0 - f_ion)*switch_func + f_ion;
+}
+} // namespace
+
+//--------------------------------------------------------------------------------------
+//! \fn void CosmicRay::InitAnisotropicOpacity(ParameterInput *pin)
+//  \brief reads the parameters of the built-in opacity and stores the stencil widths
+//         of the Ec gradient from the cached center widths of the block
+
+void CosmicRay::InitAnisotropicOpacity(ParameterInput *pin) {
+  MeshBlock *pmb = pmy_block;
+  sigma_parl_ = pin->GetOrAddReal("cr", "sigma_parl", max_opacity);
+  sigma_perp_ = pin->GetOrAddReal("cr", "sigma_perp", max_opacity);
+  f_ion_ = pin->GetOrAddReal("cr", "f_ion", 1.0);
+  t_ion_ = pin->GetOrAddReal("cr", "T_ion", 0.0);
+  dt_ion_ = pin->GetOrAddReal("cr", "dT_ion", 0.0);
+  a_decouple_ = pin->GetOrAddReal("cr", "a_decouple", 1.0);
+
+  int nc1 = pmb->ncells1, nc2 = pmb->ncells2, nc3 = pmb->ncells3;
+  opacity_scale_.NewAthenaArray(nc1);
+
+  // distance between the centers of cells i-1 and i+1
+  Coordinates *pco = pmb->pcoord;
+  inv_gradpc_dx_[0].NewAthenaArray(nc3, nc2, nc1);
+  for (int k=0; k<nc3; ++k) {
+    for (int j=0; j<nc2; ++j) {
+      for (int i=1; i<nc1-1; ++i) {
+        Real distance = 0.5*(pco->center_width1(k,j,i-1) + pco->center_width1(k,j,i+1))
+                        + pco->center_width1(k,j,i);
+        inv_gradpc_dx_[0](k,j,i) = 1.0/(3.0*distance);
+      }
+    }
+  }
+  if (pmb->block_size.nx2 > 1) {
+    inv_gradpc_dx_[1].NewAthenaArray(nc3, nc2, nc1);
+    for (int k=0; k<nc3; ++k) {
+      for (int j=1; j<nc2-1; ++j) {
+        for (int i=0; i<nc1; ++i) {
+          Real distance = 0.5*(pco->center_width2(k,j-1,i) + pco->center_width2(k,j+1,i))
+                          + pco->center_width2(k,j,i);
+          inv_gradpc_dx_[1](k,j,i) = 1.0/(3.0*distance);
+        }
+      }
+    }
+  }
+  if (pmb->block_size.nx3 > 1) {
+    inv_gradpc_dx_[2].NewAthenaArray(nc3, nc2, nc1);
+    for (int k=1; k<nc3-1; ++k) {
+      for (int j=0; j<nc2; ++j) {
+        for (int i=0; i<nc1; ++i) {
+          Real distance = 0.5*(pco->center_width3(k-1,j,i) + pco->center_width3(k+1,j,i))
+                          + pco->center_width3(k,j,i);
+          inv_gradpc_dx_[2](k,j,i) = 1.0/(3.0*distance);
+        }
+      }
+    }
+  }
+  return;
+}
+
+//--------------------------------------------------------------------------------------
+//! \fn void CosmicRay::AnisotropicOpacity(MeshBlock *pmb, AthenaArray<Real> &u_cr,
+//                                         AthenaArray<Real> &prim,
+//                                         AthenaArray<Real> &bcc)
+//  \brief sets sigma_diff, and with magnetic fields B.Grad(Pc), the streaming velocity,
+//         sigma_adv and the angles of B, in a single pass over each row
+
+void CosmicRay::AnisotropicOpacity(MeshBlock *pmb, AthenaArray<Real> &u_cr,
+                                   AthenaArray<Real> &prim, AthenaArray<Real> &bcc) {
+  CosmicRay *pcr=pmb->pcr;
+  int kl=pmb->ks, ku=pmb->ke;
+  int jl=pmb->js, ju=pmb->je;
+  int il=pmb->is-1, iu=pmb->ie+1;
+  const bool f2 = (pmb->block_size.nx2 > 1);
+  const bool f3 = (pmb->block_size.nx3 > 1);
+  if (f2) {
+    jl -= 1;
+    ju += 1;
+  }
+  if (f3) {
+    kl -= 1;
+    ku += 1;
+  }
+
+  const Real invlim = 1.0/pcr->vmax;
+  const Real max_opacity = pcr->max_opacity;
+  const Real sigma_parl = pcr->sigma_parl_, sigma_perp = pcr->sigma_perp_;
+  const Real f_ion = pcr->f_ion_, t_ion = pcr->t_ion_;
+  const Real stream_coef = pcr->a_decouple_*(4.0/3.0)*invlim;
+  const bool stream = (pcr->stream_flag > 0);
+  const bool limiter = NON_BAROTROPIC_EOS && (pcr->dt_ion_ > 0.0);
+  const Real dt_ion = limiter ? pcr->dt_ion_ : 1.0;
+  AthenaArray<Real> &scale = pcr->opacity_scale_;
+
+  for (int k=kl; k<=ku; ++k) {
+    for (int j=jl; j<=ju; ++j) {
+      if (pcr->UserOpacityScale_ != nullptr) {
+        pcr->UserOpacityScale_(pmb, prim, bcc, k, j, il, iu, scale);
+#pragma omp simd
+        for (int i=il; i<=iu; ++i) {
+          pcr->sigma_diff(0,k,j,i) = sigma_parl*scale(i);
+          pcr->sigma_diff(1,k,j,i) = sigma_perp*scale(i);
+          pcr->sigma_diff(2,k,j,i) = sigma_perp*scale(i);
+        }
+      } else {
+#pragma omp simd
+        for (int i=il; i<=iu; ++i) {
+          pcr->sigma_diff(0,k,j,i) = sigma_parl;
+          pcr->sigma_diff(1,k,j,i) = sigma_perp;
+          pcr->sigma_diff(2,k,j,i) = sigma_perp;
+        }
+      }
+
+      if (!MAGNETIC_FIELDS_ENABLED) {
+        // without a field there is no streaming
+#pragma omp simd
+        for (int i=il; i<=iu; ++i) {
+          pcr->sigma_adv(0,k,j,i) = max_opacity;
+          pcr->sigma_adv(1,k,j,i) = max_opacity;
+          pcr->sigma_adv(2,k,j,i) = max_opacity;
+          pcr->v_adv(0,k,j,i) = 0.0;
+          pcr->v_adv(1,k,j,i) = 0.0;
+          pcr->v_adv(2,k,j,i) = 0.0;
+        }
+        continue;
+      }
+
+      // neighbouring rows of Ec; in a collapsed direction they coincide, so that the
+      // gradient along it vanishes
+      const Real *ec = &u_cr(CRE,k,j,0);
+      const Real *ec_jm = &u_cr(CRE,k,f2 ? j-1 : j,0);
+      const Real *ec_jp = &u_cr(CRE,k,f2 ? j+1 : j,0);
+      const Real *ec_km = &u_cr(CRE,f3 ? k-1 : k,j,0);
+      const Real *ec_kp = &u_cr(CRE,f3 ? k+1 : k,j,0);
+      const Real *idx1 = &pcr->inv_gradpc_dx_[0](k,j,0);
+      const Real *idx2 = f2 ? &pcr->inv_gradpc_dx_[1](k,j,0) : idx1;
+      const Real *idx3 = f3 ? &pcr->inv_gradpc_dx_[2](k,j,0) : idx1;
+      const Real *rho = &prim(IDN,k,j,0);
+      const Real *pres = limiter ? &prim(IPR,k,j,0) : rho;
+      const Real *b1 = &bcc(IB1,k,j,0), *b2 = &bcc(IB2,k,j,0), *b3 = &bcc(IB3,k,j,0);
+
+#pragma omp simd simdlen(SIMD_WIDTH)
+      for (int i=il; i<=iu; ++i) {
+        Real dpcdx = (ec[i+1] - ec[i-1])*idx1[i];
+        Real dpcdy = (ec_jp[i] - ec_jm[i])*idx2[i];
+        Real dpcdz = (ec_kp[i] - ec_km[i])*idx3[i];
+        Real b_grad_pc = b1[i]*dpcdx + b2[i]*dpcdy + b3[i]*dpcdz;
+        pcr->b_grad_pc(k,j,i) = b_grad_pc;
+
+        Real bxby = std::sqrt(b1[i]*b1[i] + b2[i]*b2[i]);
+        Real btot = std::sqrt(b1[i]*b1[i] + b2[i]*b2[i] + b3[i]*b3[i]);
+
+        // streaming velocity in the current coordinate system, sigma_adv along B
+        Real f_i = limiter ? IonFraction(pres[i]/rho[i], f_ion, t_ion, dt_ion) : f_ion;
+        Real inv_sqrt_rho = 1.0/std::sqrt(rho[i]*f_i);
+        Real va = btot*inv_sqrt_rho;
+        Real dpc_sign = (b_grad_pc > TINY_NUMBER) ? 1.0 :
+                        ((-b_grad_pc > TINY_NUMBER) ? -1.0 : 0.0);
+        Real vcoef = stream ? -inv_sqrt_rho*dpc_sign : 0.0;
+        pcr->v_adv(0,k,j,i) = b1[i]*vcoef;
+        pcr->v_adv(1,k,j,i) = b2[i]*vcoef;
+        pcr->v_adv(2,k,j,i) = b3[i]*vcoef;
+
+        bool has_va = stream && (va >= TINY_NUMBER);
+        Real denom = has_va ? btot*va*stream_coef*ec[i] : 1.0;
+        pcr->sigma_adv(0,k,j,i) = has_va ? std::abs(b_grad_pc)/denom : max_opacity;
+        pcr->sigma_adv(1,k,j,i) = max_opacity;
+        pcr->sigma_adv(2,k,j,i) = max_opacity;
+
+        // b_angle = sin(theta_b), cos(theta_b), sin(phi_b), cos(phi_b)
+        bool has_b = (btot > TINY_NUMBER);
+        bool has_bxy = (bxby > TINY_NUMBER);
+        Real inv_btot = 1.0/(has_b ? btot : 1.0);
+        Real inv_bxby = 1.0/(has_bxy ? bxby : 1.0);
+        pcr->b_angle(0,k,j,i) = has_b ? bxby*inv_btot : 1.0;
+        pcr->b_angle(1,k,j,i) = has_b ? b3[i]*inv_btot : 0.0;
+        pcr->b_angle(2,k,j,i) = has_bxy ? b2[i]*inv_bxby : 0.0;
+        pcr->b_angle(3,k,j,i) = has_bxy ? b1[i]*inv_bxby : 1.0;
+      }
+    }
+  }
+  return;
+}
+
+//--------------------------------------------------------------------------------------
+//! \fn void CosmicRay::AnisotropicStreaming(MeshBlock *pmb, AthenaArray<Real> &u_cr,
+//          AthenaArray<Real> &prim, AthenaArray<Real> &bcc, AthenaArray<Real> &grad_pc,
+//          int k, int j, int is, int ie)
+//  \brief updates the streaming velocity and sigma_adv with the Grad(Pc) computed from
+//         the CR fluxes, consistently with AnisotropicOpacity
+
+void CosmicRay::AnisotropicStreaming(MeshBlock *pmb, AthenaArray<Real> &u_cr,
+                                     AthenaArray<Real> &prim, AthenaArray<Real> &bcc,
+                                     AthenaArray<Real> &grad_pc,
+                                     int k, int j, int is, int ie) {
+  CosmicRay *pcr=pmb->pcr;
+  const Real invlim = 1.0/pcr->vmax;
+  const Real max_opacity = pcr->max_opacity;
+  const Real f_ion = pcr->f_ion_, t_ion = pcr->t_ion_;
+  const Real stream_coef = pcr->a_decouple_*(4.0/3.0)*invlim;
+  const bool stream = (pcr->stream_flag > 0);
+  const bool limiter = NON_BAROTROPIC_EOS && (pcr->dt_ion_ > 0.0);
+  const Real dt_ion = limiter ? pcr->dt_ion_ : 1.0;
+  const Real *rho = &prim(IDN,k,j,0);
+  const Real *pres = limiter ? &prim(IPR,k,j,0) : rho;
+  const Real *ec = &u_cr(CRE,k,j,0);
+  const Real *bx = &bcc(IB1,k,j,0), *by = &bcc(IB2,k,j,0), *bz = &bcc(IB3,k,j,0);
+  const Real *gx = &grad_pc(0,k,j,0), *gy = &grad_pc(1,k,j,0), *gz = &grad_pc(2,k,j,0);
+
+#pragma omp simd simdlen(SIMD_WIDTH)
+  for (int i=is; i<=ie; ++i) {
+    Real b1 = bx[i], b2 = by[i], b3 = bz[i];
+    Real btot = std::sqrt(b1*b1 + b2*b2 + b3*b3);
+    Real b_grad_pc = b1*gx[i] + b2*gy[i] + b3*gz[i];
+
+    Real f_i = limiter ? IonFraction(pres[i]/rho[i], f_ion, t_ion, dt_ion) : f_ion;
+    Real inv_sqrt_rho = 1.0/std::sqrt(rho[i]*f_i);
+    Real va = btot*inv_sqrt_rho;
+    Real dpc_sign = (b_grad_pc > TINY_NUMBER) ? 1.0 :
+                    ((-b_grad_pc > TINY_NUMBER) ? -1.0 : 0.0);
+    Real vcoef = stream ? -inv_sqrt_rho*dpc_sign : 0.0;
+    pcr->v_adv(0,k,j,i) = b1*vcoef;
+    pcr->v_adv(1,k,j,i) = b2*vcoef;
+    pcr->v_adv(2,k,j,i) = b3*vcoef;
+
+    // without streaming the opacity is reset; for a vanishing Alfven speed the value
+    // set by AnisotropicOpacity is kept
+    bool has_va = (va > TINY_NUMBER);
+    Real denom = has_va ? btot*va*stream_coef*ec[i] : 1.0;
+    Real sigma_stream = has_va ? std::abs(b_grad_pc)/denom : pcr->sigma_adv(0,k,j,i);
+    pcr->sigma_adv(0,k,j,i) = stream ? sigma_stream : max_opacity;
+    pcr->sigma_adv(1,k,j,i) = max_opacity;
+    pcr->sigma_adv(2,k,j,i) = max_opacity;
+  }
+  return;
+}
@@ -0,0 +1,115 @@
+//======================================================================================
+// Athena++ astrophysical MHD code
+// Copyright (C) 2014 James M. Stone  <jmstone@princeton.edu>
+//
+// This program is free software: you can redistribute and/or modify it under the terms
+// of the GNU General Public License (GPL) as published by the Free Software Foundation,
+// either version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+// PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+//
+// You should have received a copy of GNU GPL in the file LICENSE included in the code
+// distribution.  If not see <http://www.gnu.org/licenses/>.
+//======================================================================================
+//! \file cr_refinement.cpp
+//  \brief built-in AMR refinement criterion for cosmic rays
+//
+//  Selected with <cr> amr_refine = true on an adaptive mesh, and combined with the
+//  refinement condition enrolled by the problem generator, if any. A MeshBlock is
+//  refined where the relative CR energy jump 0.5*|Ec(i+1)-Ec(i-1)|/Ec (summed in
+//  quadrature over the directions) exceeds amr_grad_refine, or where the reduced CR
+//  flux |Fc|/(vmax*Ec) exceeds amr_flux_refine, so that CR fronts and the streaming
+//  regions are resolved. It is derefined where both are below their amr_*_derefine
+//  thresholds. A non-positive amr_*_refine threshold disables that criterion. Both are
+//  normalized by max(Ec, amr_ec_floor), so that the far tails of the CR distribution,
+//  where the relative jumps are large but Ec is negligible, are not refined.
+//======================================================================================
+
+// C headers
+
+// C++ headers
+#include <algorithm>  // max
+#include <cmath>      // sqrt
+#include <sstream>    // stringstream
+#include <stdexcept>  // runtime_error
+
+// Athena++ headers
+#include "../athena.hpp"
+#include "../athena_arrays.hpp"
+#include "../mesh/mesh.hpp"
+#include "../parameter_input.hpp"
+#include "cr.hpp"
+
+//--------------------------------------------------------------------------------------
+//! \fn void CosmicRay::InitRefinement(ParameterInput *pin)
+//  \brief reads the thresholds of the built-in refinement criterion
+
+void CosmicRay::InitRefinement(ParameterInput *pin) {
+  amr_grad_refine_ = pin->GetOrAddReal("cr", "amr_grad_refine", 0.05);
+  amr_grad_derefine_ = pin->GetOrAddReal("cr", "amr_grad_derefine",
+                                         0.25*amr_grad_refine_);
+  amr_flux_refine_ = pin->GetOrAddReal("cr", "amr_flux_refine", -1.0);
+  amr_flux_derefine_ = pin->GetOrAddReal("cr", "amr_flux_derefine",
+                                         0.25*amr_flux_refine_);
+  amr_ec_floor_ = pin->GetOrAddReal("cr", "amr_ec_floor", TINY_NUMBER);
+  if (amr_grad_refine_ <= 0.0 && amr_flux_refine_ <= 0.0) {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in CosmicRay::InitRefinement" << std::endl
+        << "amr_refine needs a positive amr_grad_refine or amr_flux_refine"
+        << std::endl;
+    ATHENA_ERROR(msg);
+  }
+  if ((amr_grad_refine_ > 0.0 && amr_grad_derefine_ >= amr_grad_refine_)
+      || (amr_flux_refine_ > 0.0 && amr_flux_derefine_ >= amr_flux_refine_)) {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in CosmicRay::InitRefinement" << std::endl
+        << "The amr_*_derefine thresholds must be below the amr_*_refine ones"
+        << std::endl;
+    ATHENA_ERROR(msg);
+  }
+  return;
+}
+
+//--------------------------------------------------------------------------------------
+//! \fn int CosmicRay::CheckRefinement()
+//  \brief returns 1 to refine, -1 to derefine and 0 to keep the level of the MeshBlock.
+//         The neighbour offsets are zero in collapsed directions, so the loop has no
+//         branches and vectorizes along i.
+
+int CosmicRay::CheckRefinement() {
+  MeshBlock *pmb = pmy_block;
+  const int dj = (pmb->block_size.nx2 > 1) ? 1 : 0;
+  const int dk = (pmb->block_size.nx3 > 1) ? 1 : 0;
+  const AthenaArray<Real> &ucr = u_cr;
+  const Real ec_floor = std::max(amr_ec_floor_, TINY_NUMBER);
+  Real max_grad = 0.0, max_flux = 0.0;
+  for (int k=pmb->ks; k<=pmb->ke; ++k) {
+    for (int j=pmb->js; j<=pmb->je; ++j) {
+#pragma omp simd reduction(max: max_grad, max_flux)
+      for (int i=pmb->is; i<=pmb->ie; ++i) {
+        Real inv_ec = 1.0/std::max(ucr(CRE,k,j,i), ec_floor);
+        Real g1 = ucr(CRE,k,j,i+1) - ucr(CRE,k,j,i-1);
+        Real g2 = ucr(CRE,k,j+dj,i) - ucr(CRE,k,j-dj,i);
+        Real g3 = ucr(CRE,k+dk,j,i) - ucr(CRE,k-dk,j,i);
+        Real grad = 0.5*std::sqrt(g1*g1 + g2*g2 + g3*g3)*inv_ec;
+        // the flux variables are stored as Fc/vmax
+        Real fc = std::sqrt(SQR(ucr(CRF1,k,j,i)) + SQR(ucr(CRF2,k,j,i))
+                            + SQR(ucr(CRF3,k,j,i)))*inv_ec;
+        max_grad = std::max(max_grad, grad);
+        max_flux = std::max(max_flux, fc);
+      }
+    }
+  }
+
+  const bool use_grad = (amr_grad_refine_ > 0.0);
+  const bool use_flux = (amr_flux_refine_ > 0.0);
+  if ((use_grad && max_grad > amr_grad_refine_)
+      || (use_flux && max_flux > amr_flux_refine_))
+    return 1;
+  if ((!use_grad || max_grad < amr_grad_derefine_)
+      && (!use_flux || max_flux < amr_flux_derefine_))
+    return -1;
+  return 0;
+}
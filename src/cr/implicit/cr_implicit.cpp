@@ -0,0 +1,54 @@
+//======================================================================================
+// Athena++ astrophysical MHD code
+// Copyright (C) 2014 James M. Stone  <jmstone@princeton.edu>
+//
+// This program is free software: you can redistribute and/or modify it under the terms
+// of the GNU General Public License (GPL) as published by the Free Software Foundation,
+// either version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+// PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+//
+// You should have received a copy of GNU GPL in the file LICENSE included in the code
+// distribution.  If not see <http://www.gnu.org/licenses/>.
+//======================================================================================
+//! \file cr_implicit.cpp
+//  \brief implementation of the implicit cosmic ray transport class
+//======================================================================================
+
+// C headers
+
+// C++ headers
+#include <sstream>    // msg
+#include <stdexcept>  // runtime_error
+
+// Athena++ headers
+#include "../../athena.hpp"
+#include "../../mesh/mesh.hpp"
+#include "../../parameter_input.hpp"
+#include "cr_implicit.hpp"
+
+IMCosmicRay::IMCosmicRay(Mesh *pm, ParameterInput *pin) {
+  // read in the parameters
+  // maximum number of iterations
+  nlimit_ = pin->GetOrAddInteger("cr","nlimit",100);
+  error_limit_ = pin->GetOrAddReal("cr","error_limit",1.e-6);
+  rb_or_not = pin->GetOrAddInteger("cr","red_or_black",0);
+  if (rb_or_not < 0 || rb_or_not > 1) {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in IMCosmicRay constructor" << std::endl
+        << "red_or_black=" << rb_or_not << " must be 0 or 1" << std::endl;
+    ATHENA_ERROR(msg);
+  }
+  sum_diff_ = 0.0;
+  sum_full_ = 0.0;
+
+  pimcritlist = new IMCRITTaskList(pm);
+  pimcrhylist = new IMCRHydroTaskList(pm);
+}
+
+IMCosmicRay::~IMCosmicRay() {
+  delete pimcritlist;
+  delete pimcrhylist;
+}
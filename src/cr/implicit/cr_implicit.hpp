@@ -0,0 +1,52 @@
+#ifndef CR_IMPLICIT_CR_IMPLICIT_HPP_
+#define CR_IMPLICIT_CR_IMPLICIT_HPP_
+//======================================================================================
+// Athena++ astrophysical MHD code
+// Copyright (C) 2014 James M. Stone  <jmstone@princeton.edu>
+// See LICENSE file for full public license information.
+//======================================================================================
+//! \file cr_implicit.hpp
+//  \brief implicit cosmic ray transport class definitions
+//======================================================================================
+
+// C headers
+
+// C++ headers
+
+// Athena++ headers
+#include "../../athena.hpp"
+#include "../../athena_arrays.hpp"
+#include "../../task_list/im_cr_task_list.hpp"
+
+class Mesh;
+class MeshBlock;
+class ParameterInput;
+class TimeIntegratorTaskList;
+
+//! \class IMCosmicRay
+//  \brief iterations for the implicit CR transport (<cr> implicit = true). After each
+//  stage of the time integrator the CR moments are solved with backward Euler, which
+//  removes the vmax limit on the time step.
+
+class IMCosmicRay {
+ public:
+  IMCosmicRay(Mesh *pm, ParameterInput *pin);
+  ~IMCosmicRay();
+
+  void Iteration(Mesh *pm, TimeIntegratorTaskList *ptlist, int stage);
+  void CheckResidual(MeshBlock *pmb,
+        AthenaArray<Real> &u_cr_old, AthenaArray<Real> &u_cr_new);
+
+  int rb_or_not;  // 0: Jacobi, 1/2: red/black cells of a Gauss-Seidel sweep
+
+  IMCRITTaskList *pimcritlist;
+  IMCRHydroTaskList *pimcrhylist;
+
+ private:
+  Real sum_diff_;
+  Real sum_full_;
+  int nlimit_;       // threadhold for the number of iterations
+  Real error_limit_;
+};
+
+#endif // CR_IMPLICIT_CR_IMPLICIT_HPP_
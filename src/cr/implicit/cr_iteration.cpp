@@ -0,0 +1,149 @@
+//======================================================================================
+// Athena++ astrophysical MHD code
+// Copyright (C) 2014 James M. Stone  <jmstone@princeton.edu>
+//
+// This program is free software: you can redistribute and/or modify it under the terms
+// of the GNU General Public License (GPL) as published by the Free Software Foundation,
+// either version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+// PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+//
+// You should have received a copy of GNU GPL in the file LICENSE included in the code
+// distribution.  If not see <http://www.gnu.org/licenses/>.
+//======================================================================================
+//! \file cr_iteration.cpp
+//  \brief iterations to solve the cosmic ray transport equations implicitly
+//======================================================================================
+
+// C headers
+
+// C++ headers
+#include <cmath>      // abs
+#include <iostream>   // cout
+
+// Athena++ headers
+#include "../../athena.hpp"
+#include "../../field/field.hpp"
+#include "../../globals.hpp"
+#include "../../hydro/hydro.hpp"
+#include "../../mesh/mesh.hpp"
+#include "../../task_list/task_list.hpp"
+#include "../cr.hpp"
+#include "../integrators/cr_integrators.hpp"
+#include "cr_implicit.hpp"
+
+// MPI header
+#ifdef MPI_PARALLEL
+#include <mpi.h>
+#endif
+
+//--------------------------------------------------------------------------------------
+// \!fn void Iteration()
+// \brief function to perform iterations
+
+void IMCosmicRay::Iteration(Mesh *pm, TimeIntegratorTaskList *ptlist, int stage) {
+  // Each iteration updates every cell with the flux divergence and source terms
+  // solved together, the neighbours taken from the previous iteration, then
+  // exchanges the boundaries and computes the change of the solution
+  MeshBlock *pmb = pm->my_blocks(0);
+
+  if (stage > ptlist->nstages || !ptlist->stage_wghts[stage-1].main_stage)
+    return;
+  const Real wght = ptlist->stage_wghts[stage-1].beta*pm->dt;
+
+  bool iteration = true;
+  int niter = 0;
+
+  for (int nb=0; nb<pm->nblocal; ++nb) {
+    pmb = pm->my_blocks(nb);
+    CosmicRay *pcr = pmb->pcr;
+    Hydro *ph = pmb->phydro;
+    Field *pf = pmb->pfield;
+
+    // u_cr1 stores the value at the beginning of the step, which is the RHS
+    if (stage == 1)
+      pcr->u_cr1 = pcr->u_cr;
+
+    // diffusion speed, streaming and Grad Pc terms of the current state; the
+    // signal speeds of the implicit flux are frozen for the whole iteration
+    pcr->pcrintegrator->CalculateFluxes(ph->w, pf->bcc, pcr->u_cr, 1);
+    pcr->pcrintegrator->FirstOrderFluxDivergenceCoef(ph->w);
+
+    // u_cr_old always stores the value from the last iteration
+    pcr->u_cr_old = pcr->u_cr;
+  }
+
+  while (iteration) {
+    sum_full_ = 0.0;
+    sum_diff_ = 0.0;
+
+    if (rb_or_not > 0) {
+      // red cells
+      rb_or_not = 1;
+      pimcritlist->DoTaskListOneStage(wght);
+      // black cells
+      rb_or_not = 2;
+    }
+    pimcritlist->DoTaskListOneStage(wght);
+
+    for (int nb=0; nb<pm->nblocal; ++nb) {
+      pmb = pm->my_blocks(nb);
+      CosmicRay *pcr = pmb->pcr;
+      // copy the solution over
+      pcr->u_cr_old = pcr->u_cr;
+      sum_full_ += pcr->sum_full;
+      sum_diff_ += pcr->sum_diff;
+    }
+
+    // MPI sum across all the cores
+#ifdef MPI_PARALLEL
+    Real global_sum = 0.0;
+    Real global_diff = 0.0;
+    MPI_Allreduce(&sum_full_, &global_sum, 1, MPI_ATHENA_REAL, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(&sum_diff_, &global_diff, 1, MPI_ATHENA_REAL, MPI_SUM, MPI_COMM_WORLD);
+    sum_full_ = global_sum;
+    sum_diff_ = global_diff;
+#endif
+
+    niter++;
+    Real tot_res = sum_diff_/sum_full_;
+    if ((niter >= nlimit_) || tot_res < error_limit_)
+      iteration = false;
+  }
+
+  if (Globals::my_rank == 0) {
+    if (pm->ncycle_out != 0 && pm->ncycle%pm->ncycle_out == 0)
+      std::cout << "CR iteration stops at niter: " << niter
+                << " relative error: " << sum_diff_/sum_full_ << std::endl;
+  }
+
+  // After iteration,
+  // add CR source term to hydro
+  // update hydro boundary
+  // update opacity
+  pimcrhylist->DoTaskListOneStage(wght);
+}
+
+
+void IMCosmicRay::CheckResidual(MeshBlock *pmb,
+                                AthenaArray<Real> &u_cr_old,
+                                AthenaArray<Real> &u_cr_new) {
+  CosmicRay *pcr = pmb->pcr;
+  int is = pmb->is; int js = pmb->js; int ks = pmb->ks;
+  int ie = pmb->ie; int je = pmb->je; int ke = pmb->ke;
+
+  pcr->sum_diff = 0.0;
+  pcr->sum_full = 0.0;
+  for (int n=0; n<NCR; ++n) {
+    for (int k=ks; k<=ke; ++k) {
+      for (int j=js; j<=je; ++j) {
+        for (int i=is; i<=ie; ++i) {
+          pcr->sum_diff += std::abs(u_cr_old(n,k,j,i) - u_cr_new(n,k,j,i));
+          pcr->sum_full += std::abs(u_cr_new(n,k,j,i));
+        }
+      }
+    }
+  }
+}
@@ -95,3 +95,22 @@ void CRIntegrator::CRFlux(int fdir, int il, int iu,
   }
   return;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn CRIntegrator::HybridEnergyFlux()
+//  \brief hybrid transport: on the faces of row (k,j) next to an optically thick cell,
+//  replace the CR energy flux by the upwind advective flux 4/3 v Ec. The diffusive
+//  part of the flux there is taken by the CR diffusion Multigrid solver.
+
+void CRIntegrator::HybridEnergyFlux(const int dir, const int k, const int j,
+                                    const int il, const int iu, AthenaArray<Real> &flx) {
+  AthenaArray<Real> &thick = pmy_cr->thick;
+  const int dk = (dir == X3DIR), dj = (dir == X2DIR), di = (dir == X1DIR);
+  for (int i=il; i<=iu; ++i) {
+    if (thick(k,j,i) + thick(k-dk,j-dj,i-di) > 0.0) {
+      Real vf = 0.5*(ucr_l_(NCR,i) + ucr_r_(NCR,i));
+      flx(CRE,i) = (4.0/3.0)*vf*((vf > 0.0) ? ucr_l_(CRE,i) : ucr_r_(CRE,i));
+    }
+  }
+  return;
+}
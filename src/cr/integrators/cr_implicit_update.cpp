@@ -0,0 +1,329 @@
+//======================================================================================
+// Athena++ astrophysical MHD code
+// Copyright (C) 2014 James M. Stone  <jmstone@princeton.edu>
+//
+// This program is free software: you can redistribute and/or modify it under the terms
+// of the GNU General Public License (GPL) as published by the Free Software Foundation,
+// either version 3 of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+// PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+//
+// You should have received a copy of GNU GPL in the file LICENSE included in the code
+// distribution.  If not see <http://www.gnu.org/licenses/>.
+//======================================================================================
+//! \file cr_implicit_update.cpp
+//  \brief backward Euler update of the cosmic ray moments used by the implicit
+//  transport. The first order flux divergence and the source terms of each cell
+//  are solved together, with the neighbouring cells taken from the previous iterate,
+//  so IMCosmicRay::Iteration() converges to the implicit solution.
+//======================================================================================
+
+// C headers
+
+// C++ headers
+#include <algorithm>  // max, min
+#include <cmath>      // sqrt
+
+// Athena++ headers
+#include "../../athena.hpp"
+#include "../../athena_arrays.hpp"
+#include "../../coordinates/coordinates.hpp"
+#include "../../eos/eos.hpp"
+#include "../../field/field.hpp"
+#include "../../hydro/hydro.hpp"
+#include "../../mesh/mesh.hpp"
+#include "../../utils/utils.hpp"
+#include "../cr.hpp"
+
+// class header
+#include "cr_integrators.hpp"
+
+namespace {
+//----------------------------------------------------------------------------------------
+//! \fn void AddFaceTerms()
+//  \brief add the terms of the first order flux divergence along one direction.
+//  ap, am are wght*area/volume of the upper and lower faces, sp, sm their signal speeds,
+//  up, um the neighbouring states and d the flux component normal to the faces.
+
+inline void AddFaceTerms(const int d, const Real vmax, const Real ap, const Real am,
+                         const Real sp, const Real sm,
+                         const Real up[NCR], const Real um[NCR],
+                         Real &diag, Real &c, Real rhs[NCR]) {
+  diag += 0.5*(ap*sp + am*sm);
+  c = 0.5*vmax*(ap - am);
+  rhs[CRE] -= 0.5*(ap*(vmax*up[d] - sp*up[CRE]) - am*(vmax*um[d] + sm*um[CRE]));
+  for (int n=CRF1; n<=CRF3; ++n)
+    rhs[n] += 0.5*(ap*sp*up[n] + am*sm*um[n]);
+  rhs[d] -= 0.5*vmax*(ap*up[CRE] - am*um[CRE])/3.0;
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void CRIntegrator::FirstOrderFluxDivergenceCoef(AthenaArray<Real> &w)
+//  \brief store the signal speed of the donor cell flux at all faces, from the HLLE
+//  speeds of CRFlux() with the current velocity and diffusion speed. The implicit flux
+//  uses the larger of the two for both sides (a local Lax-Friedrichs flux): with the
+//  one-sided HLLE flux of a supersonic face the iterations do not converge once the
+//  time step is much larger than the vmax limit.
+
+void CRIntegrator::FirstOrderFluxDivergenceCoef(AthenaArray<Real> &w) {
+  CosmicRay *pcr = pmy_cr;
+  MeshBlock *pmb = pcr->pmy_block;
+  const Real vsig_max = pcr->vmax*std::sqrt(1.0/3.0);
+
+  int is = pmb->is; int js = pmb->js; int ks = pmb->ks;
+  int ie = pmb->ie; int je = pmb->je; int ke = pmb->ke;
+
+  for (int dir=X1DIR; dir<=X3DIR; ++dir) {
+    if ((dir == X2DIR && pmb->block_size.nx2 == 1)
+        || (dir == X3DIR && pmb->block_size.nx3 == 1))
+      continue;
+    const int di = (dir == X1DIR), dj = (dir == X2DIR), dk = (dir == X3DIR);
+    AthenaArray<Real> &vsig = imp_vsig_[dir];
+    for (int k=ks; k<=ke+dk; ++k) {
+      for (int j=js; j<=je+dj; ++j) {
+#pragma omp simd
+        for (int i=is; i<=ie+di; ++i) {
+          Real vl = w(IVX+dir,k-dk,j-dj,i-di);
+          Real vr = w(IVX+dir,k,j,i);
+          Real vdl = pcr->v_diff(dir,k-dk,j-dj,i-di);
+          Real vdr = pcr->v_diff(dir,k,j,i);
+
+          Real meanadv = 0.5*(vl + vr);
+          Real meandiffv = 0.5*(vdl + vdr);
+          Real al = std::min((meanadv - meandiffv),(vl - vdl));
+          Real ar = std::max((meanadv + meandiffv),(vr + vdr));
+          vsig(k,j,i) = std::min(std::max(-al,ar),vsig_max);
+        }
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void CRIntegrator::ImplicitUpdate(MeshBlock *pmb, const Real wght, const int rb,
+//        AthenaArray<Real> &w, AthenaArray<Real> &cr_ini, AthenaArray<Real> &cr_nb,
+//        AthenaArray<Real> &cr_out)
+//  \brief solve cr_out = cr_ini - wght*(div F - S) in each cell, with the neighbours
+//  in the flux divergence taken from cr_nb. rb = 0 updates all cells (Jacobi), rb = 1
+//  and 2 only the red or black cells of a checkerboard, with cr_nb = cr_out.
+
+void CRIntegrator::ImplicitUpdate(MeshBlock *pmb, const Real wght, const int rb,
+        AthenaArray<Real> &w, AthenaArray<Real> &cr_ini, AthenaArray<Real> &cr_nb,
+        AthenaArray<Real> &cr_out) {
+  CosmicRay *pcr = pmy_cr;
+  Coordinates *pco = pmb->pcoord;
+  const Real vmax = pcr->vmax;
+  const Real vlim = pcr->vmax;
+  const Real invlim = 1.0/vlim;
+  const Real ec_floor = 3*pmb->peos->GetPressureFloor();
+  const bool stream = (pcr->stream_flag != 0);
+  const bool f2 = (pmb->block_size.nx2 > 1), f3 = (pmb->block_size.nx3 > 1);
+
+  int is = pmb->is; int js = pmb->js; int ks = pmb->ks;
+  int ie = pmb->ie; int je = pmb->je; int ke = pmb->ke;
+
+  for (int k=ks; k<=ke; ++k) {
+    for (int j=js; j<=je; ++j) {
+      const Real *x1area = &(pco->face1_area(k,j,0)), *vol = &(pco->cell_volume(k,j,0));
+      const Real *x2area = &(pco->face2_area(k,j,0)),
+                 *x2area_p1 = &(pco->face2_area(k,j+1,0));
+      const Real *x3area = &(pco->face3_area(k,j,0)),
+                 *x3area_p1 = &(pco->face3_area(k+1,j,0));
+
+      // red cells have (i-is)+(j-js)+(k-ks) even
+      int il = is, di = 1;
+      if (rb > 0) {
+        il = is + ((j-js) + (k-ks) + rb - 1)%2;
+        di = 2;
+      }
+      for (int i=il; i<=ie; i+=di) {
+        Real g = wght/vol[i];
+        Real diag = 1.0;
+        Real c1 = 0.0, c2 = 0.0, c3 = 0.0;
+        Real rhs[NCR], up[NCR], um[NCR];
+        for (int n=0; n<NCR; ++n)
+          rhs[n] = cr_ini(n,k,j,i) + wght*coord_source_(n,k,j,i);
+
+        for (int n=0; n<NCR; ++n) {
+          up[n] = cr_nb(n,k,j,i+1);
+          um[n] = cr_nb(n,k,j,i-1);
+        }
+        AddFaceTerms(CRF1, vmax, g*x1area[i+1], g*x1area[i],
+                     imp_vsig_[X1DIR](k,j,i+1), imp_vsig_[X1DIR](k,j,i),
+                     up, um, diag, c1, rhs);
+        if (f2) {
+          for (int n=0; n<NCR; ++n) {
+            up[n] = cr_nb(n,k,j+1,i);
+            um[n] = cr_nb(n,k,j-1,i);
+          }
+          AddFaceTerms(CRF2, vmax, g*x2area_p1[i], g*x2area[i],
+                       imp_vsig_[X2DIR](k,j+1,i), imp_vsig_[X2DIR](k,j,i),
+                       up, um, diag, c2, rhs);
+        }
+        if (f3) {
+          for (int n=0; n<NCR; ++n) {
+            up[n] = cr_nb(n,k+1,j,i);
+            um[n] = cr_nb(n,k-1,j,i);
+          }
+          AddFaceTerms(CRF3, vmax, g*x3area_p1[i], g*x3area[i],
+                       imp_vsig_[X3DIR](k+1,j,i), imp_vsig_[X3DIR](k,j,i),
+                       up, um, diag, c3, rhs);
+        }
+
+        Real v1 = w(IVX,k,j,i);
+        Real v2 = w(IVY,k,j,i);
+        Real v3 = w(IVZ,k,j,i);
+        Real vtot1 = stream ? v1 + pcr->v_adv(0,k,j,i) : v1;
+        Real vtot2 = stream ? v2 + pcr->v_adv(1,k,j,i) : v2;
+        Real vtot3 = stream ? v3 + pcr->v_adv(2,k,j,i) : v3;
+        Real rhs_e = rhs[CRE];
+        Real fr1 = rhs[CRF1];
+        Real fr2 = rhs[CRF2];
+        Real fr3 = rhs[CRF3];
+
+        // the source terms are diagonal in the frame aligned with B
+        if (MAGNETIC_FIELDS_ENABLED) {
+          const Real sint_b = pcr->b_angle(0,k,j,i), cost_b = pcr->b_angle(1,k,j,i),
+                     sinp_b = pcr->b_angle(2,k,j,i), cosp_b = pcr->b_angle(3,k,j,i);
+          RotateVec(sint_b,cost_b,sinp_b,cosp_b,v1,v2,v3);
+          RotateVec(sint_b,cost_b,sinp_b,cosp_b,fr1,fr2,fr3);
+          RotateVec(sint_b,cost_b,sinp_b,cosp_b,c1,c2,c3);
+          vtot1 = sint_b*(cosp_b*vtot1 + sinp_b*vtot2) + cost_b*vtot3;
+          vtot2 = 0.0;
+          vtot3 = 0.0;
+          rhs_e += wght*ec_source_(k,j,i);
+        }
+
+        Real sigma_x = pcr->sigma_diff(0,k,j,i);
+        Real sigma_y = pcr->sigma_diff(1,k,j,i);
+        Real sigma_z = pcr->sigma_diff(2,k,j,i);
+        if (stream) {
+          sigma_x = 1.0/(1.0/sigma_x + 1.0/pcr->sigma_adv(0,k,j,i));
+          sigma_y = 1.0/(1.0/sigma_y + 1.0/pcr->sigma_adv(1,k,j,i));
+          sigma_z = 1.0/(1.0/sigma_z + 1.0/pcr->sigma_adv(2,k,j,i));
+        }
+
+        // same arrowhead system as CRIntegrator::AddSourceTerms(), with the flux
+        // divergence adding diag to all rows and c between Ec and Fc
+        Real coef_11 = diag - wght*sigma_x*vtot1*v1*invlim*4.0/3.0
+                            - wght*sigma_y*vtot2*v2*invlim*4.0/3.0
+                            - wght*sigma_z*vtot3*v3*invlim*4.0/3.0;
+        Real coef_12 = c1 + wght*sigma_x*vtot1;
+        Real coef_13 = c2 + wght*sigma_y*vtot2;
+        Real coef_14 = c3 + wght*sigma_z*vtot3;
+
+        Real coef_21 = c1/3.0 - wght*v1*sigma_x*4.0/3.0;
+        Real coef_22 = diag + wght*vlim*sigma_x;
+
+        Real coef_31 = c2/3.0 - wght*v2*sigma_y*4.0/3.0;
+        Real coef_33 = diag + wght*vlim*sigma_y;
+
+        Real coef_41 = c3/3.0 - wght*v3*sigma_z*4.0/3.0;
+        Real coef_44 = diag + wght*vlim*sigma_z;
+
+        Real e_coef = coef_11 - coef_12*coef_21/coef_22 - coef_13*coef_31/coef_33
+                      - coef_14*coef_41/coef_44;
+        Real new_ec = rhs_e - coef_12*fr1/coef_22 - coef_13*fr2/coef_33
+                      - coef_14*fr3/coef_44;
+        new_ec /= e_coef;
+
+        Real newfr1 = (fr1 - coef_21*new_ec)/coef_22;
+        Real newfr2 = (fr2 - coef_31*new_ec)/coef_33;
+        Real newfr3 = (fr3 - coef_41*new_ec)/coef_44;
+
+        if (MAGNETIC_FIELDS_ENABLED)
+          InvRotateVec(pcr->b_angle(0,k,j,i),pcr->b_angle(1,k,j,i),
+                       pcr->b_angle(2,k,j,i),pcr->b_angle(3,k,j,i),
+                       newfr1,newfr2,newfr3);
+
+        cr_out(CRE,k,j,i) = std::max(new_ec,ec_floor);
+        cr_out(CRF1,k,j,i) = newfr1;
+        cr_out(CRF2,k,j,i) = newfr2;
+        cr_out(CRF3,k,j,i) = newfr3;
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void CRIntegrator::AddImplicitSourceTerms(MeshBlock *pmb, const Real wght,
+//        AthenaArray<Real> &u, AthenaArray<Real> &w, AthenaArray<Real> &bcc,
+//        AthenaArray<Real> &u_cr)
+//  \brief add the momentum and energy exchanged with the converged CR state to the gas
+
+void CRIntegrator::AddImplicitSourceTerms(MeshBlock *pmb, const Real wght,
+        AthenaArray<Real> &u, AthenaArray<Real> &w, AthenaArray<Real> &bcc,
+        AthenaArray<Real> &u_cr) {
+  CosmicRay *pcr = pmy_cr;
+  const Real invlim = 1.0/pcr->vmax;
+  const bool stream = (pcr->stream_flag != 0);
+  const bool src = (pcr->src_flag > 0);
+
+  int is = pmb->is; int js = pmb->js; int ks = pmb->ks;
+  int ie = pmb->ie; int je = pmb->je; int ke = pmb->ke;
+
+  if (src) {
+    for (int k=ks; k<=ke; ++k) {
+      for (int j=js; j<=je; ++j) {
+        for (int i=is; i<=ie; ++i) {
+          Real v1 = w(IVX,k,j,i);
+          Real v2 = w(IVY,k,j,i);
+          Real v3 = w(IVZ,k,j,i);
+          Real vtot1 = stream ? v1 + pcr->v_adv(0,k,j,i) : v1;
+          Real vtot2 = stream ? v2 + pcr->v_adv(1,k,j,i) : v2;
+          Real vtot3 = stream ? v3 + pcr->v_adv(2,k,j,i) : v3;
+          Real ec = u_cr(CRE,k,j,i);
+          Real fr1 = u_cr(CRF1,k,j,i);
+          Real fr2 = u_cr(CRF2,k,j,i);
+          Real fr3 = u_cr(CRF3,k,j,i);
+
+          if (MAGNETIC_FIELDS_ENABLED) {
+            const Real sint_b = pcr->b_angle(0,k,j,i), cost_b = pcr->b_angle(1,k,j,i),
+                       sinp_b = pcr->b_angle(2,k,j,i), cosp_b = pcr->b_angle(3,k,j,i);
+            RotateVec(sint_b,cost_b,sinp_b,cosp_b,v1,v2,v3);
+            RotateVec(sint_b,cost_b,sinp_b,cosp_b,fr1,fr2,fr3);
+            vtot1 = sint_b*(cosp_b*vtot1 + sinp_b*vtot2) + cost_b*vtot3;
+            vtot2 = 0.0;
+            vtot3 = 0.0;
+          }
+
+          Real sigma_x = pcr->sigma_diff(0,k,j,i);
+          Real sigma_y = pcr->sigma_diff(1,k,j,i);
+          Real sigma_z = pcr->sigma_diff(2,k,j,i);
+          if (stream) {
+            sigma_x = 1.0/(1.0/sigma_x + 1.0/pcr->sigma_adv(0,k,j,i));
+            sigma_y = 1.0/(1.0/sigma_y + 1.0/pcr->sigma_adv(1,k,j,i));
+            sigma_z = 1.0/(1.0/sigma_z + 1.0/pcr->sigma_adv(2,k,j,i));
+          }
+
+          // momentum and energy lost by the CRs through the interaction term
+          Real dm1 = wght*sigma_x*(fr1 - v1*ec*invlim*4.0/3.0);
+          Real dm2 = wght*sigma_y*(fr2 - v2*ec*invlim*4.0/3.0);
+          Real dm3 = wght*sigma_z*(fr3 - v3*ec*invlim*4.0/3.0);
+          Real de = vtot1*dm1 + vtot2*dm2 + vtot3*dm3;
+
+          if (MAGNETIC_FIELDS_ENABLED) {
+            InvRotateVec(pcr->b_angle(0,k,j,i),pcr->b_angle(1,k,j,i),
+                         pcr->b_angle(2,k,j,i),pcr->b_angle(3,k,j,i),dm1,dm2,dm3);
+            de -= wght*ec_source_(k,j,i);
+          }
+
+          if (NON_BAROTROPIC_EOS) {
+            Real new_eg = u(IEN,k,j,i) + de;
+            u(IEN,k,j,i) = (new_eg < 0.0) ? u(IEN,k,j,i) : new_eg;
+          }
+          u(IM1,k,j,i) += dm1;
+          u(IM2,k,j,i) += dm2;
+          u(IM3,k,j,i) += dm3;
+        }
+      }
+    }
+  }
+
+  // Add user defined source term for cosmic rays
+  if (pcr->cr_source_defined)
+    pcr->UserSourceTerm_(pmb, pmb->pmy_mesh->time, wght, w, pmb->pfield->b, u_cr);
+}
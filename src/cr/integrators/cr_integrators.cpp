@@ -20,6 +20,8 @@
 // C headers
 
 // C++ headers
+#include <cstdint>    // uintptr_t
+#include <cstring>    // strcmp
 #include <sstream>
 #include <stdexcept>  // runtime_error
 #include <string>     // c_str()
@@ -50,24 +52,15 @@ CRIntegrator::CRIntegrator(CosmicRay *pcr, ParameterInput *pin) {
     }
   }
 
+  // as for Reconstruction::uniform, the flux divergence then needs no areas or volumes
+  uniform_cartesian = pin->GetOrAddBoolean("cr","uniform_divergence",true)
+                      && (std::strcmp(COORDINATE_SYSTEM, "cartesian") == 0)
+                      && pmb->block_size.x1rat == 1.0 && pmb->block_size.x2rat == 1.0
+                      && pmb->block_size.x3rat == 1.0;
+
   int ncells1 = pmb->ncells1, ncells2 = pmb->ncells2,
   ncells3 = pmb->ncells3;
 
-  x1face_area_.NewAthenaArray(ncells1+1);
-  if(ncells2 > 1) {
-    x2face_area_.NewAthenaArray(ncells1);
-    x2face_area_p1_.NewAthenaArray(ncells1);
-  }
-  if(ncells3 > 1) {
-    x3face_area_.NewAthenaArray(ncells1);
-    x3face_area_p1_.NewAthenaArray(ncells1);
-  }
-  cell_volume_.NewAthenaArray(ncells1);
-
-
-  cwidth2_.NewAthenaArray(ncells1);
-  cwidth3_.NewAthenaArray(ncells1);
-
   dflx_.NewAthenaArray(NCR,ncells1);
 
   // arrays for spatial recontruction
@@ -90,4 +83,67 @@ CRIntegrator::CRIntegrator(CosmicRay *pcr, ParameterInput *pin) {
   grad_pc_.NewAthenaArray(3,ncells3,ncells2,ncells1);
   ec_source_.NewAthenaArray(ncells3,ncells2,ncells1);
   coord_source_.NewAthenaArray(NCR,ncells3,ncells2,ncells1);
+
+  if (pcr->implicit) {
+    imp_vsig_[X1DIR].NewAthenaArray(ncells3,ncells2,ncells1+1);
+    if (ncells2 > 1)
+      imp_vsig_[X2DIR].NewAthenaArray(ncells3,ncells2+1,ncells1);
+    if (ncells3 > 1)
+      imp_vsig_[X3DIR].NewAthenaArray(ncells3+1,ncells2,ncells1);
+  }
+
+  // pad each pencil to a whole number of 64-byte cache lines and align the first one
+  // single precision coefficients (-crfloat) are always widened into the pencils, so
+  // that the transport and source kernels read them as Real
+  pack_pencils_ = pin->GetOrAddBoolean("cr","pack_pencils",false)
+                  || CR_FLOAT_COEFFICIENTS;
+  constexpr int nalign = 64/sizeof(Real);
+  pencil_stride_ = ((ncells1 + nalign - 1)/nalign)*nalign;
+  pencil_ = nullptr;
+  if (pack_pencils_) {
+    pencil_buf_.NewAthenaArray(NPENCIL*pencil_stride_ + nalign);
+    std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(pencil_buf_.data());
+    pencil_ = pencil_buf_.data() + ((64 - addr%64)%64)/sizeof(Real);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void CRIntegrator::PackPencil(AthenaArray<Real> &u_cr, const int k,
+//                        const int j, const int il, const int iu, const bool src)
+//  \brief gather opacities and B angles (and, for the source term, u_cr and the
+//  streaming velocity) of row (k,j) into the aligned pencil buffer
+
+void CRIntegrator::PackPencil(AthenaArray<Real> &u_cr, const int k, const int j,
+                              const int il, const int iu, const bool src) {
+  CosmicRay *pcr = pmy_cr;
+  for (int n=0; n<3; ++n) {
+    Real *sd = Pencil(PSD1+n), *sa = Pencil(PSA1+n);
+#pragma omp simd aligned(sd,sa:64)
+    for (int i=il; i<=iu; ++i) {
+      sd[i] = pcr->sigma_diff(n,k,j,i);
+      sa[i] = pcr->sigma_adv(n,k,j,i);
+    }
+  }
+  if (MAGNETIC_FIELDS_ENABLED) {
+    for (int n=0; n<4; ++n) {
+      Real *ba = Pencil(PSINT+n);
+#pragma omp simd aligned(ba:64)
+      for (int i=il; i<=iu; ++i)
+        ba[i] = pcr->b_angle(n,k,j,i);
+    }
+  }
+  if (src) {
+    for (int n=0; n<NCR; ++n) {
+      Real *ucr = Pencil(PEC+n);
+#pragma omp simd aligned(ucr:64)
+      for (int i=il; i<=iu; ++i)
+        ucr[i] = u_cr(n,k,j,i);
+    }
+    for (int n=0; n<3; ++n) {
+      Real *va = Pencil(PVA1+n);
+#pragma omp simd aligned(va:64)
+      for (int i=il; i<=iu; ++i)
+        va[i] = pcr->v_adv(n,k,j,i);
+    }
+  }
 }
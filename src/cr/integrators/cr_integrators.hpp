@@ -30,6 +30,8 @@ class CRIntegrator {
   CosmicRay *pmy_cr;
 
   void FluxDivergence(const Real wght, AthenaArray<Real> &cr_out);
+  // fused register update and flux divergence (uniform_cartesian only)
+  void WeightedAveFluxDivergence(const Real ave_wghts[4], const Real wght);
   void CalculateFluxes(AthenaArray<Real> &w,
           AthenaArray<Real> &bcc, AthenaArray<Real> &cr, const int order);
 
@@ -39,7 +41,16 @@ class CRIntegrator {
               AthenaArray<Real> &flx);
   void AddSourceTerms(MeshBlock *pmb, const Real dt, AthenaArray<Real> &u,
         AthenaArray<Real> &w, AthenaArray<Real> &bcc, AthenaArray<Real> &ucr);
+
+  // implicit transport (<cr> implicit = true), see cr_implicit_update.cpp
+  void FirstOrderFluxDivergenceCoef(AthenaArray<Real> &w);
+  void ImplicitUpdate(MeshBlock *pmb, const Real wght, const int rb,
+        AthenaArray<Real> &w, AthenaArray<Real> &cr_ini, AthenaArray<Real> &cr_nb,
+        AthenaArray<Real> &cr_out);
+  void AddImplicitSourceTerms(MeshBlock *pmb, const Real wght, AthenaArray<Real> &u,
+        AthenaArray<Real> &w, AthenaArray<Real> &bcc, AthenaArray<Real> &u_cr);
   int cr_xorder;
+  bool uniform_cartesian;  // Cartesian with x1rat = x2rat = x3rat = 1
 
  private:
   AthenaArray<Real> new_sol_;
@@ -52,9 +63,30 @@ class CRIntegrator {
   // temporary array to store the flux
   Real taufact_;
   int vel_flx_flag_;
-  AthenaArray<Real> x1face_area_, x2face_area_, x3face_area_;
-  AthenaArray<Real> x2face_area_p1_, x3face_area_p1_;
-  AthenaArray<Real> cell_volume_, dflx_, cwidth2_, cwidth3_;
+  AthenaArray<Real> dflx_;
+  template <int DIM, bool AVE>
+  void UniformFluxDivergence(const Real ave_wghts[4], const Real wght,
+                             AthenaArray<Real> &cr_out);
+
+  // hybrid transport: advective CR energy flux on the faces of optically thick cells
+  void HybridEnergyFlux(const int dir, const int k, const int j, const int il,
+                        const int iu, AthenaArray<Real> &flx);
+
+  // signal speed of the first order flux at each face for the implicit transport
+  AthenaArray<Real> imp_vsig_[3];
+
+  // optional structure-of-arrays scratch: the per-cell CR data used by the source
+  // and diffusion-velocity kernels is gathered into one buffer of 64-byte aligned
+  // pencils, so the inner loops read from a single contiguous stream
+  enum {PEC, PFC1, PFC2, PFC3, PSD1, PSD2, PSD3, PSA1, PSA2, PSA3,
+        PSINT, PCOST, PSINP, PCOSP, PVA1, PVA2, PVA3, NPENCIL};
+  bool pack_pencils_;
+  int pencil_stride_;
+  AthenaArray<Real> pencil_buf_;
+  Real *pencil_;
+  Real *Pencil(const int n) { return pencil_ + n*pencil_stride_; }
+  void PackPencil(AthenaArray<Real> &u_cr, const int k, const int j,
+                  const int il, const int iu, const bool src);
 };
 
 #endif // CR_INTEGRATORS_CR_INTEGRATORS_HPP_
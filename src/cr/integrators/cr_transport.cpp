@@ -21,6 +21,8 @@
 
 // C++ headers
 #include <algorithm>   // min,max
+#include <cmath>       // exp,sqrt
+#include <limits>      // numeric_limits
 
 // Athena++ headers
 #include "../../athena.hpp"
@@ -49,6 +51,21 @@
 
 static constexpr Real tau_asymptotic_lim=1.0e-3;
 
+namespace {
+//----------------------------------------------------------------------------------------
+//! \fn Real DiffusionSpeedFactor(Real tau)
+//  \brief reduction of the diffusion speed sqrt((1-exp(-tau))/tau) with optical depth,
+//  using the expansion sqrt(1-tau/2) in the optically thin limit. Both branches are
+//  evaluated and blended with a select so that the caller's loop vectorizes.
+
+inline Real DiffusionSpeedFactor(const Real tau) {
+  Real tau_thick = std::max(tau, tau_asymptotic_lim);
+  Real thin = std::sqrt(std::max(1.0 - 0.5*tau, 0.0));
+  Real thick = std::sqrt((1.0 - std::exp(-tau_thick))/tau_thick);
+  return (tau < tau_asymptotic_lim) ? thin : thick;
+}
+} // namespace
+
 void CRIntegrator::CalculateFluxes(
     AthenaArray<Real> &w, AthenaArray<Real> &bcc,
     AthenaArray<Real> &cr, const int order) {
@@ -76,119 +93,100 @@ void CRIntegrator::CalculateFluxes(
   }
 
   //---------------------------------------------------------------------
+  // diffusion velocity along the direction of sigma vector
+  // We first assume B is along x coordinate, then rotate according to B direction
+  // to the actual coordinate. All three directions are computed in a single pass
+  // so that sigma_diff, sigma_adv, b_angle and v_diff are streamed only once
+  // (or, with pack_pencils, read from the aligned pencil buffer).
+  const Real eddf = 1.0/3.0;
+  const Real vdiff_max = pcr->vmax * std::sqrt(eddf);
+  const bool stream = (pcr->stream_flag != 0);
+  const bool f2 = (ncells2 > 1), f3 = (ncells3 > 1);
+  const Real vflx = static_cast<Real>(vel_flx_flag_);
+  // hybrid transport: cells thicker than hybrid_tau in every direction are diffused by
+  // the CR diffusion Multigrid solver
+  const bool hybrid = (pcr->hybrid_tau > 0.0);
+  const Real hybrid_tau = pcr->hybrid_tau;
   for (int k=0; k<ncells3; ++k) {
     for (int j=0; j<ncells2; ++j) {
-      // diffusion velocity along the direction of sigma vector
-      // We first assume B is along x coordinate
-      // Then rotate according to B direction to the actual acooridnate
-      for (int i=0; i<ncells1; ++i) {
-        Real eddxx=1.0/3.0;
-        Real totsigma = pcr->sigma_diff(0,k,j,i);
-        if (pcr->stream_flag)
-          totsigma = 1.0/(1.0/pcr->sigma_diff(0,k,j,i)
-                          + 1.0/pcr->sigma_adv(0,k,j,i));
-        Real taux = taufact_ * totsigma * pco->dx1f(i);
-        taux = taux * taux/(2.0 * eddxx);
-        Real diffv = 1.0;
-
-        if (taux < tau_asymptotic_lim) {
-          diffv = std::sqrt((1.0 - 0.5* taux));
-        } else {
-          diffv = std::sqrt((1.0 - std::exp(-taux)) / taux);
-        }
-        pcr->v_diff(0,k,j,i) = pcr->vmax * std::sqrt(eddxx) * diffv;
+      const Real *dx2 = &(pco->center_width2(k,j,0)), *dx3 = &(pco->center_width3(k,j,0));
+      const Real *sd0, *sd1, *sd2, *sa0, *sa1, *sa2, *sint_b, *cost_b, *sinp_b, *cosp_b;
+      if (pack_pencils_) {
+        PackPencil(cr, k, j, 0, ncells1-1, false);
+        sd0 = Pencil(PSD1); sd1 = Pencil(PSD2); sd2 = Pencil(PSD3);
+        sa0 = Pencil(PSA1); sa1 = Pencil(PSA2); sa2 = Pencil(PSA3);
+        sint_b = Pencil(PSINT); cost_b = Pencil(PCOST);
+        sinp_b = Pencil(PSINP); cosp_b = Pencil(PCOSP);
       }
-
-      // y direction
-      if (ncells2 >1) {
-        pco->CenterWidth2(k,j,0,ncells1-1,cwidth2_);
-        // get the optical depth across the cell
-        for (int i=0; i<ncells1; ++i) {
-          Real eddyy=1.0/3.0;
-          Real totsigma = pcr->sigma_diff(1,k,j,i);
-          if (pcr->stream_flag)
-            totsigma = 1.0/(1.0/pcr->sigma_diff(1,k,j,i)
-                            + 1.0/pcr->sigma_adv(1,k,j,i));
-          Real tauy = taufact_ * totsigma * cwidth2_(i);
-          tauy = tauy * tauy/(2.0 * eddyy);
-
-          Real diffv = 1.0;
-
-          if (tauy < tau_asymptotic_lim) {
-            diffv = std::sqrt((1.0 - 0.5* tauy));
-          } else {
-            diffv = std::sqrt((1.0 - std::exp(-tauy)) / tauy);
-          }
-          pcr->v_diff(1,k,j,i) = pcr->vmax * std::sqrt(eddyy) * diffv;
-        }
-      } else {
-        for (int i=0; i<ncells1; ++i)
-          pcr->v_diff(1,k,j,i) = 0.0;
+#if !CR_FLOAT_COEFFICIENTS
+      else {  // NOLINT
+        sd0 = &(pcr->sigma_diff(0,k,j,0)); sa0 = &(pcr->sigma_adv(0,k,j,0));
+        sd1 = &(pcr->sigma_diff(1,k,j,0)); sa1 = &(pcr->sigma_adv(1,k,j,0));
+        sd2 = &(pcr->sigma_diff(2,k,j,0)); sa2 = &(pcr->sigma_adv(2,k,j,0));
+        sint_b = &(pcr->b_angle(0,k,j,0)); cost_b = &(pcr->b_angle(1,k,j,0));
+        sinp_b = &(pcr->b_angle(2,k,j,0)); cosp_b = &(pcr->b_angle(3,k,j,0));
       }
-
-      // z direction
-      if (ncells3 > 1) {
-        pco->CenterWidth3(k,j,0,ncells1-1,cwidth3_);
+#endif
+      Real *vd0 = &(pcr->v_diff(0,k,j,0)), *vd1 = &(pcr->v_diff(1,k,j,0)),
+           *vd2 = &(pcr->v_diff(2,k,j,0));
+      Real *thk = hybrid ? &(pcr->thick(k,j,0)) : nullptr;
+#pragma omp simd simdlen(SIMD_WIDTH)
+      for (int i=0; i<ncells1; ++i) {
         // get the optical depth across the cell
-        for (int i=0; i<ncells1; ++i) {
-          Real eddzz=1.0/3.0;
-          Real totsigma = pcr->sigma_diff(2,k,j,i);
-          if (pcr->stream_flag)
-            totsigma = 1.0/(1.0/pcr->sigma_diff(2,k,j,i)
-                            + 1.0/pcr->sigma_adv(2,k,j,i));
-          Real tauz = taufact_ * totsigma * cwidth3_(i);
-          tauz = tauz * tauz/(2.0 * eddzz);
-
-          Real diffv = 1.0;
-
-          if (tauz < tau_asymptotic_lim) {
-            diffv = std::sqrt((1.0 - 0.5* tauz));
-          } else {
-            diffv = std::sqrt((1.0 - std::exp(-tauz)) / tauz);
-          }
-          pcr->v_diff(2,k,j,i) = pcr->vmax * std::sqrt(eddzz) * diffv;
+        Real sigx = stream ? 1.0/(1.0/sd0[i] + 1.0/sa0[i]) : sd0[i];
+        Real taux = taufact_ * sigx * pco->dx1f(i);
+        Real vx = vdiff_max * DiffusionSpeedFactor(taux * taux/(2.0 * eddf));
+
+        // y and z are evaluated unconditionally (the cached widths stay finite
+        // in 1D/2D) and discarded by a select, to keep the loop free of branches
+        Real sigy = stream ? 1.0/(1.0/sd1[i] + 1.0/sa1[i]) : sd1[i];
+        Real tauy = taufact_ * sigy * dx2[i];
+        Real vy = vdiff_max * DiffusionSpeedFactor(tauy * tauy/(2.0 * eddf));
+        vy = f2 ? vy : 0.0;
+
+        Real sigz = stream ? 1.0/(1.0/sd2[i] + 1.0/sa2[i]) : sd2[i];
+        Real tauz = taufact_ * sigz * dx3[i];
+        Real vz = vdiff_max * DiffusionSpeedFactor(tauz * tauz/(2.0 * eddf));
+        vz = f3 ? vz : 0.0;
+        if (hybrid) {
+          Real tau = std::min(taux, std::min(f2 ? tauy : taux, f3 ? tauz : taux));
+          thk[i] = (tau > hybrid_tau) ? 1.0 : 0.0;
         }
-      } else {
-        for (int i=0; i<ncells1; ++i)
-          pcr->v_diff(2,k,j,i) = 0.0;
-      }
-
-      // rotate the v_diff vector to the local coordinate
-      if (MAGNETIC_FIELDS_ENABLED) {
-        for (int i=0; i<ncells1; ++i) {
-          InvRotateVec(pcr->b_angle(0,k,j,i),pcr->b_angle(1,k,j,i),
-                       pcr->b_angle(2,k,j,i),pcr->b_angle(3,k,j,i),
-                       pcr->v_diff(0,k,j,i),pcr->v_diff(1,k,j,i),
-                       pcr->v_diff(2,k,j,i));
-          // take the absolute value
-          // Also add the Alfven velocity for the streaming flux
-          pcr->v_diff(0,k,j,i) = std::abs(pcr->v_diff(0,k,j,i));
 
-          pcr->v_diff(1,k,j,i) = std::abs(pcr->v_diff(1,k,j,i));
-
-          pcr->v_diff(2,k,j,i) = std::abs(pcr->v_diff(2,k,j,i));
-        }
-      }
-      // need to add additional sound speed for stability
-      for (int i=0; i<ncells1; ++i) {
-        Real cr_sound_x = vel_flx_flag_ * std::sqrt((4.0/9.0)
-                                                    * cr(CRE,k,j,i)/w(IDN,k,j,i));
-        pcr->v_diff(0,k,j,i) += cr_sound_x;
-        if (ncells2 > 1) {
-          Real cr_sound_y = vel_flx_flag_ * std::sqrt((4.0/9.0)
-                                                      * cr(CRE,k,j,i)/w(IDN,k,j,i));
-          pcr->v_diff(1,k,j,i) += cr_sound_y;
+        // rotate the v_diff vector to the local coordinate and take the
+        // absolute value
+        if (MAGNETIC_FIELDS_ENABLED) {
+          InvRotateVec(sint_b[i], cost_b[i], sinp_b[i], cosp_b[i], vx, vy, vz);
+          vx = std::abs(vx);
+          vy = std::abs(vy);
+          vz = std::abs(vz);
         }
 
-        if (ncells3 > 1) {
-          Real cr_sound_z = vel_flx_flag_ * std::sqrt((4.0/9.0)
-                                                      * cr(CRE,k,j,i)/w(IDN,k,j,i));
-
-          pcr->v_diff(2,k,j,i) += cr_sound_z;
+        // need to add additional sound speed for stability
+        Real cr_sound = vflx * std::sqrt((4.0/9.0) * cr(CRE,k,j,i)/w(IDN,k,j,i));
+        vd0[i] = vx + cr_sound;
+        vd1[i] = f2 ? vy + cr_sound : vy;
+        vd2[i] = f3 ? vz + cr_sound : vz;
+      }
+    }
+  }
+  // a MeshBlock that is thick everywhere is only limited by the diffusion signal speed
+  // of the explicit flux equation in NewBlockTimeStep()
+  if (hybrid) {
+    Real nthin = 0.0, vd_max = 0.0;
+    for (int k=0; k<ncells3; ++k) {
+      for (int j=0; j<ncells2; ++j) {
+        for (int i=0; i<ncells1; ++i) {
+          nthin += 1.0 - pcr->thick(k,j,i);
+          vd_max = std::max(vd_max, std::max(pcr->v_diff(0,k,j,i),
+                            std::max(pcr->v_diff(1,k,j,i), pcr->v_diff(2,k,j,i))));
         }
       }
     }
+    pcr->all_thick = (nthin == 0.0);
+    pcr->max_vdiff = vd_max;
   }
+
   // prepare Array for reconstruction
   for (int n=0; n<NCR; ++n) {
     for (int k=0; k<ncells3; ++k) {
@@ -234,6 +232,7 @@ void CRIntegrator::CalculateFluxes(
 
       // calculate the flux
       CRFlux(CRF1, is, ie+1, ucr_l_, ucr_r_, vdiff_l_, vdiff_r_, dflx_);
+      if (hybrid) HybridEnergyFlux(X1DIR, k, j, is, ie+1, dflx_);
       // store the flux
       for (int n=0; n<NCR; ++n) {
 #pragma omp simd
@@ -290,6 +289,7 @@ void CRIntegrator::CalculateFluxes(
         }
         // calculate the flux
         CRFlux(CRF2, il, iu, ucr_l_, ucr_r_, vdiff_l_, vdiff_r_, dflx_);
+        if (hybrid) HybridEnergyFlux(X2DIR, k, j, il, iu, dflx_);
         // store the flux
         for (int n=0; n<NCR; ++n) {
 #pragma omp simd
@@ -341,6 +341,7 @@ void CRIntegrator::CalculateFluxes(
         }
         // calculate the flux
         CRFlux(CRF3, il, iu, ucr_l_, ucr_r_, vdiff_l_, vdiff_r_, dflx_);
+        if (hybrid) HybridEnergyFlux(X3DIR, k, j, il, iu, dflx_);
         for (int n=0; n<NCR; ++n) {
 #pragma omp simd
           for (int i=il; i<=iu; ++i) {
@@ -361,40 +362,37 @@ void CRIntegrator::CalculateFluxes(
   if (MAGNETIC_FIELDS_ENABLED) {
     for (int k=ks; k<=ke; ++k) {
       for (int j=js; j<=je; ++j) {
-        pmb->pcoord->Face1Area(k,j,is,ie+1,x1face_area_);
-        pmb->pcoord->CellVolume(k,j,is,ie,cell_volume_);
+        const Real *area1 = &(pco->face1_area(k,j,0)), *vol = &(pco->cell_volume(k,j,0));
         // x1 direction
         for (int n=0; n<3; ++n) {
 #pragma omp simd
           for (int i=is; i<=ie; ++i) {
-            grad_pc_(n,k,j,i) = (x1face_area_(i+1)*x1flux(CRF1+n,k,j,i+1)
-                                 - x1face_area_(i)*x1flux(CRF1+n,k,j,i))/cell_volume_(i);
+            grad_pc_(n,k,j,i) = (area1[i+1]*x1flux(CRF1+n,k,j,i+1)
+                                 - area1[i]*x1flux(CRF1+n,k,j,i))/vol[i];
           }
         }
 
         if (pmb->block_size.nx2 > 1) {
           AthenaArray<Real> &x2flux=pcr->flux[X2DIR];
-          pmb->pcoord->Face2Area(k,j  ,is,ie,x2face_area_   );
-          pmb->pcoord->Face2Area(k,j+1,is,ie,x2face_area_p1_);
+          const Real *area2 = &(pco->face2_area(k,j,0)),
+                     *area2_p1 = &(pco->face2_area(k,j+1,0));
           for (int n=0; n<3; ++n) {
 #pragma omp simd
             for (int i=is; i<=ie; ++i) {
-              grad_pc_(n,k,j,i) += (x2face_area_p1_(i)*x2flux(CRF1+n,k,j+1,i)
-                                    - x2face_area_(i)*x2flux(CRF1+n,k,j,i))
-                                   /cell_volume_(i);
+              grad_pc_(n,k,j,i) += (area2_p1[i]*x2flux(CRF1+n,k,j+1,i)
+                                    - area2[i]*x2flux(CRF1+n,k,j,i))/vol[i];
             }
           }
         }
         if (pmb->block_size.nx3 > 1) {
           AthenaArray<Real> &x3flux=pcr->flux[X3DIR];
-          pmb->pcoord->Face3Area(k  ,j,is,ie,x3face_area_);
-          pmb->pcoord->Face3Area(k+1,j,is,ie,x3face_area_p1_);
+          const Real *area3 = &(pco->face3_area(k,j,0)),
+                     *area3_p1 = &(pco->face3_area(k+1,j,0));
           for (int n=0; n<3; ++n) {
 #pragma omp simd
             for (int i=is; i<=ie; ++i) {
-              grad_pc_(n,k,j,i) += (x3face_area_p1_(i) *x3flux(CRF1+n,k+1,j,i)
-                                    - x3face_area_(i)*x3flux(CRF1+n,k,j,i))
-                                   /cell_volume_(i);
+              grad_pc_(n,k,j,i) += (area3_p1[i]*x3flux(CRF1+n,k+1,j,i)
+                                    - area3[i]*x3flux(CRF1+n,k,j,i))/vol[i];
             }
           }
         }
@@ -447,60 +445,67 @@ void CRIntegrator::CalculateFluxes(
 void CRIntegrator::FluxDivergence(const Real wght, AthenaArray<Real> &cr_out) {
   CosmicRay *pcr=pmy_cr;
   MeshBlock *pmb = pcr->pmy_block;
-  //  Coordinates *pco = pmb->pcoord;
-
   AthenaArray<Real> &x1flux=pcr->flux[X1DIR];
   AthenaArray<Real> &x2flux=pcr->flux[X2DIR];
   AthenaArray<Real> &x3flux=pcr->flux[X3DIR];
   int is = pmb->is; int js = pmb->js; int ks = pmb->ks;
   int ie = pmb->ie; int je = pmb->je; int ke = pmb->ke;
 
-  AthenaArray<Real> &x1area = x1face_area_, &x2area = x2face_area_,
-                 &x2area_p1 = x2face_area_p1_, &x3area = x3face_area_,
-                 &x3area_p1 = x3face_area_p1_, &vol = cell_volume_, &dflx = dflx_;
+  if (uniform_cartesian) {
+    if (pmb->block_size.nx3 > 1)
+      UniformFluxDivergence<3, false>(nullptr, wght, cr_out);
+    else if (pmb->block_size.nx2 > 1)
+      UniformFluxDivergence<2, false>(nullptr, wght, cr_out);
+    else
+      UniformFluxDivergence<1, false>(nullptr, wght, cr_out);
+    return;
+  }
+
+  Coordinates *pco = pmb->pcoord;
+  AthenaArray<Real> &dflx = dflx_;
 
   for (int k=ks; k<=ke; ++k) {
     for (int j=js; j<=je; ++j) {
       // calculate x1-flux divergence
-      pmb->pcoord->Face1Area(k,j,is,ie+1,x1area);
+      const Real *x1area = &(pco->face1_area(k,j,0));
 
       for (int n=0; n<NCR; ++n) {
 #pragma omp simd
         for (int i=is; i<=ie; ++i) {
-          dflx(n,i) = (x1area(i+1) *x1flux(n,k,j,i+1) - x1area(i)*x1flux(n,k,j,i));
+          dflx(n,i) = (x1area[i+1] *x1flux(n,k,j,i+1) - x1area[i]*x1flux(n,k,j,i));
         }// end n
       }// End i
 
       // calculate x2-flux
       if (pmb->block_size.nx2 > 1) {
-        pmb->pcoord->Face2Area(k,j  ,is,ie,x2area   );
-        pmb->pcoord->Face2Area(k,j+1,is,ie,x2area_p1);
+        const Real *x2area = &(pco->face2_area(k,j,0)),
+                   *x2area_p1 = &(pco->face2_area(k,j+1,0));
         for (int n=0; n<NCR; ++n) {
 #pragma omp simd
           for (int i=is; i<=ie; ++i) {
-            dflx(n,i) += (x2area_p1(i)*x2flux(n,k,j+1,i) - x2area(i)*x2flux(n,k,j,i));
+            dflx(n,i) += (x2area_p1[i]*x2flux(n,k,j+1,i) - x2area[i]*x2flux(n,k,j,i));
           }
         }
       }// end nx2
 
       // calculate x3-flux divergence
       if (pmb->block_size.nx3 > 1) {
-        pmb->pcoord->Face3Area(k  ,j,is,ie,x3area   );
-        pmb->pcoord->Face3Area(k+1,j,is,ie,x3area_p1);
+        const Real *x3area = &(pco->face3_area(k,j,0)),
+                   *x3area_p1 = &(pco->face3_area(k+1,j,0));
 
         for (int n=0; n<NCR; ++n) {
 #pragma omp simd
           for (int i=is; i<=ie; ++i) {
-            dflx(n,i) += (x3area_p1(i)*x3flux(n,k+1,j,i) - x3area(i)*x3flux(n,k,j,i));
+            dflx(n,i) += (x3area_p1[i]*x3flux(n,k+1,j,i) - x3area[i]*x3flux(n,k,j,i));
           }
         }
       }// end nx3
       // update variable with flux divergence
-      pmb->pcoord->CellVolume(k,j,is,ie,vol);
+      const Real *vol = &(pco->cell_volume(k,j,0));
       for (int n=0; n<NCR; ++n) {
 #pragma omp simd
         for (int i=is; i<=ie; ++i) {
-          cr_out(n,k,j,i) -= wght*dflx(n,i)/vol(i);
+          cr_out(n,k,j,i) -= wght*dflx(n,i)/vol[i];
         }
       }
     }
@@ -525,3 +530,85 @@ void CRIntegrator::FluxDivergence(const Real wght, AthenaArray<Real> &cr_out) {
           cr_out(CRE,k,j,i) = ec_floor;
       }
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn void CRIntegrator::WeightedAveFluxDivergence(const Real ave_wghts[4],
+//                                                   const Real wght)
+//  \brief low-storage register update of u_cr and u_cr1 at the start of a stage, with
+//  ave_wghts = {delta, gamma_1, gamma_2, gamma_3}, followed by the flux divergence, in
+//  a single pass over the MeshBlock. Only for uniform Cartesian meshes.
+
+void CRIntegrator::WeightedAveFluxDivergence(const Real ave_wghts[4], const Real wght) {
+  CosmicRay *pcr = pmy_cr;
+  MeshBlock *pmb = pcr->pmy_block;
+  if (pmb->block_size.nx3 > 1)
+    UniformFluxDivergence<3, true>(ave_wghts, wght, pcr->u_cr);
+  else if (pmb->block_size.nx2 > 1)
+    UniformFluxDivergence<2, true>(ave_wghts, wght, pcr->u_cr);
+  else
+    UniformFluxDivergence<1, true>(ave_wghts, wght, pcr->u_cr);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn template <int DIM, bool AVE> void CRIntegrator::UniformFluxDivergence(
+//                  const Real ave_wghts[4], const Real wght, AthenaArray<Real> &cr_out)
+//  \brief flux divergence on a uniform Cartesian MeshBlock of dimension DIM. The face
+//  areas and the cell volume reduce to the constant inverse cell widths, so there are
+//  no area or volume pencils, and the update of cr_out, the coordinate source term (zero)
+//  and the Ec floor are one loop. With AVE the weighted average of the registers of
+//  WeightedAveFluxDivergence() is applied to each cell first.
+
+template <int DIM, bool AVE>
+void CRIntegrator::UniformFluxDivergence(const Real ave_wghts[4], const Real wght,
+                                         AthenaArray<Real> &cr_out) {
+  CosmicRay *pcr = pmy_cr;
+  MeshBlock *pmb = pcr->pmy_block;
+  Coordinates *pco = pmb->pcoord;
+
+  AthenaArray<Real> &x1flux = pcr->flux[X1DIR];
+  AthenaArray<Real> &x2flux = pcr->flux[X2DIR];
+  AthenaArray<Real> &x3flux = pcr->flux[X3DIR];
+  int is = pmb->is; int js = pmb->js; int ks = pmb->ks;
+  int ie = pmb->ie; int je = pmb->je; int ke = pmb->ke;
+
+  const Real wdx1 = wght/pco->dx1f(is);
+  const Real wdx2 = (DIM > 1) ? wght/pco->dx2f(js) : 0.0;
+  const Real wdx3 = (DIM > 2) ? wght/pco->dx3f(ks) : 0.0;
+
+  // u_cr2 is only allocated (and gamma_3 only nonzero) for the 3S* integrators
+  Real delta = 0.0, gam1 = 0.0, gam2 = 0.0, gam3 = 0.0;
+  if (AVE) {
+    delta = ave_wghts[0];
+    gam1 = ave_wghts[1]; gam2 = ave_wghts[2]; gam3 = ave_wghts[3];
+  }
+  const bool swap = (gam1 == 0.0 && gam2 == 1.0 && gam3 == 0.0);
+  AthenaArray<Real> &u1 = pcr->u_cr1;
+  AthenaArray<Real> &u2 = (gam3 != 0.0) ? pcr->u_cr2 : pcr->u_cr1;
+
+  const Real ec_floor = 3*pmb->peos->GetPressureFloor();
+  for (int n=0; n<NCR; ++n) {
+    const Real floor = (n == CRE) ? ec_floor : -std::numeric_limits<Real>::max();
+    for (int k=ks; k<=ke; ++k) {
+      for (int j=js; j<=je; ++j) {
+#pragma omp simd
+        for (int i=is; i<=ie; ++i) {
+          Real u = cr_out(n,k,j,i);
+          if (AVE) {
+            Real u1_new = u1(n,k,j,i) + delta*u;
+            if (swap) {
+              u1(n,k,j,i) = u;
+              u = u1_new;
+            } else {
+              u1(n,k,j,i) = u1_new;
+              u = gam1*u + gam2*u1_new + gam3*u2(n,k,j,i);
+            }
+          }
+          Real du = wdx1*(x1flux(n,k,j,i+1) - x1flux(n,k,j,i));
+          if (DIM > 1) du += wdx2*(x2flux(n,k,j+1,i) - x2flux(n,k,j,i));
+          if (DIM > 2) du += wdx3*(x3flux(n,k+1,j,i) - x3flux(n,k,j,i));
+          cr_out(n,k,j,i) = std::max(u - du, floor);
+        }
+      }
+    }
+  }
+}
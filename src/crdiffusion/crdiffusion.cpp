@@ -9,6 +9,7 @@
 // C headers
 
 // C++ headers
+#include <algorithm>  // max, min
 #include <iostream>
 #include <sstream>    // sstream
 #include <stdexcept>  // runtime_error
@@ -22,9 +23,11 @@
 #include "../bvals/bvals_interfaces.hpp"
 #include "../bvals/cc/bvals_cc.hpp"
 #include "../coordinates/coordinates.hpp"
+#include "../cr/cr.hpp"
 #include "../mesh/mesh.hpp"
 #include "../parameter_input.hpp"
 #include "../utils/buffer_utils.hpp"
+#include "../utils/utils.hpp"
 #include "crdiffusion.hpp"
 #include "mg_crdiffusion.hpp"
 
@@ -41,10 +44,22 @@ CRDiffusion::CRDiffusion(MeshBlock *pmb, ParameterInput *pin) :
                AthenaArray<Real>::DataStatus::empty)),
     empty_flux{AthenaArray<Real>(), AthenaArray<Real>(), AthenaArray<Real>()},
     output_defect(false), crbvar(pmb, &ecr, &coarse_ecr, empty_flux, false),
-    refinement_idx_(), Dpara_(), Dperp_(), Lambda_() {
-  Dpara_ = pin->GetReal("crdiffusion", "Dpara");
-  Dperp_ = pin->GetReal("crdiffusion", "Dperp");
-  Lambda_ = pin->GetReal("crdiffusion", "Lambda");
+    hybrid(false), refinement_idx_(), Dpara_(), Dperp_(), Lambda_() {
+  // with the hybrid CR transport the coefficients follow from the CR opacities
+  hybrid = (CR_ENABLED && pmb->pcr->hybrid_tau > 0.0);
+  if (hybrid) {
+    if (pin->GetOrAddBoolean("crdiffusion", "steady", false)) {
+      std::stringstream msg;
+      msg << "### FATAL ERROR in CRDiffusion::CRDiffusion" << std::endl
+          << "The hybrid CR transport (<cr> hybrid_tau > 0) is time-dependent and "
+          << "cannot be combined with <crdiffusion> steady = true." << std::endl;
+      ATHENA_ERROR(msg);
+    }
+  } else {
+    Dpara_ = pin->GetReal("crdiffusion", "Dpara");
+    Dperp_ = pin->GetReal("crdiffusion", "Dperp");
+    Lambda_ = pin->GetReal("crdiffusion", "Lambda");
+  }
 
   output_defect = pin->GetOrAddBoolean("crdiffusion", "output_defect", false);
   if (output_defect)
@@ -84,6 +99,10 @@ void CRDiffusion::CalculateCoefficients(const AthenaArray<Real> &w,
     jl -= NGHOST, ju += NGHOST;
   if (pmy_block->pmy_mesh->f3)
     kl -= NGHOST, ku += NGHOST;
+  if (hybrid) {
+    CalculateHybridCoefficients();
+    return;
+  }
   Real Dpara = Dpara_, Dperp = Dperp_, Lambda = Lambda_;
 
   if (MAGNETIC_FIELDS_ENABLED) {
@@ -121,3 +140,106 @@ void CRDiffusion::CalculateCoefficients(const AthenaArray<Real> &w,
 }
 
 
+
+
+//----------------------------------------------------------------------------------------
+//! \fn void CRDiffusion::CalculateHybridCoefficients()
+//! \brief Calculate the coefficients of the hybrid CR transport: D = vmax/(3 sigma)
+//!        along each principal direction of the CR opacity in the optically thick
+//!        cells, and no diffusion in the thin cells, which the two-moment solver evolves
+void CRDiffusion::CalculateHybridCoefficients() {
+  CosmicRay *pcr = pmy_block->pcr;
+  int il = pmy_block->is - NGHOST, iu = pmy_block->ie + NGHOST;
+  int jl = pmy_block->js, ju = pmy_block->je;
+  int kl = pmy_block->ks, ku = pmy_block->ke;
+  if (pmy_block->pmy_mesh->f2)
+    jl -= NGHOST, ju += NGHOST;
+  if (pmy_block->pmy_mesh->f3)
+    kl -= NGHOST, ku += NGHOST;
+  const Real dfac = pcr->vmax/3.0;
+  const bool stream = (pcr->stream_flag != 0);
+
+  for (int k = kl; k <= ku; ++k) {
+    for (int j = jl; j <= ju; ++j) {
+      for (int i = il; i <= iu; ++i) {
+        for (int n = 0; n < NCOEFF; ++n)
+          coeff(n,k,j,i) = 0.0;
+        if (pcr->thick(k,j,i) == 0.0) continue;
+        Real d[3];
+        for (int n = 0; n < 3; ++n) {
+          Real sigma = pcr->sigma_diff(n,k,j,i);
+          if (stream)
+            sigma = 1.0/(1.0/sigma + 1.0/pcr->sigma_adv(n,k,j,i));
+          d[n] = dfac/sigma;
+        }
+        if (MAGNETIC_FIELDS_ENABLED) {
+          // D = sum_n d_n e_n e_n^T with e_n the n-th axis of the B frame
+          for (int n = 0; n < 3; ++n) {
+            Real ex = (n == 0) ? 1.0 : 0.0, ey = (n == 1) ? 1.0 : 0.0,
+                 ez = (n == 2) ? 1.0 : 0.0;
+            InvRotateVec(pcr->b_angle(0,k,j,i), pcr->b_angle(1,k,j,i),
+                         pcr->b_angle(2,k,j,i), pcr->b_angle(3,k,j,i), ex, ey, ez);
+            coeff(DXX,k,j,i) += d[n] * ex * ex;
+            coeff(DXY,k,j,i) += d[n] * ex * ey;
+            coeff(DXZ,k,j,i) += d[n] * ex * ez;
+            coeff(DYY,k,j,i) += d[n] * ey * ey;
+            coeff(DYZ,k,j,i) += d[n] * ey * ez;
+            coeff(DZZ,k,j,i) += d[n] * ez * ez;
+          }
+        } else {
+          coeff(DXX,k,j,i) = d[0];
+          coeff(DYY,k,j,i) = d[1];
+          coeff(DZZ,k,j,i) = d[2];
+        }
+      }
+    }
+  }
+  return;
+}
+
+
+//----------------------------------------------------------------------------------------
+//! \fn void CRDiffusion::LoadHybridEnergy()
+//! \brief Copy the CR energy density of the two-moment solver into ecr
+void CRDiffusion::LoadHybridEnergy() {
+  const AthenaArray<Real> &u_cr = pmy_block->pcr->u_cr;
+  for (int k = 0; k < pmy_block->ncells3; ++k) {
+    for (int j = 0; j < pmy_block->ncells2; ++j) {
+#pragma omp simd
+      for (int i = 0; i < pmy_block->ncells1; ++i)
+        ecr(k,j,i) = u_cr(CRE,k,j,i);
+    }
+  }
+  return;
+}
+
+
+//----------------------------------------------------------------------------------------
+//! \fn void CRDiffusion::StoreHybridEnergy()
+//! \brief Copy the diffused CR energy density back to the two-moment solver in the
+//!        cells coupled to an optically thick cell; elsewhere the Multigrid solution is
+//!        the identity up to the solver tolerance and u_cr is left untouched
+void CRDiffusion::StoreHybridEnergy() {
+  CosmicRay *pcr = pmy_block->pcr;
+  const int nc1 = pmy_block->ncells1, nc2 = pmy_block->ncells2,
+            nc3 = pmy_block->ncells3;
+  for (int k = 0; k < nc3; ++k) {
+    const int kl = std::max(k-1, 0), ku = std::min(k+1, nc3-1);
+    for (int j = 0; j < nc2; ++j) {
+      const int jl = std::max(j-1, 0), ju = std::min(j+1, nc2-1);
+      for (int i = 0; i < nc1; ++i) {
+        const int il = std::max(i-1, 0), iu = std::min(i+1, nc1-1);
+        Real nthick = 0.0;
+        for (int kk = kl; kk <= ku; ++kk) {
+          for (int jj = jl; jj <= ju; ++jj) {
+            for (int ii = il; ii <= iu; ++ii)
+              nthick += pcr->thick(kk,jj,ii);
+          }
+        }
+        if (nthick > 0.0)
+          pcr->u_cr(CRE,k,j,i) = ecr(k,j,i);
+      }
+    }
+  }
+  return;
+}
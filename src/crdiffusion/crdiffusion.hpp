@@ -51,12 +51,19 @@ class CRDiffusion {
 
   void CalculateCoefficients(const AthenaArray<Real> &w,
                              const AthenaArray<Real> &bcc);
+  // hybrid CR transport: exchange the CR energy with CosmicRay::u_cr around the solve
+  void LoadHybridEnergy();
+  void StoreHybridEnergy();
+
+  bool hybrid;
 
   friend class MGCRDiffusuionDriver;
 
  private:
   int refinement_idx_;
   Real Dpara_, Dperp_, Lambda_;
+
+  void CalculateHybridCoefficients();
 };
 
 #endif // CRDIFFUSION_CRDIFFUSION_HPP_
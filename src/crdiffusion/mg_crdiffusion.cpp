@@ -10,6 +10,7 @@
 
 // C++ headers
 #include <algorithm>
+#include <cmath>      // abs
 #include <iostream>
 #include <sstream>    // sstream
 #include <stdexcept>  // runtime_error
@@ -37,8 +38,64 @@ class MeshBlock;
 
 namespace {
   AthenaArray<Real> *temp; // temporary data for the Jacobi iteration
+  AthenaArray<Real> *tempc = nullptr; // forward sweep coefficients of the line smoother
+
+//! sum of the 18 off-diagonal terms of the stencil
+inline Real OffDiagonal(const AthenaArray<Real> &matrix, const AthenaArray<Real> &u,
+                        int k, int j, int i) {
+  return matrix(CCM,k,j,i)*u(k,j,i-1)   + matrix(CCP,k,j,i)*u(k,j,i+1)
+       + matrix(CMC,k,j,i)*u(k,j-1,i)   + matrix(CPC,k,j,i)*u(k,j+1,i)
+       + matrix(MCC,k,j,i)*u(k-1,j,i)   + matrix(PCC,k,j,i)*u(k+1,j,i)
+       + matrix(CMM,k,j,i)*u(k,j-1,i-1) + matrix(CMP,k,j,i)*u(k,j-1,i+1)
+       + matrix(CPM,k,j,i)*u(k,j+1,i-1) + matrix(CPP,k,j,i)*u(k,j+1,i+1)
+       + matrix(MCM,k,j,i)*u(k-1,j,i-1) + matrix(MCP,k,j,i)*u(k-1,j,i+1)
+       + matrix(PCM,k,j,i)*u(k+1,j,i-1) + matrix(PCP,k,j,i)*u(k+1,j,i+1)
+       + matrix(MMC,k,j,i)*u(k-1,j-1,i) + matrix(MPC,k,j,i)*u(k-1,j+1,i)
+       + matrix(PMC,k,j,i)*u(k+1,j-1,i) + matrix(PPC,k,j,i)*u(k+1,j+1,i);
 }
 
+//! direction with the strongest face coupling in the region
+int DominantAxis(const AthenaArray<Real> &matrix,
+                 int il, int iu, int jl, int ju, int kl, int ku) {
+  Real sx = 0.0, sy = 0.0, sz = 0.0;
+  for (int k=kl; k<=ku; k++) {
+    for (int j=jl; j<=ju; j++) {
+#pragma omp simd reduction(+: sx, sy, sz)
+      for (int i=il; i<=iu; i++) {
+        sx += std::abs(matrix(CCM,k,j,i)) + std::abs(matrix(CCP,k,j,i));
+        sy += std::abs(matrix(CMC,k,j,i)) + std::abs(matrix(CPC,k,j,i));
+        sz += std::abs(matrix(MCC,k,j,i)) + std::abs(matrix(PCC,k,j,i));
+      }
+    }
+  }
+  if (sx >= sy && sx >= sz) return 0;
+  return (sy >= sz) ? 1 : 2;
+}
+
+//! dependence of the ghost cell on the adjacent active cell for a user boundary
+//! function, probed on a single cell assuming that the boundary condition is affine
+Real GhostSlope(MGBoundaryFunc bfunc, int face, const RegionSize &msize) {
+  RegionSize size = msize;
+  size.nx1 = size.nx2 = size.nx3 = 1;
+  MGCoordinates coord;
+  coord.AllocateMGCoordinates(3, 3, 3);
+  coord.CalculateMGCoordinates(size, 0, 1);
+  AthenaArray<Real> u;
+  u.NewAthenaArray(1, 3, 3, 3);
+  // ghost cell next to the active cell (1,1,1) on this face
+  int gi = 1 + ((face == BoundaryFace::outer_x1) - (face == BoundaryFace::inner_x1));
+  int gj = 1 + ((face == BoundaryFace::outer_x2) - (face == BoundaryFace::inner_x2));
+  int gk = 1 + ((face == BoundaryFace::outer_x3) - (face == BoundaryFace::inner_x3));
+  Real g[2];
+  for (int n = 0; n < 2; ++n) {
+    u(0,1,1,1) = static_cast<Real>(n);
+    bfunc(u, 0.0, 1, 1, 1, 1, 1, 1, 1, 1, coord);
+    g[n] = u(0,gk,gj,gi);
+  }
+  return g[1] - g[0];
+}
+} // namespace
+
 //----------------------------------------------------------------------------------------
 //! \fn MGCRDiffusionDriver::MGCRDiffusionDriver(Mesh *pm, ParameterInput *pin)
 //! \brief MGCRDiffusionDriver constructor
@@ -55,9 +112,25 @@ MGCRDiffusionDriver::MGCRDiffusionDriver(Mesh *pm, ParameterInput *pin)
   fsubtract_average_ = false;
   omega_ = pin->GetOrAddReal("crdiffusion", "omega", 1.0);
   fsteady_ = pin->GetOrAddBoolean("crdiffusion", "steady", false);
+  // reuse the matrix of a block until its coefficients change by more than this
+  mtol_ = pin->GetOrAddReal("crdiffusion", "matrix_tolerance", 0.0);
   npresmooth_ = pin->GetOrAddReal("crdiffusion", "npresmooth", 2);
   npostsmooth_ = pin->GetOrAddReal("crdiffusion", "npostsmooth", 2);
   fshowdef_ = pin->GetOrAddBoolean("crdiffusion", "show_defect", fshowdef_);
+  // threads of the solver; when they outnumber the MeshBlocks on this rank, they work
+  // inside each MeshBlock instead of over the MeshBlocks
+  int maxth = pm->GetNumMeshThreads();
+#ifdef OPENMP_PARALLEL
+  maxth = std::max(maxth, omp_get_max_threads());
+#endif
+  nthreads_ = pin->GetOrAddInteger("crdiffusion", "num_threads", nthreads_);
+  if (nthreads_ < 1 || nthreads_ > maxth) {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in MGCRDiffusionDriver::MGCRDiffusionDriver" << std::endl
+        << "The \"num_threads\" parameter in the <crdiffusion> block must be between 1"
+        << " and " << maxth << "." << std::endl;
+    ATHENA_ERROR(msg);
+  }
   std::string smoother = pin->GetOrAddString("crdiffusion", "smoother", "jacobi-rb");
   if (smoother == "jacobi-rb") {
     fsmoother_ = 1;
@@ -65,10 +138,41 @@ MGCRDiffusionDriver::MGCRDiffusionDriver(Mesh *pm, ParameterInput *pin)
   } else if (smoother == "jacobi-double") {
     fsmoother_ = 0;
     redblack_ = true;
+  } else if (smoother == "line") { // zebra line relaxation
+    fsmoother_ = 2;
+    redblack_ = true;
   } else { // jacobi
     fsmoother_ = 0;
     redblack_ = false;
   }
+  if (fsmoother_ == 2) // over-relaxation does not help the line solves
+    omega_ = pin->GetOrAddReal("crdiffusion", "line_omega", 1.0);
+  std::string axis = pin->GetOrAddString("crdiffusion", "line_axis", "auto");
+  if (axis == "x1") {
+    laxis_ = 0;
+  } else if (axis == "x2") {
+    laxis_ = 1;
+  } else if (axis == "x3") {
+    laxis_ = 2;
+  } else { // the strongest coupling on each block and level
+    laxis_ = -1;
+  }
+  std::string solver = pin->GetOrAddString("crdiffusion", "solver", "mg");
+  if (solver == "bicgstab") {
+    krylov_ = MGKrylovType::bicgstab;
+  } else if (solver == "gmres") {
+    krylov_ = MGKrylovType::gmres;
+    nrestart_ = std::max(1, pin->GetOrAddInteger("crdiffusion", "gmres_restart",
+                                                 nrestart_));
+  } else if (solver != "mg") {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in MGCRDiffusionDriver::MGCRDiffusionDriver" << std::endl
+        << "The \"solver\" parameter in the <crdiffusion> block is invalid." << std::endl
+        << "mg: Multigrid iteration (default)" << std::endl
+        << "bicgstab: BiCGStab preconditioned with a V-cycle" << std::endl
+        << "gmres: restarted GMRES preconditioned with a V-cycle" << std::endl;
+    ATHENA_ERROR(msg);
+  }
   std::string prol = pin->GetOrAddString("crdiffusion", "prolongation", "trilinear");
   if (prol == "tricubic")
     fprolongation_ = 1;
@@ -109,6 +213,21 @@ MGCRDiffusionDriver::MGCRDiffusionDriver(Mesh *pm, ParameterInput *pin)
   mg_mesh_bcs_[outer_x3] =
               GetMGBoundaryFlag(pin->GetOrAddString("crdiffusion", "ox3_bc", "none"));
   CheckBoundaryFunctions();
+  // unlike the Poisson equation, the time-dependent operator 1 + dt L is not singular
+  // on periodic or zero-gradient meshes and the mean CR energy must be kept
+  if (!fsteady_)
+    fsubtract_average_ = false;
+  // the line smoother solves the physical boundary conditions implicitly
+  for (int f = 0; f < 6; ++f) {
+    if (mg_mesh_bcs_[f] == BoundaryFlag::user)
+      lbeta_[f] = GhostSlope(MGBoundaryFunction_[f], f, pm->mesh_size);
+    else if (mg_mesh_bcs_[f] == BoundaryFlag::mg_zerograd)
+      lbeta_[f] = 1.0;
+    else if (mg_mesh_bcs_[f] == BoundaryFlag::mg_zerofixed)
+      lbeta_[f] = -1.0;
+    else // periodic or multipole, lagged
+      lbeta_[f] = 0.0;
+  }
 
   mgtlist_ = new MultigridTaskList(this);
 
@@ -117,9 +236,9 @@ MGCRDiffusionDriver::MGCRDiffusionDriver(Mesh *pm, ParameterInput *pin)
 
   crtlist_ = new CRDiffusionBoundaryTaskList(pin, pm);
 
-  int nth = 1;
+  int nth = nthreads_;
 #ifdef OPENMP_PARALLEL
-  nth = omp_get_max_threads();
+  nth = std::max(nth, omp_get_max_threads());
 #endif
   temp = new AthenaArray<Real>[nth];
   int nx = std::max(pmy_mesh_->block_size.nx1, pmy_mesh_->nrbx1) + 2*mgroot_->ngh_;
@@ -127,6 +246,11 @@ MGCRDiffusionDriver::MGCRDiffusionDriver(Mesh *pm, ParameterInput *pin)
   int nz = std::max(pmy_mesh_->block_size.nx3, pmy_mesh_->nrbx3) + 2*mgroot_->ngh_;
   for (int n = 0; n < nth; ++n)
     temp[n].NewAthenaArray(nz, ny, nx);
+  if (fsmoother_ == 2) {
+    tempc = new AthenaArray<Real>[nth];
+    for (int n = 0; n < nth; ++n)
+      tempc[n].NewAthenaArray(nz, ny, nx);
+  }
 }
 
 
@@ -139,6 +263,7 @@ MGCRDiffusionDriver::~MGCRDiffusionDriver() {
   delete mgroot_;
   delete mgtlist_;
   delete [] temp;
+  delete [] tempc;
 }
 
 
@@ -147,7 +272,8 @@ MGCRDiffusionDriver::~MGCRDiffusionDriver() {
 //! \brief MGCRDiffusion constructor
 
 MGCRDiffusion::MGCRDiffusion(MGCRDiffusionDriver *pmd, MeshBlock *pmb)
-  : Multigrid(pmd, pmb, 1), omega_(pmd->omega_), fsmoother_(pmd->fsmoother_) {
+  : Multigrid(pmd, pmb, 1), omega_(pmd->omega_), fsmoother_(pmd->fsmoother_),
+    laxis_(pmd->laxis_) {
   btype = btypef = BoundaryQuantity::mg;
   pmgbval = new MGBoundaryValues(this, mg_block_bcs_);
 }
@@ -219,12 +345,15 @@ void MGCRDiffusionDriver::Solve(int stage, Real dt) {
     CRDiffusion *pcrdiff = pmg->pmy_block_->pcrdiff;
     Hydro *phydro = pmg->pmy_block_->phydro;
     Field *pfield = pmg->pmy_block_->pfield;
+    if (pcrdiff->hybrid)
+      pcrdiff->LoadHybridEnergy();
     pcrdiff->CalculateCoefficients(phydro->w, pfield->bcc);
     if (!fsteady_)
       pmg->LoadSource(pcrdiff->ecr, 0, NGHOST, 1.0);
     if (mode_ == 1) // load the current data as the initial guess
       pmg->LoadFinestData(pcrdiff->ecr, 0, NGHOST);
-    pmg->LoadCoefficients(pcrdiff->coeff, NGHOST);
+    if (mtol_ <= 0.0 || pmg->CoefficientChange(pcrdiff->coeff, NGHOST) > mtol_)
+      pmg->LoadCoefficients(pcrdiff->coeff, NGHOST);
     pmg->AddCRSource(pcrdiff->source, NGHOST, dt);
   }
 
@@ -233,7 +362,9 @@ void MGCRDiffusionDriver::Solve(int stage, Real dt) {
     if (mode_ == 0) {
       SolveFMGCycle();
     } else {
-      if (eps_ >= 0.0)
+      if (krylov_ != MGKrylovType::none)
+        SolveKrylov();
+      else if (eps_ >= 0.0)
         SolveIterative();
       else
         SolveIterativeFixedTimes();
@@ -265,6 +396,14 @@ void MGCRDiffusionDriver::Solve(int stage, Real dt) {
 
   crtlist_->DoTaskListOneStage(pmy_mesh_, stage);
 
+  // hand the diffused CR energy back to the two-moment CR transport
+#pragma omp parallel for num_threads(nthreads_)
+  for (auto itr = vmg_.begin(); itr < vmg_.end(); itr++) {
+    CRDiffusion *pcrdiff = (*itr)->pmy_block_->pcrdiff;
+    if (pcrdiff->hybrid)
+      pcrdiff->StoreHybridEnergy();
+  }
+
   return;
 }
 
@@ -285,7 +424,9 @@ void MGCRDiffusion::Smooth(AthenaArray<Real> &u, const AthenaArray<Real> &src,
   Real dx2 = SQR(dx);
   Real isix = omega_/6.0;
   color ^= pmy_driver_->coffset_;
-  if (fsmoother_ == 1) { // jacobi-rb
+  if (fsmoother_ == 2) { // zebra line
+    SmoothLine(u, src, matrix, rlev, il, iu, jl, ju, kl, ku, color, th);
+  } else if (fsmoother_ == 1) { // jacobi-rb
     if (th == true && (ku-kl) >=  minth_) {
       AthenaArray<Real> &work = temp[0];
 #pragma omp parallel num_threads(pmy_driver_->nthreads_)
@@ -421,6 +562,137 @@ void MGCRDiffusion::Smooth(AthenaArray<Real> &u, const AthenaArray<Real> &src,
 }
 
 
+//----------------------------------------------------------------------------------------
+//! \fn void MGCRDiffusion::SmoothLine(AthenaArray<Real> &u,
+//!            const AthenaArray<Real> &src, const AthenaArray<Real> &matrix, int rlev,
+//!            int il, int iu, int jl, int ju, int kl, int ku, int color, bool th)
+//! \brief Zebra line relaxation: the couplings along one axis are solved exactly with
+//!        the Thomas algorithm on every other line, the rest of the stencil is taken
+//!        from the current solution. Lines along x2 and x3 are solved in batches over i.
+//!        Physical boundaries at the line ends are included in the solve, while block
+//!        and octet boundaries are lagged.
+
+void MGCRDiffusion::SmoothLine(AthenaArray<Real> &u, const AthenaArray<Real> &src,
+                               const AthenaArray<Real> &matrix, int rlev, int il, int iu,
+                               int jl, int ju, int kl, int ku, int color, bool th) {
+  bool fth = (th == true && (ku-kl) >= minth_);
+  int t = 0;
+#ifdef OPENMP_PARALLEL
+  if (!fth) t = omp_get_thread_num();
+#endif
+  AthenaArray<Real> &work = temp[t], &cp = tempc[t];
+  int axis = (laxis_ >= 0) ? laxis_ : DominantAxis(matrix, il, iu, jl, ju, kl, ku);
+  // ghost = bl*u + const at the lower end of the line, bu*u + const at the upper end
+  Real bl = 0.0, bu = 0.0;
+  if (rlev <= 0) {
+    const Real *lbeta = static_cast<MGCRDiffusionDriver*>(pmy_driver_)->lbeta_;
+    if (mg_block_bcs_[2*axis] != BoundaryFlag::block) bl = lbeta[2*axis];
+    if (mg_block_bcs_[2*axis+1] != BoundaryFlag::block) bu = lbeta[2*axis+1];
+  }
+
+  if (axis == 0) {
+#pragma omp parallel for num_threads(pmy_driver_->nthreads_) if (fth)
+    for (int k=kl; k<=ku; k++) {
+      for (int j=jl; j<=ju; j++) {
+        if ((color + k + j) & 1) continue;
+        for (int i=il; i<=iu; i++) {
+          Real r = src(k,j,i) - OffDiagonal(matrix, u, k, j, i);
+          Real a = (i > il) ? matrix(CCM,k,j,i) : 0.0;
+          Real c = (i < iu) ? matrix(CCP,k,j,i) : 0.0;
+          Real e = ((i == il) ? bl*matrix(CCM,k,j,i) : 0.0)
+                 + ((i == iu) ? bu*matrix(CCP,k,j,i) : 0.0);
+          r += a*u(k,j,i-1) + c*u(k,j,i+1) + e*u(k,j,i);
+          Real m = 1.0/(matrix(CCC,k,j,i) + e - ((i > il) ? a*cp(k,j,i-1) : 0.0));
+          cp(k,j,i) = c*m;
+          work(k,j,i) = (r - ((i > il) ? a*work(k,j,i-1) : 0.0))*m;
+        }
+        for (int i=iu-1; i>=il; i--)
+          work(k,j,i) -= cp(k,j,i)*work(k,j,i+1);
+      }
+    }
+#pragma omp parallel for num_threads(pmy_driver_->nthreads_) if (fth)
+    for (int k=kl; k<=ku; k++) {
+      for (int j=jl; j<=ju; j++) {
+        if ((color + k + j) & 1) continue;
+#pragma omp simd
+        for (int i=il; i<=iu; i++)
+          u(k,j,i) += omega_ * (work(k,j,i) - u(k,j,i));
+      }
+    }
+  } else if (axis == 1) {
+#pragma omp parallel for num_threads(pmy_driver_->nthreads_) if (fth)
+    for (int k=kl; k<=ku; k++) {
+      int s = (color + k) & 1;
+      for (int j=jl; j<=ju; j++) {
+        Real fa = (j > jl) ? 1.0 : 0.0, fc = (j < ju) ? 1.0 : 0.0;
+        Real ga = (j == jl) ? bl : 0.0, gc = (j == ju) ? bu : 0.0;
+        int jm = (j > jl) ? j-1 : j;
+#pragma ivdep
+        for (int i=il+s; i<=iu; i+=2) {
+          Real a = fa*matrix(CMC,k,j,i), c = fc*matrix(CPC,k,j,i);
+          Real e = ga*matrix(CMC,k,j,i) + gc*matrix(CPC,k,j,i);
+          Real r = src(k,j,i) - OffDiagonal(matrix, u, k, j, i)
+                 + a*u(k,j-1,i) + c*u(k,j+1,i) + e*u(k,j,i);
+          Real m = 1.0/(matrix(CCC,k,j,i) + e - a*cp(k,jm,i));
+          cp(k,j,i) = c*m;
+          work(k,j,i) = (r - a*work(k,jm,i))*m;
+        }
+      }
+      for (int j=ju-1; j>=jl; j--) {
+#pragma ivdep
+        for (int i=il+s; i<=iu; i+=2)
+          work(k,j,i) -= cp(k,j,i)*work(k,j+1,i);
+      }
+    }
+#pragma omp parallel for num_threads(pmy_driver_->nthreads_) if (fth)
+    for (int k=kl; k<=ku; k++) {
+      int s = (color + k) & 1;
+      for (int j=jl; j<=ju; j++) {
+#pragma ivdep
+        for (int i=il+s; i<=iu; i+=2)
+          u(k,j,i) += omega_ * (work(k,j,i) - u(k,j,i));
+      }
+    }
+  } else {
+#pragma omp parallel for num_threads(pmy_driver_->nthreads_) if (fth)
+    for (int j=jl; j<=ju; j++) {
+      int s = (color + j) & 1;
+      for (int k=kl; k<=ku; k++) {
+        Real fa = (k > kl) ? 1.0 : 0.0, fc = (k < ku) ? 1.0 : 0.0;
+        Real ga = (k == kl) ? bl : 0.0, gc = (k == ku) ? bu : 0.0;
+        int km = (k > kl) ? k-1 : k;
+#pragma ivdep
+        for (int i=il+s; i<=iu; i+=2) {
+          Real a = fa*matrix(MCC,k,j,i), c = fc*matrix(PCC,k,j,i);
+          Real e = ga*matrix(MCC,k,j,i) + gc*matrix(PCC,k,j,i);
+          Real r = src(k,j,i) - OffDiagonal(matrix, u, k, j, i)
+                 + a*u(k-1,j,i) + c*u(k+1,j,i) + e*u(k,j,i);
+          Real m = 1.0/(matrix(CCC,k,j,i) + e - a*cp(km,j,i));
+          cp(k,j,i) = c*m;
+          work(k,j,i) = (r - a*work(km,j,i))*m;
+        }
+      }
+      for (int k=ku-1; k>=kl; k--) {
+#pragma ivdep
+        for (int i=il+s; i<=iu; i+=2)
+          work(k,j,i) -= cp(k,j,i)*work(k+1,j,i);
+      }
+    }
+#pragma omp parallel for num_threads(pmy_driver_->nthreads_) if (fth)
+    for (int j=jl; j<=ju; j++) {
+      int s = (color + j) & 1;
+      for (int k=kl; k<=ku; k++) {
+#pragma ivdep
+        for (int i=il+s; i<=iu; i+=2)
+          u(k,j,i) += omega_ * (work(k,j,i) - u(k,j,i));
+      }
+    }
+  }
+
+  return;
+}
+
+
 //----------------------------------------------------------------------------------------
 //! \fn void MGCRDiffusion::CalculateDefect(AthenaArray<Real> &def,
 //!            const AthenaArray<Real> &u, const AthenaArray<Real> &src,
@@ -51,8 +51,12 @@ class MGCRDiffusion : public Multigrid {
   friend class MGCRDiffusionDriver;
 
  private:
+  void SmoothLine(AthenaArray<Real> &u, const AthenaArray<Real> &src,
+                  const AthenaArray<Real> &matrix, int rlev, int il, int iu,
+                  int jl, int ju, int kl, int ku, int color, bool th);
+
   Real omega_;
-  int fsmoother_;
+  int fsmoother_, laxis_;
 };
 
 
@@ -69,8 +73,8 @@ class MGCRDiffusionDriver : public MultigridDriver {
 
  private:
   CRDiffusionBoundaryTaskList *crtlist_;
-  Real omega_;
-  int fsmoother_;
+  Real omega_, lbeta_[6];
+  int fsmoother_, laxis_;
   bool fsteady_;
 };
 
@@ -70,9 +70,6 @@ FieldDiffusion::FieldDiffusion(MeshBlock *pmb, ParameterInput *pin) :
     edge_length_.NewAthenaArray(nc1);
     edge_length_m1_.NewAthenaArray(nc1);
     cell_volume_.NewAthenaArray(nc1);
-    dx1_.NewAthenaArray(nc1);
-    dx2_.NewAthenaArray(nc1);
-    dx3_.NewAthenaArray(nc1);
 
     if (pmb->pmy_mesh->FieldDiffusivity_ == nullptr)
       CalcMagDiffCoeff_ = ConstDiffusivity;
@@ -261,7 +258,6 @@ void FieldDiffusion::NewDiffusionDt(Real &dt_oa, Real &dt_h) {
   dt_h  = real_max;
 
   AthenaArray<Real> &eta_t = eta_tot_;
-  AthenaArray<Real> &len = dx1_, &dx2 = dx2_, &dx3 = dx3_;
 
   for (int k=ks; k<=ke; ++k) {
     for (int j=js; j<=je; ++j) {
@@ -281,24 +277,25 @@ void FieldDiffusion::NewDiffusionDt(Real &dt_oa, Real &dt_h) {
           eta_t(i) += etaB(DiffProcess::ambipolar,k,j,i);
         }
       }
-      pmb->pcoord->CenterWidth1(k, j, is, ie, len);
-      pmb->pcoord->CenterWidth2(k, j, is, ie, dx2);
-      pmb->pcoord->CenterWidth3(k, j, is, ie, dx3);
-#pragma omp simd
-      for (int i=is; i<=ie; ++i) {
-        len(i) = (f2) ? std::min(len(i), dx2(i)):len(i);
-        len(i) = (f3) ? std::min(len(i), dx3(i)):len(i);
-      }
+      const Real *dx1 = &(pmb->pcoord->center_width1(k,j,0)),
+                 *dx2 = &(pmb->pcoord->center_width2(k,j,0)),
+                 *dx3 = &(pmb->pcoord->center_width3(k,j,0));
       if ((eta_ohm > 0.0) || (eta_ad > 0.0)) {
-        for (int i=is; i<=ie; ++i)
+        for (int i=is; i<=ie; ++i) {
+          Real len = (f2) ? std::min(dx1[i], dx2[i]) : dx1[i];
+          len = (f3) ? std::min(len, dx3[i]) : len;
           dt_oa = std::min(dt_oa, static_cast<Real>(
-              fac_oa*SQR(len(i)) / (eta_t(i) + TINY_NUMBER)));
+              fac_oa*SQR(len) / (eta_t(i) + TINY_NUMBER)));
+        }
       }
       if (eta_hall > 0.0) {
-        for (int i=is; i<=ie; ++i)
+        for (int i=is; i<=ie; ++i) {
+          Real len = (f2) ? std::min(dx1[i], dx2[i]) : dx1[i];
+          len = (f3) ? std::min(len, dx3[i]) : len;
           dt_h = std::min(dt_h, static_cast<Real>(
-              fac_h*SQR(len(i)) / (std::abs(etaB(DiffProcess::hall,k,j,i))
-                                   + TINY_NUMBER)));
+              fac_h*SQR(len) / (std::abs(etaB(DiffProcess::hall,k,j,i))
+                                + TINY_NUMBER)));
+        }
       }
     }
   }
@@ -87,7 +87,7 @@ class FieldDiffusion {
 
   AthenaArray<Real> face_area_, face_area_p1_, edge_length_, edge_length_m1_;
   AthenaArray<Real>  cell_volume_;
-  AthenaArray<Real> dx1_, dx2_, dx3_, len_;
+  AthenaArray<Real> len_;
   AthenaArray<Real> eta_tot_;
 };
 #endif // FIELD_FIELD_DIFFUSION_FIELD_DIFFUSION_HPP_
@@ -29,12 +29,54 @@
 #include <omp.h>
 #endif
 
+namespace {
+//----------------------------------------------------------------------------------------
+//! \struct FaceBox
+//! \brief index ranges [kl,ku]x[jl,ju]x[il,iu] of a box of faces in one direction
+
+struct FaceBox {
+  int kl, ku, jl, ju, il, iu;
+};
+
+//----------------------------------------------------------------------------------------
+//! \fn void ForEachFaceBox(FluxRegion region, FaceBox all, FaceBox in, F f)
+//! \brief calls f(kl, ku, jl, ju, il, iu) on the faces of the box all in the given
+//! region: all of them, those in the interior box in, or those outside in (as up to six
+//! boxes). The interior box must lie inside all.
+
+template <typename F>
+void ForEachFaceBox(FluxRegion region, FaceBox all, FaceBox in, F f) {
+  bool empty = (in.kl > in.ku || in.jl > in.ju || in.il > in.iu);
+  if (region == FluxRegion::interior) {
+    if (!empty) f(in.kl, in.ku, in.jl, in.ju, in.il, in.iu);
+  } else if (region == FluxRegion::all || empty) {
+    f(all.kl, all.ku, all.jl, all.ju, all.il, all.iu);
+  } else {
+    // slabs below and above the interior box in x3, then in x2, then in x1
+    if (all.kl < in.kl) f(all.kl, in.kl-1, all.jl, all.ju, all.il, all.iu);
+    if (in.ku < all.ku) f(in.ku+1, all.ku, all.jl, all.ju, all.il, all.iu);
+    if (all.jl < in.jl) f(in.kl, in.ku, all.jl, in.jl-1, all.il, all.iu);
+    if (in.ju < all.ju) f(in.kl, in.ku, in.ju+1, all.ju, all.il, all.iu);
+    if (all.il < in.il) f(in.kl, in.ku, in.jl, in.ju, all.il, in.il-1);
+    if (in.iu < all.iu) f(in.kl, in.ku, in.jl, in.ju, in.iu+1, all.iu);
+  }
+  return;
+}
+} // namespace
+
 //----------------------------------------------------------------------------------------
 //! \fn  void Hydro::CalculateFluxes
 //! \brief Calculate Hydrodynamic Fluxes using the Riemann solver
+//!
+//! region selects the faces: FluxRegion::interior computes only the faces whose
+//! reconstruction stencil lies in the active cells (at least NGHOST cells from the
+//! MeshBlock boundary), which can be done before the ghost zones are exchanged;
+//! FluxRegion::boundary computes the remaining faces and adds the diffusion fluxes.
+//! Both require order < 4.
 
 void Hydro::CalculateFluxes(AthenaArray<Real> &w, FaceField &b,
-                            AthenaArray<Real> &bcc, const int order) {
+                            AthenaArray<Real> &bcc, const int order,
+                            const FluxRegion region) {
   MeshBlock *pmb = pmy_block;
   int is = pmb->is; int js = pmb->js; int ks = pmb->ks;
   int ie = pmb->ie; int je = pmb->je; int ke = pmb->ke;
@@ -73,36 +115,11 @@ void Hydro::CalculateFluxes(AthenaArray<Real> &w, FaceField &b,
     }
   }
 
-  for (int k=kl; k<=ku; ++k) {
-    for (int j=jl; j<=ju; ++j) {
-      // reconstruct L/R states
-      if (order == 1) {
-        pmb->precon->DonorCellX1(k, j, is-1, ie+1, w, bcc, wl_, wr_);
-      } else if (order == 2) {
-        pmb->precon->PiecewiseLinearX1(k, j, is-1, ie+1, w, bcc, wl_, wr_);
-      } else {
-        pmb->precon->PiecewiseParabolicX1(k, j, is-1, ie+1, w, bcc, wl_, wr_);
-      }
-
-      pmb->pcoord->CenterWidth1(k, j, is, ie+1, dxw_);
-#if !MAGNETIC_FIELDS_ENABLED  // Hydro:
-      RiemannSolver(k, j, is, ie+1, IVX, wl_, wr_, x1flux, dxw_);
-#else  // MHD:
-      // x1flux(IBY) = (v1*b2 - v2*b1) = -EMFZ
-      // x1flux(IBZ) = (v1*b3 - v3*b1) =  EMFY
-      RiemannSolver(k, j, is, ie+1, IVX, b1, wl_, wr_, x1flux, e3x1, e2x1, w_x1f, dxw_);
-#endif
-
-      if (order == 4) {
-        for (int n=0; n<NWAVE; n++) {
-          for (int i=is; i<=ie+1; i++) {
-            wl3d_(n,k,j,i) = wl_(n,i);
-            wr3d_(n,k,j,i) = wr_(n,i);
-          }
-        }
-      }
-    }
-  }
+  ForEachFaceBox(region, {kl, ku, jl, ju, is, ie+1},
+                 {ks, ke, js, je, is+NGHOST, ie+1-NGHOST},
+                 [&](int k0, int k1, int j0, int j1, int i0, int i1) {
+    CalculateFluxesX1(w, b, bcc, order, k0, k1, j0, j1, i0, i1);
+  });
 
   if (order == 4) {
     // TODO(felker): assuming uniform mesh with dx1f=dx2f=dx3f, so this should factor out
@@ -172,47 +189,12 @@ void Hydro::CalculateFluxes(AthenaArray<Real> &w, FaceField &b,
         kl = ks-1, ku = ke+1;
     }
 
-    for (int k=kl; k<=ku; ++k) {
-      // reconstruct the first row
-      if (order == 1) {
-        pmb->precon->DonorCellX2(k, js-1, il, iu, w, bcc, wl_, wr_);
-      } else if (order == 2) {
-        pmb->precon->PiecewiseLinearX2(k, js-1, il, iu, w, bcc, wl_, wr_);
-      } else {
-        pmb->precon->PiecewiseParabolicX2(k, js-1, il, iu, w, bcc, wl_, wr_);
-      }
-      for (int j=js; j<=je+1; ++j) {
-        // reconstruct L/R states at j
-        if (order == 1) {
-          pmb->precon->DonorCellX2(k, j, il, iu, w, bcc, wlb_, wr_);
-        } else if (order == 2) {
-          pmb->precon->PiecewiseLinearX2(k, j, il, iu, w, bcc, wlb_, wr_);
-        } else {
-          pmb->precon->PiecewiseParabolicX2(k, j, il, iu, w, bcc, wlb_, wr_);
-        }
+    ForEachFaceBox(region, {kl, ku, js, je+1, il, iu},
+                   {ks, ke, js+NGHOST, je+1-NGHOST, is, ie},
+                   [&](int k0, int k1, int j0, int j1, int i0, int i1) {
+      CalculateFluxesX2(w, b, bcc, order, k0, k1, j0, j1, i0, i1);
+    });
 
-        pmb->pcoord->CenterWidth2(k, j, il, iu, dxw_);
-#if !MAGNETIC_FIELDS_ENABLED  // Hydro:
-        RiemannSolver(k, j, il, iu, IVY, wl_, wr_, x2flux, dxw_);
-#else  // MHD:
-        // flx(IBY) = (v2*b3 - v3*b2) = -EMFX
-        // flx(IBZ) = (v2*b1 - v1*b2) =  EMFZ
-        RiemannSolver(k, j, il, iu, IVY, b2, wl_, wr_, x2flux, e1x2, e3x2, w_x2f, dxw_);
-#endif
-
-        if (order == 4) {
-          for (int n=0; n<NWAVE; n++) {
-            for (int i=il; i<=iu; i++) {
-              wl3d_(n,k,j,i) = wl_(n,i);
-              wr3d_(n,k,j,i) = wr_(n,i);
-            }
-          }
-        }
-
-        // swap the arrays for the next step
-        wl_.SwapAthenaArray(wlb_);
-      }
-    }
     if (order == 4) {
       // TODO(felker): assuming uniform mesh with dx1f=dx2f=dx3f, so factor this out
       // TODO(felker): also, this may need to be dx2v, since Laplacian is cell-centered
@@ -278,46 +260,12 @@ void Hydro::CalculateFluxes(AthenaArray<Real> &w, FaceField &b,
       il = is-1, iu = ie+1, jl = js-1, ju = je+1;
     }
 
-    for (int j=jl; j<=ju; ++j) { // this loop ordering is intentional
-      // reconstruct the first row
-      if (order == 1) {
-        pmb->precon->DonorCellX3(ks-1, j, il, iu, w, bcc, wl_, wr_);
-      } else if (order == 2) {
-        pmb->precon->PiecewiseLinearX3(ks-1, j, il, iu, w, bcc, wl_, wr_);
-      } else {
-        pmb->precon->PiecewiseParabolicX3(ks-1, j, il, iu, w, bcc, wl_, wr_);
-      }
-      for (int k=ks; k<=ke+1; ++k) {
-        // reconstruct L/R states at k
-        if (order == 1) {
-          pmb->precon->DonorCellX3(k, j, il, iu, w, bcc, wlb_, wr_);
-        } else if (order == 2) {
-          pmb->precon->PiecewiseLinearX3(k, j, il, iu, w, bcc, wlb_, wr_);
-        } else {
-          pmb->precon->PiecewiseParabolicX3(k, j, il, iu, w, bcc, wlb_, wr_);
-        }
-
-        pmb->pcoord->CenterWidth3(k, j, il, iu, dxw_);
-#if !MAGNETIC_FIELDS_ENABLED  // Hydro:
-        RiemannSolver(k, j, il, iu, IVZ, wl_, wr_, x3flux, dxw_);
-#else  // MHD:
-        // flx(IBY) = (v3*b1 - v1*b3) = -EMFY
-        // flx(IBZ) = (v3*b2 - v2*b3) =  EMFX
-        RiemannSolver(k, j, il, iu, IVZ, b3, wl_, wr_, x3flux, e2x3, e1x3, w_x3f, dxw_);
-#endif
-        if (order == 4) {
-          for (int n=0; n<NWAVE; n++) {
-            for (int i=il; i<=iu; i++) {
-              wl3d_(n,k,j,i) = wl_(n,i);
-              wr3d_(n,k,j,i) = wr_(n,i);
-            }
-          }
-        }
+    ForEachFaceBox(region, {ks, ke+1, jl, ju, il, iu},
+                   {ks+NGHOST, ke+1-NGHOST, js, je, is, ie},
+                   [&](int k0, int k1, int j0, int j1, int i0, int i1) {
+      CalculateFluxesX3(w, b, bcc, order, k0, k1, j0, j1, i0, i1);
+    });
 
-        // swap the arrays for the next step
-        wl_.SwapAthenaArray(wlb_);
-      }
-    }
     if (order == 4) {
       // TODO(felker): assuming uniform mesh with dx1f=dx2f=dx3f, so factor this out
       // TODO(felker): also, this may need to be dx3v, since Laplacian is cell-centered
@@ -371,12 +319,183 @@ void Hydro::CalculateFluxes(AthenaArray<Real> &w, FaceField &b,
     } // end if (order == 4)
   }
 
-  if (!STS_ENABLED)
+  if (!STS_ENABLED && region != FluxRegion::interior)
     AddDiffusionFluxes();
 
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void Hydro::CalculateFluxesX1(AthenaArray<Real> &w, FaceField &b,
+//!                                   AthenaArray<Real> &bcc, const int order,
+//!                                   const int kl, const int ku, const int jl,
+//!                                   const int ju, const int il, const int iu)
+//! \brief reconstructs w and computes the x1 fluxes on faces [kl,ku]x[jl,ju]x[il,iu]
+
+void Hydro::CalculateFluxesX1(AthenaArray<Real> &w, FaceField &b, AthenaArray<Real> &bcc,
+                              const int order, const int kl, const int ku, const int jl,
+                              const int ju, const int il, const int iu) {
+  MeshBlock *pmb = pmy_block;
+  AthenaArray<Real> &x1flux = flux[X1DIR];
+#if MAGNETIC_FIELDS_ENABLED
+  AthenaArray<Real> &b1 = b.x1f, &w_x1f = pmb->pfield->wght.x1f,
+                  &e3x1 = pmb->pfield->e3_x1f, &e2x1 = pmb->pfield->e2_x1f;
+#endif
+
+  for (int k=kl; k<=ku; ++k) {
+    for (int j=jl; j<=ju; ++j) {
+      // reconstruct L/R states
+      if (order == 1) {
+        pmb->precon->DonorCellX1(k, j, il-1, iu, w, bcc, wl_, wr_);
+      } else if (order == 2) {
+        pmb->precon->PiecewiseLinearX1(k, j, il-1, iu, w, bcc, wl_, wr_);
+      } else {
+        pmb->precon->PiecewiseParabolicX1(k, j, il-1, iu, w, bcc, wl_, wr_);
+      }
+
+      pmb->pcoord->CenterWidth1(k, j, il, iu, dxw_);
+#if !MAGNETIC_FIELDS_ENABLED  // Hydro:
+      RiemannSolver(k, j, il, iu, IVX, wl_, wr_, x1flux, dxw_);
+#else  // MHD:
+      // x1flux(IBY) = (v1*b2 - v2*b1) = -EMFZ
+      // x1flux(IBZ) = (v1*b3 - v3*b1) =  EMFY
+      RiemannSolver(k, j, il, iu, IVX, b1, wl_, wr_, x1flux, e3x1, e2x1, w_x1f, dxw_);
+#endif
+
+      if (order == 4) {
+        for (int n=0; n<NWAVE; n++) {
+          for (int i=il; i<=iu; i++) {
+            wl3d_(n,k,j,i) = wl_(n,i);
+            wr3d_(n,k,j,i) = wr_(n,i);
+          }
+        }
+      }
+    }
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Hydro::CalculateFluxesX2(AthenaArray<Real> &w, FaceField &b,
+//!                                   AthenaArray<Real> &bcc, const int order,
+//!                                   const int kl, const int ku, const int jl,
+//!                                   const int ju, const int il, const int iu)
+//! \brief reconstructs w and computes the x2 fluxes on faces [kl,ku]x[jl,ju]x[il,iu]
+
+void Hydro::CalculateFluxesX2(AthenaArray<Real> &w, FaceField &b, AthenaArray<Real> &bcc,
+                              const int order, const int kl, const int ku, const int jl,
+                              const int ju, const int il, const int iu) {
+  MeshBlock *pmb = pmy_block;
+  AthenaArray<Real> &x2flux = flux[X2DIR];
+#if MAGNETIC_FIELDS_ENABLED
+  AthenaArray<Real> &b2 = b.x2f, &w_x2f = pmb->pfield->wght.x2f,
+                  &e1x2 = pmb->pfield->e1_x2f, &e3x2 = pmb->pfield->e3_x2f;
+#endif
+
+  for (int k=kl; k<=ku; ++k) {
+    // reconstruct the first row
+    if (order == 1) {
+      pmb->precon->DonorCellX2(k, jl-1, il, iu, w, bcc, wl_, wr_);
+    } else if (order == 2) {
+      pmb->precon->PiecewiseLinearX2(k, jl-1, il, iu, w, bcc, wl_, wr_);
+    } else {
+      pmb->precon->PiecewiseParabolicX2(k, jl-1, il, iu, w, bcc, wl_, wr_);
+    }
+    for (int j=jl; j<=ju; ++j) {
+      // reconstruct L/R states at j
+      if (order == 1) {
+        pmb->precon->DonorCellX2(k, j, il, iu, w, bcc, wlb_, wr_);
+      } else if (order == 2) {
+        pmb->precon->PiecewiseLinearX2(k, j, il, iu, w, bcc, wlb_, wr_);
+      } else {
+        pmb->precon->PiecewiseParabolicX2(k, j, il, iu, w, bcc, wlb_, wr_);
+      }
+
+      pmb->pcoord->CenterWidth2(k, j, il, iu, dxw_);
+#if !MAGNETIC_FIELDS_ENABLED  // Hydro:
+      RiemannSolver(k, j, il, iu, IVY, wl_, wr_, x2flux, dxw_);
+#else  // MHD:
+      // flx(IBY) = (v2*b3 - v3*b2) = -EMFX
+      // flx(IBZ) = (v2*b1 - v1*b2) =  EMFZ
+      RiemannSolver(k, j, il, iu, IVY, b2, wl_, wr_, x2flux, e1x2, e3x2, w_x2f, dxw_);
+#endif
+
+      if (order == 4) {
+        for (int n=0; n<NWAVE; n++) {
+          for (int i=il; i<=iu; i++) {
+            wl3d_(n,k,j,i) = wl_(n,i);
+            wr3d_(n,k,j,i) = wr_(n,i);
+          }
+        }
+      }
+
+      // swap the arrays for the next step
+      wl_.SwapAthenaArray(wlb_);
+    }
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Hydro::CalculateFluxesX3(AthenaArray<Real> &w, FaceField &b,
+//!                                   AthenaArray<Real> &bcc, const int order,
+//!                                   const int kl, const int ku, const int jl,
+//!                                   const int ju, const int il, const int iu)
+//! \brief reconstructs w and computes the x3 fluxes on faces [kl,ku]x[jl,ju]x[il,iu]
+
+void Hydro::CalculateFluxesX3(AthenaArray<Real> &w, FaceField &b, AthenaArray<Real> &bcc,
+                              const int order, const int kl, const int ku, const int jl,
+                              const int ju, const int il, const int iu) {
+  MeshBlock *pmb = pmy_block;
+  AthenaArray<Real> &x3flux = flux[X3DIR];
+#if MAGNETIC_FIELDS_ENABLED
+  AthenaArray<Real> &b3 = b.x3f, &w_x3f = pmb->pfield->wght.x3f,
+                  &e1x3 = pmb->pfield->e1_x3f, &e2x3 = pmb->pfield->e2_x3f;
+#endif
+
+  for (int j=jl; j<=ju; ++j) { // this loop ordering is intentional
+    // reconstruct the first row
+    if (order == 1) {
+      pmb->precon->DonorCellX3(kl-1, j, il, iu, w, bcc, wl_, wr_);
+    } else if (order == 2) {
+      pmb->precon->PiecewiseLinearX3(kl-1, j, il, iu, w, bcc, wl_, wr_);
+    } else {
+      pmb->precon->PiecewiseParabolicX3(kl-1, j, il, iu, w, bcc, wl_, wr_);
+    }
+    for (int k=kl; k<=ku; ++k) {
+      // reconstruct L/R states at k
+      if (order == 1) {
+        pmb->precon->DonorCellX3(k, j, il, iu, w, bcc, wlb_, wr_);
+      } else if (order == 2) {
+        pmb->precon->PiecewiseLinearX3(k, j, il, iu, w, bcc, wlb_, wr_);
+      } else {
+        pmb->precon->PiecewiseParabolicX3(k, j, il, iu, w, bcc, wlb_, wr_);
+      }
+
+      pmb->pcoord->CenterWidth3(k, j, il, iu, dxw_);
+#if !MAGNETIC_FIELDS_ENABLED  // Hydro:
+      RiemannSolver(k, j, il, iu, IVZ, wl_, wr_, x3flux, dxw_);
+#else  // MHD:
+      // flx(IBY) = (v3*b1 - v1*b3) = -EMFY
+      // flx(IBZ) = (v3*b2 - v2*b3) =  EMFX
+      RiemannSolver(k, j, il, iu, IVZ, b3, wl_, wr_, x3flux, e2x3, e1x3, w_x3f, dxw_);
+#endif
+      if (order == 4) {
+        for (int n=0; n<NWAVE; n++) {
+          for (int i=il; i<=iu; i++) {
+            wl3d_(n,k,j,i) = wl_(n,i);
+            wr3d_(n,k,j,i) = wr_(n,i);
+          }
+        }
+      }
+
+      // swap the arrays for the next step
+      wl_.SwapAthenaArray(wlb_);
+    }
+  }
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn  void Hydro::CalculateFluxes_STS
 //! \brief Calculate Hydrodynamic Diffusion Fluxes for STS
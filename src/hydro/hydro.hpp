@@ -23,6 +23,12 @@
 class MeshBlock;
 class ParameterInput;
 
+//! \enum FluxRegion
+//! \brief faces computed by Hydro::CalculateFluxes(): all of them, only the interior
+//! faces that do not depend on the ghost zones, or the remaining boundary faces
+
+enum class FluxRegion {all, interior, boundary};
+
 // TODO(felker): consider adding a struct FaceFlux w/ overloaded ctor in athena.hpp, or:
 // using FaceFlux = AthenaArray<Real>[3];
 
@@ -70,7 +76,8 @@ class Hydro {
                              AthenaArray<Real> &fl_div_out,
                              std::vector<int> idx_subset);
   void CalculateFluxes(AthenaArray<Real> &w, FaceField &b,
-                       AthenaArray<Real> &bcc, const int order);
+                       AthenaArray<Real> &bcc, const int order,
+                       const FluxRegion region = FluxRegion::all);
   void CalculateFluxes_STS();
 #if !MAGNETIC_FIELDS_ENABLED  // Hydro:
   void RiemannSolver(
@@ -118,6 +125,15 @@ class Hydro {
   TimeStepFunc UserTimeStep_;
 
   void AddDiffusionFluxes();
+  void CalculateFluxesX1(AthenaArray<Real> &w, FaceField &b, AthenaArray<Real> &bcc,
+                         const int order, const int kl, const int ku, const int jl,
+                         const int ju, const int il, const int iu);
+  void CalculateFluxesX2(AthenaArray<Real> &w, FaceField &b, AthenaArray<Real> &bcc,
+                         const int order, const int kl, const int ku, const int jl,
+                         const int ju, const int il, const int iu);
+  void CalculateFluxesX3(AthenaArray<Real> &w, FaceField &b, AthenaArray<Real> &bcc,
+                         const int order, const int kl, const int ku, const int jl,
+                         const int ju, const int il, const int iu);
   Real GetWeightForCT(Real dflx, Real rhol, Real rhor, Real dx, Real dt);
 };
 #endif // HYDRO_HYDRO_HPP_
@@ -44,12 +44,6 @@ HydroDiffusion::HydroDiffusion(Hydro *phyd, ParameterInput *pin) :
     visflx[X1DIR].NewAthenaArray(NHYDRO, nc3, nc2, nc1+1);
     visflx[X2DIR].NewAthenaArray(NHYDRO, nc3, nc2+1, nc1);
     visflx[X3DIR].NewAthenaArray(NHYDRO, nc3+1, nc2, nc1);
-    x1area_.NewAthenaArray(nc1+1);
-    x2area_.NewAthenaArray(nc1);
-    x3area_.NewAthenaArray(nc1);
-    x2area_p1_.NewAthenaArray(nc1);
-    x3area_p1_.NewAthenaArray(nc1);
-    vol_.NewAthenaArray(nc1);
     fx_.NewAthenaArray(nc1);
     fy_.NewAthenaArray(nc1);
     fz_.NewAthenaArray(nc1);
@@ -88,9 +82,6 @@ HydroDiffusion::HydroDiffusion(Hydro *phyd, ParameterInput *pin) :
   }
 
   if (hydro_diffusion_defined) {
-    dx1_.NewAthenaArray(nc1);
-    dx2_.NewAthenaArray(nc1);
-    dx3_.NewAthenaArray(nc1);
     nu_tot_.NewAthenaArray(nc1);
     kappa_tot_.NewAthenaArray(nc1);
   }
@@ -255,7 +246,6 @@ void HydroDiffusion::NewDiffusionDt(Real &dt_vis, Real &dt_cnd) {
 
   AthenaArray<Real> &nu_t = nu_tot_;
   AthenaArray<Real> &kappa_t = kappa_tot_;
-  AthenaArray<Real> &len = dx1_, &dx2 = dx2_, &dx3 = dx3_;
 
   for (int k=kl; k<=ku; ++k) {
     for (int j=jl; j<=ju; ++j) {
@@ -280,23 +270,24 @@ void HydroDiffusion::NewDiffusionDt(Real &dt_vis, Real &dt_cnd) {
 #pragma omp simd
         for (int i=il; i<=iu; ++i) kappa_t(i) += kappa(DiffProcess::aniso,k,j,i);
       }
-      pmb_->pcoord->CenterWidth1(k, j, il, iu, len);
-      pmb_->pcoord->CenterWidth2(k, j, il, iu, dx2);
-      pmb_->pcoord->CenterWidth3(k, j, il, iu, dx3);
-#pragma omp simd
-      for (int i=il; i<=iu; ++i) {
-        len(i) = (f2) ? std::min(len(i), dx2(i)) : len(i);
-        len(i) = (f3) ? std::min(len(i), dx3(i)) : len(i);
-      }
+      const Real *dx1 = &(pco_->center_width1(k,j,0)),
+                 *dx2 = &(pco_->center_width2(k,j,0)),
+                 *dx3 = &(pco_->center_width3(k,j,0));
       if ((nu_iso > 0.0) || (nu_aniso > 0.0)) {
-        for (int i=il; i<=iu; ++i)
+        for (int i=il; i<=iu; ++i) {
+          Real len = (f2) ? std::min(dx1[i], dx2[i]) : dx1[i];
+          len = (f3) ? std::min(len, dx3[i]) : len;
           dt_vis = std::min(dt_vis, static_cast<Real>(
-              SQR(len(i))*fac/(nu_t(i) + TINY_NUMBER)));
+              SQR(len)*fac/(nu_t(i) + TINY_NUMBER)));
+        }
       }
       if ((kappa_iso > 0.0) || (kappa_aniso > 0.0)) {
-        for (int i=il; i<=iu; ++i)
+        for (int i=il; i<=iu; ++i) {
+          Real len = (f2) ? std::min(dx1[i], dx2[i]) : dx1[i];
+          len = (f3) ? std::min(len, dx3[i]) : len;
           dt_cnd = std::min(dt_cnd, static_cast<Real>(
-              SQR(len(i))*fac/(kappa_t(i) + TINY_NUMBER)));
+              SQR(len)*fac/(kappa_t(i) + TINY_NUMBER)));
+        }
       }
     }
   }
@@ -81,10 +81,7 @@ class HydroDiffusion {
   MeshBlock *pmb_;    // ptr to meshblock containing this HydroDiffusion
   Coordinates *pco_;  // ptr to coordinates class
   AthenaArray<Real> div_vel_; // divergence of velocity
-  AthenaArray<Real> x1area_, x2area_, x2area_p1_, x3area_, x3area_p1_;
-  AthenaArray<Real> vol_;
   AthenaArray<Real> fx_, fy_, fz_;
-  AthenaArray<Real> dx1_, dx2_, dx3_;
   AthenaArray<Real> nu_tot_, kappa_tot_;
 
   // functions pointer to calculate spatial dependent coefficients
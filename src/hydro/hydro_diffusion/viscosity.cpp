@@ -237,44 +237,44 @@ void HydroDiffusion::DivVelocity(const AthenaArray<Real> &prim,
   for (int k=kl; k<=ku; ++k) {
     for (int j=jl; j<=ju; ++j) {
       // calculate x1-flux divergence
-      pmb_->pcoord->Face1Area(k, j, il, iu+1, x1area_);
+      const Real *x1area = &(pco_->face1_area(k,j,0));
 #pragma omp simd private(area_p1, area, vel_p1, vel)
       for (int i=il; i<=iu; ++i) {
-        area_p1 = x1area_(i+1);
-        area    = x1area_(i);
+        area_p1 = x1area[i+1];
+        area    = x1area[i];
         vel_p1  = 0.5*(prim(IM1,k,j,i+1) + prim(IM1,k,j,i  ));
         vel     = 0.5*(prim(IM1,k,j,i  ) + prim(IM1,k,j,i-1));
         div_vel(k,j,i) = area_p1*vel_p1 - area*vel;
       }
       // calculate x2-flux divergnece
       if (f2) {
-        pmb_->pcoord->Face2Area(k, j  , il, iu, x2area_);
-        pmb_->pcoord->Face2Area(k, j+1, il, iu, x2area_p1_);
+        const Real *x2area = &(pco_->face2_area(k,j,0)),
+                   *x2area_p1 = &(pco_->face2_area(k,j+1,0));
 #pragma omp simd private(area_p1, area, vel_p1, vel)
         for (int i=il; i<=iu; ++i) {
-          area_p1 = x2area_p1_(i);
-          area    = x2area_(i);
+          area_p1 = x2area_p1[i];
+          area    = x2area[i];
           vel_p1  = 0.5*(prim(IM2,k,j+1,i) + prim(IM2,k,j  ,i));
           vel     = 0.5*(prim(IM2,k,j  ,i) + prim(IM2,k,j-1,i));
           div_vel(k,j,i) += area_p1*vel_p1 - area*vel;
         }
       }
       if (f3) {
-        pmb_->pcoord->Face3Area(k  , j, il, iu, x3area_);
-        pmb_->pcoord->Face3Area(k+1, j, il, iu, x3area_p1_);
+        const Real *x3area = &(pco_->face3_area(k,j,0)),
+                   *x3area_p1 = &(pco_->face3_area(k+1,j,0));
 #pragma omp simd private(area_p1, area, vel_p1, vel)
         for (int i=il; i<=iu; ++i) {
-          area_p1 = x3area_p1_(i);
-          area    = x3area_(i);
+          area_p1 = x3area_p1[i];
+          area    = x3area[i];
           vel_p1  = 0.5*(prim(IM3,k+1,j,i) + prim(IM3, k  ,j,i));
           vel     = 0.5*(prim(IM3,k  ,j,i) + prim(IM3, k-1,j,i));
           div_vel(k,j,i) += area_p1*vel_p1 - area*vel;
         }
       }
-      pmb_->pcoord->CellVolume(k,j,il,iu,vol_);
+      const Real *vol = &(pco_->cell_volume(k,j,0));
 #pragma omp simd
       for (int i=il; i<=iu; ++i) {
-        div_vel(k,j,i) = div_vel(k,j,i)/vol_(i);
+        div_vel(k,j,i) = div_vel(k,j,i)/vol[i];
       }
     }
   }
@@ -65,8 +65,14 @@ void Hydro::NewBlockTimeStep() {
   Real cspeed = 0.0;
   if(NR_RADIATION_ENABLED)
     cspeed = pmb->pnrrad->reduced_c;
-  if(CR_ENABLED)
-    cspeed = std::max(cspeed,pmb->pcr->vmax);
+  // subcycled CR transport only needs dt/nsubcycle to satisfy its own CFL condition,
+  // and implicit CR transport does not limit dt. In a MeshBlock that the hybrid CR
+  // transport diffuses entirely with Multigrid, the signal speed is v_diff, not vmax
+  if(CR_ENABLED && !pmb->pcr->implicit) {
+    Real vcr = (pmb->pcr->hybrid_tau > 0.0 && pmb->pcr->all_thick) ?
+               pmb->pcr->max_vdiff : pmb->pcr->vmax;
+    cspeed = std::max(cspeed,vcr/pmb->pcr->nsubcycle);
+  }
 
   // TODO(felker): skip this next loop if pm->fluid_setup == FluidFormulation::disabled
   FluidFormulation fluid_status = pmb->pmy_mesh->fluid_setup;
@@ -35,6 +35,8 @@
 // Athena++ headers
 #include "athena.hpp"
 #include "chem_rad/chem_rad.hpp"
+#include "cr/cr.hpp"
+#include "cr/implicit/cr_implicit.hpp"
 #include "crdiffusion/mg_crdiffusion.hpp"
 #include "fft/turbulence.hpp"
 #include "globals.hpp"
@@ -47,6 +49,8 @@
 #include "outputs/outputs.hpp"
 #include "parameter_input.hpp"
 #include "task_list/chem_rad_task_list.hpp"
+#include "task_list/cr_subcycle_task_list.hpp"
+#include "task_list/task_timer.hpp"
 #include "utils/utils.hpp"
 
 // MPI/OpenMP headers
@@ -269,6 +273,10 @@ int main(int argc, char *argv[]) {
   //--- Step 4. --------------------------------------------------------------------------
   // Construct and initialize Mesh
 
+  // the TaskLists, including the Multigrid ones built with the Mesh, time their tasks
+  // if <time> task_timing is set
+  TaskTimer::Enable(pinput);
+
   Mesh *pmesh;
 #ifdef ENABLE_EXCEPTIONS
   try {
@@ -366,6 +374,26 @@ int main(int argc, char *argv[]) {
 #endif // ENABLE_EXCEPTIONS
   }
 
+  // subcycled cosmic ray transport
+  CRSubcycleTaskList *pcrsublist = nullptr;
+  if (CR_ENABLED && ptlist->cr_nsubcycle > 1) {
+#ifdef ENABLE_EXCEPTIONS
+    try {
+#endif
+      pcrsublist = new CRSubcycleTaskList(pinput, pmesh, ptlist);
+#ifdef ENABLE_EXCEPTIONS
+    }
+    catch(std::bad_alloc& ba) {
+      std::cout << "### FATAL ERROR in main" << std::endl << "memory allocation failed "
+                << "in creating task list " << ba.what() << std::endl;
+#ifdef MPI_PARALLEL
+      MPI_Finalize();
+#endif
+      return(0);
+    }
+#endif // ENABLE_EXCEPTIONS
+  }
+
   // chemistry radiation
   ChemRadiationIntegratorTaskList *pchemradlist = nullptr;
   if (CHEMRADIATION_ENABLED) {
@@ -510,6 +538,8 @@ int main(int argc, char *argv[]) {
     }
 
     for (int stage=1; stage<=ptlist->nstages; ++stage) {
+      if (pcrsublist != nullptr)
+        pcrsublist->DoSubcycles(pmesh, stage);
       ptlist->DoTaskListOneStage(pmesh, stage);
       if (ptlist->CheckNextMainStage(stage)) {
         if (SELF_GRAVITY_ENABLED == 1) // fft (0: discrete kernel, 1: continuous kernel)
@@ -520,6 +550,8 @@ int main(int argc, char *argv[]) {
       if (IM_RADIATION_ENABLED) {
         pmesh->pimrad->Iteration(pmesh,ptlist,stage);
       }
+      if (pmesh->pimcr != nullptr)
+        pmesh->pimcr->Iteration(pmesh,ptlist,stage);
     }
 
     if (STS_ENABLED && pmesh->sts_integrator == "rkl2") {
@@ -650,11 +682,23 @@ int main(int argc, char *argv[]) {
     std::cout << std::endl << "omp wtime used = " << omp_time << std::endl;
     std::cout << "zone-cycles/omp_wsecond = " << zc_omps << std::endl;
 #endif
+
+    // memory footprint of the CR coefficient arrays (halved by -crfloat)
+    if (CR_ENABLED) {
+      CosmicRay *pcr = pmesh->my_blocks(0)->pcr;
+      std::cout << std::endl << "CR coefficient storage per MeshBlock = "
+                << pcr->CoefficientBytes() << " bytes (u_cr = "
+                << pcr->u_cr.GetSizeInBytes() << " bytes)" << std::endl;
+    }
   }
 
+  // per-task timing summed over ranks, printed by rank 0
+  TaskTimer::Report(pinput);
+
   delete pinput;
   delete pmesh;
   delete ptlist;
+  delete pcrsublist;
   delete pouts;
   delete pchemradlist;
 
@@ -550,7 +550,9 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, int ntot) {
   newlist.NewAthenaArray(nblist[Globals::my_rank]);
   RegionSize block_size = my_blocks(0)->block_size;
 
-  for (int n=nbs; n<=nbe; n++) {
+  // new MeshBlocks are created on the threads that own them (Mesh::GetOwnerThread)
+  ConstructOnOwnerThreads(nblist[Globals::my_rank], [&](int lid) {
+    int n = nbs + lid;
     int on = newtoold[n];
     if ((ranklist[on] == Globals::my_rank) && (loclist[on].level == newloc[n].level)) {
       // on the same MPI rank and same level -> just move it
@@ -580,7 +582,7 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, int ntot) {
         FillSameRankCoarseToFineAMR(pob, newlist(n-nbs), newloc[n]);
       }
     }
-  }
+  });
 
   // discard remaining MeshBlocks
   // they could be reused, but for the moment, just throw them away for simplicity
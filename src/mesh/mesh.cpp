@@ -17,6 +17,8 @@
 #include <cstdint>    // std::int64_t fixed-wdith integer type alias
 #include <cstdlib>
 #include <cstring>    // std::memcpy()
+#include <exception>  // std::exception_ptr, std::current_exception()
+#include <functional> // std::function
 #include <iomanip>    // std::setprecision()
 #include <iostream>
 #include <limits>
@@ -34,6 +36,7 @@
 #include "../chem_rad/integrators/rad_integrators.hpp"
 #include "../coordinates/coordinates.hpp"
 #include "../cr/cr.hpp"
+#include "../cr/implicit/cr_implicit.hpp"
 #include "../crdiffusion/crdiffusion.hpp"
 #include "../crdiffusion/mg_crdiffusion.hpp"
 #include "../eos/eos.hpp"
@@ -66,6 +69,10 @@
 #include <mpi.h>
 #endif
 
+#ifdef OPENMP_PARALLEL
+#include <omp.h>
+#endif
+
 //----------------------------------------------------------------------------------------
 //! Mesh constructor, builds mesh at start of calculation using parameters in input file
 
@@ -120,8 +127,8 @@ Mesh::Mesh(ParameterInput *pin, int mesh_test) :
     MeshGenerator_{UniformMeshGeneratorX1, UniformMeshGeneratorX2,
                    UniformMeshGeneratorX3},
     BoundaryFunction_{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr},
-    AMRFlag_{}, UserSourceTerm_{}, UserTimeStep_{}, ViscosityCoeff_{},
-    ConductionCoeff_{}, FieldDiffusivity_{},
+    AMRFlag_{}, UserSourceTerm_{}, UserTimeStep_{}, user_history_block_func_{},
+    ViscosityCoeff_{}, ConductionCoeff_{}, FieldDiffusivity_{},
     OrbitalVelocity_{}, OrbitalVelocityDerivative_{nullptr, nullptr},
     MGGravityBoundaryFunction_{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr},
     MGCRDiffusionBoundaryFunction_{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr},
@@ -149,6 +156,9 @@ Mesh::Mesh(ParameterInput *pin, int mesh_test) :
     ATHENA_ERROR(msg);
   }
 
+  // select the TaskList scheduler
+  SetTaskScheduler(pin);
+
   // check number of grid cells in root level of mesh from input file.
   if (mesh_size.nx1 < 4) {
     msg << "### FATAL ERROR in Mesh constructor" << std::endl
@@ -547,18 +557,22 @@ Mesh::Mesh(ParameterInput *pin, int mesh_test) :
     pimrad = new IMRadiation(this, pin);
   }
 
+  pimcr = nullptr;
+  if (CR_ENABLED && pin->GetOrAddBoolean("cr", "implicit", false))
+    pimcr = new IMCosmicRay(this, pin);
+
   // create MeshBlock list for this process
   gids_ = nslist[Globals::my_rank];
   gide_ = gids_ + nblist[Globals::my_rank] - 1;
   nblocal = nblist[Globals::my_rank];
   my_blocks.NewAthenaArray(nblocal);
   // create MeshBlocks for this node
-  for (int i=gids_; i<=gide_; i++) {
+  ConstructOnOwnerThreads(nblocal, [&](int lid) {
+    int i = gids_ + lid;
     SetBlockSizeAndBoundaries(loclist[i], block_size, block_bcs);
-    my_blocks(i-gids_) = new MeshBlock(i, i-gids_, loclist[i], block_size, block_bcs,
-                                       this, pin);
-    my_blocks(i-gids_)->pbval->SearchAndSetNeighbors(tree, ranklist, nslist);
-  }
+    my_blocks(lid) = new MeshBlock(i, lid, loclist[i], block_size, block_bcs, this, pin);
+    my_blocks(lid)->pbval->SearchAndSetNeighbors(tree, ranklist, nslist);
+  });
 
   ResetLoadBalanceVariables();
 
@@ -621,8 +635,8 @@ Mesh::Mesh(ParameterInput *pin, IOWrapper& resfile, int mesh_test) :
     MeshGenerator_{UniformMeshGeneratorX1, UniformMeshGeneratorX2,
                    UniformMeshGeneratorX3},
     BoundaryFunction_{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr},
-    AMRFlag_{}, UserSourceTerm_{}, UserTimeStep_{}, ViscosityCoeff_{},
-    ConductionCoeff_{}, FieldDiffusivity_{},
+    AMRFlag_{}, UserSourceTerm_{}, UserTimeStep_{}, user_history_block_func_{},
+    ViscosityCoeff_{}, ConductionCoeff_{}, FieldDiffusivity_{},
     OrbitalVelocity_{}, OrbitalVelocityDerivative_{nullptr, nullptr},
     MGGravityBoundaryFunction_{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr},
     MGCRDiffusionBoundaryFunction_{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr},
@@ -652,6 +666,9 @@ Mesh::Mesh(ParameterInput *pin, IOWrapper& resfile, int mesh_test) :
     ATHENA_ERROR(msg);
   }
 
+  // select the TaskList scheduler
+  SetTaskScheduler(pin);
+
   // get the end of the header
   headeroffset = resfile.GetPosition();
   // read the restart file
@@ -881,6 +898,10 @@ Mesh::Mesh(ParameterInput *pin, IOWrapper& resfile, int mesh_test) :
     pimrad = new IMRadiation(this, pin);
   }
 
+  pimcr = nullptr;
+  if (CR_ENABLED && pin->GetOrAddBoolean("cr", "implicit", false))
+    pimcr = new IMCosmicRay(this, pin);
+
 
   // allocate data buffer
   int nbmin = nblist[0];
@@ -893,8 +914,9 @@ Mesh::Mesh(ParameterInput *pin, IOWrapper& resfile, int mesh_test) :
   gide_ = gids_ + nblocal - 1;
   char *mbdata = new char[datasize];
   my_blocks.NewAthenaArray(nblocal);
-  for (int i=gids_; i<=gide_; i++) {
-    if (i - gids_ < nbmin) {
+  ConstructOnOwnerThreads(nblocal, [&](int lid) {
+    int i = gids_ + lid;
+    if (lid < nbmin) {
       // load MeshBlock (parallel)
       if (resfile.Read_at_all(mbdata, datasize, 1, headeroffset+i*datasize) != 1) {
         msg << "### FATAL ERROR in Mesh constructor" << std::endl
@@ -913,10 +935,10 @@ Mesh::Mesh(ParameterInput *pin, IOWrapper& resfile, int mesh_test) :
     }
     // Match fixed-width integer precision of IOWrapperSizeT datasize
     SetBlockSizeAndBoundaries(loclist[i], block_size, block_bcs);
-    my_blocks(i-gids_) = new MeshBlock(i, i-gids_, this, pin, loclist[i], block_size,
-                                       block_bcs, costlist[i], mbdata);
-    my_blocks(i-gids_)->pbval->SearchAndSetNeighbors(tree, ranklist, nslist);
-  }
+    my_blocks(lid) = new MeshBlock(i, lid, this, pin, loclist[i], block_size,
+                                   block_bcs, costlist[i], mbdata);
+    my_blocks(lid)->pbval->SearchAndSetNeighbors(tree, ranklist, nslist);
+  });
   delete [] mbdata;
   // check consistency
   if ( (NR_RADIATION_ENABLED || IM_RADIATION_ENABLED) &&
@@ -960,6 +982,7 @@ Mesh::~Mesh() {
   if (SELF_GRAVITY_ENABLED == 1) delete pfgrd;
   else if (SELF_GRAVITY_ENABLED == 2) delete pmgrd;
   if (IM_RADIATION_ENABLED) delete pimrad;
+  delete pimcr;
   if (turb_flag > 0) delete ptrbd;
   if (adaptive) { // deallocate arrays for AMR
     delete [] nref;
@@ -1421,6 +1444,18 @@ void Mesh::EnrollUserHistoryOutput(int i, HistoryOutputFunc my_func, const char
   user_history_ops_[i] = op;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void Mesh::EnrollUserHistoryBlockFunction(HistoryBlockFunc my_func)
+//! \brief Enroll a function that computes, in one sweep of a MeshBlock, the values of
+//!        all user-defined history outputs enrolled without a function. It is called
+//!        with usr_data[0..nuser_history_output_-1] zeroed, and sets usr_data[n] as
+//!        the function of output n would have returned it.
+
+void Mesh::EnrollUserHistoryBlockFunction(HistoryBlockFunc my_func) {
+  user_history_block_func_ = my_func;
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void Mesh::EnrollUserMetric(MetricFunc my_func)
 //! \brief Enroll a user-defined metric for arbitrary GR coordinates
@@ -1874,6 +1909,19 @@ MeshBlock* Mesh::FindMeshBlock(int tgid) {
   return nullptr;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void Mesh::FindMeshBlocksInBox(const RegionSize &box,
+//!                                     std::vector<LogicalLocation> *locs)
+//! \brief return the locations of all the MeshBlocks (on any rank) overlapping the
+//!  physical box [x1min,x1max]x[x2min,x2max]x[x3min,x3max]
+
+void Mesh::FindMeshBlocksInBox(const RegionSize &box,
+                               std::vector<LogicalLocation> *locs) {
+  locs->clear();
+  tree.GetMeshBlocksInBox(box, locs);
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void Mesh::SetBlockSizeAndBoundaries(LogicalLocation loc,
 //!                RegionSize &block_size, BundaryFlag *block_bcs)
@@ -2234,3 +2282,91 @@ void Mesh::OutputCycleDiagnostics() {
   }
   return;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn void Mesh::SetTaskScheduler(ParameterInput *pin)
+//! \brief reads <mesh> task_scheduler: polling, stealing (default) or pinned
+
+void Mesh::SetTaskScheduler(ParameterInput *pin) {
+  std::string name = pin->GetOrAddString("mesh", "task_scheduler", "stealing");
+  if (name == "polling") {
+    task_scheduler = TaskScheduler::polling;
+  } else if (name == "stealing") {
+    task_scheduler = TaskScheduler::stealing;
+  } else if (name == "pinned") {
+    task_scheduler = TaskScheduler::pinned;
+  } else {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in Mesh constructor" << std::endl
+        << "task_scheduler must be polling, stealing or pinned, but task_scheduler="
+        << name << std::endl;
+    ATHENA_ERROR(msg);
+  }
+#ifdef OPENMP_PARALLEL
+  // the MeshBlocks only stay in the memory of their thread if it does not migrate
+  if (task_scheduler == TaskScheduler::pinned && num_mesh_threads_ > 1
+      && omp_get_proc_bind() == omp_proc_bind_false && Globals::my_rank == 0) {
+    std::cout << "### Warning in Mesh constructor" << std::endl
+              << "task_scheduler=pinned, but the OpenMP threads are not bound to cores;"
+              << " set OMP_PROC_BIND and OMP_PLACES" << std::endl;
+  }
+#else
+  // without OpenMP one thread owns all MeshBlocks, as in the work-stealing scheduler
+  if (task_scheduler == TaskScheduler::pinned)
+    task_scheduler = TaskScheduler::stealing;
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn int Mesh::GetOwnerThread(int lid, int nmb) const
+//! \brief OpenMP thread that owns the local MeshBlock lid of nmb with the pinned task
+//! scheduler: the MeshBlocks are split into contiguous ranges (neighbors in the Z-order
+//! curve) of nearly equal size, one per thread
+
+int Mesh::GetOwnerThread(int lid, int nmb) const {
+  int q = nmb/num_mesh_threads_, r = nmb%num_mesh_threads_;
+  // the first r threads own q+1 MeshBlocks, the others q
+  if (lid < r*(q+1)) return lid/(q+1);
+  return r + (lid - r*(q+1))/q;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Mesh::ConstructOnOwnerThreads(int nmb,
+//!                                        const std::function<void(int)> &construct)
+//! \brief calls construct(lid) for the local MeshBlocks lid = 0, ..., nmb-1 in order.
+//! With the pinned task scheduler each call is made by the thread that owns the
+//! MeshBlock, one at a time, so that the arrays allocated (and zeroed) by the MeshBlock
+//! constructor are first touched by that thread and placed in its NUMA domain.
+
+void Mesh::ConstructOnOwnerThreads(int nmb,
+                                   const std::function<void(int)> &construct) {
+  if (task_scheduler != TaskScheduler::pinned || num_mesh_threads_ == 1) {
+    for (int lid=0; lid<nmb; ++lid)
+      construct(lid);
+    return;
+  }
+
+  // errors cannot leave the parallel region; rethrow the first one after it
+  std::exception_ptr perror = nullptr;
+#pragma omp parallel num_threads(num_mesh_threads_)
+  {
+#ifdef OPENMP_PARALLEL
+    int tid = omp_get_thread_num();
+#else
+    int tid = 0;
+#endif
+    for (int lid=0; lid<nmb; ++lid) {
+      if (GetOwnerThread(lid, nmb) == tid && perror == nullptr) {
+        try {
+          construct(lid);
+        } catch (...) {
+          perror = std::current_exception();
+        }
+      }
+#pragma omp barrier
+    }
+  }
+  if (perror != nullptr) std::rethrow_exception(perror);
+  return;
+}
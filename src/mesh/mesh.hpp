@@ -15,7 +15,7 @@
 
 // C++ headers
 #include <cstdint>     // int64_t
-#include <functional>  // reference_wrapper
+#include <functional>  // reference_wrapper, function
 #include <string>
 #include <vector>
 
@@ -63,6 +63,7 @@ class Particles;
 class PassiveScalars;
 class NRRadiation;
 class IMRadiation;
+class IMCosmicRay;
 class TurbulenceDriver;
 
 FluidFormulation GetFluidFormulation(const std::string& input_string);
@@ -219,6 +220,7 @@ class Mesh {
   friend class Hydro;
   friend class NRRadiation;
   friend class IMRadiation;
+  friend class IMCosmicRay;
   friend class CosmicRay;
   friend class FFTDriver;
   friend class FFTGravityDriver;
@@ -243,6 +245,7 @@ class Mesh {
 
   // accessors
   int GetNumMeshThreads() const {return num_mesh_threads_;}
+  int GetOwnerThread(int lid, int nmb) const;
   std::int64_t GetTotalCells() {return static_cast<std::int64_t> (nbtotal)*
   my_blocks(0)->block_size.nx1*my_blocks(0)->block_size.nx2*my_blocks(0)->block_size.nx3;}
 
@@ -260,6 +263,7 @@ class Mesh {
   std::string sts_integrator;
   Real sts_max_dt_ratio;
   TaskType sts_loc;
+  TaskScheduler task_scheduler;  // how TaskLists distribute MeshBlocks over threads
   Real muj, nuj, muj_tilde, gammaj_tilde;
   int nbtotal, nblocal, nbnew, nbdel;
 
@@ -278,6 +282,8 @@ class Mesh {
 
   // implicit radiation iteration
   IMRadiation *pimrad;
+  // implicit cosmic ray transport iteration, nullptr unless <cr> implicit = true
+  IMCosmicRay *pimcr;
 
   AthenaArray<Real> *ruser_mesh_data;
   AthenaArray<int> *iuser_mesh_data;
@@ -291,6 +297,7 @@ class Mesh {
   void LoadBalancingAndAdaptiveMeshRefinement(ParameterInput *pin);
   int CreateAMRMPITag(int lid, int ox1, int ox2, int ox3);
   MeshBlock* FindMeshBlock(int tgid);
+  void FindMeshBlocksInBox(const RegionSize &box, std::vector<LogicalLocation> *locs);
   void ApplyUserWorkBeforeOutput(ParameterInput *pin);
 
   // function for distributing unique "phys" bitfield IDs to BoundaryVariable objects and
@@ -352,6 +359,7 @@ class Mesh {
   SrcTermFunc UserSourceTerm_;
   TimeStepFunc UserTimeStep_;
   HistoryOutputFunc *user_history_func_;
+  HistoryBlockFunc user_history_block_func_;
   MetricFunc UserMetric_;
   ViscosityCoeffFunc ViscosityCoeff_;
   ConductionCoeffFunc ConductionCoeff_;
@@ -372,6 +380,8 @@ class Mesh {
 
   void CorrectMidpointInitialCondition();
   void ReserveMeshBlockPhysIDs();
+  void SetTaskScheduler(ParameterInput *pin);
+  void ConstructOnOwnerThreads(int nmb, const std::function<void(int)> &construct);
 
   // Mesh::LoadBalancingAndAdaptiveMeshRefinement() helper functions:
   void UpdateCostList();
@@ -422,6 +432,7 @@ class Mesh {
   void AllocateUserHistoryOutput(int n);
   void EnrollUserHistoryOutput(int i, HistoryOutputFunc my_func, const char *name,
                                UserHistoryOperation op=UserHistoryOperation::sum);
+  void EnrollUserHistoryBlockFunction(HistoryBlockFunc my_func);
   void EnrollUserMetric(MetricFunc my_func);
   void EnrollViscosityCoefficient(ViscosityCoeffFunc my_func);
   void EnrollConductionCoefficient(ConductionCoeffFunc my_func);
@@ -21,6 +21,7 @@
 #include "../athena.hpp"
 #include "../athena_arrays.hpp"
 #include "../coordinates/coordinates.hpp"
+#include "../cr/cr.hpp"
 #include "../field/field.hpp"
 #include "../globals.hpp"
 #include "../hydro/hydro.hpp"
@@ -1400,6 +1401,11 @@ void MeshRefinement::CheckRefinementCondition() {
   if (AMRFlag_ != nullptr)
     ret = AMRFlag_(pmb);
   aret = std::max(aret,ret);
+  // built-in cosmic ray criterion; on its own it may also derefine
+  if (CR_ENABLED && pmb->pcr->amr_refine) {
+    ret = pmb->pcr->CheckRefinement();
+    aret = (AMRFlag_ != nullptr) ? std::max(aret,ret) : ret;
+  }
 
   if (aret >= 0)
     deref_count_ = 0;
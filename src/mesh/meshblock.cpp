@@ -238,6 +238,11 @@ MeshBlock::MeshBlock(int igid, int ilid, LogicalLocation iloc, RegionSize input_
     pbval->AdvanceCounterPhysID(RadBoundaryVariable::max_phys_id);
   }
 
+  // the CR and diffusion kernels read the block geometry from the caches
+  if (CR_ENABLED || phydro->hdif.hydro_diffusion_defined
+      || (MAGNETIC_FIELDS_ENABLED && pfield->fdif.field_diffusion_defined))
+    pcoord->CacheGeometry();
+
   if (CR_ENABLED) {
     pcr = new CosmicRay(this, pin);
     pbval->AdvanceCounterPhysID(CellCenteredBoundaryVariable::max_phys_id);
@@ -422,6 +427,11 @@ MeshBlock::MeshBlock(int igid, int ilid, Mesh *pm, ParameterInput *pin,
     pbval->AdvanceCounterPhysID(RadBoundaryVariable::max_phys_id);
   }
 
+  // the CR and diffusion kernels read the block geometry from the caches
+  if (CR_ENABLED || phydro->hdif.hydro_diffusion_defined
+      || (MAGNETIC_FIELDS_ENABLED && pfield->fdif.field_diffusion_defined))
+    pcoord->CacheGeometry();
+
   if (CR_ENABLED) {
     pcr = new CosmicRay(this, pin);
     pbval->AdvanceCounterPhysID(CellCenteredBoundaryVariable::max_phys_id);
@@ -15,6 +15,7 @@
 // C headers
 
 // C++ headers
+#include <algorithm>  // min
 #include <cstdint>    // int64_t
 #include <iostream>
 #include <sstream>
@@ -482,6 +483,46 @@ MeshBlockTree* MeshBlockTree::FindMeshBlock(LogicalLocation tloc) {
 }
 
 
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBlockTree::GetMeshBlocksInBox(const RegionSize &box,
+//!                                             std::vector<LogicalLocation> *locs)
+//! \brief append the locations of the MeshBlocks overlapping the physical box; only the
+//!  branches of the tree overlapping it are visited
+
+void MeshBlockTree::GetMeshBlocksInBox(const RegionSize &box,
+                                       std::vector<LogicalLocation> *locs) {
+  // extent of this node; above the root grid, that of its root grid descendants
+  LogicalLocation lloc = loc_, hloc = loc_;
+  if (loc_.level < pmesh_->root_level) {
+    int sh = pmesh_->root_level - loc_.level;
+    lloc.level = hloc.level = pmesh_->root_level;
+    lloc.lx1 = loc_.lx1<<sh;
+    lloc.lx2 = loc_.lx2<<sh;
+    lloc.lx3 = loc_.lx3<<sh;
+    hloc.lx1 = std::min((loc_.lx1+1)<<sh, static_cast<std::int64_t>(pmesh_->nrbx1)) - 1;
+    hloc.lx2 = std::min((loc_.lx2+1)<<sh, static_cast<std::int64_t>(pmesh_->nrbx2)) - 1;
+    hloc.lx3 = std::min((loc_.lx3+1)<<sh, static_cast<std::int64_t>(pmesh_->nrbx3)) - 1;
+  }
+  RegionSize lsize, hsize;
+  BoundaryFlag bcs[6];
+  pmesh_->SetBlockSizeAndBoundaries(lloc, lsize, bcs);
+  pmesh_->SetBlockSizeAndBoundaries(hloc, hsize, bcs);
+  if (lsize.x1min >= box.x1max || hsize.x1max <= box.x1min) return;
+  if (pmesh_->f2 && (lsize.x2min >= box.x2max || hsize.x2max <= box.x2min)) return;
+  if (pmesh_->f3 && (lsize.x3min >= box.x3max || hsize.x3max <= box.x3min)) return;
+
+  if (pleaf_ == nullptr) {
+    locs->push_back(loc_);
+    return;
+  }
+  for (int n=0; n<nleaf_; n++) {
+    if (pleaf_[n] != nullptr)
+      pleaf_[n]->GetMeshBlocksInBox(box, locs);
+  }
+  return;
+}
+
+
 //----------------------------------------------------------------------------------------
 //! \fn void MeshBlockTree::CountMGOctets(int *noct)
 //! \brief count the number of octets for Multigrid with mesh refinement
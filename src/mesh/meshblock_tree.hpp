@@ -51,6 +51,7 @@ class MeshBlockTree {
   void Refine(int &nnew);
   void Derefine(int &ndel);
   MeshBlockTree* FindMeshBlock(LogicalLocation tloc);
+  void GetMeshBlocksInBox(const RegionSize &box, std::vector<LogicalLocation> *locs);
   void CountMeshBlock(int& count);
   void GetMeshBlockList(LogicalLocation *list, int *pglist, int& count);
   MeshBlockTree* FindNeighbor(LogicalLocation myloc, int ox1, int ox2, int ox3,
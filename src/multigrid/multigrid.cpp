@@ -13,6 +13,7 @@
 #include <cmath>
 #include <cstring>    // memset, memcpy
 #include <iostream>
+#include <limits>
 #include <sstream>    // stringstream
 #include <stdexcept>  // runtime_error
 #include <string>     // c_str()
@@ -31,7 +32,7 @@
 
 Multigrid::Multigrid(MultigridDriver *pmd, MeshBlock *pmb, int nghost) :
   pmy_driver_(pmd), pmy_block_(pmb), ngh_(nghost), nvar_(pmd->nvar_),
-  ncoeff_(pmd->ncoeff_), nmatrix_(pmd->nmatrix_), defscale_(1.0) {
+  ncoeff_(pmd->ncoeff_), nmatrix_(pmd->nmatrix_), defscale_(1.0), newcoeff_(true) {
   if (pmy_block_ != nullptr) {
     loc_ = pmy_block_->loc;
     size_ = pmy_block_->block_size;
@@ -263,10 +264,45 @@ void Multigrid::LoadCoefficients(const AthenaArray<Real> &coeff, int ngh) {
       }
     }
   }
+  newcoeff_ = true;
   return;
 }
 
 
+//----------------------------------------------------------------------------------------
+//! \fn Real Multigrid::CoefficientChange(const AthenaArray<Real> &coeff, int ngh)
+//! \brief Maximum change of the coefficients from those currently loaded, relative to
+//!        the maximum magnitude of each coefficient, including the ghost cells
+
+Real Multigrid::CoefficientChange(const AthenaArray<Real> &coeff, int ngh) {
+  const AthenaArray<Real> &cm=coeff_[nlevel_-1];
+  int is, ie, js, je, ks, ke;
+  is=js=ks=0;
+  ie=size_.nx1+2*ngh_-1, je=size_.nx2+2*ngh_-1, ke=size_.nx3+2*ngh_-1;
+  Real change = 0.0;
+  for (int v = 0; v < ncoeff_; ++v) {
+    Real dmax = 0.0, cmax = 0.0;
+    for (int mk=ks; mk<=ke; ++mk) {
+      int k = mk + ngh - ngh_;
+      for (int mj=js; mj<=je; ++mj) {
+        int j = mj + ngh - ngh_;
+#pragma omp simd reduction(max: dmax, cmax)
+        for (int mi=is; mi<=ie; ++mi) {
+          int i = mi + ngh - ngh_;
+          dmax = std::max(dmax, std::abs(coeff(v,k,j,i) - cm(v,mk,mj,mi)));
+          cmax = std::max(cmax, std::abs(cm(v,mk,mj,mi)));
+        }
+      }
+    }
+    if (dmax > change*cmax) {
+      if (cmax == 0.0) return std::numeric_limits<Real>::max();
+      change = dmax/cmax;
+    }
+  }
+  return change;
+}
+
+
 
 //----------------------------------------------------------------------------------------
 //! \fn void Multigrid::ApplyMask()
@@ -389,7 +425,7 @@ void Multigrid::RestrictBlock() {
   int is, ie, js, je, ks, ke;
   int th = false;
 #ifdef OPENMP_PARALLEL
-  if (pmy_block_ == nullptr)
+  if (pmy_block_ == nullptr || pmy_driver_->fthblock_)
     th = true;
 #endif
 
@@ -422,7 +458,7 @@ void Multigrid::ProlongateAndCorrectBlock() {
   int is, ie, js, je, ks, ke;
   int th = false;
 #ifdef OPENMP_PARALLEL
-  if (pmy_block_ == nullptr)
+  if (pmy_block_ == nullptr || pmy_driver_->fthblock_)
     th = true;
 #endif
   is=js=ks=ngh_;
@@ -451,7 +487,7 @@ void Multigrid::FMGProlongateBlock() {
   int is, ie, js, je, ks, ke;
   int th = false;
 #ifdef OPENMP_PARALLEL
-  if (pmy_block_ == nullptr)
+  if (pmy_block_ == nullptr || pmy_driver_->fthblock_)
     th = true;
 #endif
   is=js=ks=ngh_;
@@ -474,7 +510,7 @@ void Multigrid::SmoothBlock(int color) {
   int is, ie, js, je, ks, ke;
   int th = false;
 #ifdef OPENMP_PARALLEL
-  if (pmy_block_ == nullptr)
+  if (pmy_block_ == nullptr || pmy_driver_->fthblock_)
     th = true;
 #endif
   is = js = ks = ngh_;
@@ -496,7 +532,7 @@ void Multigrid::CalculateDefectBlock() {
   int is, ie, js, je, ks, ke;
   int th = false;
 #ifdef OPENMP_PARALLEL
-  if (pmy_block_ == nullptr)
+  if (pmy_block_ == nullptr || pmy_driver_->fthblock_)
     th = true;
 #endif
   is = js = ks = ngh_;
@@ -519,7 +555,7 @@ void Multigrid::CalculateFASRHSBlock() {
   int is, ie, js, je, ks, ke;
   int th = false;
 #ifdef OPENMP_PARALLEL
-  if (pmy_block_ == nullptr)
+  if (pmy_block_ == nullptr || pmy_driver_->fthblock_)
     th = true;
 #endif
   is = js = ks = ngh_;
@@ -539,10 +575,15 @@ void Multigrid::CalculateFASRHSBlock() {
 void Multigrid::CalculateMatrixBlock(Real dt) {
   int is, ie, js, je, ks, ke;
   is=js=ks=ngh_;
+  int th = false;
+#ifdef OPENMP_PARALLEL
+  if (pmy_block_ == nullptr || pmy_driver_->fthblock_)
+    th = true;
+#endif
   for (int lev = nlevel_ - 1; lev >= 0; lev--) {
     int ll = nlevel_ - lev - 1;
     ie=is+(size_.nx1>>ll)-1, je=js+(size_.nx2>>ll)-1, ke=ks+(size_.nx3>>ll)-1;
-    CalculateMatrix(matrix_[lev], coeff_[lev], dt, -ll, is, ie, js, je, ks, ke, false);
+    CalculateMatrix(matrix_[lev], coeff_[lev], dt, -ll, is, ie, js, je, ks, ke, th);
   }
 
   return;
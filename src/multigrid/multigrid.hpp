@@ -35,8 +35,9 @@ class MeshBlock;
 class ParameterInput;
 class Coordinates;
 
-enum class MGVariable {src, u, coeff};
+enum class MGVariable {src, u, coeff, def};
 enum class MGNormType {max, l1, l2};
+enum class MGKrylovType {none, bicgstab, gmres};
 
 constexpr int minth_ = 8;
 
@@ -102,6 +103,7 @@ class Multigrid {
   void LoadFinestData(const AthenaArray<Real> &src, int ns, int ngh);
   void LoadSource(const AthenaArray<Real> &src, int ns, int ngh, Real fac);
   void LoadCoefficients(const AthenaArray<Real> &coeff, int ngh);
+  Real CoefficientChange(const AthenaArray<Real> &coeff, int ngh);
   void ApplyMask();
   void RestrictFMGSource();
   void RetrieveResult(AthenaArray<Real> &dst, int ns, int ngh);
@@ -123,6 +125,13 @@ class Multigrid {
   Real GetCoarsestData(MGVariable type, int n);
   void SetData(MGVariable type, int n, int k, int j, int i, Real v);
 
+  // vector operations on the finest level for the Krylov outer iteration
+  void AllocateKrylovVectors(int nvec);
+  void CopyToKrylov(int n, MGVariable type);
+  void CopyFromKrylov(MGVariable type, int n);
+  void CombineKrylov(int n, Real a, int na, Real b, int nb);
+  Real DotKrylov(int na, int nb);
+
   void CalculateMultipoleCoefficients(AthenaArray<Real> &mpcoeff);
   void CalculateCenterOfMass(AthenaArray<Real> &mpcoeff);
 
@@ -174,7 +183,9 @@ class Multigrid {
   int nlevel_, ngh_, nvar_, ncoeff_, nmatrix_, current_level_;
   Real rdx_, rdy_, rdz_;
   Real defscale_;
+  bool newcoeff_; // coefficients loaded since the matrix was calculated
   AthenaArray<Real> *u_, *def_, *src_, *uold_, *coeff_, *matrix_;
+  AthenaArray<Real> krylov_;
   MGCoordinates *coord_, *ccoord_;
 
  private:
@@ -217,6 +228,20 @@ class MultigridDriver {
   void SolveFMGCycle();
   void SolveIterative();
   void SolveIterativeFixedTimes();
+  void SolveKrylov();
+  void SolveBiCGStab();
+  void SolveGMRES();
+
+  // Krylov helpers, implemented in multigrid_krylov.cpp
+  void KrylovCopy(int n, MGVariable type);
+  void KrylovLoad(MGVariable type, int n);
+  void KrylovCombine(int n, Real a, int na, Real b, int nb);
+  Real KrylovDot(int na, int nb);
+  Real KrylovNorm(int n);
+  void KrylovDefect(int dst, int src);
+  void KrylovOperator(int dst, int src);
+  void KrylovPrecondition(int dst, int src);
+  bool KrylovConverged(Real def, int n);
 
   virtual void SolveCoarsestGrid();
   Real CalculateDefectNorm(MGNormType nrm, int n);
@@ -275,6 +300,7 @@ class MultigridDriver {
   std::vector<Multigrid*> vmg_;
   Multigrid *mgroot_;
   bool fsubtract_average_, ffas_, redblack_, needinit_, fshowdef_;
+  bool fthblock_; // thread inside the blocks rather than over them
   Real last_ave_;
   Real eps_;
   int niter_, npresmooth_, npostsmooth_;
@@ -282,6 +308,16 @@ class MultigridDriver {
   int coffset_;
   int fprolongation_;
 
+  // the matrix is rebuilt only on blocks with new coefficients, and on all blocks
+  // when dt changes by more than mtol_ relative to mdt_
+  Real mtol_, mdt_;
+
+  // Krylov outer iteration preconditioned with one V-cycle
+  MGKrylovType krylov_;
+  int nrestart_;
+  bool faffine_;
+  std::vector<Real> defhistory_;
+
   // for mesh refinement
   std::vector<MGOctet> *octets_;
   std::unordered_map<LogicalLocation, int, LogicalLocationHash> *octetmap_;
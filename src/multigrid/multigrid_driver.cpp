@@ -45,8 +45,10 @@ MultigridDriver::MultigridDriver(Mesh *pm, MGBoundaryFunc *MGBoundary,
     maxreflevel_(pm->multilevel?pm->max_level-pm->root_level:0),
     nrbx1_(pm->nrbx1), nrbx2_(pm->nrbx2), nrbx3_(pm->nrbx3), srcmask_(MGSourceMask),
     coeffmask_(MGCoeffMask), pmy_mesh_(pm), fsubtract_average_(false),
-    ffas_(pm->multilevel), redblack_(true), needinit_(true), fshowdef_(false), eps_(-1.0),
+    ffas_(pm->multilevel), redblack_(true), needinit_(true), fshowdef_(false),
+    fthblock_(false), eps_(-1.0),
     niter_(-1), npresmooth_(1), npostsmooth_(1), coffset_(0), fprolongation_(0),
+    mtol_(0.0), mdt_(-1.0), krylov_(MGKrylovType::none), nrestart_(10), faffine_(false),
     mporder_(-1), nmpcoeff_(0), mpo_(3), autompo_(false), nodipole_(false), nb_rank_(0) {
   std::cout << std::scientific << std::setprecision(15);
 
@@ -417,6 +419,9 @@ void MultigridDriver::SetupMultigrid(Real dt, bool ftrivial) {
 
   if (pmy_mesh_->amr_updated)
     needinit_ = true;
+  bool fnewmatrix = needinit_;
+  // with fewer blocks than threads, the threads share the work inside each block
+  fthblock_ = (nthreads_ > 1 && static_cast<int>(vmg_.size()) < nthreads_);
 
   // note: the level of an Octet is one level lower than the data stored there
   if (nreflevel_ > 0 && needinit_) {
@@ -505,10 +510,31 @@ void MultigridDriver::SetupMultigrid(Real dt, bool ftrivial) {
   }
 
   if (!ftrivial) {
-    if (ncoeff_ > 0)
-      SetupCoefficients();
-    if (nmatrix_ > 0)
-      CalculateMatrix(dt);
+    if (ncoeff_ > 0 || nmatrix_ > 0) {
+      if (fnewmatrix || std::abs(dt - mdt_) > mtol_*std::abs(mdt_)) {
+        for (auto itr = vmg_.begin(); itr < vmg_.end(); itr++)
+          (*itr)->newcoeff_ = true;
+        mdt_ = dt;
+      }
+      // keep all the matrices if no block has new coefficients
+      int nnew = 0;
+      for (auto itr = vmg_.begin(); itr < vmg_.end(); itr++) {
+        if ((*itr)->newcoeff_) nnew++;
+      }
+#ifdef MPI_PARALLEL
+      MPI_Allreduce(MPI_IN_PLACE, &nnew, 1, MPI_INT, MPI_SUM, MPI_COMM_MULTIGRID);
+#endif
+      if (fshowdef_ && Globals::my_rank == 0)
+        std::cout << "Multigrid matrix rebuilt on " << nnew << " blocks" << std::endl;
+      if (nnew > 0) {
+        if (ncoeff_ > 0)
+          SetupCoefficients();
+        if (nmatrix_ > 0)
+          CalculateMatrix(dt);
+      }
+      for (auto itr = vmg_.begin(); itr < vmg_.end(); itr++)
+        (*itr)->newcoeff_ = false;
+    }
 
     if (mode_ == 0) { // FMG
 #pragma omp parallel for num_threads(nthreads_)
@@ -536,7 +562,8 @@ void MultigridDriver::SetupCoefficients() {
 #pragma omp parallel for num_threads(nthreads_)
   for (auto itr = vmg_.begin(); itr < vmg_.end(); itr++) {
     Multigrid *pmg = *itr;
-    pmg->RestrictCoefficients();
+    if (pmg->newcoeff_)
+      pmg->RestrictCoefficients();
   }
   TransferCoefficientFromBlocksToRoot();
   if (nreflevel_ > 0) {
@@ -584,7 +611,9 @@ void MultigridDriver::SetupCoefficients() {
         pmg->current_level_ = lev;
         pmg->pmgbval->StartReceivingMultigrid(BoundaryQuantity::mg_coeff, false);
       }
-#pragma omp for nowait
+      // the receive below does not wait for the blocks on this rank, so all the blocks
+      // must have sent before any of them receives
+#pragma omp for
       for (auto itr = vmg_.begin(); itr < vmg_.end(); itr++) {
         Multigrid *pmg = *itr;
         pmg->pmgbval->SendMultigridBoundaryBuffers(BoundaryQuantity::mg_coeff, false);
@@ -942,7 +971,9 @@ void MultigridDriver::SolveFMGCycle() {
   fmglevel_ = ntotallevel_ - 1;
   if (fsubtract_average_)
     SubtractAverage(MGVariable::u);
-  if (eps_ >= 0.0)
+  if (krylov_ != MGKrylovType::none)
+    SolveKrylov();
+  else if (eps_ >= 0.0)
     SolveIterative();
   else
     SolveIterativeFixedTimes();
@@ -1283,10 +1314,11 @@ void MultigridDriver::RestrictOctets() {
 //! \brief Calculate Matrix elements
 
 void MultigridDriver::CalculateMatrix(Real dt) {
-#pragma omp parallel for num_threads(nthreads_)
+#pragma omp parallel for num_threads(nthreads_) if (!fthblock_)
   for (auto itr = vmg_.begin(); itr < vmg_.end(); itr++) {
     Multigrid *pmg = *itr;
-    pmg->CalculateMatrixBlock(dt);
+    if (pmg->newcoeff_)
+      pmg->CalculateMatrixBlock(dt);
   }
   if (nreflevel_ > 0) {
     const int &ngh = mgroot_->ngh_;
@@ -0,0 +1,477 @@
+//========================================================================================
+// Athena++ astrophysical MHD code
+// Copyright(C) 2014 James M. Stone <jmstone@princeton.edu> and other code contributors
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+//! \file multigrid_krylov.cpp
+//! \brief Krylov (BiCGStab / restarted GMRES) outer iteration of the Multigrid solver
+//!        using one V-cycle as the right preconditioner
+//!
+//! The outer iteration works on the finest level of the MeshBlocks. A V-cycle started
+//! from zero is a fixed linear operator as long as the smoother colors are not swapped
+//! between the cycles, so coffset_ is restored after each application. With
+//! inhomogeneous (user or multipole) boundary conditions both the operator and the
+//! V-cycle are affine; their constant parts, A(0) and M(0), are computed once per solve
+//! and subtracted so that the Krylov method sees linear operators.
+
+// C headers
+
+// C++ headers
+#include <algorithm>
+#include <cmath>
+#include <iomanip>    // setprecision
+#include <iostream>   // endl
+#include <sstream>    // sstream
+#include <vector>
+
+// Athena++ headers
+#include "../athena.hpp"
+#include "../athena_arrays.hpp"
+#include "../globals.hpp"
+#include "../mesh/mesh.hpp"
+#include "multigrid.hpp"
+
+#ifdef MPI_PARALLEL
+#include <mpi.h>
+#endif
+
+namespace {
+// indices of the vectors common to both methods; solver work vectors follow
+constexpr int KX = 0;  // solution
+constexpr int KB = 1;  // right hand side
+constexpr int KD = 2;  // defect of the zero solution, b - A(0)
+constexpr int KM = 3;  // V-cycle applied to the zero source, M(0)
+constexpr int KS = 4;  // first work vector
+constexpr int nbicgstab = 6;
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void Multigrid::AllocateKrylovVectors(int nvec)
+//! \brief allocate nvec vectors with the size of the finest level
+
+void Multigrid::AllocateKrylovVectors(int nvec) {
+  if (krylov_.IsAllocated() && krylov_.GetDim5() == nvec)
+    return;
+  krylov_.DeleteAthenaArray();
+  krylov_.NewAthenaArray(nvec, nvar_, size_.nx3+2*ngh_, size_.nx2+2*ngh_,
+                         size_.nx1+2*ngh_);
+  return;
+}
+
+
+//----------------------------------------------------------------------------------------
+//! \fn void Multigrid::CopyToKrylov(int n, MGVariable type)
+//! \brief copy the active zone of the finest level data to the Krylov vector n
+
+void Multigrid::CopyToKrylov(int n, MGVariable type) {
+  const AthenaArray<Real> &src = (type == MGVariable::src) ? src_[nlevel_-1] :
+                                 (type == MGVariable::def) ? def_[nlevel_-1] :
+                                 u_[nlevel_-1];
+  int is, ie, js, je, ks, ke;
+  is = js = ks = ngh_;
+  ie = is+size_.nx1-1, je = js+size_.nx2-1, ke = ks+size_.nx3-1;
+  for (int v=0; v<nvar_; ++v) {
+    for (int k=ks; k<=ke; ++k) {
+      for (int j=js; j<=je; ++j) {
+#pragma omp simd
+        for (int i=is; i<=ie; ++i)
+          krylov_(n,v,k,j,i) = src(v,k,j,i);
+      }
+    }
+  }
+  return;
+}
+
+
+//----------------------------------------------------------------------------------------
+//! \fn void Multigrid::CopyFromKrylov(MGVariable type, int n)
+//! \brief copy the Krylov vector n to the active zone of the finest level data
+
+void Multigrid::CopyFromKrylov(MGVariable type, int n) {
+  AthenaArray<Real> &dst = (type == MGVariable::src) ? src_[nlevel_-1] :
+                           (type == MGVariable::def) ? def_[nlevel_-1] :
+                           u_[nlevel_-1];
+  int is, ie, js, je, ks, ke;
+  is = js = ks = ngh_;
+  ie = is+size_.nx1-1, je = js+size_.nx2-1, ke = ks+size_.nx3-1;
+  for (int v=0; v<nvar_; ++v) {
+    for (int k=ks; k<=ke; ++k) {
+      for (int j=js; j<=je; ++j) {
+#pragma omp simd
+        for (int i=is; i<=ie; ++i)
+          dst(v,k,j,i) = krylov_(n,v,k,j,i);
+      }
+    }
+  }
+  return;
+}
+
+
+//----------------------------------------------------------------------------------------
+//! \fn void Multigrid::CombineKrylov(int n, Real a, int na, Real b, int nb)
+//! \brief set the Krylov vector n to a*(vector na) + b*(vector nb); n may be na or nb
+
+void Multigrid::CombineKrylov(int n, Real a, int na, Real b, int nb) {
+  int is, ie, js, je, ks, ke;
+  is = js = ks = ngh_;
+  ie = is+size_.nx1-1, je = js+size_.nx2-1, ke = ks+size_.nx3-1;
+  for (int v=0; v<nvar_; ++v) {
+    for (int k=ks; k<=ke; ++k) {
+      for (int j=js; j<=je; ++j) {
+#pragma omp simd
+        for (int i=is; i<=ie; ++i)
+          krylov_(n,v,k,j,i) = a*krylov_(na,v,k,j,i) + b*krylov_(nb,v,k,j,i);
+      }
+    }
+  }
+  return;
+}
+
+
+//----------------------------------------------------------------------------------------
+//! \fn Real Multigrid::DotKrylov(int na, int nb)
+//! \brief volume-weighted inner product of the Krylov vectors na and nb
+
+Real Multigrid::DotKrylov(int na, int nb) {
+  int is, ie, js, je, ks, ke;
+  is = js = ks = ngh_;
+  ie = is+size_.nx1-1, je = js+size_.nx2-1, ke = ks+size_.nx3-1;
+  Real dot = 0.0;
+  for (int v=0; v<nvar_; ++v) {
+    for (int k=ks; k<=ke; ++k) {
+      for (int j=js; j<=je; ++j) {
+#pragma omp simd reduction(+: dot)
+        for (int i=is; i<=ie; ++i)
+          dot += krylov_(na,v,k,j,i)*krylov_(nb,v,k,j,i);
+      }
+    }
+  }
+  return dot*rdx_*rdy_*rdz_*defscale_;
+}
+
+
+//----------------------------------------------------------------------------------------
+//! \fn void MultigridDriver::KrylovCopy(int n, MGVariable type)
+//! \brief copy the finest level data to the Krylov vector n on all the MeshBlocks
+
+void MultigridDriver::KrylovCopy(int n, MGVariable type) {
+#pragma omp parallel for num_threads(nthreads_)
+  for (auto itr = vmg_.begin(); itr < vmg_.end(); itr++) {
+    Multigrid *pmg = *itr;
+    pmg->CopyToKrylov(n, type);
+  }
+  return;
+}
+
+
+//----------------------------------------------------------------------------------------
+//! \fn void MultigridDriver::KrylovLoad(MGVariable type, int n)
+//! \brief copy the Krylov vector n to the finest level data on all the MeshBlocks
+
+void MultigridDriver::KrylovLoad(MGVariable type, int n) {
+#pragma omp parallel for num_threads(nthreads_)
+  for (auto itr = vmg_.begin(); itr < vmg_.end(); itr++) {
+    Multigrid *pmg = *itr;
+    pmg->CopyFromKrylov(type, n);
+  }
+  return;
+}
+
+
+//----------------------------------------------------------------------------------------
+//! \fn void MultigridDriver::KrylovCombine(int n, Real a, int na, Real b, int nb)
+//! \brief vector n = a*(vector na) + b*(vector nb) on all the MeshBlocks
+
+void MultigridDriver::KrylovCombine(int n, Real a, int na, Real b, int nb) {
+#pragma omp parallel for num_threads(nthreads_)
+  for (auto itr = vmg_.begin(); itr < vmg_.end(); itr++) {
+    Multigrid *pmg = *itr;
+    pmg->CombineKrylov(n, a, na, b, nb);
+  }
+  return;
+}
+
+
+//----------------------------------------------------------------------------------------
+//! \fn Real MultigridDriver::KrylovDot(int na, int nb)
+//! \brief global inner product of the Krylov vectors na and nb
+
+Real MultigridDriver::KrylovDot(int na, int nb) {
+  Real dot = 0.0;
+#pragma omp parallel for reduction(+ : dot) num_threads(nthreads_)
+  for (auto itr = vmg_.begin(); itr < vmg_.end(); itr++) {
+    Multigrid *pmg = *itr;
+    dot += pmg->DotKrylov(na, nb);
+  }
+#ifdef MPI_PARALLEL
+  MPI_Allreduce(MPI_IN_PLACE, &dot, 1, MPI_ATHENA_REAL, MPI_SUM, MPI_COMM_MULTIGRID);
+#endif
+  return dot;
+}
+
+
+//----------------------------------------------------------------------------------------
+//! \fn Real MultigridDriver::KrylovNorm(int n)
+//! \brief L2 norm of the Krylov vector n, normalized as in CalculateDefectNorm
+
+Real MultigridDriver::KrylovNorm(int n) {
+  Real vol = (mgroot_->size_.x1max-mgroot_->size_.x1min)
+           * (mgroot_->size_.x2max-mgroot_->size_.x2min)
+           * (mgroot_->size_.x3max-mgroot_->size_.x3min);
+  return std::sqrt(KrylovDot(n, n)/vol);
+}
+
+
+//----------------------------------------------------------------------------------------
+//! \fn void MultigridDriver::KrylovDefect(int dst, int src)
+//! \brief vector dst = b - A(vector src), including the boundary conditions
+
+void MultigridDriver::KrylovDefect(int dst, int src) {
+  KrylovLoad(MGVariable::u, src);
+  mgtlist_->SetMGTaskListBoundaryCommunication();
+  mgtlist_->DoTaskListOneStage(this);
+#pragma omp parallel for num_threads(nthreads_)
+  for (auto itr = vmg_.begin(); itr < vmg_.end(); itr++) {
+    Multigrid *pmg = *itr;
+    pmg->CalculateDefectBlock();
+    pmg->CopyToKrylov(dst, MGVariable::def);
+  }
+  return;
+}
+
+
+//----------------------------------------------------------------------------------------
+//! \fn void MultigridDriver::KrylovOperator(int dst, int src)
+//! \brief vector dst = A(vector src) - A(0), the linear part of the operator
+
+void MultigridDriver::KrylovOperator(int dst, int src) {
+  KrylovDefect(dst, src);
+  KrylovCombine(dst, 1.0, KD, -1.0, dst);
+  return;
+}
+
+
+//----------------------------------------------------------------------------------------
+//! \fn void MultigridDriver::KrylovPrecondition(int dst, int src)
+//! \brief vector dst = M(vector src) - M(0), one V-cycle started from zero
+
+void MultigridDriver::KrylovPrecondition(int dst, int src) {
+  KrylovLoad(MGVariable::src, src);
+#pragma omp parallel for num_threads(nthreads_)
+  for (auto itr = vmg_.begin(); itr < vmg_.end(); itr++) {
+    Multigrid *pmg = *itr;
+    pmg->ZeroClearData();
+  }
+  int coffset = coffset_;
+  SolveVCycle(npresmooth_, npostsmooth_);
+  coffset_ = coffset;
+  KrylovCopy(dst, MGVariable::u);
+  if (faffine_)
+    KrylovCombine(dst, 1.0, dst, -1.0, KM);
+  KrylovLoad(MGVariable::src, KB);
+  return;
+}
+
+
+//----------------------------------------------------------------------------------------
+//! \fn bool MultigridDriver::KrylovConverged(Real def, int n)
+//! \brief record the defect after n preconditioned steps and check the convergence
+
+bool MultigridDriver::KrylovConverged(Real def, int n) {
+  defhistory_.push_back(def);
+  if (eps_ < 0.0)
+    return (n >= niter_);
+  if (def <= eps_)
+    return true;
+  if (eps_ == 0.0 && n > 0 && def > 0.9*defhistory_[defhistory_.size()-2])
+    return true;
+  if (n > 100) {
+    if (Globals::my_rank == 0) {
+      std::cout
+          << "### Warning in MultigridDriver::SolveKrylov" << std::endl
+          << "Aborting because the # iterations is too large, n > 100." << std::endl
+          << "Check the solution as it may not be accurate enough." << std::endl;
+    }
+    return true;
+  }
+  return false;
+}
+
+
+//----------------------------------------------------------------------------------------
+//! \fn void MultigridDriver::SolveKrylov()
+//! \brief Solve with the Krylov outer iteration starting from the current solution
+
+void MultigridDriver::SolveKrylov() {
+  int nvec = KS + ((krylov_ == MGKrylovType::gmres) ? nrestart_ + 3 : nbicgstab);
+#pragma omp parallel for num_threads(nthreads_)
+  for (auto itr = vmg_.begin(); itr < vmg_.end(); itr++) {
+    Multigrid *pmg = *itr;
+    pmg->AllocateKrylovVectors(nvec);
+  }
+  faffine_ = false;
+  for (int i = 0; i < 6; ++i) {
+    if (mg_mesh_bcs_[i] == BoundaryFlag::user
+        || mg_mesh_bcs_[i] == BoundaryFlag::mg_multipole)
+      faffine_ = true;
+  }
+
+  KrylovCopy(KX, MGVariable::u);
+  KrylovCopy(KB, MGVariable::src);
+  if (faffine_) {
+    KrylovCombine(KD, 0.0, KB, 0.0, KB);
+    KrylovDefect(KD, KD);
+    faffine_ = false; // M(0) itself is taken as is
+    KrylovCombine(KM, 0.0, KB, 0.0, KB);
+    KrylovPrecondition(KM, KM);
+    faffine_ = true;
+  } else {
+    KrylovCombine(KD, 1.0, KB, 0.0, KB);
+  }
+
+  defhistory_.clear();
+  if (krylov_ == MGKrylovType::gmres)
+    SolveGMRES();
+  else
+    SolveBiCGStab();
+
+  // return the solution and its defect to the finest level
+  KrylovLoad(MGVariable::u, KX);
+  mgtlist_->SetMGTaskListBoundaryCommunication();
+  mgtlist_->DoTaskListOneStage(this);
+  Real def = 0.0;
+  for (int v = 0; v < nvar_; ++v)
+    def += CalculateDefectNorm(MGNormType::l2, v);
+  if (fsubtract_average_)
+    SubtractAverage(MGVariable::u);
+
+  if (Globals::my_rank == 0 && (fshowdef_ || (pmy_mesh_->ncycle_out != 0
+                                && pmy_mesh_->ncycle%pmy_mesh_->ncycle_out == 0))) {
+    std::stringstream msg;
+    msg << std::scientific << std::setprecision(6)
+        << ((krylov_ == MGKrylovType::gmres) ? "GMRES" : "BiCGStab")
+        << " + V-cycle: niter = " << defhistory_.size() - 1
+        << ", final defect L2-norm = " << def << std::endl << "  defect history :";
+    for (Real d : defhistory_)
+      msg << " " << d;
+    std::cout << msg.str() << std::endl;
+  }
+  return;
+}
+
+
+//----------------------------------------------------------------------------------------
+//! \fn void MultigridDriver::SolveBiCGStab()
+//! \brief right-preconditioned BiCGStab; each half step applies one V-cycle
+
+void MultigridDriver::SolveBiCGStab() {
+  constexpr int r = KS, rh = KS+1, p = KS+2, v = KS+3, t = KS+4, z = KS+5;
+  KrylovDefect(r, KX);
+  KrylovCombine(rh, 1.0, r, 0.0, r);
+  KrylovCombine(p, 1.0, r, 0.0, r);
+  Real rho = KrylovDot(rh, r);
+  int n = 0;
+  if (KrylovConverged(KrylovNorm(r), n))
+    return;
+  while (true) {
+    KrylovPrecondition(z, p);
+    KrylovOperator(v, z);
+    Real rhv = KrylovDot(rh, v);
+    if (rhv == 0.0 || rho == 0.0) { // breakdown; restart from the current residual
+      KrylovCombine(rh, 1.0, r, 0.0, r);
+      KrylovCombine(p, 1.0, r, 0.0, r);
+      rho = KrylovDot(rh, r);
+      if (rho == 0.0) break;
+      continue;
+    }
+    Real alpha = rho/rhv;
+    KrylovCombine(KX, 1.0, KX, alpha, z);
+    KrylovCombine(r, 1.0, r, -alpha, v); // r is now s
+    if (KrylovConverged(KrylovNorm(r), ++n))
+      break;
+    KrylovPrecondition(z, r);
+    KrylovOperator(t, z);
+    Real tt = KrylovDot(t, t);
+    Real omega = (tt > 0.0) ? KrylovDot(t, r)/tt : 0.0;
+    KrylovCombine(KX, 1.0, KX, omega, z);
+    KrylovCombine(r, 1.0, r, -omega, t);
+    if (KrylovConverged(KrylovNorm(r), ++n) || omega == 0.0)
+      break;
+    Real rhonew = KrylovDot(rh, r);
+    Real beta = (rhonew/rho)*(alpha/omega);
+    rho = rhonew;
+    KrylovCombine(p, 1.0, p, -omega, v);
+    KrylovCombine(p, 1.0, r, beta, p);
+  }
+  return;
+}
+
+
+//----------------------------------------------------------------------------------------
+//! \fn void MultigridDriver::SolveGMRES()
+//! \brief right-preconditioned GMRES restarted every nrestart_ steps; the preconditioned
+//!        basis is not stored, one more V-cycle is applied to the update at the restart
+
+void MultigridDriver::SolveGMRES() {
+  constexpr int w = KS, z = KS+1, kv = KS+2;
+  const int m = nrestart_;
+  Real vol = (mgroot_->size_.x1max-mgroot_->size_.x1min)
+           * (mgroot_->size_.x2max-mgroot_->size_.x2min)
+           * (mgroot_->size_.x3max-mgroot_->size_.x3min);
+  Real rvol = 1.0/std::sqrt(vol);
+  std::vector<Real> h((m+1)*m), g(m+1), cs(m), sn(m), y(m);
+  int n = 0;
+  bool fconv = false;
+  KrylovDefect(w, KX);
+  Real beta = std::sqrt(KrylovDot(w, w));
+  fconv = KrylovConverged(beta*rvol, n);
+  while (!fconv && beta > 0.0) {
+    KrylovCombine(kv, 1.0/beta, w, 0.0, w);
+    std::fill(g.begin(), g.end(), 0.0);
+    g[0] = beta;
+    int nj = 0;
+    for (int j = 0; j < m; ++j) {
+      KrylovPrecondition(z, kv+j);
+      KrylovOperator(w, z);
+      // modified Gram-Schmidt
+      for (int i = 0; i <= j; ++i) {
+        h[i*m+j] = KrylovDot(w, kv+i);
+        KrylovCombine(w, 1.0, w, -h[i*m+j], kv+i);
+      }
+      Real hn = std::sqrt(KrylovDot(w, w));
+      if (hn > 0.0)
+        KrylovCombine(kv+j+1, 1.0/hn, w, 0.0, w);
+      // Givens rotations
+      for (int i = 0; i < j; ++i) {
+        Real tmp = cs[i]*h[i*m+j] + sn[i]*h[(i+1)*m+j];
+        h[(i+1)*m+j] = -sn[i]*h[i*m+j] + cs[i]*h[(i+1)*m+j];
+        h[i*m+j] = tmp;
+      }
+      Real d = std::sqrt(SQR(h[j*m+j]) + SQR(hn));
+      cs[j] = h[j*m+j]/d;
+      sn[j] = hn/d;
+      h[j*m+j] = d;
+      g[j+1] = -sn[j]*g[j];
+      g[j] = cs[j]*g[j];
+      nj = j + 1;
+      fconv = KrylovConverged(std::abs(g[j+1])*rvol, ++n);
+      if (fconv || hn == 0.0) break;
+    }
+    // x += M(V y)
+    for (int i = nj - 1; i >= 0; --i) {
+      y[i] = g[i];
+      for (int l = i + 1; l < nj; ++l)
+        y[i] -= h[i*m+l]*y[l];
+      y[i] /= h[i*m+i];
+    }
+    KrylovCombine(z, y[0], kv, 0.0, kv);
+    for (int i = 1; i < nj; ++i)
+      KrylovCombine(z, 1.0, z, y[i], kv+i);
+    KrylovPrecondition(z, z);
+    KrylovCombine(KX, 1.0, KX, 1.0, z);
+    if (fconv) break;
+    KrylovDefect(w, KX);
+    beta = std::sqrt(KrylovDot(w, w));
+  }
+  return;
+}
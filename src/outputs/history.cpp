@@ -26,6 +26,7 @@
 #include "../chem_rad/chem_rad.hpp"
 #include "../coordinates/coordinates.hpp"
 #include "../cr/cr.hpp"
+#include "../crdiffusion/crdiffusion.hpp"
 #include "../field/field.hpp"
 #include "../globals.hpp"
 #include "../gravity/gravity.hpp"
@@ -39,9 +40,9 @@
 // NEW_OUTPUT_TYPES:
 
 // "3" for 1-KE, 2-KE, 3-KE additional columns (come before tot-E)
-// 14 radiation variables, 4 cosmic ray variables
+// 14 radiation variables, 4 cosmic ray variables, 1 CR diffusion energy
 #define NHISTORY_VARS ((NHYDRO) + (SELF_GRAVITY_ENABLED > 0) + (NFIELD) + 3 + (NSCALARS) \
-                      +(NRAD) + (NCR))
+                      +(NRAD) + (NCR) + (CRDIFFUSION_ENABLED > 0))
 
 //----------------------------------------------------------------------------------------
 //! \fn void HistoryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin, bool flag)
@@ -58,6 +59,7 @@ void HistoryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin, bool flag) {
   }
   const int nhistory_output = nhistory_vars + pm->nuser_history_output_;
   std::unique_ptr<Real[]> hst_data(new Real[nhistory_output]);
+  std::unique_ptr<Real[]> usr_block_data(new Real[pm->nuser_history_output_]);
   // initialize built-in variable sums to 0.0
   for (int n=0; n<nhistory_vars; ++n) hst_data[n] = 0.0;
   // initialize user-defined history outputs depending on the requested operation
@@ -86,6 +88,7 @@ void HistoryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin, bool flag) {
     OrbitalAdvection *porb = pmb->porb;
     NRRadiation *prad = pmb->pnrrad;
     CosmicRay *pcr = pmb->pcr;
+    CRDiffusion *pcrdiff = pmb->pcrdiff;
 
     // Sum history variables over cells. Note ghost cells are never included in sums
     if(porb->orbital_advection_defined
@@ -190,6 +193,11 @@ void HistoryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin, bool flag) {
               hst_data[prev_out + 2] += vol(i)*pcr->u_cr(IFR2,k,j,i);
               hst_data[prev_out + 3] += vol(i)*pcr->u_cr(IFR3,k,j,i);
             }
+            if (CRDIFFUSION_ENABLED) {
+              constexpr int prev_out = NHYDRO + 3 + (SELF_GRAVITY_ENABLED > 0) + NFIELD +
+                                  NSCALARS + NRAD + NCR;
+              hst_data[prev_out] += vol(i)*pcrdiff->ecr(0,k,j,i);
+            }
           }
         }
       }
@@ -293,13 +301,26 @@ void HistoryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin, bool flag) {
               hst_data[prev_out + 2] += vol(i)*pcr->u_cr(IFR2,k,j,i);
               hst_data[prev_out + 3] += vol(i)*pcr->u_cr(IFR3,k,j,i);
             }
+            if (CRDIFFUSION_ENABLED) {
+              constexpr int prev_out = NHYDRO + 3 + (SELF_GRAVITY_ENABLED > 0) + NFIELD +
+                                  NSCALARS + NRAD + NCR;
+              hst_data[prev_out] += vol(i)*pcrdiff->ecr(0,k,j,i);
+            }
           }
         }
       }
     }
-    for (int n=0; n<pm->nuser_history_output_; n++) { // user-defined history outputs
-      if (pm->user_history_func_[n] != nullptr) {
-        Real usr_val = pm->user_history_func_[n](pmb, n);
+    // user-defined history outputs: those enrolled without a function of their own are
+    // filled together by the history block function, in a single sweep of the MeshBlock
+    if (pm->user_history_block_func_ != nullptr) {
+      for (int n=0; n<pm->nuser_history_output_; n++) usr_block_data[n] = 0.0;
+      pm->user_history_block_func_(pmb, usr_block_data.get());
+    }
+    for (int n=0; n<pm->nuser_history_output_; n++) {
+      if (pm->user_history_func_[n] != nullptr
+          || pm->user_history_block_func_ != nullptr) {
+        Real usr_val = (pm->user_history_func_[n] != nullptr) ?
+                       pm->user_history_func_[n](pmb, n) : usr_block_data[n];
         switch (pm->user_history_ops_[n]) {
           case UserHistoryOperation::sum:
             // TODO(felker): this should automatically volume-weight the sum, like the
@@ -319,35 +340,51 @@ void HistoryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin, bool flag) {
   }  // end loop over MeshBlocks
 
 #ifdef MPI_PARALLEL
-  // sum built-in/predefined hst_data[] over all ranks
-  if (Globals::my_rank == 0) {
-    MPI_Reduce(MPI_IN_PLACE, hst_data.get(), nhistory_vars, MPI_ATHENA_REAL, MPI_SUM, 0,
-               MPI_COMM_WORLD);
-  } else {
-    MPI_Reduce(hst_data.get(), hst_data.get(), nhistory_vars, MPI_ATHENA_REAL, MPI_SUM,
-               0, MPI_COMM_WORLD);
-  }
-  // apply separate chosen operations to each user-defined history output
+  // batch the reductions whatever the number of outputs: the built-in variables and
+  // the summed user-defined outputs in one MPI_SUM, and the maxima and (negated)
+  // minima of the user-defined outputs, if any, in one MPI_MAX
+  std::unique_ptr<Real[]> max_data(new Real[pm->nuser_history_output_ + 1]);
+  std::unique_ptr<int[]> usr_index(new int[pm->nuser_history_output_ + 1]);
+  int nsum = nhistory_vars, nmax = 0;
   for (int n=0; n<pm->nuser_history_output_; n++) {
-    Real *usr_hst_data = hst_data.get() + nhistory_vars + n;
-    MPI_Op usr_op;
+    Real &val = hst_data[nhistory_vars+n];
     switch (pm->user_history_ops_[n]) {
       case UserHistoryOperation::sum:
-        usr_op = MPI_SUM;
+        usr_index[n] = nsum;
+        hst_data[nsum++] = val;
         break;
       case UserHistoryOperation::max:
-        usr_op = MPI_MAX;
+        usr_index[n] = -1 - nmax;
+        max_data[nmax++] = val;
         break;
       case UserHistoryOperation::min:
-        usr_op = MPI_MIN;
+        usr_index[n] = -1 - nmax;
+        max_data[nmax++] = -val;
         break;
     }
-    if (Globals::my_rank == 0) {
-      MPI_Reduce(MPI_IN_PLACE, usr_hst_data, 1, MPI_ATHENA_REAL, usr_op, 0,
+  }
+  if (Globals::my_rank == 0) {
+    MPI_Reduce(MPI_IN_PLACE, hst_data.get(), nsum, MPI_ATHENA_REAL, MPI_SUM, 0,
+               MPI_COMM_WORLD);
+    if (nmax > 0)
+      MPI_Reduce(MPI_IN_PLACE, max_data.get(), nmax, MPI_ATHENA_REAL, MPI_MAX, 0,
                  MPI_COMM_WORLD);
-    } else {
-      MPI_Reduce(usr_hst_data, usr_hst_data, 1, MPI_ATHENA_REAL, usr_op, 0,
+  } else {
+    MPI_Reduce(hst_data.get(), hst_data.get(), nsum, MPI_ATHENA_REAL, MPI_SUM, 0,
+               MPI_COMM_WORLD);
+    if (nmax > 0)
+      MPI_Reduce(max_data.get(), max_data.get(), nmax, MPI_ATHENA_REAL, MPI_MAX, 0,
                  MPI_COMM_WORLD);
+  }
+  // unpack the user-defined outputs in their enrolled order, from the last one, since
+  // the summed outputs were only moved to lower indices
+  for (int n=pm->nuser_history_output_-1; n>=0; n--) {
+    if (usr_index[n] >= 0) {
+      hst_data[nhistory_vars+n] = hst_data[usr_index[n]];
+    } else {
+      Real val = max_data[-1 - usr_index[n]];
+      hst_data[nhistory_vars+n] =
+          (pm->user_history_ops_[n] == UserHistoryOperation::min) ? -val : val;
     }
   }
 #endif
@@ -440,6 +477,7 @@ void HistoryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin, bool flag) {
         std::fprintf(pfile,"[%d]=Fc2    ", iout++);
         std::fprintf(pfile,"[%d]=Fc3    ", iout++);
       }
+      if (CRDIFFUSION_ENABLED) std::fprintf(pfile,"[%d]=Ecr    ", iout++);
       for (int n=0; n<pm->nuser_history_output_; n++)
         std::fprintf(pfile,"[%d]=%-7s ", iout++,
                      pm->user_history_output_names_[n].c_str());
@@ -344,6 +344,23 @@ Outputs::~Outputs() {
   }
 }
 
+namespace {
+//----------------------------------------------------------------------------------------
+//! \fn void LoadCRCoefficients(AthenaArray<CRReal> &src, AthenaArray<Real> &dst)
+//! \brief views the 3 components of a CR coefficient array, or copies them into Real
+//! when the coefficients are stored in single precision (-crfloat)
+
+void LoadCRCoefficients(AthenaArray<CRReal> &src, AthenaArray<Real> &dst) {
+#if CR_FLOAT_COEFFICIENTS
+  dst.NewAthenaArray(3, src.GetDim3(), src.GetDim2(), src.GetDim1());
+  for (int n=0; n<dst.GetSize(); ++n)
+    dst(n) = src(n);
+#else
+  dst.InitWithShallowSlice(src,4,0,3);
+#endif
+}
+} // namespace
+
 //----------------------------------------------------------------------------------------
 //! \fn void OutputType::LoadOutputData(MeshBlock *pmb)
 //! \brief Create doubly linked list of OutputData's containing requested variables
@@ -1103,7 +1120,7 @@ void OutputType::LoadOutputData(MeshBlock *pmb) {
       pod = new OutputData;
       pod->type = "VECTORS";
       pod->name = "Sigma_diff";
-      pod->data.InitWithShallowSlice(pcr->sigma_diff,4,0,3);
+      LoadCRCoefficients(pcr->sigma_diff, pod->data);
       AppendOutputDataNode(pod);
       num_vars_+=3;
     }
@@ -1114,7 +1131,7 @@ void OutputType::LoadOutputData(MeshBlock *pmb) {
       pod = new OutputData;
       pod->type = "VECTORS";
       pod->name = "Sigma_adv";
-      pod->data.InitWithShallowSlice(pcr->sigma_adv,4,0,3);
+      LoadCRCoefficients(pcr->sigma_adv, pod->data);
       AppendOutputDataNode(pod);
       num_vars_+=3;
     }
@@ -1126,12 +1143,12 @@ void OutputType::LoadOutputData(MeshBlock *pmb) {
       pod = new OutputData;
       pod->type = "VECTORS";
       pod->name = "Vc";
-      pod->data.InitWithShallowSlice(pcr->v_adv,4,0,3);
+      LoadCRCoefficients(pcr->v_adv, pod->data);
       AppendOutputDataNode(pod);
       num_vars_+=3;
       if (output_params.cartesian_vector) {
         AthenaArray<Real> src;
-        src.InitWithShallowSlice(pcr->v_adv,4,0,3);
+        LoadCRCoefficients(pcr->v_adv, src);
         pod = new OutputData;
         pod->type = "VECTORS";
         pod->name = "Vc_xyz";
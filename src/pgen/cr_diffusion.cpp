@@ -50,16 +50,13 @@ static Real vy = 0.0;
 static Real vz = 0.0;
 static int direction = 0;
 
-void Diffusion(MeshBlock *pmb, AthenaArray<Real> &u_cr,
-        AthenaArray<Real> &prim, AthenaArray<Real> &bcc);
-
 void Mesh::UserWorkAfterLoop(ParameterInput *pin) {
   // calculate the anaysis solution and compare
   //find the time, going through all the mesh block
   MeshBlock *pmb = my_blocks(0);
   Real vmax = pmb->pcr->vmax;
   Real sum_error=0.0;
-  int num_cell=0;
+  Real sum_vol=0.0;
   Real diff_coef=vmax/(3.0*sigma);
   for(int nb=0; nb<nblocal; ++nb) {
     pmb=my_blocks(nb);
@@ -79,20 +76,22 @@ void Mesh::UserWorkAfterLoop(ParameterInput *pin) {
             dist_sq=(x3-vz*time)*(x3-vz*time);
           Real sol = std::exp(-40.0*dist_sq/(4*diff_coef*time*40.0
                                              + 1.0))/std::sqrt(4*diff_coef*time*40+1);
-          sum_error += std::abs(pmb->pcr->u_cr(CRE,k,j,i)-sol);
-          num_cell++;
+          // volume weighted, so that the error is comparable with mesh refinement
+          Real vol = pmb->pcoord->GetCellVolume(k,j,i);
+          sum_error += std::abs(pmb->pcr->u_cr(CRE,k,j,i)-sol)*vol;
+          sum_vol += vol;
         }
       }
     }
   }
 
 #ifdef MPI_PARALLEL
-  MPI_Allreduce(&sum_error, &sum_error, 1, MPI_DOUBLE,MPI_SUM, MPI_COMM_WORLD);
-  MPI_Allreduce(&num_cell, &num_cell, 1, MPI_INT,MPI_SUM, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, &sum_error, 1, MPI_DOUBLE,MPI_SUM, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, &sum_vol, 1, MPI_DOUBLE,MPI_SUM, MPI_COMM_WORLD);
 #endif
 
   if (Globals::my_rank == 0) {
-    sum_error /= num_cell;
+    sum_error /= sum_vol;
     std::string fname;
     fname.assign("diffusion_error.dat");
     std::stringstream msg;
@@ -123,9 +122,13 @@ void Mesh::UserWorkAfterLoop(ParameterInput *pin) {
   }
 }
 
-void MeshBlock::InitUserMeshBlockData(ParameterInput *pin) {
+void Mesh::InitUserMeshData(ParameterInput *pin) {
+  // isotropic diffusion with the built-in opacity and streaming
   if (CR_ENABLED) {
-    pcr->EnrollOpacityFunction(Diffusion);
+    sigma = pin->GetOrAddReal("problem","sigma",1.e3);
+    pin->SetString("cr","opacity","anisotropic");
+    pin->SetReal("cr","sigma_parl",sigma);
+    pin->SetReal("cr","sigma_perp",sigma);
   }
 }
 
@@ -251,168 +254,3 @@ void MeshBlock::ProblemGenerator(ParameterInput *pin) {
   }
   return;
 }
-
-void Diffusion(MeshBlock *pmb, AthenaArray<Real> &u_cr,
-               AthenaArray<Real> &prim, AthenaArray<Real> &bcc) {
-  // set the default opacity to be a large value in the default hydro case
-  CosmicRay *pcr=pmb->pcr;
-  int kl=pmb->ks, ku=pmb->ke;
-  int jl=pmb->js, ju=pmb->je;
-  int il=pmb->is-1, iu=pmb->ie+1;
-  if (pmb->block_size.nx2 > 1) {
-    jl -= 1;
-    ju += 1;
-  }
-  if (pmb->block_size.nx3 > 1) {
-    kl -= 1;
-    ku += 1;
-  }
-
-  for(int k=kl; k<=ku; ++k) {
-    for(int j=jl; j<=ju; ++j) {
-#pragma omp simd
-      for(int i=il; i<=iu; ++i) {
-        pcr->sigma_diff(0,k,j,i) = sigma;
-        pcr->sigma_diff(1,k,j,i) = sigma;
-        pcr->sigma_diff(2,k,j,i) = sigma;
-      }
-    }
-  }
-
-  Real invlim=1.0/pcr->vmax;
-
-  // The information stored in the array
-  // b_angle is
-  // b_angle[0]=sin_theta_b
-  // b_angle[1]=cos_theta_b
-  // b_angle[2]=sin_phi_b
-  // b_angle[3]=cos_phi_b
-
-  if (MAGNETIC_FIELDS_ENABLED) {
-    // First, calculate B_dot_grad_Pc
-    for(int k=kl; k<=ku; ++k) {
-      for(int j=jl; j<=ju; ++j) {
-        // x component
-        pmb->pcoord->CenterWidth1(k,j,il-1,iu+1,pcr->cwidth);
-        for(int i=il; i<=iu; ++i) {
-          Real distance = 0.5*(pcr->cwidth(i-1) + pcr->cwidth(i+1))
-                          + pcr->cwidth(i);
-          Real dprdx=(u_cr(CRE,k,j,i+1) - u_cr(CRE,k,j,i-1))/3.0;
-          dprdx /= distance;
-          pcr->b_grad_pc(k,j,i) = bcc(IB1,k,j,i) * dprdx;
-        }
-        // y component
-        pmb->pcoord->CenterWidth2(k,j-1,il,iu,pcr->cwidth1);
-        pmb->pcoord->CenterWidth2(k,j,il,iu,pcr->cwidth);
-        pmb->pcoord->CenterWidth2(k,j+1,il,iu,pcr->cwidth2);
-        for(int i=il; i<=iu; ++i) {
-          Real distance = 0.5*(pcr->cwidth1(i) + pcr->cwidth2(i))
-                         + pcr->cwidth(i);
-          Real dprdy=(u_cr(CRE,k,j+1,i) - u_cr(CRE,k,j-1,i))/3.0;
-          dprdy /= distance;
-          pcr->b_grad_pc(k,j,i) += bcc(IB2,k,j,i) * dprdy;
-        }
-        // z component
-        pmb->pcoord->CenterWidth3(k-1,j,il,iu,pcr->cwidth1);
-        pmb->pcoord->CenterWidth3(k,j,il,iu,pcr->cwidth);
-        pmb->pcoord->CenterWidth3(k+1,j,il,iu,pcr->cwidth2);
-
-        for(int i=il; i<=iu; ++i) {
-          Real distance = 0.5*(pcr->cwidth1(i) + pcr->cwidth2(i))
-                          + pcr->cwidth(i);
-          Real dprdz=(u_cr(CRE,k+1,j,i) - u_cr(CRE,k-1,j,i))/3.0;
-          dprdz /= distance;
-          pcr->b_grad_pc(k,j,i) += bcc(IB3,k,j,i) * dprdz;
-        }
-
-        // now calculate the streaming velocity
-        // streaming velocity is calculated with respect to the current coordinate
-        //  system
-        // diffusion coefficient is calculated with respect to B direction
-        for(int i=il; i<=iu; ++i) {
-          Real pb= bcc(IB1,k,j,i)*bcc(IB1,k,j,i)
-                  +bcc(IB2,k,j,i)*bcc(IB2,k,j,i)
-                  +bcc(IB3,k,j,i)*bcc(IB3,k,j,i);
-          Real inv_sqrt_rho = 1.0/std::sqrt(prim(IDN,k,j,i));
-          Real va1 = bcc(IB1,k,j,i)*inv_sqrt_rho;
-          Real va2 = bcc(IB2,k,j,i)*inv_sqrt_rho;
-          Real va3 = bcc(IB3,k,j,i)*inv_sqrt_rho;
-
-          Real va = std::sqrt(pb/prim(IDN,k,j,i));
-
-          Real dpc_sign = 0.0;
-          if (pcr->b_grad_pc(k,j,i) > TINY_NUMBER) dpc_sign = 1.0;
-          else if (-pcr->b_grad_pc(k,j,i) > TINY_NUMBER) dpc_sign = -1.0;
-
-          pcr->v_adv(0,k,j,i) = -va1 * dpc_sign;
-          pcr->v_adv(1,k,j,i) = -va2 * dpc_sign;
-          pcr->v_adv(2,k,j,i) = -va3 * dpc_sign;
-
-          // now the diffusion coefficient
-          if (va < TINY_NUMBER) {
-            pcr->sigma_adv(0,k,j,i) = pcr->max_opacity;
-          } else {
-            pcr->sigma_adv(0,k,j,i) = std::abs(pcr->b_grad_pc(k,j,i))
-                          /(std::sqrt(pb)* va * (1.0 + 1.0/3.0)
-                                    * invlim * u_cr(CRE,k,j,i));
-          }
-
-          pcr->sigma_adv(1,k,j,i) = pcr->max_opacity;
-          pcr->sigma_adv(2,k,j,i) = pcr->max_opacity;
-
-          // Now calculate the angles of B
-          Real bxby = std::sqrt(bcc(IB1,k,j,i)*bcc(IB1,k,j,i) +
-                           bcc(IB2,k,j,i)*bcc(IB2,k,j,i));
-          Real btot = std::sqrt(pb);
-          if (btot > TINY_NUMBER) {
-            pcr->b_angle(0,k,j,i) = bxby/btot;
-            pcr->b_angle(1,k,j,i) = bcc(IB3,k,j,i)/btot;
-          } else {
-            pcr->b_angle(0,k,j,i) = 1.0;
-            pcr->b_angle(1,k,j,i) = 0.0;
-          }
-          if (bxby > TINY_NUMBER) {
-            pcr->b_angle(2,k,j,i) = bcc(IB2,k,j,i)/bxby;
-            pcr->b_angle(3,k,j,i) = bcc(IB1,k,j,i)/bxby;
-          } else {
-            pcr->b_angle(2,k,j,i) = 0.0;
-            pcr->b_angle(3,k,j,i) = 1.0;
-          }
-        }
-      }
-    }
-  } else {
-  for(int k=kl; k<=ku; ++k) {
-    for(int j=jl; j<=ju; ++j) {
-      // x component
-      pmb->pcoord->CenterWidth1(k,j,il-1,iu+1,pcr->cwidth);
-      for(int i=il; i<=iu; ++i) {
-         Real distance = 0.5*(pcr->cwidth(i-1) + pcr->cwidth(i+1))
-                        + pcr->cwidth(i);
-         Real grad_pr=(u_cr(CRE,k,j,i+1) - u_cr(CRE,k,j,i-1))/3.0;
-         grad_pr /= distance;
-         Real va = 0.0;
-         if (va < TINY_NUMBER) {
-           pcr->sigma_adv(0,k,j,i) = pcr->max_opacity;
-           pcr->v_adv(0,k,j,i) = 0.0;
-         } else {
-           Real sigma2 = std::abs(grad_pr)/(va * (1.0 + 1.0/3.0)
-                             * invlim * u_cr(CRE,k,j,i));
-           if (std::abs(grad_pr) < TINY_NUMBER) {
-             pcr->sigma_adv(0,k,j,i) = 0.0;
-             pcr->v_adv(0,k,j,i) = 0.0;
-           } else {
-             pcr->sigma_adv(0,k,j,i) = sigma2;
-             pcr->v_adv(0,k,j,i) = -va * grad_pr/std::abs(grad_pr);
-           }
-        }
-        pcr->sigma_adv(1,k,j,i) = pcr->max_opacity;
-        pcr->sigma_adv(2,k,j,i) = pcr->max_opacity;
-
-        pcr->v_adv(1,k,j,i) = 0.0;
-        pcr->v_adv(2,k,j,i) = 0.0;
-      }
-    }
-  }
-  }
-}
@@ -45,6 +45,7 @@
 
 namespace {
   Real e0;
+  void ECRExtrema(MeshBlock *pmb, Real *usr_data);
 }
 
 void CRFixedInnerX1(AthenaArray<Real> &dst, Real time, int nvar,
@@ -157,6 +158,10 @@ void Mesh::InitUserMeshData(ParameterInput *pin) {
   EnrollUserMGCRDiffusionBoundaryFunction(BoundaryFace::outer_x2, CRFixedOuterX2);
   EnrollUserMGCRDiffusionBoundaryFunction(BoundaryFace::inner_x3, CRFixedInnerX3);
   EnrollUserMGCRDiffusionBoundaryFunction(BoundaryFace::outer_x3, CRFixedOuterX3);
+  AllocateUserHistoryOutput(2);
+  EnrollUserHistoryOutput(0, nullptr, "ecr-max", UserHistoryOperation::max);
+  EnrollUserHistoryOutput(1, nullptr, "ecr-min", UserHistoryOperation::min);
+  EnrollUserHistoryBlockFunction(ECRExtrema);
 }
 
 
@@ -168,6 +173,10 @@ void Mesh::InitUserMeshData(ParameterInput *pin) {
 void MeshBlock::ProblemGenerator(ParameterInput *pin) {
   Real gamma = peos->GetGamma();
   Real r0 = 0.2, rho0 = 1.0;
+  // uniform magnetic field, which sets the direction of the anisotropic diffusion
+  Real b1 = pin->GetOrAddReal("problem", "b1", 1.0);
+  Real b2 = pin->GetOrAddReal("problem", "b2", 1.0);
+  Real b3 = pin->GetOrAddReal("problem", "b3", 0.0);
 
   for(int k=ks; k<=ke; ++k) {
     Real x3 = pcoord->x3v(k);
@@ -189,7 +198,7 @@ void MeshBlock::ProblemGenerator(ParameterInput *pin) {
     for (int k=ks; k<=ke; ++k) {
       for (int j=js; j<=je; ++j) {
         for (int i=is; i<=ie+1; ++i) {
-          pfield->b.x1f(k,j,i) = 1.0;
+          pfield->b.x1f(k,j,i) = b1;
         }
       }
     }
@@ -197,7 +206,7 @@ void MeshBlock::ProblemGenerator(ParameterInput *pin) {
       for (int k=ks; k<=ke; ++k) {
         for (int j=js; j<=je+1; ++j) {
           for (int i=is; i<=ie; ++i) {
-            pfield->b.x2f(k,j,i) = 1.0;
+            pfield->b.x2f(k,j,i) = b2;
           }
         }
       }
@@ -206,7 +215,7 @@ void MeshBlock::ProblemGenerator(ParameterInput *pin) {
       for (int k=ks; k<=ke+1; ++k) {
         for (int j=js; j<=je; ++j) {
           for (int i=is; i<=ie; ++i) {
-            pfield->b.x3f(k,j,i) = 0.0;
+            pfield->b.x3f(k,j,i) = b3;
           }
         }
       }
@@ -238,3 +247,25 @@ void MeshBlock::ProblemGenerator(ParameterInput *pin) {
   return;
 }
 
+namespace {
+//======================================================================================
+//! \fn void ECRExtrema(MeshBlock *pmb, Real *usr_data)
+//  \brief extrema of the CR energy density in a MeshBlock for the history output
+//======================================================================================
+
+void ECRExtrema(MeshBlock *pmb, Real *usr_data) {
+  AthenaArray<Real> &ecr = pmb->pcrdiff->ecr;
+  Real emax = ecr(pmb->ks,pmb->js,pmb->is), emin = emax;
+  for (int k=pmb->ks; k<=pmb->ke; ++k) {
+    for (int j=pmb->js; j<=pmb->je; ++j) {
+      for (int i=pmb->is; i<=pmb->ie; ++i) {
+        emax = std::max(emax, ecr(k,j,i));
+        emin = std::min(emin, ecr(k,j,i));
+      }
+    }
+  }
+  usr_data[0] = emax;
+  usr_data[1] = emin;
+  return;
+}
+} // namespace
@@ -37,6 +37,7 @@
 #include "../hydro/srcterms/hydro_srcterms.hpp"
 #include "../mesh/mesh.hpp"
 #include "../parameter_input.hpp"
+#include "../utils/townsend_cooling.hpp"
 #include "../fft/turbulence.hpp"
 
 
@@ -77,51 +78,25 @@ static Real decouple ;
 // Tlower   [3.e+02 2.e+03 8.e+03 1.e+05 4.e+07] K
 // Lks      [2.2380e-32 1.0012e-30 4.6240e-36 1.7800e-18 3.2217e-27] cm3 erg / s
 // alphaks  [ 2.     1.5    2.867 -0.65   0.5  ]
-// TEF bounds for Tmax= 10000000000.0  K
-// Yks      [1.91682979 1.91275108 1.91203155 1.91184059 1.87350889 0.   
 double Tupps[5] = {2.0e+3,8.0e+3,1.0e+5,4.0e+7,1e+10};
 double Tlows[5] = {3.0e+2,2.0e+3,8.0e+3,1.0e+5,4.0e+7};
 double Lks[5] = {2.2380e-32, 1.0012e-30, 4.6240e-36, 1.7800e-18, 3.2217e-27};
 double aks[5] = {2.0,1.5,2.867,-0.65,0.5};
-double Yks[6] = {1.9168297910695002, 1.9127510824010463 , 1.9120315518174356,1.911840589669069 , 1.8735088935932651, 0.0};
 double Tmax = 1.0e+10;
-double LN =  Lks[4] * std::pow(Tmax,aks[4]);
 
-double TEF(double T);
-double invTEF(double T);
+// the piecewise power law, tabulated in K and cgs for the exact integration
+TownsendCooling *pcool = nullptr;
 
-double TEF(double T){
-  double val = 0.0;
+Real CoolingFunction(Real T) {
   int j = 0;
-  double Temp = T*T_scale;
-  
-  //Figure out which T bin we are in
-  while(Temp >= Tupps[j]) j++;
-
-  //Calculate Y function value at Temparture T*T_scale
-  val = (1/(1-aks[j]))*(LN/Lks[j])*std::pow(Tlows[j],-1*aks[j])*(Tlows[j]/Tmax);
-  val *= (1-std::pow(Tlows[j]/(Temp),aks[j]-1));
-  val += Yks[j];
-  return val;
+  while ((j < 4) && (T >= Tupps[j])) j++;
+  return Lks[j]*std::pow(T,aks[j]);
 }
 
-double invTEF(double y) {
-  double val = 0.0;
-  int j = 0;
-  //Figure out which T bin we are in
-  if (y> Yks[0]) {
-    val = Tlows[0];
-  } else {
-    while(y<= Yks[j]) j++;
-    j -= 1;
-  }
-  // Calculate invY
-  val = (Lks[j]/LN)*std::pow(Tlows[j],aks[j])*(Tmax/Tlows[j]);
-  val *= (y-Yks[j])*(1-aks[j]);
-  val = 1-val;
-  val = (Tlows[j]/T_scale)*std::pow(val,1.0/(1-aks[j]));
-  return val;
-}   
+// new temperature (code units) after cooling for dt at density d, above the floor
+inline Real CoolTemperature(Real T, Real d, Real gm1, Real dt) {
+  return pcool->Integrate(T*T_scale, t_scale*gm1*d*n_scale/k_B*dt)/T_scale;
+}
 
 void CRSource(MeshBlock *pmb, const Real time, const Real dt,
                 const AthenaArray<Real> &prim, FaceField &b, 
@@ -133,169 +108,89 @@ void mySource(MeshBlock *pmb, const Real time, const Real dt,
                AthenaArray<Real> &cons_scalar);
               
 
-void Opacity(MeshBlock *pmb, AthenaArray<Real> &u_cr,
-        AthenaArray<Real> &prim, AthenaArray<Real> &bcc);
-
-void Streaming(MeshBlock *pmb, AthenaArray<Real> &u_cr,
-             AthenaArray<Real> &prim, AthenaArray<Real> &bcc,
-             AthenaArray<Real> &grad_pc, int k, int j, int is, int ie);
-
-Real TotalHeating(MeshBlock *pmb, int iout);
-
-Real Ec_source(MeshBlock *pmb,int iout);
-
-Real correlation(MeshBlock *pmb,int iout);
+void ICMHistory(MeshBlock *pmb, Real *usr_data);
 Real div_correlation(MeshBlock *pmb,int iout);
 // Real Correlation(MeshBlock *pmb, int iout);
 
-Real TotalHeating(MeshBlock *pmb, int iout){
-  // Real heat=0;
-  int is=pmb->is, ie=pmb->ie, js=pmb->js, je=pmb->je, ks=pmb->ks, ke=pmb->ke;
+// All the user history outputs in one sweep of the MeshBlock:
+//   0, 1: energy radiated over the next step and volume of the cooling gas
+//   2, 3: CR energy gradient along the flow and (absolute) along the Alfven velocity
+//   4-6:  rho-Ec correlation, gamma-ray luminosity and CR loss rate
+void ICMHistory(MeshBlock *pmb, Real *usr_data) {
   Real pfloor = pmb->peos->GetPressureFloor();
   Real dfloor = pmb->peos->GetDensityFloor();
   Real Tfloor = Tlows[0]/T_scale;
   double gm1 = pmb->peos->GetGamma()-1.0;
 
-  double totdE = 0.0;
-  double totV = 0.0;
-  
-  AthenaArray<Real> &cons = pmb->phydro->u;
-  AthenaArray<Real> &bcc = pmb->pfield->bcc;
-  Real dt = pmb->pmy_mesh->dt;
-  for (int k=pmb->ks; k<=pmb->ke; ++k) {
-    for (int j=pmb->js; j<=pmb->je; ++j) {
-#pragma omp simd
-      for (int i=pmb->is; i<=pmb->ie; ++i) {
-        double d = cons(IDN,k,j,i);
-        double p = gm1*(cons(IEN,k,j,i) - 0.5*(SQR(cons(IM1,k,j,i))+SQR(cons(IM2,k,j,i))+SQR(cons(IM3,k,j,i)))/d - 0.5*(SQR(bcc(IB1,k,j,i))+SQR(bcc(IB2,k,j,i))+SQR(bcc(IB3,k,j,i))));
+  double totdE = 0.0, totV = 0.0;
+  double src_u = 0.0, src_vs = 0.0;
+  double corr = 0.0, var1 = 0.0, var2 = 0.0, vol_tot = 0.0;
 
-        if ((d> dfloor) && (p> pfloor) ) {
-          double T = p/d;
-          if ((T > Tfloor)){
-            double time0 = t_scale*gm1*d*n_scale*LN/(k_B*Tmax);
-            double newT = invTEF(TEF(T) + dt*time0);
-            double dE = d*(newT-T)/gm1;
-            totdE += -1*dE * pmb->pcoord->GetCellVolume(k,j,i);
-            totV += pmb->pcoord->GetCellVolume(k,j,i);
-          }
-        }
-      }
-    }
-  }
-  Real heat = totdE / totV;
-  if (iout == 0) return totdE;
-  if (iout == 1) return totV;
-  
-  return heat;
-}
-
-Real Ec_source(MeshBlock *pmb, int iout){
-  // Real heat=0;
-  int is=pmb->is, ie=pmb->ie, js=pmb->js, je=pmb->je, ks=pmb->ks, ke=pmb->ke;
-  // Real pfloor = pmb->peos->GetPressureFloor();
-  // Real dfloor = pmb->peos->GetDensityFloor();
-  // Real Tfloor = Tlows[0]/T_scale;
-  // double gm1 = pmb->peos->GetGamma()-1.0;
-
-  double totdE = 0.0;
-  
   AthenaArray<Real> &cons = pmb->phydro->u;
   AthenaArray<Real> &prim = pmb->phydro->w;
   AthenaArray<Real> &bcc = pmb->pfield->bcc;
   AthenaArray<Real> &u_cr = pmb->pcr->u_cr;
-  
   Real dt = pmb->pmy_mesh->dt;
   for (int k=pmb->ks; k<=pmb->ke; ++k) {
     for (int j=pmb->js; j<=pmb->je; ++j) {
-#pragma omp simd
+#pragma omp simd reduction(+:totdE,totV,src_u,src_vs,corr,var1,var2,vol_tot)
       for (int i=pmb->is; i<=pmb->ie; ++i) {
-        Real dens = cons(IDN,k,j,i);
-        Real v_1, v_2, v_3 = 0.0;
-        if (iout==2){
-          v_1 = cons(IM1,k,j,i)/dens;
-          v_2 = cons(IM2,k,j,i)/dens;
-          v_3 = cons(IM3,k,j,i)/dens;
-        } else if (iout == 3){
-          Real Temp = prim(IPR,k,j,i)/prim(IDN,k,j,i);
-          Real switch_func = 0.5*(1+std::tanh( (Temp - T_f_i)/dT_f_i));
-          Real my_fi = (1-f_i)*switch_func + f_i;
-          // Real my_fi = std::pow(10,(1-std::log10(f_i))*switch_func + std::log10(f_i));
-          Real inv_sqrt_rho = 1.0/std::sqrt(cons(IDN,k,j,i) * my_fi);
-          v_1 = bcc(IB1,k,j,i)*inv_sqrt_rho;
-          v_2 = bcc(IB2,k,j,i)*inv_sqrt_rho;
-          v_3 = bcc(IB3,k,j,i)*inv_sqrt_rho;
-        }
+        Real vol = pmb->pcoord->GetCellVolume(k,j,i);
+        double d = cons(IDN,k,j,i);
+        double p = gm1*(cons(IEN,k,j,i) - 0.5*(SQR(cons(IM1,k,j,i))+SQR(cons(IM2,k,j,i))+SQR(cons(IM3,k,j,i)))/d - 0.5*(SQR(bcc(IB1,k,j,i))+SQR(bcc(IB2,k,j,i))+SQR(bcc(IB3,k,j,i))));
 
-        Real grad_1 = (1.0/3.0)/pmb->pcoord->GetEdge1Length(k,j,i);
-        Real grad_2 = (1.0/3.0)/pmb->pcoord->GetEdge2Length(k,j,i);
-        Real grad_3 = (1.0/3.0)/pmb->pcoord->GetEdge3Length(k,j,i);
-        if (v_1 > 0){
-          grad_1 *= u_cr(CRE,k,j,i+1) - u_cr(CRE,k,j,i);
-        } else {
-          grad_1 *= u_cr(CRE,k,j,i) - u_cr(CRE,k,j,i-1);
-        }
-        if (v_2 > 0){
-          grad_2 *= u_cr(CRE,k,j+1,i) - u_cr(CRE,k,j,i);
-        } else {
-          grad_2 *= u_cr(CRE,k,j,i) - u_cr(CRE,k,j-1,i);
-        }
-        if (v_3 > 0){
-          grad_3 *= u_cr(CRE,k+1,j,i) - u_cr(CRE,k,j,i);
-        } else {
-          grad_3 *= u_cr(CRE,k,j,i) - u_cr(CRE,k-1,j,i);
-        }
-        if (iout==2){
-          totdE += grad_1 * v_1 + grad_2 * v_2 + grad_3 * v_3  ;
-        } else if (iout == 3){
-          totdE += std::abs(grad_1 * v_1) + std::abs(grad_2 * v_2) + std::abs(grad_3 * v_3)  ;
+        if ((d> dfloor) && (p> pfloor) && (p/d > Tfloor)) {
+          double T = p/d;
+          double newT = CoolTemperature(T, d, gm1, dt);
+          double dE = d*(newT-T)/gm1;
+          totdE += -1*dE * vol;
+          totV += vol;
         }
-        
-      }
-    }
-  }
-  
-  return totdE;
-}
-
-Real correlation(MeshBlock *pmb, int iout){
-
-  int is=pmb->is, ie=pmb->ie, js=pmb->js, je=pmb->je, ks=pmb->ks, ke=pmb->ke;
 
-  double corr = 0.0;
-  double var1 = 0.0;
-  double var2 = 0.0;
-  double vol_tot = 0.0;
-  
-  AthenaArray<Real> &cons = pmb->phydro->u;
-  AthenaArray<Real> &bcc = pmb->pfield->bcc;
-  AthenaArray<Real> &u_cr = pmb->pcr->u_cr;
-  Real dt = pmb->pmy_mesh->dt;
-  for (int k=pmb->ks; k<=pmb->ke; ++k) {
-    for (int j=pmb->js; j<=pmb->je; ++j) {
-#pragma omp simd
-      for (int i=pmb->is; i<=pmb->ie; ++i) {
-        Real vol = pmb->pcoord->GetCellVolume(k,j,i);
-        Real dens = cons(IDN,k,j,i);
-        Real cr_e = u_cr(CRE,k,j,i);
-        var1 += dens * vol;
-        var2 += cr_e * vol;
-        corr += cr_e*dens*vol;
+        // upwind CR energy gradients
+        Real ec = u_cr(CRE,k,j,i);
+        Real dl1 = (1.0/3.0)/pmb->pcoord->GetEdge1Length(k,j,i);
+        Real dl2 = (1.0/3.0)/pmb->pcoord->GetEdge2Length(k,j,i);
+        Real dl3 = (1.0/3.0)/pmb->pcoord->GetEdge3Length(k,j,i);
+        Real gp1 = dl1*(u_cr(CRE,k,j,i+1) - ec), gm1_ = dl1*(ec - u_cr(CRE,k,j,i-1));
+        Real gp2 = dl2*(u_cr(CRE,k,j+1,i) - ec), gm2_ = dl2*(ec - u_cr(CRE,k,j-1,i));
+        Real gp3 = dl3*(u_cr(CRE,k+1,j,i) - ec), gm3_ = dl3*(ec - u_cr(CRE,k-1,j,i));
+
+        Real v_1 = cons(IM1,k,j,i)/d;
+        Real v_2 = cons(IM2,k,j,i)/d;
+        Real v_3 = cons(IM3,k,j,i)/d;
+        src_u += ((v_1 > 0) ? gp1 : gm1_)*v_1 + ((v_2 > 0) ? gp2 : gm2_)*v_2
+                 + ((v_3 > 0) ? gp3 : gm3_)*v_3;
+
+        Real Temp = prim(IPR,k,j,i)/prim(IDN,k,j,i);
+        Real switch_func = 0.5*(1+std::tanh( (Temp - T_f_i)/dT_f_i));
+        Real my_fi = (1-f_i)*switch_func + f_i;
+        Real inv_sqrt_rho = 1.0/std::sqrt(d * my_fi);
+        v_1 = bcc(IB1,k,j,i)*inv_sqrt_rho;
+        v_2 = bcc(IB2,k,j,i)*inv_sqrt_rho;
+        v_3 = bcc(IB3,k,j,i)*inv_sqrt_rho;
+        src_vs += std::abs(((v_1 > 0) ? gp1 : gm1_)*v_1)
+                  + std::abs(((v_2 > 0) ? gp2 : gm2_)*v_2)
+                  + std::abs(((v_3 > 0) ? gp3 : gm3_)*v_3);
+
+        var1 += d * vol;
+        var2 += ec * vol;
+        corr += ec*d*vol;
         vol_tot += vol;
       }
     }
   }
-  Real out = 0.0;
-  if (iout==4){ 
-    out = corr / (var1 * var2) * vol_tot;
-  }
-  else if(iout==5){
-    // using hadronic loss rate from Guo & Oh 2008 of -5.86e-16 erg s^-1 cm^-3 into L_sun
-    out = corr* 7192.30777903 ;
-  } else if (iout==6){
-    out = corr * crLoss;
-  }
-  return out;
+  usr_data[0] = totdE;
+  usr_data[1] = totV;
+  usr_data[2] = src_u;
+  usr_data[3] = src_vs;
+  usr_data[4] = corr / (var1 * var2) * vol_tot;
+  // using hadronic loss rate from Guo & Oh 2008 of -5.86e-16 erg s^-1 cm^-3 into L_sun
+  usr_data[5] = corr* 7192.30777903;
+  usr_data[6] = corr * crLoss;
+  return;
 }
+
 Real div_correlation(MeshBlock *pmb, int iout){
 
   int is=pmb->is, ie=pmb->ie, js=pmb->js, je=pmb->je, ks=pmb->ks, ke=pmb->ke;
@@ -344,8 +239,6 @@ Real div_correlation(MeshBlock *pmb, int iout){
 
 void MeshBlock::InitUserMeshBlockData(ParameterInput *pin) {
   if (CR_ENABLED) {
-    pcr->EnrollOpacityFunction(Opacity);
-    pcr->EnrollStreamingFunction(Streaming);
     bool lossFlag = (pin->GetOrAddReal("problem","crLoss",0.0) > 0.0);
     if (lossFlag) {
         pcr->EnrollUserCRSource(CRSource);
@@ -353,6 +246,11 @@ void MeshBlock::InitUserMeshBlockData(ParameterInput *pin) {
   }
 }
 
+void Mesh::UserWorkAfterLoop(ParameterInput *pin) {
+  delete pcool;
+  pcool = nullptr;
+}
+
 void Mesh::InitUserMeshData(ParameterInput *pin) {
   int rank;
   MPI_Comm_rank(MPI_COMM_WORLD, &rank); //Just for print statements
@@ -376,6 +274,14 @@ void Mesh::InitUserMeshData(ParameterInput *pin) {
     dT_f_i = pin->GetOrAddReal("cr","dT_f_i",1000)/T_scale;
     decouple = pin->GetOrAddReal("cr","A_decouple",1);
     crLoss = pin->GetOrAddReal("problem","crLoss",0.0);
+    // use the built-in anisotropic opacity and streaming
+    pin->SetString("cr","opacity","anisotropic");
+    pin->SetReal("cr","sigma_parl",sigmaParl);
+    pin->SetReal("cr","sigma_perp",sigmaPerp);
+    pin->SetReal("cr","f_ion",f_i);
+    pin->SetReal("cr","T_ion",T_f_i);
+    pin->SetReal("cr","dT_ion",dT_f_i);
+    pin->SetReal("cr","a_decouple",decouple);
 
     if (rank == 0){
       std::cout << "Vmax = " << vmax / (c / (v_scale)) << " c" << std::endl;
@@ -389,6 +295,9 @@ void Mesh::InitUserMeshData(ParameterInput *pin) {
     // EnrollUserTimeStepFunction(CoolingTimeStep);
     EnrollUserExplicitSourceFunction(mySource);
   }
+  pcool = new TownsendCooling(Tlows[0], Tmax,
+                              pin->GetOrAddInteger("problem","cooling_nbins",1000),
+                              CoolingFunction);
   // turb_flag is initialzed in the Mesh constructor to 0 by default;
   // turb_flag = 1 for decaying turbulence
   // turb_flag = 2 for driven turbulence
@@ -403,14 +312,16 @@ void Mesh::InitUserMeshData(ParameterInput *pin) {
 #endif
   }
 
+  // the seven outputs are computed together by ICMHistory
   AllocateUserHistoryOutput(7);
-  EnrollUserHistoryOutput(0, TotalHeating, "totdE_heat");
-  EnrollUserHistoryOutput(1, TotalHeating, "totV_heat");
-  EnrollUserHistoryOutput(2, Ec_source, "totdE_cr_u");
-  EnrollUserHistoryOutput(3, Ec_source, "totdE_cr_vs");
-  EnrollUserHistoryOutput(4, correlation, "corr_rho_ec");
-  EnrollUserHistoryOutput(5, correlation, "Lgamma_Lsun");
-  EnrollUserHistoryOutput(6, correlation, "CR_Loss_Rate");
+  EnrollUserHistoryOutput(0, nullptr, "totdE_heat");
+  EnrollUserHistoryOutput(1, nullptr, "totV_heat");
+  EnrollUserHistoryOutput(2, nullptr, "totdE_cr_u");
+  EnrollUserHistoryOutput(3, nullptr, "totdE_cr_vs");
+  EnrollUserHistoryOutput(4, nullptr, "corr_rho_ec");
+  EnrollUserHistoryOutput(5, nullptr, "Lgamma_Lsun");
+  EnrollUserHistoryOutput(6, nullptr, "CR_Loss_Rate");
+  EnrollUserHistoryBlockFunction(ICMHistory);
   // EnrollUserHistoryOutput(7, div_correlation, "corr_pc_div");
   return;
 }
@@ -439,8 +350,7 @@ void mySource(MeshBlock *pmb, const Real time, const Real dt,
         if ((d> dfloor) && (p> pfloor) ) {
           double T = p/d;
           if ((T > Tfloor)){
-            double time0 = t_scale*gm1*d*n_scale*LN/(k_B*Tmax);
-            double newT = invTEF(TEF(T) + dt*time0);
+            double newT = CoolTemperature(T, d, gm1, dt);
             double dE = d*(newT-T)/gm1;
             totdE += -1*dE * pmb->pcoord->GetCellVolume(k,j,i);
             totV += pmb->pcoord->GetCellVolume(k,j,i);
@@ -628,209 +538,3 @@ void MeshBlock::ProblemGenerator(ParameterInput *pin) {
 }
 
 
-void Opacity(MeshBlock *pmb, AthenaArray<Real> &u_cr,
-               AthenaArray<Real> &prim, AthenaArray<Real> &bcc) {
-  // set the default opacity to be a large value in the default hydro case
-  CosmicRay *pcr=pmb->pcr;
-  int kl=pmb->ks, ku=pmb->ke;
-  int jl=pmb->js, ju=pmb->je;
-  int il=pmb->is-1, iu=pmb->ie+1;
-  if (pmb->block_size.nx2 > 1) {
-    jl -= 1;
-    ju += 1;
-  }
-  if (pmb->block_size.nx3 > 1) {
-    kl -= 1;
-    ku += 1;
-  }
-
-  for(int k=kl; k<=ku; ++k) {
-    for(int j=jl; j<=ju; ++j) {
-#pragma omp simd
-      for(int i=il; i<=iu; ++i) {
-        pcr->sigma_diff(0,k,j,i) = sigmaParl;
-        pcr->sigma_diff(1,k,j,i) = sigmaPerp;
-        pcr->sigma_diff(2,k,j,i) = sigmaPerp;
-      }
-    }
-  }
-
-  Real invlim=1.0/pcr->vmax;
-
-  // The information stored in the array
-  // b_angle is
-  // b_angle[0]=sin_theta_b
-  // b_angle[1]=cos_theta_b
-  // b_angle[2]=sin_phi_b
-  // b_angle[3]=cos_phi_b
-
-
-
-
-  if (MAGNETIC_FIELDS_ENABLED) {
-    //First, calculate B_dot_grad_Pc
-    for(int k=kl; k<=ku; ++k) {
-      for(int j=jl; j<=ju; ++j) {
-        // x component
-        pmb->pcoord->CenterWidth1(k,j,il-1,iu+1,pcr->cwidth);
-        for(int i=il; i<=iu; ++i) {
-          Real distance = 0.5*(pcr->cwidth(i-1) + pcr->cwidth(i+1))
-                          + pcr->cwidth(i);
-          Real dprdx=(u_cr(CRE,k,j,i+1) - u_cr(CRE,k,j,i-1))/3.0;
-          dprdx /= distance;
-          pcr->b_grad_pc(k,j,i) = bcc(IB1,k,j,i) * dprdx;
-        }
-        // y component
-        pmb->pcoord->CenterWidth2(k,j-1,il,iu,pcr->cwidth1);
-        pmb->pcoord->CenterWidth2(k,j,il,iu,pcr->cwidth);
-        pmb->pcoord->CenterWidth2(k,j+1,il,iu,pcr->cwidth2);
-        for(int i=il; i<=iu; ++i) {
-          Real distance = 0.5*(pcr->cwidth1(i) + pcr->cwidth2(i))
-                         + pcr->cwidth(i);
-          Real dprdy=(u_cr(CRE,k,j+1,i) - u_cr(CRE,k,j-1,i))/3.0;
-          dprdy /= distance;
-          pcr->b_grad_pc(k,j,i) += bcc(IB2,k,j,i) * dprdy;
-        }
-        // z component
-        pmb->pcoord->CenterWidth3(k-1,j,il,iu,pcr->cwidth1);
-        pmb->pcoord->CenterWidth3(k,j,il,iu,pcr->cwidth);
-        pmb->pcoord->CenterWidth3(k+1,j,il,iu,pcr->cwidth2);
-
-        for(int i=il; i<=iu; ++i) {
-          Real distance = 0.5*(pcr->cwidth1(i) + pcr->cwidth2(i))
-                          + pcr->cwidth(i);
-          Real dprdz=(u_cr(CRE,k+1,j,i) - u_cr(CRE,k-1,j,i))/3.0;
-          dprdz /= distance;
-          pcr->b_grad_pc(k,j,i) += bcc(IB3,k,j,i) * dprdz;
-
-          // now only get the sign
-          //  if (pcr->b_grad_pc(k,j,i) > TINY_NUMBER) pcr->b_grad_pc(k,j,i) = 1.0;
-          //  else if (-pcr->b_grad_pc(k,j,i) > TINY_NUMBER) pcr->b_grad_pc(k,j,i)
-          //    = -1.0;
-          //  else pcr->b_grad_pc(k,j,i) = 0.0;
-        }
-
-      // now calculate the streaming velocity
-      // streaming velocity is calculated with respect to the current coordinate
-      //  system
-      // diffusion coefficient is calculated with respect to B direction
-        for(int i=il; i<=iu; ++i) {
-          Real pb= bcc(IB1,k,j,i)*bcc(IB1,k,j,i)
-                  +bcc(IB2,k,j,i)*bcc(IB2,k,j,i)
-                  +bcc(IB3,k,j,i)*bcc(IB3,k,j,i);
-          Real Temp = prim(IPR,k,j,i)/prim(IDN,k,j,i);
-          Real switch_func = 0.5*(1+std::tanh( (Temp - T_f_i)/dT_f_i));
-          Real my_fi = (1-f_i)*switch_func + f_i;
-          // Real my_fi = std::pow(10,(1-std::log10(f_i))*switch_func + std::log10(f_i));
-          Real inv_sqrt_rho = 1.0/std::sqrt(prim(IDN,k,j,i) * my_fi);
-          Real va1 = bcc(IB1,k,j,i)*inv_sqrt_rho;
-          Real va2 = bcc(IB2,k,j,i)*inv_sqrt_rho;
-          Real va3 = bcc(IB3,k,j,i)*inv_sqrt_rho;
-
-
-          Real va = std::sqrt(SQR(va1) + SQR(va2) + SQR(va3));
-
-          Real dpc_sign = 0.0;
-          if (pcr->b_grad_pc(k,j,i) > TINY_NUMBER) dpc_sign = 1.0;
-          else if (-pcr->b_grad_pc(k,j,i) > TINY_NUMBER) dpc_sign = -1.0;
-          if (pcr->stream_flag > 0) {
-            pcr->v_adv(0,k,j,i) = -va1 * dpc_sign;
-            pcr->v_adv(1,k,j,i) = -va2 * dpc_sign;
-            pcr->v_adv(2,k,j,i) = -va3 * dpc_sign;
-          } else {
-            pcr->v_adv(0,k,j,i) = 0.0;
-            pcr->v_adv(1,k,j,i) = 0.0;
-            pcr->v_adv(2,k,j,i) = 0.0;
-          }
-
-          // now the diffusion coefficient
-          if (pcr->stream_flag > 0) {
-            if (va < TINY_NUMBER) {
-              pcr->sigma_adv(0,k,j,i) = pcr->max_opacity;
-            } else {
-              pcr->sigma_adv(0,k,j,i) = std::abs(pcr->b_grad_pc(k,j,i))
-                            /(std::sqrt(pb)* va * decouple * (1.0 + 1.0/3.0)
-                                      * invlim * u_cr(CRE,k,j,i));
-            }
-
-            pcr->sigma_adv(1,k,j,i) = pcr->max_opacity;
-            pcr->sigma_adv(2,k,j,i) = pcr->max_opacity;
-          } else {
-            pcr->sigma_adv(0,k,j,i)  = pcr->max_opacity;
-            pcr->sigma_adv(1,k,j,i)  = pcr->max_opacity;
-            pcr->sigma_adv(2,k,j,i)  = pcr->max_opacity;
-          }
-          // Now calculate the angles of B
-          Real bxby = std::sqrt(bcc(IB1,k,j,i)*bcc(IB1,k,j,i) +
-                           bcc(IB2,k,j,i)*bcc(IB2,k,j,i));
-          Real btot = std::sqrt(pb);
-          if (btot > TINY_NUMBER) {
-            pcr->b_angle(0,k,j,i) = bxby/btot;
-            pcr->b_angle(1,k,j,i) = bcc(IB3,k,j,i)/btot;
-          } else {
-            pcr->b_angle(0,k,j,i) = 1.0;
-            pcr->b_angle(1,k,j,i) = 0.0;
-          }
-          if (bxby > TINY_NUMBER) {
-            pcr->b_angle(2,k,j,i) = bcc(IB2,k,j,i)/bxby;
-            pcr->b_angle(3,k,j,i) = bcc(IB1,k,j,i)/bxby;
-          } else {
-            pcr->b_angle(2,k,j,i) = 0.0;
-            pcr->b_angle(3,k,j,i) = 1.0;
-          }
-        }
-      }
-    }
-  }
-}
-
-void Streaming(MeshBlock *pmb, AthenaArray<Real> &u_cr,
-             AthenaArray<Real> &prim, AthenaArray<Real> &bcc,
-             AthenaArray<Real> &grad_pc, int k, int j, int is, int ie) {
-  CosmicRay *pcr=pmb->pcr;
-  Real invlim = 1.0/pcr->vmax;
-
-  for(int i=is; i<=ie; ++i) {
-    Real Temp = prim(IPR,k,j,i)/prim(IDN,k,j,i);
-    Real switch_func = 0.5*(1+std::tanh( (Temp - T_f_i)/dT_f_i));
-    Real my_fi = (1-f_i)*switch_func + f_i;
-    // Real my_fi = std::pow(10,(1-std::log10(f_i))*switch_func + std::log10(f_i));
-    Real inv_sqrt_rho = 1.0/std::sqrt(prim(IDN,k,j,i) * my_fi);
-    Real bsq = bcc(IB1,k,j,i)*bcc(IB1,k,j,i)
-              +bcc(IB2,k,j,i)*bcc(IB2,k,j,i)
-              +bcc(IB3,k,j,i)*bcc(IB3,k,j,i);
-
-    Real b_grad_pc = bcc(IB1,k,j,i) * grad_pc(0,k,j,i)
-                   + bcc(IB2,k,j,i) * grad_pc(1,k,j,i)
-                   + bcc(IB3,k,j,i) * grad_pc(2,k,j,i);
-
-    Real va1 = bcc(IB1,k,j,i) * inv_sqrt_rho;
-    Real va2 = bcc(IB2,k,j,i) * inv_sqrt_rho;
-    Real va3 = bcc(IB3,k,j,i) * inv_sqrt_rho;
-
-    Real va = std::sqrt(bsq) * inv_sqrt_rho;
-    Real dpc_sign = 0.0;
-
-    if (b_grad_pc > TINY_NUMBER) dpc_sign = 1.0;
-    else if (-b_grad_pc > TINY_NUMBER) dpc_sign = -1.0;
-
-    if (pcr->stream_flag > 0) {
-      pcr->v_adv(0,k,j,i) = -va1 * dpc_sign;
-      pcr->v_adv(1,k,j,i) = -va2 * dpc_sign;
-      pcr->v_adv(2,k,j,i) = -va3 * dpc_sign;
-      if (va > TINY_NUMBER) {
-        pcr->sigma_adv(0,k,j,i) = std::abs(b_grad_pc)/(std::sqrt(bsq) * va * decouple *
-                               (4.0/3.0) * invlim * u_cr(CRE,k,j,i));
-        pcr->sigma_adv(1,k,j,i) = pcr->max_opacity;
-        pcr->sigma_adv(2,k,j,i) = pcr->max_opacity;
-      }
-    } else {
-      pcr->v_adv(0,k,j,i) = 0.0;
-      pcr->v_adv(1,k,j,i) = 0.0;
-      pcr->v_adv(2,k,j,i) = 0.0;
-      pcr->sigma_adv(0,k,j,i)  = pcr->max_opacity;
-      pcr->sigma_adv(1,k,j,i)  = pcr->max_opacity;
-      pcr->sigma_adv(2,k,j,i)  = pcr->max_opacity;
-    }
-  }
-}
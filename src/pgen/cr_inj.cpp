@@ -26,6 +26,7 @@
 #include <cfloat>      // FLT_MAX
 #include <vector> 
 #include <chrono>
+#include <cstdint>    // int64_t
 
 // Athena++ headers
 #include "../athena.hpp"
@@ -41,6 +42,9 @@
 #include "../hydro/srcterms/hydro_srcterms.hpp"
 #include "../mesh/mesh.hpp"
 #include "../parameter_input.hpp"
+#include "../utils/point_sources.hpp"
+#include "../utils/townsend_cooling.hpp"
+#include "../utils/weighted_sampler.hpp"
 
 
 //======================================================================================
@@ -63,12 +67,12 @@ int uniformInj;
 int uniformCRInj;
 int massWeight;
 
-std::vector<double> X1Inj = {};
-std::vector<double> X2Inj = {};
-std::vector<double> X3Inj = {};
+PointSources *psn = nullptr; // SN sites of the current step, binned by MeshBlock
+TownsendCooling *pcool = nullptr; // tabulated cooling function
 unsigned seed_inj;
 std::default_random_engine gen;
 int NInjs = 0;
+WeightedSampler injSampler; // mass weighted SN sites, reused every step
 int TotalInjs = 0;
 // double lastInjT = 0.0;
 double SNRate = 0.0;
@@ -106,10 +110,9 @@ void mySource(MeshBlock *pmb, const Real time, const Real dt,
                const AthenaArray<Real> &prim, const AthenaArray<Real> &prim_scalar,
                const AthenaArray<Real> &bcc, AthenaArray<Real> &cons,
                AthenaArray<Real> &cons_scalar);
+Real CoolingFunction(Real T);
               
 
-void Diffusion(MeshBlock *pmb, AthenaArray<Real> &u_cr,
-        AthenaArray<Real> &prim, AthenaArray<Real> &bcc);
 
 //Floors for Diode boundary conds
 Real dfloor, pfloor; // Floor values for density and rpessure
@@ -138,7 +141,6 @@ void DiodeCRInnerX2(MeshBlock *pmb, Coordinates *pco, CosmicRay *pcr,
 void MeshBlock::InitUserMeshBlockData(ParameterInput *pin) {
   if (CR_ENABLED) {
     pcr->EnrollUserCRSource(CRSource);
-    pcr->EnrollOpacityFunction(Diffusion);
   }
 }
 
@@ -187,6 +189,10 @@ void Mesh::InitUserMeshData(ParameterInput *pin) {
     sigmaPerp = vmax/(3*kappaPerp);
     sigmaParl = vmax/(3*kappaParl);
     crLoss = pin->GetOrAddReal("problem","crLoss",0.0);
+    // use the built-in anisotropic opacity and streaming
+    pin->SetString("cr","opacity","anisotropic");
+    pin->SetReal("cr","sigma_parl",sigmaParl);
+    pin->SetReal("cr","sigma_perp",sigmaPerp);
     if (rank == 0){
       std::cout << "Vmax = " << vmax / (c / (v_scale)) << " c" << std::endl;
       std::cout << "sigmaParl = " << sigmaParl << std::endl;
@@ -194,6 +200,13 @@ void Mesh::InitUserMeshData(ParameterInput *pin) {
     }
   }
   cooling_flag = pin->GetInteger("problem","cooling");
+  if (cooling_flag != 0) {
+    // tabulate the cooling function from the floor (300 K for CIE) up to 10^10 K
+    Real T_floor = ((cooling_flag == 3) ? 300.0 : 30.0)/T_scale;
+    pcool = new TownsendCooling(T_floor, 1.0e10/T_scale,
+                                pin->GetOrAddInteger("problem","cooling_nbins",1000),
+                                CoolingFunction);
+  }
 
   SNRate = pin->GetReal("problem","SNRate");
   injH = pin->GetOrAddReal("problem","InjH",100); 
@@ -214,6 +227,9 @@ void Mesh::InitUserMeshData(ParameterInput *pin) {
   uniformInj = pin->GetOrAddInteger("problem","uniformInj",0);
   uniformCRInj = pin->GetOrAddInteger("problem","uniformCRInj",0);
 
+  psn = new PointSources(this, injL);
+  psn->OpenLog("injections.bin", pin->GetOrAddInteger("problem","inj_log_buffer",4096));
+
   EnrollUserExplicitSourceFunction(mySource);
   
   if (mesh_bcs[BoundaryFace::inner_x2] == BoundaryFlag::user) {
@@ -254,12 +270,6 @@ void Mesh::InitUserMeshData(ParameterInput *pin) {
 void MeshBlock::ProblemGenerator(ParameterInput *pin) {
   int rank;
   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-  if (rank==0) {
-    std::ofstream myfile;
-    myfile.open("injections.csv",std::ios::out | std::ios::app);
-    myfile << "Cell,X1,X2,X3\n";
-    myfile.close();
-  }
   Mesh *pm = pmy_mesh; 
   Real myGamma = pin->GetReal("hydro","gamma");
 
@@ -409,6 +419,10 @@ void Mesh::UserWorkAfterLoop(ParameterInput *pin) {
   if (rank==0) {
     std::cout << "Total Number of Injections = " << TotalInjs << std::endl;
   }
+  delete psn; // flushes the injection log
+  psn = nullptr;
+  delete pcool;
+  pcool = nullptr;
 }
 
 
@@ -416,18 +430,14 @@ void Mesh::UserWorkAfterLoop(ParameterInput *pin) {
 void Mesh::UserWorkInLoop(void)
 {
   if (uniformInj != 1){
-    int size, rank;
-    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    int rank;
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-    X1Inj.clear();
-    X2Inj.clear();
-    X3Inj.clear();
+    psn->Reset();
     NInjs = 0;
     if ((dt < FLT_MAX) && (time < StopT) && (time > 0.0)) {
         if (massWeight == 0) {
+            std::vector<double> xinj;
             if (rank == 0) {
-                std::ofstream myfile;
-                myfile.open("injections.csv",std::ios::out | std::ios::app);
                 std::poisson_distribution<int> distN(SNRate*dt);
                 NInjs = distN(gen);
                 Real x1d = (mesh_size.x1max - mesh_size.x1min)/float(mesh_size.nx1);
@@ -437,151 +447,69 @@ void Mesh::UserWorkInLoop(void)
                 std::uniform_real_distribution<double> distx2(-1*injH,injH-x2d);
                 std::uniform_real_distribution<double> distx3(mesh_size.x3min+injL/2,mesh_size.x3max - x3d-injL/2);
                 for (int n = 1; n <= NInjs; n++){
-                  X1Inj.insert(X1Inj.end(), round((distx1(gen)-mesh_size.x1min)/x1d)*x1d + mesh_size.x1min + 0.5*x1d);
-                  X2Inj.insert(X2Inj.end(), round((distx2(gen)-mesh_size.x2min)/x2d)*x2d + mesh_size.x2min + 0.5*x2d);
-                  X3Inj.insert(X3Inj.end(), round((distx3(gen)-mesh_size.x3min)/x3d)*x3d + mesh_size.x3min + 0.5*x3d);
-                  myfile <<  0 << ","<< X1Inj[n-1] << "," <<  X2Inj[n-1] << "," <<  X3Inj[n-1] << "\n";
+                  xinj.push_back(round((distx1(gen)-mesh_size.x1min)/x1d)*x1d + mesh_size.x1min + 0.5*x1d);
+                  xinj.push_back(round((distx2(gen)-mesh_size.x2min)/x2d)*x2d + mesh_size.x2min + 0.5*x2d);
+                  xinj.push_back(round((distx3(gen)-mesh_size.x3min)/x3d)*x3d + mesh_size.x3min + 0.5*x3d);
                 }
-                myfile.close();
             }
+            MPI_Bcast(&NInjs,1,MPI_INT,0,MPI_COMM_WORLD);
+            xinj.resize(3*NInjs);
+            MPI_Bcast(xinj.data(),3*NInjs,MPI_DOUBLE,0,MPI_COMM_WORLD);
+            for (int n = 0; n < NInjs; n++)
+              psn->Add(xinj[3*n], xinj[3*n+1], xinj[3*n+2], 0);
         } else {
-          std::vector<double> vecD = {};
-          std::vector<double> vecX1 = {};
-          std::vector<double> vecX2 = {};
-          std::vector<double> vecX3 = {};
+          // each rank only keeps the weights of its own cells; the sites are drawn
+          // from the global distribution by WeightedSampler without gathering them
+          injSampler.Reset();
           for (int b=0; b<nblocal; ++b) {
             MeshBlock *pmb = my_blocks(b);
             for (int k=pmb->ks; k<=pmb->ke; k++) {
               for (int j=pmb->js; j<=pmb->je; j++) {
                 for (int i=pmb->is; i<=pmb->ie; i++) {
-                    Real x1 = pmb->pcoord->x1v(i);
-                    Real x2 = pmb->pcoord->x2v(j);
-                    Real x3 = pmb->pcoord->x3v(k);
+                  Real x2 = pmb->pcoord->x2v(j);
+                  if (fabs(x2) <= injH) {
                     Real density = pmb->phydro->u(IDN,k,j,i);
-                    if (fabs(x2) <= injH) {
-                        vecD.insert(vecD.end(),pow(density,KSLaw));
-                        vecX1.insert(vecX1.end(),x1);
-                        vecX2.insert(vecX2.end(),x2);
-                        vecX3.insert(vecX3.end(),x3);
-                    }
+                    injSampler.Add(pow(density,KSLaw), pmb->pcoord->x1v(i), x2,
+                                   pmb->pcoord->x3v(k));
+                  }
                 }
               }
             }
           }
-          int nelements = (int)vecD.size();
-          
-          // if (nelements > 0) std::cout << rank << " max Element=" << *std::max_element(vecX3.begin() , vecX3.end())<<std::endl; 
-          int global_nelements = 0;
-          // std::cout << nelements << std::endl;
-          // MPI_Reduce(&nelements, &global_nelements, 1, MPI_INT, MPI_SUM, 0,MPI_COMM_WORLD);
-          int nLst[size];
-          int displacements[size];
-          if (rank ==0) {
-              MPI_Gather(&nelements, 1, MPI_INT, nLst, 1, MPI_INT, 0, MPI_COMM_WORLD);
-              global_nelements = std::accumulate(nLst, nLst + size, 0);
-          } else {
-              MPI_Gather(&nelements, 1, MPI_INT, NULL, 0, MPI_INT, 0, MPI_COMM_WORLD);
-          }
-          
-          std::vector<double> allD = {};
-          std::vector<double> allX1 = {};
-          std::vector<double> allX2 = {}; 
-          std::vector<double> allX3 = {};
-          // double* allX1 = NULL;
-          // double* allX2 = NULL;
-          // double* allX3 = NULL;
-          if (rank == 0){
-              // std::cout << global_nelements << std::endl;
-              
-            
-            allD.resize(global_nelements);
-            allX1.resize(global_nelements);
-            allX2.resize(global_nelements);
-            allX3.resize(global_nelements);
-            // allX1 =  new double[global_nelements];
-            // allX2 =  new double[global_nelements];
-            // allX3 =  new double[global_nelements];
-            
-            // std::partial_sum(nLst,nLst + size,displacements);
-            for (int i = 0; i < size; i++)
-               displacements[i] = (i > 0) ? (displacements[i-1] + nLst[i-1]) : 0;
-            // for (int n = 0; n < size; n++){
-            //       std::cout << n << "  " << nLst[n] << " " << displacements[n] << std::endl;
-            // }
-            // std::cout << "Rank 0 Post Reduce elements: "<< global_nelements << " vs " << displacements[size-1]+ nLst[size-1] << std::endl;
-          }
-            // std::cout << "Start Gather" <<std::endl;
-          MPI_Gatherv(vecD.data(), nelements, MPI_DOUBLE, allD.data(), nLst, displacements, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-          MPI_Gatherv(vecX1.data(), nelements, MPI_DOUBLE, allX1.data(), nLst, displacements, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-          MPI_Gatherv(vecX2.data(), nelements, MPI_DOUBLE, allX2.data(), nLst, displacements, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-          MPI_Gatherv(vecX3.data(), nelements, MPI_DOUBLE, allX3.data(), nLst, displacements, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-            // std::cout << "End Gather" <<std::endl;
-//           } else {
-//             MPI_Gatherv(vecD.data(), nelements, MPI_FLOAT, NULL, NULL, NULL, MPI_FLOAT, 0, MPI_COMM_WORLD);
-//             MPI_Gatherv(vecX1.data(), nelements, MPI_FLOAT, NULL, NULL, NULL, MPI_FLOAT, 0, MPI_COMM_WORLD);
-//             MPI_Gatherv(vecX2.data(), nelements, MPI_FLOAT, NULL, NULL, NULL, MPI_FLOAT, 0, MPI_COMM_WORLD);
-//             MPI_Gatherv(vecX3.data(), nelements, MPI_FLOAT, NULL, NULL, NULL, MPI_FLOAT, 0, MPI_COMM_WORLD);
-//           }
-        
-          if (rank== 0) {
-              // std::cout << "max X3 = "<< *std::max_element(allX3.begin() , allX3.end()) << std::endl;
-              // std::cout << "max D = "<< *std::max_element(allD.begin() , allD.end()) << std::endl;
-              std::ofstream myfile;
-              myfile.open("injections.csv",std::ios::out | std::ios::app);
-              std::poisson_distribution<int> distN(SNRate*dt);
-              NInjs = distN(gen);
-              std::discrete_distribution<int> dist(allD.begin(),allD.end());
-              // std::cout << "Total Elements "<< global_nelements << std::endl;
-              for (int n = 1; n <= NInjs; n++){
-                //sample from distribution. 
-                int pick = dist(gen);
-                X1Inj.insert(X1Inj.end(), allX1[pick]);
-                X2Inj.insert(X2Inj.end(), allX2[pick]);
-                X3Inj.insert(X3Inj.end(), allX3[pick]);
-                myfile <<  pick << "," << X1Inj[n-1] << "," <<  X2Inj[n-1] << "," <<  X3Inj[n-1] << "\n";
-                
-                // std::cout << "X1: " << X1Inj[n-1] << std::endl;
-                // std::cout << "X2: " << X2Inj[n-1] << std::endl;
-                // std::cout << "X3: " << X3Inj[n-1] << std::endl;
-              }
-              myfile.close();
+
+          std::vector<Real> injU;
+          if (rank == 0) {
+            std::poisson_distribution<int> distN(SNRate*dt);
+            NInjs = distN(gen);
+            std::uniform_real_distribution<double> distU(0.0, 1.0);
+            for (int n = 0; n < NInjs; n++) injU.push_back(distU(gen));
           }
-          vecD.clear();
-          vecX1.clear();
-          vecX2.clear();
-          vecX3.clear();
+          MPI_Bcast(&NInjs,1,MPI_INT,0,MPI_COMM_WORLD);
+          injU.resize(NInjs);
+          MPI_Bcast(injU.data(),NInjs,MPI_ATHENA_REAL,0,MPI_COMM_WORLD);
+          std::vector<Real> x1(NInjs), x2(NInjs), x3(NInjs);
+          std::vector<std::int64_t> picks(NInjs);
+          injSampler.Draw(NInjs, injU.data(), x1.data(), x2.data(), x3.data(),
+                          picks.data());
+          for (int n = 0; n < NInjs; n++)
+            psn->Add(x1[n], x2[n], x3[n], picks[n]);
         }
 
-    } 
-    
-    //MPI_Bcast(&lastInjT,1,MPI_DOUBLE,0,MPI_COMM_WORLD);
-    MPI_Bcast(&NInjs,1,MPI_INT,0,MPI_COMM_WORLD);
-
-    if ((NInjs > 0) && (rank != 0)){
-      X1Inj.insert(X1Inj.end(),NInjs,FLT_MAX);
-      X2Inj.insert(X2Inj.end(),NInjs,FLT_MAX);
-      X3Inj.insert(X3Inj.end(),NInjs,FLT_MAX);
+        // the source functions only visit the cells of the MeshBlocks overlapped by a SN
+        psn->BinByMeshBlock();
+        psn->LogSources(time);
     }
-
-    MPI_Bcast(X1Inj.data(),NInjs,MPI_DOUBLE,0,MPI_COMM_WORLD);
-    MPI_Bcast(X2Inj.data(),NInjs,MPI_DOUBLE,0,MPI_COMM_WORLD);
-    MPI_Bcast(X3Inj.data(),NInjs,MPI_DOUBLE,0,MPI_COMM_WORLD);
     TotalInjs += NInjs;
-    
   }
 }
 
 
 
-void mySource(MeshBlock *pmb, const Real time, const Real dt,
-               const AthenaArray<Real> &prim, const AthenaArray<Real> &prim_scalar,
-               const AthenaArray<Real> &bcc, AthenaArray<Real> &cons,
-               AthenaArray<Real> &cons_scalar){
+//----------------------------------------------------------------------------------------
+//! \fn Real CoolingFunction(Real T)
+//  \brief Lambda(T) of the selected cooling_flag in code units, tabulated in pcool
 
-  Mesh *pm = pmb->pmy_mesh;
-    
-  const Real Heat    =  2e-26 / (e_scale/t_scale) ;
-  const Real T_floor =  30 / T_scale ; 
+Real CoolingFunction(Real T) {
   // Inoue
   Real lamb_scale = (e_scale * n_scale * n_scale) /t_scale;
   const Real Lamb1_I   =  7.3e-21 / lamb_scale; 
@@ -596,7 +524,6 @@ void mySource(MeshBlock *pmb, const Real time, const Real dt,
   const Real T1b_K     =  1000.0 / T_scale;
   const Real T2_K      =  92.0 /T_scale;
   //CIE
-  const Real T0_C  =  3.0e2 / T_scale ;
   const Real T1_C  =  2.0e3 / T_scale;
   const Real T2_C  =  8.0e3 / T_scale ;
   const Real T3_C  =  1.0e5 / T_scale ;
@@ -617,6 +544,46 @@ void mySource(MeshBlock *pmb, const Real time, const Real dt,
 
   const Real T_switch = 1.40413e4 / T_scale;
 
+  Real Lamb = 0.0;
+  if (cooling_flag == 1) {
+    Lamb = Lamb1_I*exp(-1*T1a_I/(T + T1b_I)) + Lamb2_I*exp(-1*T2_I/T);
+  } else if (cooling_flag == 2) {
+    Lamb = Lamb1_K*exp(-1*T1a_K/(T + T1b_K)) + Lamb2_K*sqrt(T)*exp(-1*T2_K/T);
+  } else if (cooling_flag == 3) {
+    if (T < T1_C) { 
+      Lamb = A1_C * pow(T,a1_C);
+    } else if ((T >= T1_C) && (T< T2_C)){
+      Lamb = A2_C * pow(T,a2_C);
+    } else if ((T>= T2_C) && (T < T3_C)){
+      Lamb = A3_C * pow(T,a3_C);
+    } else if ((T>= T3_C) && (T < T4_C)){
+      Lamb = A4_C * pow(T,a4_C);
+    } else if ((T >= T4_C) ){
+      Lamb = A5_C * pow(T,a5_C);
+    }
+  } else if (cooling_flag == 4) {
+    if (T< T_switch){
+      Lamb = Lamb1_I*exp(-1*T1a_I/(T + T1b_I)) + Lamb2_I*exp(-1*T2_I/T);
+    } else if ((T>= T_switch) && (T < T3_C)){
+      Lamb = A3_C * pow(T,a3_C);
+    } else if ((T>= T3_C) && (T < T4_C)){
+      Lamb = A4_C * pow(T,a4_C);
+    } else if ((T >= T4_C) ){
+      Lamb = A5_C * pow(T,a5_C);
+    }
+  }
+  return Lamb;
+}
+
+void mySource(MeshBlock *pmb, const Real time, const Real dt,
+               const AthenaArray<Real> &prim, const AthenaArray<Real> &prim_scalar,
+               const AthenaArray<Real> &bcc, AthenaArray<Real> &cons,
+               AthenaArray<Real> &cons_scalar){
+
+  Mesh *pm = pmb->pmy_mesh;
+  const Real gm1 = pmb->peos->GetGamma() - 1.0;
+  const Real Heat    =  2e-26 / (e_scale/t_scale) ;
+
   for (int k=pmb->ks; k<=pmb->ke; ++k) {
     for (int j=pmb->js; j<=pmb->je; ++j) {
 #pragma omp simd
@@ -635,68 +602,15 @@ void mySource(MeshBlock *pmb, const Real time, const Real dt,
         //COOLING
         if ((d> dfloor) && (p> pfloor) && (cooling_flag != 0) ) {
           Real T = p/d;
-          Real Lamb = 0.0;
           Real Gam = Heat;
           if (HSE_Gamma == 1) Gam *=  pow(cosh(x2/(nGrav*h)),-1.0*nGrav);
 
-          if (cooling_flag == 1) {
-            Lamb = Lamb1_I*exp(-1*T1a_I/(T + T1b_I)) + Lamb2_I*exp(-1*T2_I/T);
-          } else if (cooling_flag == 2) {
-            Lamb = Lamb1_K*exp(-1*T1a_K/(T + T1b_K)) + Lamb2_K*sqrt(T)*exp(-1*T2_K/T);
-          } else if (cooling_flag == 3) {
-            if ((T >= T0_C) && (T < T1_C)) { 
-              Lamb = A1_C * pow(T,a1_C);
-            } else if ((T >= T1_C) && (T< T2_C)){
-              Lamb = A2_C * pow(T,a2_C);
-            } else if ((T>= T2_C) && (T < T3_C)){
-              Lamb = A3_C * pow(T,a3_C);
-            } else if ((T>= T3_C) && (T < T4_C)){
-              Lamb = A4_C * pow(T,a4_C);
-            } else if ((T >= T4_C) ){
-              Lamb = A5_C * pow(T,a5_C);
-            }
-          } else if (cooling_flag == 4) {
-            if (T< T_switch){
-              Lamb = Lamb1_I*exp(-1*T1a_I/(T + T1b_I)) + Lamb2_I*exp(-1*T2_I/T);
-            } else if ((T>= T_switch) && (T < T3_C)){
-              Lamb = A3_C * pow(T,a3_C);
-            } else if ((T>= T3_C) && (T < T4_C)){
-              Lamb = A4_C * pow(T,a4_C);
-            } else if ((T >= T4_C) ){
-              Lamb = A5_C * pow(T,a5_C);
-            }
-          }
-          Real dEdt = ((T > T_floor) ) ? (d*d*Lamb - d*Gam) : (-1*d*Gam);
-          cons(IEN,k,j,i) -= dEdt*dt;
+          // exact radiative losses above the floor, dT/dt = -gm1*d*Lambda(T), and
+          // heating at the constant rate Gam
+          Real T_new = pcool->Integrate(T, gm1*d*dt);
+          cons(IEN,k,j,i) += d*(T_new - T)/gm1 + d*Gam*dt;
         }
 
-        //INJECTION
-        if (uniformInj != 1){
-
-          Real x1 = pmb->pcoord->x1v(i);
-          Real x2 = pmb->pcoord->x2v(j);
-          Real x3 = pmb->pcoord->x3v(k);
-          Real dx1 = pmb->pcoord->dx1v(i);
-          Real dx2 = pmb->pcoord->dx2v(j);
-          Real dx3 = pmb->pcoord->dx3v(k);
-          Real cellVol = pmb->pcoord->GetCellVolume(k,j,i);
-          for (int m = 0 ; m < NInjs; ++m) {
-            Real x10   = X1Inj[m];
-            Real x20   = X2Inj[m];
-            Real x30   = X3Inj[m];
-            Real ax = (x1 - x10 - dx1/2)/injL;
-            Real bx = (x1 - x10 + dx1/2)/injL;
-            Real ay = (x2 - x20 - dx2/2)/injL;
-            Real by = (x2 - x20 + dx2/2)/injL;
-            Real az = (x3 - x30 - dx3/2)/injL;
-            Real bz = (x3 - x30 + dx3/2)/injL;
-            Real frac = (fmin(0.5,bx) - fmax(-0.5,ax))*(fmin(0.5,by) - fmax(-0.5,ay))*(fmin(0.5,bz) - fmax(-0.5,az));
-
-            if ( ( bx > -0.5) && ( ax < 0.5) && ( by > -0.5) && ( ay < 0.5) && ( bz > -0.5) && ( az < 0.5)) {
-              cons(IEN,k,j,i) += Esn_th/cellVol*frac;
-            }
-          }
-        }
         if (uniformInj == 1){
           Real x2v = abs(pmb->pcoord->x2v(j));
           Real Vol = 2*injH*(pm->mesh_size.x1max - pm->mesh_size.x1min)*(pm->mesh_size.x3max - pm->mesh_size.x3min);
@@ -707,6 +621,9 @@ void mySource(MeshBlock *pmb, const Real time, const Real dt,
       }
     }
   }
+
+  //INJECTION
+  if (uniformInj != 1) psn->Deposit(pmb, Esn_th, cons, IEN);
   return;
 }
 
@@ -715,6 +632,9 @@ void CRSource(MeshBlock *pmb, const Real time, const Real dt,
                 AthenaArray<Real> &u_cr){ 
   Mesh *pm = pmb->pmy_mesh;
   if ((HSE_CR_Forcing == 1) || (Esn_cr > 0.0)) {
+  //INJECTION, before the losses below
+  if ((uniformInj != 1) && (uniformCRInj != 1)) psn->Deposit(pmb, Esn_cr, u_cr, CRE);
+
   for (int k=pmb->ks; k<=pmb->ke; ++k) {
     for (int j=pmb->js; j<=pmb->je; ++j) {
   #pragma omp simd
@@ -727,32 +647,6 @@ void CRSource(MeshBlock *pmb, const Real time, const Real dt,
           u_cr(CRE,k,j,i) += arg*coeff*dt;
         }
 
-        //INJECTION
-        if ((uniformInj != 1) && (uniformCRInj !=1)){
-          Real x1 = pmb->pcoord->x1v(i);
-          Real x2 = pmb->pcoord->x2v(j);
-          Real x3 = pmb->pcoord->x3v(k);
-          Real dx1 = pmb->pcoord->dx1v(i+1);
-          Real dx2 = pmb->pcoord->dx2v(j+1);
-          Real dx3 = pmb->pcoord->dx3v(k+1);
-          Real cellVol = pmb->pcoord->GetCellVolume(k,j,i);
-          for (int m = 0 ; m < NInjs; ++m) {
-            Real x10   = X1Inj.at(m);
-            Real x20   = X2Inj.at(m);
-            Real x30   = X3Inj.at(m);
-            Real ax = (x1 - x10 - dx1/2)/injL;
-            Real bx = (x1 - x10 + dx1/2)/injL;
-            Real ay = (x2 - x20 - dx2/2)/injL;
-            Real by = (x2 - x20 + dx2/2)/injL;
-            Real az = (x3 - x30 - dx3/2)/injL;
-            Real bz = (x3 - x30 + dx3/2)/injL;
-            Real frac = (fmin(0.5,bx) - fmax(-0.5,ax))*(fmin(0.5,by) - fmax(-0.5,ay))*(fmin(0.5,bz) - fmax(-0.5,az));
-
-            if ( ( bx > -0.5) && ( ax < 0.5) && ( by > -0.5) && ( ay < 0.5) && ( bz > -0.5) && ( az < 0.5)) {
-              u_cr(CRE,k,j,i) += Esn_cr/cellVol*frac;
-            }
-          }
-        }
         if ((uniformInj != 1) && (uniformCRInj == 1)){
           Real x2l = pmb->pcoord->x2f(j);
           Real x2u = pmb->pcoord->x2f(j+1);
@@ -791,183 +685,6 @@ void CRSource(MeshBlock *pmb, const Real time, const Real dt,
 
 
 
-void Diffusion(MeshBlock *pmb, AthenaArray<Real> &u_cr,
-               AthenaArray<Real> &prim, AthenaArray<Real> &bcc) {
-  // set the default opacity to be a large value in the default hydro case
-  CosmicRay *pcr=pmb->pcr;
-  int kl=pmb->ks, ku=pmb->ke;
-  int jl=pmb->js, ju=pmb->je;
-  int il=pmb->is-1, iu=pmb->ie+1;
-  if (pmb->block_size.nx2 > 1) {
-    jl -= 1;
-    ju += 1;
-  }
-  if (pmb->block_size.nx3 > 1) {
-    kl -= 1;
-    ku += 1;
-  }
-
-  for(int k=kl; k<=ku; ++k) {
-    for(int j=jl; j<=ju; ++j) {
-#pragma omp simd
-      for(int i=il; i<=iu; ++i) {
-        pcr->sigma_diff(0,k,j,i) = sigmaParl; //sigma_diff is defined with x0 coordinate parallel to local B field
-        pcr->sigma_diff(1,k,j,i) = sigmaPerp;
-        pcr->sigma_diff(2,k,j,i) = sigmaPerp;
-      }
-    }
-  }
-
-  Real invlim=1.0/pcr->vmax;
-
-  // The information stored in the array
-  // b_angle is
-  // b_angle[0]=sin_theta_b
-  // b_angle[1]=cos_theta_b
-  // b_angle[2]=sin_phi_b
-  // b_angle[3]=cos_phi_b
-
-
-
-
-  if (MAGNETIC_FIELDS_ENABLED) {
-    //First, calculate B_dot_grad_Pc
-    for(int k=kl; k<=ku; ++k) {
-      for(int j=jl; j<=ju; ++j) {
-        // x component
-        pmb->pcoord->CenterWidth1(k,j,il-1,iu+1,pcr->cwidth);
-        for(int i=il; i<=iu; ++i) {
-          Real distance = 0.5*(pcr->cwidth(i-1) + pcr->cwidth(i+1))
-                          + pcr->cwidth(i);
-          Real dprdx=(u_cr(CRE,k,j,i+1) - u_cr(CRE,k,j,i-1))/3.0;
-          dprdx /= distance;
-          pcr->b_grad_pc(k,j,i) = bcc(IB1,k,j,i) * dprdx;
-        }
-        // y component
-        pmb->pcoord->CenterWidth2(k,j-1,il,iu,pcr->cwidth1);
-        pmb->pcoord->CenterWidth2(k,j,il,iu,pcr->cwidth);
-        pmb->pcoord->CenterWidth2(k,j+1,il,iu,pcr->cwidth2);
-        for(int i=il; i<=iu; ++i) {
-          Real distance = 0.5*(pcr->cwidth1(i) + pcr->cwidth2(i))
-                         + pcr->cwidth(i);
-          Real dprdy=(u_cr(CRE,k,j+1,i) - u_cr(CRE,k,j-1,i))/3.0;
-          dprdy /= distance;
-          pcr->b_grad_pc(k,j,i) += bcc(IB2,k,j,i) * dprdy;
-        }
-        // z component
-        pmb->pcoord->CenterWidth3(k-1,j,il,iu,pcr->cwidth1);
-        pmb->pcoord->CenterWidth3(k,j,il,iu,pcr->cwidth);
-        pmb->pcoord->CenterWidth3(k+1,j,il,iu,pcr->cwidth2);
-
-        for(int i=il; i<=iu; ++i) {
-          Real distance = 0.5*(pcr->cwidth1(i) + pcr->cwidth2(i))
-                          + pcr->cwidth(i);
-          Real dprdz=(u_cr(CRE,k+1,j,i) - u_cr(CRE,k-1,j,i))/3.0;
-          dprdz /= distance;
-          pcr->b_grad_pc(k,j,i) += bcc(IB3,k,j,i) * dprdz;
-
-          // now only get the sign
-          //  if (pcr->b_grad_pc(k,j,i) > TINY_NUMBER) pcr->b_grad_pc(k,j,i) = 1.0;
-          //  else if (-pcr->b_grad_pc(k,j,i) > TINY_NUMBER) pcr->b_grad_pc(k,j,i)
-          //    = -1.0;
-          //  else pcr->b_grad_pc(k,j,i) = 0.0;
-        }
-
-      // now calculate the streaming velocity
-      // streaming velocity is calculated with respect to the current coordinate
-      //  system
-      // diffusion coefficient is calculated with respect to B direction
-        for(int i=il; i<=iu; ++i) {
-          Real pb= bcc(IB1,k,j,i)*bcc(IB1,k,j,i)
-                  +bcc(IB2,k,j,i)*bcc(IB2,k,j,i)
-                  +bcc(IB3,k,j,i)*bcc(IB3,k,j,i);
-          Real inv_sqrt_rho = 1.0/std::sqrt(prim(IDN,k,j,i));
-          Real va1 = bcc(IB1,k,j,i)*inv_sqrt_rho;
-          Real va2 = bcc(IB2,k,j,i)*inv_sqrt_rho;
-          Real va3 = bcc(IB3,k,j,i)*inv_sqrt_rho;
-
-          Real va = std::sqrt(pb/prim(IDN,k,j,i));
-
-          Real dpc_sign = 0.0;
-          if (pcr->b_grad_pc(k,j,i) > TINY_NUMBER) dpc_sign = 1.0;
-          else if (-pcr->b_grad_pc(k,j,i) > TINY_NUMBER) dpc_sign = -1.0;
-
-          pcr->v_adv(0,k,j,i) = -va1 * dpc_sign;
-          pcr->v_adv(1,k,j,i) = -va2 * dpc_sign;
-          pcr->v_adv(2,k,j,i) = -va3 * dpc_sign;
-
-          // now the diffusion coefficient
-
-          if (va < TINY_NUMBER) {
-            pcr->sigma_adv(0,k,j,i) = pcr->max_opacity;
-          } else {
-            pcr->sigma_adv(0,k,j,i) = std::abs(pcr->b_grad_pc(k,j,i))
-                          /(std::sqrt(pb)* va * (1.0 + 1.0/3.0)
-                                    * invlim * u_cr(CRE,k,j,i));
-          }
-
-          pcr->sigma_adv(1,k,j,i) = pcr->max_opacity;
-          pcr->sigma_adv(2,k,j,i) = pcr->max_opacity;
-
-          // Now calculate the angles of B
-          Real bxby = std::sqrt(bcc(IB1,k,j,i)*bcc(IB1,k,j,i) +
-                           bcc(IB2,k,j,i)*bcc(IB2,k,j,i));
-          Real btot = std::sqrt(pb);
-          if (btot > TINY_NUMBER) {
-            pcr->b_angle(0,k,j,i) = bxby/btot;
-            pcr->b_angle(1,k,j,i) = bcc(IB3,k,j,i)/btot;
-          } else {
-            pcr->b_angle(0,k,j,i) = 1.0;
-            pcr->b_angle(1,k,j,i) = 0.0;
-          }
-          if (bxby > TINY_NUMBER) {
-            pcr->b_angle(2,k,j,i) = bcc(IB2,k,j,i)/bxby;
-            pcr->b_angle(3,k,j,i) = bcc(IB1,k,j,i)/bxby;
-          } else {
-            pcr->b_angle(2,k,j,i) = 0.0;
-            pcr->b_angle(3,k,j,i) = 1.0;
-          }
-        }
-      }
-    }
-  } else {
-  for(int k=kl; k<=ku; ++k) {
-    for(int j=jl; j<=ju; ++j) {
-  // x component
-      pmb->pcoord->CenterWidth1(k,j,il-1,iu+1,pcr->cwidth);
-      for(int i=il; i<=iu; ++i) {
-         Real distance = 0.5*(pcr->cwidth(i-1) + pcr->cwidth(i+1))
-                        + pcr->cwidth(i);
-         Real grad_pr=(u_cr(CRE,k,j,i+1) - u_cr(CRE,k,j,i-1))/3.0;
-         grad_pr /= distance;
-         Real va = 0.0;
-         if (va < TINY_NUMBER) {
-           pcr->sigma_adv(0,k,j,i) = pcr->max_opacity;
-           pcr->v_adv(0,k,j,i) = 0.0;
-         } else {
-           Real sigma2 = std::abs(grad_pr)/(va * (1.0 + 1.0/3.0)
-                             * invlim * u_cr(CRE,k,j,i));
-           if (std::abs(grad_pr) < TINY_NUMBER) {
-             pcr->sigma_adv(0,k,j,i) = 0.0;
-             pcr->v_adv(0,k,j,i) = 0.0;
-           } else {
-             pcr->sigma_adv(0,k,j,i) = sigma2;
-             pcr->v_adv(0,k,j,i) = -va * grad_pr/std::abs(grad_pr);
-           }
-        }
-        pcr->sigma_adv(1,k,j,i) = pcr->max_opacity;
-        pcr->sigma_adv(2,k,j,i) = pcr->max_opacity;
-
-        pcr->v_adv(1,k,j,i) = 0.0;
-        pcr->v_adv(2,k,j,i) = 0.0;
-      }
-    }
-  }
-  }
-}
-
-
-
 //----------------------------------------------------------------------------------------
 //! \fn void DiodeInnerX2(MeshBlock *pmb, Coordinates *pco,
 //!                             AthenaArray<Real> &prim, FaceField &b, Real time, Real dt,
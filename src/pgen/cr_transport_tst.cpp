@@ -58,26 +58,24 @@ void Streaming(MeshBlock *pmb, AthenaArray<Real> &u_cr,
 
 void MeshBlock::InitUserMeshBlockData(ParameterInput *pin) {
   if (CR_ENABLED) {
+    // read here rather than in ProblemGenerator, which is skipped on restarts
+    Real kappa = pin->GetOrAddReal("cr","kappa",1);
+    sigma = pcr->vmax/(3*kappa);
     pcr->EnrollOpacityFunction(Opacity);
     pcr->EnrollStreamingFunction(Streaming);
   }
+  f_i = pin->GetOrAddReal("problem","f_i",1);
+  decouple = pin->GetOrAddReal("problem","A",1);
 }
 
 
 void MeshBlock::ProblemGenerator(ParameterInput *pin) {
-  // read in the mean velocity, diffusion coefficient
-  Real vmax = pcr->vmax;
-  Real kappa = pin->GetOrAddReal("cr","kappa",1);
-  sigma = vmax/(3*kappa);
+  // read in the initial profile
   Real beta = pin->GetOrAddReal("problem","beta",1);
   Real beta_cr = pin->GetOrAddReal("problem","beta_cr",1);
   Real d0 =  pin->GetOrAddReal("problem","d0",1);
   Real p0 = pin->GetOrAddReal("problem","p0",1);
   Real dev =  pin->GetOrAddReal("problem","width",1);
-  f_i = pin->GetOrAddReal("problem","f_i",1);
-  decouple = pin->GetOrAddReal("problem","A",1);
-
-
   Real gamma = peos->GetGamma();
   // Initialize hydro variable
   for(int k=ks; k<=ke; ++k) {
@@ -37,14 +37,34 @@
 #include "../hydro/srcterms/hydro_srcterms.hpp"
 #include "../mesh/mesh.hpp"
 #include "../parameter_input.hpp"
+#include "../utils/townsend_cooling.hpp"
 
 namespace {
   Real unit_density_in_nH_;
   Real unit_E_in_cgs_;
   Real unit_time_in_s_;
-  Real cooling_cfl;
   Real v_max;
   int sign(Real number);
+  TownsendCooling *pcool = nullptr;
+
+  // Assuming units of v = 10^5 cm/s, l = 1 pc, n = 1/cm^3, m = 1 m_p
+  // therefore conversions are:
+  //         multiply by 5.420598489365e-28 for cgs erg/s
+  //         multiply by 5.420598489365e-28 for cgs erg cm^3 /s
+  //         multiply by 1.21147513e+02 for K
+  const Real Heat    =  3.68962948e+01 ;
+  const Real T_floor =  1.65087995e-01 ;
+  // Inoue
+  const Real Lamb1_I   =  3.65000000e+05 ; // Note these are Lambda/Gamma Terms
+  const Real Lamb2_I   =  3.95000000e-01 ;
+  const Real T1a_I     =  9.77320931e+02 ;
+  const Real T1b_I     =  1.23815996e+01 ;
+  const Real T2_I      =  7.59404778e-01 ;
+
+  // Koyama & Inutsuka (2002), in cgs with T in K
+  const Real k_b = 1.381e-16;
+  const Real Heating = 2e-26;
+  const Real T_floor_K = 20.0;
 }
 
 //======================================================================================
@@ -71,15 +91,10 @@ void mySource(MeshBlock *pmb, const Real time, const Real dt,
                const AthenaArray<Real> &bcc, AthenaArray<Real> &cons,
                AthenaArray<Real> &cons_scalar);
 
-Real CoolingAndHeatingRate(Real T, Real nH);              
-
-void Diffusion(MeshBlock *pmb, AthenaArray<Real> &u_cr,
-        AthenaArray<Real> &prim, AthenaArray<Real> &bcc);
 
 
 void MeshBlock::InitUserMeshBlockData(ParameterInput *pin) {
   if (CR_ENABLED) {
-    pcr->EnrollOpacityFunction(Diffusion);
     bool lossFlag = (pin->GetOrAddReal("problem","crLoss",0.0) > 0.0);
     if (lossFlag) {
         pcr->EnrollUserCRSource(CRSource);
@@ -96,11 +111,28 @@ void Mesh::InitUserMeshData(ParameterInput *pin) {
     sigmaPerp = vmax/(3*kappaPerp);
     sigmaParl = vmax/(3*kappaParl);
     crLoss = pin->GetOrAddReal("problem","crLoss",0.0);
+    // use the built-in anisotropic opacity and streaming
+    pin->SetString("cr","opacity","anisotropic");
+    pin->SetReal("cr","sigma_parl",sigmaParl);
+    pin->SetReal("cr","sigma_perp",sigmaPerp);
   }
   cooling_flag = pin->GetInteger("problem","cooling");
   if (cooling_flag != 0) {
     //EnrollUserTimeStepFunction(CoolingTimeStep);
     EnrollUserExplicitSourceFunction(mySource);
+    // tabulate the cooling function up to 10^9 K for the exact integration
+    int nbins = pin->GetOrAddInteger("problem","cooling_nbins",1000);
+    if (cooling_flag == 1) {
+      pcool = new TownsendCooling(T_floor, 1.0e9/1.21147513e+02, nbins, [](Real T) {
+        return Heat*(Lamb1_I*std::exp(-1*T1a_I/(T + T1b_I))
+                     + Lamb2_I*std::exp(-1*T2_I/T));
+      });
+    } else if (cooling_flag == 2) {
+      pcool = new TownsendCooling(T_floor_K, 1.0e9, nbins, [](Real T) {
+        return 2e-26*(1e7*std::exp(-1.184e5/(T+ 1e3))
+                      + 1.4e-2*std::sqrt(T)*std::exp(-92/T));
+      });
+    }
   }
   
   Real unit_length_in_cm_  = pin->GetOrAddReal("problem","unit_length_in_cm_", 3.086e+18);
@@ -108,7 +140,6 @@ void Mesh::InitUserMeshData(ParameterInput *pin) {
   unit_density_in_nH_ = pin->GetOrAddReal("problem","unit_density_in_nH_", 1);
   unit_E_in_cgs_ = 1.67e-24 * 1.4 * unit_density_in_nH_ * unit_vel_in_cms_ * unit_vel_in_cms_;
   unit_time_in_s_ = unit_length_in_cm_/unit_vel_in_cms_;
-  cooling_cfl = pin->GetOrAddReal("problem", "cooling_cfl", 0.1);
   v_max = pin->GetOrAddReal("problem", "v_max", 80.0);
 
   // turb_flag is initialzed in the Mesh constructor to 0 by default;
@@ -127,36 +158,21 @@ void Mesh::InitUserMeshData(ParameterInput *pin) {
   return;
 }
 
-// sub-cycling method for computing the cooling time step
+void Mesh::UserWorkAfterLoop(ParameterInput *pin) {
+  delete pcool;
+  pcool = nullptr;
+}
+
+// radiative cooling integrated exactly with the tabulated cooling function, followed
+// by the heating, which does not depend on the temperature
 void mySource(MeshBlock *pmb, const Real time, const Real dt,
                const AthenaArray<Real> &prim, const AthenaArray<Real> &prim_scalar,
                const AthenaArray<Real> &bcc, AthenaArray<Real> &cons,
                AthenaArray<Real> &cons_scalar){
-    
-  // Assuming units of v = 10^5 cm/s, l = 1 pc, n = 1/cm^3, m = 1 m_p
-  // therefore conversions are:
-  //         multiply by 5.420598489365e-28 for cgs erg/s
-  //         multiply by 5.420598489365e-28 for cgs erg cm^3 /s
-  //         multiply by 1.21147513e+02 for K
-  const Real Heat    =  3.68962948e+01 ;
-  const Real T_floor =  1.65087995e-01 ; 
-  // Inoue
-  const Real Lamb1_I   =  3.65000000e+05 ; // Note these are Lambda/Gamma Terms
-  const Real Lamb2_I   =  3.95000000e-01 ;
-  const Real T1a_I     =  9.77320931e+02 ;
-  const Real T1b_I     =  1.23815996e+01 ;
-  const Real T2_I      =  7.59404778e-01 ;
-  // Koyama
-  const Real Lamb1_K   =  1.00000000e+07 ;
-  const Real Lamb2_K   =  1.54093843e-01 ;
-  const Real T1a_K     =  9.47605092e+02 ;
-  const Real T1b_K     =  8.25439976e+00 ;
-  const Real T2_K      =  7.59404778e-01 ;
   Real pfloor = pmb->peos->GetPressureFloor();
   Real dfloor = pmb->peos->GetDensityFloor();
   Real      g = pmb->peos->GetGamma();
-  const Real k_b = 1.381e-16;
-  Real E, E_ergs, T, T0, dEDdt, dEdt;
+  const Real dt_s = dt*unit_time_in_s_;
   AthenaArray<Real> &u = cons;
 
   for (int k=pmb->ks; k<=pmb->ke; ++k) {
@@ -167,43 +183,17 @@ void mySource(MeshBlock *pmb, const Real time, const Real dt,
         Real p = prim(IPR,k,j,i);
 
         if ((d> dfloor) && (p> pfloor) ) {
-          if (cooling_flag != 2){ 
+          if (cooling_flag == 1) {
+            // code units: dT/dt = -(g-1)*d*Heat*Lambda(T) + (g-1)*Heat
             Real T = p/d;
-            Real Lamb = 0.0;
-            if (cooling_flag == 1) {
-              Lamb = Lamb1_I*exp(-1*T1a_I/(T + T1b_I)) + Lamb2_I*exp(-1*T2_I/T);
-            } else if (cooling_flag == 2) {
-              Lamb = Lamb1_K*exp(-1*T1a_K/(T + T1b_K)) + Lamb2_K*sqrt(T)*exp(-1*T2_K/T);
-            }
-            Real dEdt = ((T > T_floor) ) ? d*Heat*( d*Lamb - 1) : -1*d*Heat;
-            cons(IEN,k,j,i) -= dEdt*dt;
-          } else {
-            Real   nH   = prim(IDN,k,j,i)*unit_density_in_nH_;
-            E = prim(IPR,k,j,i)/(g-1.0);
-            E_ergs  = E * unit_E_in_cgs_ / nH;
-            T       = T0 = E_ergs / (1.5*k_b);
-            Real remain_dt = dt;
-            Real tc = 0.0;
-            //std::cout<<"ED, Ergs, T, dEdt = "<<ED<<", "<<E_ergs<<", "<<T<<", "<<dEdt<<std::endl;
-            // sub-cycling method to evaluate the energy
-            while (remain_dt > 0.0) {
-              E_ergs = E * unit_E_in_cgs_ / nH;
-              T      = E_ergs / (1.5*k_b);
-              if ( T < 0.0 ){
-                std::cout<<"T, T0 = "<< T <<", "<<T0<<std::endl;
-                std::stringstream msg;
-                msg << "### FATAL ERROR in pgen::mySource, T  < 0 " << std::endl;
-                throw std::runtime_error(msg.str().c_str());
-              }
-              dEdt = CoolingAndHeatingRate(T, nH);
-              dEDdt = (dEdt * nH / unit_E_in_cgs_) * unit_time_in_s_;
-              tc = std::min(remain_dt, cooling_cfl*std::abs(E/dEDdt));
-
-              E += dEDdt*tc;
-              if (E < pfloor/(g - 1.0))
-                E = pfloor/(g - 1.0);
-              remain_dt -= tc;
-            }
+            Real T_new = pcool->Integrate(T, (g-1.0)*d*dt);
+            cons(IEN,k,j,i) += d*(T_new - T)/(g-1.0) + d*Heat*dt;
+          } else if (cooling_flag == 2) {
+            // cgs: dT/dt = (Heating - nH*Lambda(T))/(1.5*k_b), per H atom
+            Real nH = d*unit_density_in_nH_;
+            Real T  = (p/(g-1.0))*unit_E_in_cgs_/(nH*1.5*k_b);
+            T = pcool->Integrate(T, nH*dt_s/(1.5*k_b)) + Heating*dt_s/(1.5*k_b);
+            Real E = std::max(1.5*k_b*T*nH/unit_E_in_cgs_, pfloor/(g - 1.0));
             // Apply the final energy to the conserved variable
             if (NON_BAROTROPIC_EOS) {
               u(IEN,k,j,i) = E
@@ -216,25 +206,12 @@ void mySource(MeshBlock *pmb, const Real time, const Real dt,
             }
           }
         }
-        
       }
     }
   }
   return;
 }
 
-// Return the Cooling rate in cgs unit 
-// Input T in K, nH in  cm^-3
-Real CoolingAndHeatingRate(Real T, Real nH){
-  Real Heating = 2e-26;
-  Real Cooling = 2e-26*nH*(1e7*exp(-1.184e5/(T+ 1e3)) + 1.4e-2*sqrt(T)*exp(-92/T));
-  Real dEdt = Heating;
-  if (T > 20.0) {
-    dEdt = dEdt - Cooling;
-  }
-  return dEdt;
-}
-
 void CRSource(MeshBlock *pmb, const Real time, const Real dt,
                 const AthenaArray<Real> &prim, FaceField &b, 
                 AthenaArray<Real> &u_cr){ 
@@ -357,179 +334,6 @@ void MeshBlock::ProblemGenerator(ParameterInput *pin) {
   return;
 }
 
-void Diffusion(MeshBlock *pmb, AthenaArray<Real> &u_cr,
-               AthenaArray<Real> &prim, AthenaArray<Real> &bcc) {
-  // set the default opacity to be a large value in the default hydro case
-  CosmicRay *pcr=pmb->pcr;
-  int kl=pmb->ks, ku=pmb->ke;
-  int jl=pmb->js, ju=pmb->je;
-  int il=pmb->is-1, iu=pmb->ie+1;
-  if (pmb->block_size.nx2 > 1) {
-    jl -= 1;
-    ju += 1;
-  }
-  if (pmb->block_size.nx3 > 1) {
-    kl -= 1;
-    ku += 1;
-  }
-
-  for(int k=kl; k<=ku; ++k) {
-    for(int j=jl; j<=ju; ++j) {
-#pragma omp simd
-      for(int i=il; i<=iu; ++i) {
-        pcr->sigma_diff(0,k,j,i) = sigmaParl; //sigma_diff is defined with x0 coordinate parallel to local B field
-        pcr->sigma_diff(1,k,j,i) = sigmaPerp;
-        pcr->sigma_diff(2,k,j,i) = sigmaPerp;
-      }
-    }
-  }
-
-  Real invlim=1.0/pcr->vmax;
-
-  // The information stored in the array
-  // b_angle is
-  // b_angle[0]=sin_theta_b
-  // b_angle[1]=cos_theta_b
-  // b_angle[2]=sin_phi_b
-  // b_angle[3]=cos_phi_b
-
-  if (MAGNETIC_FIELDS_ENABLED) {
-    //First, calculate B_dot_grad_Pc
-    for(int k=kl; k<=ku; ++k) {
-      for(int j=jl; j<=ju; ++j) {
-        // x component
-        pmb->pcoord->CenterWidth1(k,j,il-1,iu+1,pcr->cwidth);
-        for(int i=il; i<=iu; ++i) {
-          Real distance = 0.5*(pcr->cwidth(i-1) + pcr->cwidth(i+1))
-                          + pcr->cwidth(i);
-          Real dprdx=(u_cr(CRE,k,j,i+1) - u_cr(CRE,k,j,i-1))/3.0;
-          dprdx /= distance;
-          pcr->b_grad_pc(k,j,i) = bcc(IB1,k,j,i) * dprdx;
-        }
-        // y component
-        pmb->pcoord->CenterWidth2(k,j-1,il,iu,pcr->cwidth1);
-        pmb->pcoord->CenterWidth2(k,j,il,iu,pcr->cwidth);
-        pmb->pcoord->CenterWidth2(k,j+1,il,iu,pcr->cwidth2);
-        for(int i=il; i<=iu; ++i) {
-          Real distance = 0.5*(pcr->cwidth1(i) + pcr->cwidth2(i))
-                         + pcr->cwidth(i);
-          Real dprdy=(u_cr(CRE,k,j+1,i) - u_cr(CRE,k,j-1,i))/3.0;
-          dprdy /= distance;
-          pcr->b_grad_pc(k,j,i) += bcc(IB2,k,j,i) * dprdy;
-        }
-        // z component
-        pmb->pcoord->CenterWidth3(k-1,j,il,iu,pcr->cwidth1);
-        pmb->pcoord->CenterWidth3(k,j,il,iu,pcr->cwidth);
-        pmb->pcoord->CenterWidth3(k+1,j,il,iu,pcr->cwidth2);
-
-        for(int i=il; i<=iu; ++i) {
-          Real distance = 0.5*(pcr->cwidth1(i) + pcr->cwidth2(i))
-                          + pcr->cwidth(i);
-          Real dprdz=(u_cr(CRE,k+1,j,i) - u_cr(CRE,k-1,j,i))/3.0;
-          dprdz /= distance;
-          pcr->b_grad_pc(k,j,i) += bcc(IB3,k,j,i) * dprdz;
-
-          // now only get the sign
-          //  if (pcr->b_grad_pc(k,j,i) > TINY_NUMBER) pcr->b_grad_pc(k,j,i) = 1.0;
-          //  else if (-pcr->b_grad_pc(k,j,i) > TINY_NUMBER) pcr->b_grad_pc(k,j,i)
-          //    = -1.0;
-          //  else pcr->b_grad_pc(k,j,i) = 0.0;
-        }
-
-      // now calculate the streaming velocity
-      // streaming velocity is calculated with respect to the current coordinate
-      //  system
-      // diffusion coefficient is calculated with respect to B direction
-        for(int i=il; i<=iu; ++i) {
-          Real pb= bcc(IB1,k,j,i)*bcc(IB1,k,j,i)
-                  +bcc(IB2,k,j,i)*bcc(IB2,k,j,i)
-                  +bcc(IB3,k,j,i)*bcc(IB3,k,j,i);
-          Real inv_sqrt_rho = 1.0/std::sqrt(prim(IDN,k,j,i));
-          Real va1 = bcc(IB1,k,j,i)*inv_sqrt_rho;
-          Real va2 = bcc(IB2,k,j,i)*inv_sqrt_rho;
-          Real va3 = bcc(IB3,k,j,i)*inv_sqrt_rho;
-
-          Real va = std::sqrt(pb/prim(IDN,k,j,i));
-
-          Real dpc_sign = 0.0;
-          if (pcr->b_grad_pc(k,j,i) > TINY_NUMBER) dpc_sign = 1.0;
-          else if (-pcr->b_grad_pc(k,j,i) > TINY_NUMBER) dpc_sign = -1.0;
-
-          pcr->v_adv(0,k,j,i) = -va1 * dpc_sign;
-          pcr->v_adv(1,k,j,i) = -va2 * dpc_sign;
-          pcr->v_adv(2,k,j,i) = -va3 * dpc_sign;
-
-          // now the diffusion coefficient
-
-          if (va < TINY_NUMBER) {
-            pcr->sigma_adv(0,k,j,i) = pcr->max_opacity;
-          } else {
-            pcr->sigma_adv(0,k,j,i) = std::abs(pcr->b_grad_pc(k,j,i))
-                          /(std::sqrt(pb)* va * (1.0 + 1.0/3.0)
-                                    * invlim * u_cr(CRE,k,j,i));
-          }
-
-          pcr->sigma_adv(1,k,j,i) = pcr->max_opacity;
-          pcr->sigma_adv(2,k,j,i) = pcr->max_opacity;
-
-          // Now calculate the angles of B
-          Real bxby = std::sqrt(bcc(IB1,k,j,i)*bcc(IB1,k,j,i) +
-                           bcc(IB2,k,j,i)*bcc(IB2,k,j,i));
-          Real btot = std::sqrt(pb);
-          if (btot > TINY_NUMBER) {
-            pcr->b_angle(0,k,j,i) = bxby/btot;
-            pcr->b_angle(1,k,j,i) = bcc(IB3,k,j,i)/btot;
-          } else {
-            pcr->b_angle(0,k,j,i) = 1.0;
-            pcr->b_angle(1,k,j,i) = 0.0;
-          }
-          if (bxby > TINY_NUMBER) {
-            pcr->b_angle(2,k,j,i) = bcc(IB2,k,j,i)/bxby;
-            pcr->b_angle(3,k,j,i) = bcc(IB1,k,j,i)/bxby;
-          } else {
-            pcr->b_angle(2,k,j,i) = 0.0;
-            pcr->b_angle(3,k,j,i) = 1.0;
-          }
-        }
-      }
-    }
-  } else {
-  for(int k=kl; k<=ku; ++k) {
-    for(int j=jl; j<=ju; ++j) {
-  // x component
-      pmb->pcoord->CenterWidth1(k,j,il-1,iu+1,pcr->cwidth);
-      for(int i=il; i<=iu; ++i) {
-         Real distance = 0.5*(pcr->cwidth(i-1) + pcr->cwidth(i+1))
-                        + pcr->cwidth(i);
-         Real grad_pr=(u_cr(CRE,k,j,i+1) - u_cr(CRE,k,j,i-1))/3.0;
-         grad_pr /= distance;
-         Real va = 0.0;
-         if (va < TINY_NUMBER) {
-           pcr->sigma_adv(0,k,j,i) = pcr->max_opacity;
-           pcr->v_adv(0,k,j,i) = 0.0;
-         } else {
-           Real sigma2 = std::abs(grad_pr)/(va * (1.0 + 1.0/3.0)
-                             * invlim * u_cr(CRE,k,j,i));
-           if (std::abs(grad_pr) < TINY_NUMBER) {
-             pcr->sigma_adv(0,k,j,i) = 0.0;
-             pcr->v_adv(0,k,j,i) = 0.0;
-           } else {
-             pcr->sigma_adv(0,k,j,i) = sigma2;
-             pcr->v_adv(0,k,j,i) = -va * grad_pr/std::abs(grad_pr);
-           }
-        }
-        pcr->sigma_adv(1,k,j,i) = pcr->max_opacity;
-        pcr->sigma_adv(2,k,j,i) = pcr->max_opacity;
-
-        pcr->v_adv(1,k,j,i) = 0.0;
-        pcr->v_adv(2,k,j,i) = 0.0;
-      }
-    }
-  }
-  }
-}
-
-
 void MeshBlock::UserWorkInLoop() {
   //set velocity floors
   for (int k=ks; k<=ke; k++) {
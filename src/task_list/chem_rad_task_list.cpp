@@ -20,11 +20,14 @@
 #include "../mesh/mesh.hpp"
 #include "chem_rad_task_list.hpp"
 #include "task_list.hpp"
+#include "task_timer.hpp"
 
 //--------------------------------------------------------------------------------------
 //! ChemRadiationIntegratorTaskList constructor
 ChemRadiationIntegratorTaskList::ChemRadiationIntegratorTaskList(ParameterInput *pin,
                                                                  Mesh *pm) {
+  ptimer_ = TaskTimer::Get("ChemRadiation",
+                           ChemRadiationIntegratorTaskNames::kTaskNames);
   integrator = CHEMRADIATION_INTEGRATOR;
   // Now assemble list of tasks for each step of chemistry integrator
   {using namespace ChemRadiationIntegratorTaskNames; // NOLINT (build/namespace)
@@ -63,6 +66,7 @@ ChemRadiationIntegratorTaskList::ChemRadiationIntegratorTaskList(ParameterInput
 //! \brief Sets id and dependency for "ntask" member of task_list_ array, then iterates
 //! value of ntask.
 void ChemRadiationIntegratorTaskList::AddTask(const TaskID& id, const TaskID& dep) {
+  task_list_.emplace_back();
   task_list_[ntasks].task_id=id;
   task_list_[ntasks].dependency=dep;
 
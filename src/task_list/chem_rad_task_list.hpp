@@ -76,6 +76,12 @@ const TaskID RECV_SEND_COL_IX3(12);
 const TaskID RECV_SEND_COL_OX3(13);
 const TaskID CLEAR_SIXRAY_RECV(14);
 const TaskID UPDATE_RAD(15);
+
+//! names of the tasks above indexed by ID number, for the task timing report
+const char *const kTaskNames[] = {"NONE", "INT_CONST", "GET_COL_MB_IX1", "GET_COL_MB_OX1",
+  "GET_COL_MB_IX2", "GET_COL_MB_OX2", "GET_COL_MB_IX3", "GET_COL_MB_OX3",
+  "RECV_SEND_COL_IX1", "RECV_SEND_COL_OX1", "RECV_SEND_COL_IX2", "RECV_SEND_COL_OX2",
+  "RECV_SEND_COL_IX3", "RECV_SEND_COL_OX3", "CLEAR_SIXRAY_RECV", "UPDATE_RAD"};
 } // namespace ChemRadiationIntegratorTaskNames
 
 #endif // TASK_LIST_CHEM_RAD_TASK_LIST_HPP_
@@ -0,0 +1,246 @@
+//========================================================================================
+// Athena++ astrophysical MHD code
+// Copyright(C) 2014 James M. Stone <jmstone@princeton.edu> and other code contributors
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+//! \file cr_subcycle_task_list.cpp
+//! \brief CR transport substeps taken within each stage of the time integrator
+//!
+//! Each substep advances the CR variables by beta*dt/nsubcycle with the hydro
+//! primitives of the start of the stage. The momentum and energy exchanged with the gas
+//! in these substeps is accumulated and added to the hydro variables by
+//! TimeIntegratorTaskList::AddSourceTermsCRTC() after the hydro update.
+
+// C headers
+
+// C++ headers
+#include <iostream>   // endl
+#include <sstream>    // sstream
+#include <stdexcept>  // runtime_error
+#include <string>     // c_str()
+#include <vector>     // vector
+
+// Athena++ headers
+#include "../athena.hpp"
+#include "../bvals/bvals.hpp"
+#include "../cr/cr.hpp"
+#include "../cr/integrators/cr_integrators.hpp"
+#include "../field/field.hpp"
+#include "../hydro/hydro.hpp"
+#include "../mesh/mesh.hpp"
+#include "../parameter_input.hpp"
+#include "cr_subcycle_task_list.hpp"
+#include "task_list.hpp"
+#include "task_timer.hpp"
+
+//----------------------------------------------------------------------------------------
+//! CRSubcycleTaskList constructor
+
+CRSubcycleTaskList::CRSubcycleTaskList(ParameterInput *pin, Mesh *pm,
+                                       TimeIntegratorTaskList *ptlist) :
+    nsub(ptlist->cr_nsubcycle), isub(1), ptlist_(ptlist) {
+  ptimer_ = TaskTimer::Get("CRSubcycle", CRSubcycleTaskNames::kTaskNames);
+  nstages = ptlist->nstages;
+
+  {using namespace CRSubcycleTaskNames; // NOLINT (build/namespace)
+    AddTask(CALC_CRFLX,NONE);
+    if (pm->multilevel) {
+      AddTask(SEND_CRFLX,CALC_CRFLX);
+      AddTask(RECV_CRFLX,CALC_CRFLX);
+      AddTask(INT_CR,RECV_CRFLX);
+    } else {
+      AddTask(INT_CR,CALC_CRFLX);
+    }
+    AddTask(SRCTERM_CR,INT_CR);
+    AddTask(SEND_CR,SRCTERM_CR);
+    AddTask(RECV_CR,NONE);
+    AddTask(SETB_CR,(RECV_CR|SRCTERM_CR));
+    if (pm->multilevel) {
+      AddTask(PROLONG_CR,(SEND_CR|SETB_CR));
+      AddTask(PHY_BVAL_CR,PROLONG_CR);
+    } else {
+      AddTask(PHY_BVAL_CR,(SEND_CR|SETB_CR));
+    }
+    AddTask(CR_OPACITY,PHY_BVAL_CR);
+    if (pm->multilevel) {
+      AddTask(CLEAR_CRBND,(CR_OPACITY|SEND_CRFLX));
+    } else {
+      AddTask(CLEAR_CRBND,CR_OPACITY);
+    }
+  } // end of using namespace block
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void CRSubcycleTaskList::AddTask(const TaskID& id, const TaskID& dep)
+//! \brief Sets id and dependency for "ntask" member of task_list_ array, then iterates
+//! value of ntask.
+
+void CRSubcycleTaskList::AddTask(const TaskID& id, const TaskID& dep) {
+  task_list_.emplace_back();
+  task_list_[ntasks].task_id=id;
+  task_list_[ntasks].dependency=dep;
+
+  using namespace CRSubcycleTaskNames; // NOLINT (build/namespace)
+  if (id == CLEAR_CRBND) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (TaskList::*)(MeshBlock*,int)>
+        (&CRSubcycleTaskList::ClearCRBoundary);
+    task_list_[ntasks].lb_time = false;
+  } else if (id == CALC_CRFLX) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (TaskList::*)(MeshBlock*,int)>
+        (&CRSubcycleTaskList::CalculateCRFlux);
+    task_list_[ntasks].lb_time = true;
+  } else if (id == SEND_CRFLX) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (TaskList::*)(MeshBlock*,int)>
+        (&CRSubcycleTaskList::SendCRFlux);
+    task_list_[ntasks].lb_time = true;
+  } else if (id == RECV_CRFLX) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (TaskList::*)(MeshBlock*,int)>
+        (&CRSubcycleTaskList::ReceiveAndCorrectCRFlux);
+    task_list_[ntasks].lb_time = false;
+  } else if (id == INT_CR) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (TaskList::*)(MeshBlock*,int)>
+        (&CRSubcycleTaskList::IntegrateCR);
+    task_list_[ntasks].lb_time = true;
+  } else if (id == SRCTERM_CR) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (TaskList::*)(MeshBlock*,int)>
+        (&CRSubcycleTaskList::AddSourceTermsCR);
+    task_list_[ntasks].lb_time = true;
+  } else if (id == SEND_CR) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (TaskList::*)(MeshBlock*,int)>
+        (&CRSubcycleTaskList::SendCR);
+    task_list_[ntasks].lb_time = true;
+  } else if (id == RECV_CR) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (TaskList::*)(MeshBlock*,int)>
+        (&CRSubcycleTaskList::ReceiveCR);
+    task_list_[ntasks].lb_time = false;
+  } else if (id == SETB_CR) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (TaskList::*)(MeshBlock*,int)>
+        (&CRSubcycleTaskList::SetBoundariesCR);
+    task_list_[ntasks].lb_time = true;
+  } else if (id == PROLONG_CR) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (TaskList::*)(MeshBlock*,int)>
+        (&CRSubcycleTaskList::ProlongateCR);
+    task_list_[ntasks].lb_time = true;
+  } else if (id == PHY_BVAL_CR) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (TaskList::*)(MeshBlock*,int)>
+        (&CRSubcycleTaskList::PhysicalBoundaryCR);
+    task_list_[ntasks].lb_time = true;
+  } else if (id == CR_OPACITY) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (TaskList::*)(MeshBlock*,int)>
+        (&CRSubcycleTaskList::CROpacity);
+    task_list_[ntasks].lb_time = true;
+  } else {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in CRSubcycleTaskList::AddTask" << std::endl
+        << "Invalid Task is specified" << std::endl;
+    ATHENA_ERROR(msg);
+  }
+  ntasks++;
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void CRSubcycleTaskList::DoSubcycles(Mesh *pmesh, int stage)
+//! \brief take the first nsub-1 CR substeps of a stage of the time integrator
+
+void CRSubcycleTaskList::DoSubcycles(Mesh *pmesh, int stage) {
+  if (!ptlist_->stage_wghts[stage-1].main_stage) return;
+  for (isub=1; isub<nsub; ++isub)
+    DoTaskListOneStage(pmesh, stage);
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void CRSubcycleTaskList::StartupTaskList(MeshBlock *pmb, int stage)
+//! \brief Initialize the CR registers and the hydro copy before the first substep
+
+void CRSubcycleTaskList::StartupTaskList(MeshBlock *pmb, int stage) {
+  CosmicRay *pcr = pmb->pcr;
+  if (isub == 1) {
+    if (stage == 1) {
+      pcr->u_cr1.ZeroClear();
+      if (ptlist_->integrator == "ssprk5_4")
+        pcr->u_cr2 = pcr->u_cr;
+    }
+    pcr->u_hydro_sub = pmb->phydro->u;
+  }
+  pcr->cr_bvar.StartReceiving(BoundaryCommSubset::all);
+  return;
+}
+
+TaskStatus CRSubcycleTaskList::ClearCRBoundary(MeshBlock *pmb, int stage) {
+  CosmicRay *pcr = pmb->pcr;
+  pcr->cr_bvar.ClearBoundary(BoundaryCommSubset::all);
+
+  // after the last substep, keep only the change of the hydro variables
+  if (isub == nsub - 1) {
+    AthenaArray<Real> &u = pmb->phydro->u;
+    AthenaArray<Real> &du = pcr->u_hydro_sub;
+    for (int k=pmb->ks; k<=pmb->ke; ++k) {
+      for (int j=pmb->js; j<=pmb->je; ++j) {
+#pragma omp simd
+        for (int i=pmb->is; i<=pmb->ie; ++i) {
+          du(IM1,k,j,i) -= u(IM1,k,j,i);
+          du(IM2,k,j,i) -= u(IM2,k,j,i);
+          du(IM3,k,j,i) -= u(IM3,k,j,i);
+          if (NON_BAROTROPIC_EOS)
+            du(IEN,k,j,i) -= u(IEN,k,j,i);
+        }
+      }
+    }
+  }
+  return TaskStatus::success;
+}
+
+TaskStatus CRSubcycleTaskList::IntegrateCR(MeshBlock *pmb, int stage) {
+  CosmicRay *pcr = pmb->pcr;
+  if (isub == 1)
+    ptlist_->WeightedAveCRTC(pmb, stage);
+  const Real wght = ptlist_->stage_wghts[stage-1].beta*pmb->pmy_mesh->dt/nsub;
+  pcr->pcrintegrator->FluxDivergence(wght, pcr->u_cr);
+  return TaskStatus::next;
+}
+
+TaskStatus CRSubcycleTaskList::AddSourceTermsCR(MeshBlock *pmb, int stage) {
+  CosmicRay *pcr = pmb->pcr;
+  Hydro *ph = pmb->phydro;
+  Field *pf = pmb->pfield;
+  const Real dt = ptlist_->stage_wghts[stage-1].beta*pmb->pmy_mesh->dt/nsub;
+  pcr->pcrintegrator->AddSourceTerms(pmb, dt, pcr->u_hydro_sub, ph->w, pf->bcc,
+                                     pcr->u_cr);
+  return TaskStatus::next;
+}
+
+TaskStatus CRSubcycleTaskList::ProlongateCR(MeshBlock *pmb, int stage) {
+  const TimeIntegratorTaskList::IntegratorWeight &wght = ptlist_->stage_wghts[stage-1];
+  // Time at the end of this substep
+  Real t_end_sub = pmb->pmy_mesh->time + pmb->pmy_mesh->dt
+                   *(wght.sbeta + (wght.ebeta - wght.sbeta)*isub/nsub);
+  Real dt = wght.beta*pmb->pmy_mesh->dt/nsub;
+  std::vector<BoundaryVariable *> bvars_cr = {&(pmb->pcr->cr_bvar)};
+  pmb->pbval->ProlongateBoundaries(t_end_sub, dt, bvars_cr);
+  return TaskStatus::success;
+}
+
+TaskStatus CRSubcycleTaskList::PhysicalBoundaryCR(MeshBlock *pmb, int stage) {
+  const TimeIntegratorTaskList::IntegratorWeight &wght = ptlist_->stage_wghts[stage-1];
+  // Time at the end of this substep
+  Real t_end_sub = pmb->pmy_mesh->time + pmb->pmy_mesh->dt
+                   *(wght.sbeta + (wght.ebeta - wght.sbeta)*isub/nsub);
+  Real dt = wght.beta*pmb->pmy_mesh->dt/nsub;
+  std::vector<BoundaryVariable *> bvars_cr = {&(pmb->pcr->cr_bvar)};
+  pmb->pbval->ApplyPhysicalBoundaries(t_end_sub, dt, bvars_cr);
+  return TaskStatus::success;
+}
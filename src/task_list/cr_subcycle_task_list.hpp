@@ -0,0 +1,103 @@
+#ifndef TASK_LIST_CR_SUBCYCLE_TASK_LIST_HPP_
+#define TASK_LIST_CR_SUBCYCLE_TASK_LIST_HPP_
+//========================================================================================
+// Athena++ astrophysical MHD code
+// Copyright(C) 2014 James M. Stone <jmstone@princeton.edu> and other code contributors
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+//! \file cr_subcycle_task_list.hpp
+//! \brief define CRSubcycleTaskList
+
+// C headers
+
+// C++ headers
+#include <cstdint>      // std::uint64_t
+
+// Athena++ headers
+#include "../athena.hpp"
+#include "task_list.hpp"
+
+// forward declarations
+class Mesh;
+class MeshBlock;
+
+//----------------------------------------------------------------------------------------
+//! \class CRSubcycleTaskList
+//! \brief CR transport substeps taken at a fraction of the hydro time step.
+//!
+//! With <cr> nsubcycle = N > 1, the CR flux, update, source and boundary tasks of each
+//! stage are repeated N times. This list takes the first N-1 substeps, each with its own
+//! boundary exchange, and the CR tasks of TimeIntegratorTaskList take the last one, so
+//! hydro, CT and the hydro boundary exchange still run once per stage.
+
+class CRSubcycleTaskList : public TaskList {
+ public:
+  CRSubcycleTaskList(ParameterInput *pin, Mesh *pm, TimeIntegratorTaskList *ptlist);
+
+  // data
+  int nsub;  // number of CR substeps per stage
+  int isub;  // current substep, 1 <= isub < nsub
+
+  // functions
+  void DoSubcycles(Mesh *pmesh, int stage);
+
+  TaskStatus ClearCRBoundary(MeshBlock *pmb, int stage);
+  TaskStatus IntegrateCR(MeshBlock *pmb, int stage);
+  TaskStatus AddSourceTermsCR(MeshBlock *pmb, int stage);
+  TaskStatus ProlongateCR(MeshBlock *pmb, int stage);
+  TaskStatus PhysicalBoundaryCR(MeshBlock *pmb, int stage);
+
+  // tasks shared with the last substep in TimeIntegratorTaskList
+  TaskStatus CalculateCRFlux(MeshBlock *pmb, int stage) {
+    return ptlist_->CalculateCRTCFlux(pmb, stage);
+  }
+  TaskStatus SendCRFlux(MeshBlock *pmb, int stage) {
+    return ptlist_->SendCRTCFlux(pmb, stage);
+  }
+  TaskStatus ReceiveAndCorrectCRFlux(MeshBlock *pmb, int stage) {
+    return ptlist_->ReceiveAndCorrectCRTCFlux(pmb, stage);
+  }
+  TaskStatus SendCR(MeshBlock *pmb, int stage) {
+    return ptlist_->SendCRTC(pmb, stage);
+  }
+  TaskStatus ReceiveCR(MeshBlock *pmb, int stage) {
+    return ptlist_->ReceiveCRTC(pmb, stage);
+  }
+  TaskStatus SetBoundariesCR(MeshBlock *pmb, int stage) {
+    return ptlist_->SetBoundariesCRTC(pmb, stage);
+  }
+  TaskStatus CROpacity(MeshBlock *pmb, int stage) {
+    return ptlist_->CRTCOpacity(pmb, stage);
+  }
+
+ private:
+  TimeIntegratorTaskList *ptlist_;
+  void AddTask(const TaskID& id, const TaskID& dep) override;
+  void StartupTaskList(MeshBlock *pmb, int stage) override;
+};
+
+
+//----------------------------------------------------------------------------------------
+//! 64-bit integers with "1" in different bit positions used to ID each CR substep task.
+namespace CRSubcycleTaskNames {
+const TaskID NONE(0);
+const TaskID CLEAR_CRBND(1);
+
+const TaskID CALC_CRFLX(2);
+const TaskID SEND_CRFLX(3);
+const TaskID RECV_CRFLX(4);
+const TaskID INT_CR(5);
+const TaskID SRCTERM_CR(6);
+const TaskID SEND_CR(7);
+const TaskID RECV_CR(8);
+const TaskID SETB_CR(9);
+const TaskID PROLONG_CR(10);
+const TaskID PHY_BVAL_CR(11);
+const TaskID CR_OPACITY(12);
+
+//! names of the tasks above indexed by ID number, for the task timing report
+const char *const kTaskNames[] = {"NONE", "CLEAR_CRBND", "CALC_CRFLX", "SEND_CRFLX",
+  "RECV_CRFLX", "INT_CR", "SRCTERM_CR", "SEND_CR", "RECV_CR", "SETB_CR", "PROLONG_CR",
+  "PHY_BVAL_CR", "CR_OPACITY"};
+}  // namespace CRSubcycleTaskNames
+#endif // TASK_LIST_CR_SUBCYCLE_TASK_LIST_HPP_
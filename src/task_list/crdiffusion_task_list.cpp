@@ -21,11 +21,14 @@
 #include "../parameter_input.hpp"
 #include "crdiffusion_task_list.hpp"
 #include "task_list.hpp"
+#include "task_timer.hpp"
 
 //----------------------------------------------------------------------------------------
 //! CRDiffusionBoundaryTaskList constructor
 
 CRDiffusionBoundaryTaskList::CRDiffusionBoundaryTaskList(ParameterInput *pin, Mesh *pm) {
+  ptimer_ = TaskTimer::Get("CRDiffusionBoundary",
+                           CRDiffusionBoundaryTaskNames::kTaskNames);
   // Now assemble list of tasks for each stage of time integrator
   {using namespace CRDiffusionBoundaryTaskNames; // NOLINT (build/namespace)
     AddTask(SEND_CRDIFF_BND,NONE);
@@ -47,6 +50,7 @@ CRDiffusionBoundaryTaskList::CRDiffusionBoundaryTaskList(ParameterInput *pin, Me
 //! value of ntask.
 
 void CRDiffusionBoundaryTaskList::AddTask(const TaskID& id, const TaskID& dep) {
+  task_list_.emplace_back();
   task_list_[ntasks].task_id=id;
   task_list_[ntasks].dependency=dep;
 
@@ -54,5 +54,9 @@ const TaskID RECV_CRDIFF_BND(3);
 const TaskID SETB_CRDIFF_BND(4);
 const TaskID PROLONG_CRDIFF_BND(5);
 const TaskID CRDIFF_PHYS_BND(6);
-}
+
+//! names of the tasks above indexed by ID number, for the task timing report
+const char *const kTaskNames[] = {"NONE", "CLEAR_CRDIFF", "SEND_CRDIFF_BND",
+  "RECV_CRDIFF_BND", "SETB_CRDIFF_BND", "PROLONG_CRDIFF_BND", "CRDIFF_PHYS_BND"};
+} // namespace CRDiffusionBoundaryTaskNames
 #endif // TASK_LIST_CRDIFFUSION_TASK_LIST_HPP_
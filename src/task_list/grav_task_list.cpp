@@ -21,11 +21,13 @@
 #include "../parameter_input.hpp"
 #include "grav_task_list.hpp"
 #include "task_list.hpp"
+#include "task_timer.hpp"
 
 //----------------------------------------------------------------------------------------
 //! GravityBoundaryTaskList constructor
 
 GravityBoundaryTaskList::GravityBoundaryTaskList(ParameterInput *pin, Mesh *pm) {
+  ptimer_ = TaskTimer::Get("GravityBoundary", GravityBoundaryTaskNames::kTaskNames);
   {using namespace GravityBoundaryTaskNames; // NOLINT (build/namespace)
     AddTask(SEND_GRAV_BND,NONE);
     AddTask(RECV_GRAV_BND,NONE);
@@ -46,6 +48,7 @@ GravityBoundaryTaskList::GravityBoundaryTaskList(ParameterInput *pin, Mesh *pm)
 //! value of ntask.
 
 void GravityBoundaryTaskList::AddTask(const TaskID& id, const TaskID& dep) {
+  task_list_.emplace_back();
   task_list_[ntasks].task_id=id;
   task_list_[ntasks].dependency=dep;
 
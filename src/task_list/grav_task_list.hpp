@@ -54,5 +54,9 @@ const TaskID RECV_GRAV_BND(3);
 const TaskID SETB_GRAV_BND(4);
 const TaskID PROLONG_GRAV_BND(5);
 const TaskID GRAV_PHYS_BND(6);
-}
+
+//! names of the tasks above indexed by ID number, for the task timing report
+const char *const kTaskNames[] = {"NONE", "CLEAR_GRAV", "SEND_GRAV_BND", "RECV_GRAV_BND",
+  "SETB_GRAV_BND", "PROLONG_GRAV_BND", "GRAV_PHYS_BND"};
+} // namespace GravityBoundaryTaskNames
 #endif // TASK_LIST_GRAV_TASK_LIST_HPP_
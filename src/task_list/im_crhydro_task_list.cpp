@@ -0,0 +1,183 @@
+//========================================================================================
+// Athena++ astrophysical MHD code
+// Copyright(C) 2014 James M. Stone <jmstone@princeton.edu> and other code contributors
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+//! \file im_crhydro_task_list.cpp
+//! \brief function implementation for the hydro update after the implicit CR transport
+
+// C headers
+
+// C++ headers
+#include <iostream>   // endl
+#include <sstream>    // sstream
+#include <stdexcept>  // runtime_error
+#include <string>     // c_str()
+
+// Athena++ headers
+#include "../athena.hpp"
+#include "../bvals/bvals.hpp"
+#include "../cr/cr.hpp"
+#include "../cr/integrators/cr_integrators.hpp"
+#include "../eos/eos.hpp"
+#include "../field/field.hpp"
+#include "../hydro/hydro.hpp"
+#include "../mesh/mesh.hpp"
+#include "../scalars/scalars.hpp"
+#include "./im_cr_task_list.hpp"
+#include "task_timer.hpp"
+
+//----------------------------------------------------------------------------------------
+//! IMCRHydroTaskList constructor
+
+IMCRHydroTaskList::IMCRHydroTaskList(Mesh *pm) {
+  ptimer_ = TaskTimer::Get("IMCRHydro", IMCRHydroTaskNames::kTaskNames);
+  pmy_mesh = pm;
+  {using namespace IMCRHydroTaskNames; // NOLINT (build/namespace)
+    AddTask(ADD_CR_SRC,NONE);
+    AddTask(SEND_HYD_BND,ADD_CR_SRC);
+    AddTask(RECV_HYD_BND,NONE);
+    AddTask(SETB_HYD_BND,(RECV_HYD_BND|SEND_HYD_BND));
+    if (pm->multilevel) {
+      AddTask(PRLN_HYD_BND,SETB_HYD_BND);
+      AddTask(CONS_TO_PRIM,PRLN_HYD_BND);
+    } else {
+      AddTask(CONS_TO_PRIM,SETB_HYD_BND);
+    }
+    AddTask(HYD_PHYS_BND,CONS_TO_PRIM);
+    AddTask(CLEAR_HYD, HYD_PHYS_BND);
+    AddTask(UPD_OPA,HYD_PHYS_BND);
+  } // end of using namespace block
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void IMCRHydroTaskList::AddTask(const TaskID& id, const TaskID& dep)
+//! \brief Sets id and dependency for "ntask" member of task_list_ array, then iterates
+//! value of ntask.
+
+void IMCRHydroTaskList::AddTask(const TaskID& id, const TaskID& dep) {
+  task_list_.emplace_back();
+  task_list_[ntasks].task_id=id;
+  task_list_[ntasks].dependency=dep;
+
+  using namespace IMCRHydroTaskNames; // NOLINT (build/namespace)
+  if (id == CLEAR_HYD) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (IMRadTaskList::*)(MeshBlock*)>
+        (&IMCRHydroTaskList::ClearHydroBoundary);
+  } else if (id == SEND_HYD_BND) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (IMRadTaskList::*)(MeshBlock*)>
+        (&IMCRHydroTaskList::SendHydroBoundary);
+  } else if (id == RECV_HYD_BND) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (IMRadTaskList::*)(MeshBlock*)>
+        (&IMCRHydroTaskList::ReceiveHydroBoundary);
+  } else if (id == SETB_HYD_BND) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (IMRadTaskList::*)(MeshBlock*)>
+        (&IMCRHydroTaskList::SetHydroBoundary);
+  } else if (id == HYD_PHYS_BND) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (IMRadTaskList::*)(MeshBlock*)>
+        (&IMCRHydroTaskList::PhysicalHydroBoundary);
+  } else if (id == PRLN_HYD_BND) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (IMRadTaskList::*)(MeshBlock*)>
+        (&IMRadTaskList::ProlongateBoundary);
+  } else if (id == UPD_OPA) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (IMRadTaskList::*)(MeshBlock*)>
+        (&IMCRHydroTaskList::UpdateOpacity);
+  } else if (id == ADD_CR_SRC) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (IMRadTaskList::*)(MeshBlock*)>
+        (&IMCRHydroTaskList::AddCRSource);
+  } else if (id == CONS_TO_PRIM) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (IMRadTaskList::*)(MeshBlock*)>
+        (&IMCRHydroTaskList::Primitive);
+  } else {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in IMCRHydroTaskList::AddTask" << std::endl
+        << "Invalid Task is specified" << std::endl;
+    ATHENA_ERROR(msg);
+  }
+  ntasks++;
+  return;
+}
+
+TaskStatus IMCRHydroTaskList::ClearHydroBoundary(MeshBlock *pmb) {
+  pmb->phydro->hbvar.ClearBoundary(BoundaryCommSubset::radhydro);
+  return TaskStatus::success;
+}
+
+TaskStatus IMCRHydroTaskList::SendHydroBoundary(MeshBlock *pmb) {
+  pmb->phydro->hbvar.SwapHydroQuantity(pmb->phydro->u, HydroBoundaryQuantity::cons);
+  pmb->phydro->hbvar.SendBoundaryBuffers();
+  return TaskStatus::success;
+}
+
+TaskStatus IMCRHydroTaskList::ReceiveHydroBoundary(MeshBlock *pmb) {
+  bool ret = pmb->phydro->hbvar.ReceiveBoundaryBuffers();
+  if (!ret)
+    return TaskStatus::fail;
+  return TaskStatus::success;
+}
+
+TaskStatus IMCRHydroTaskList::SetHydroBoundary(MeshBlock *pmb) {
+  pmb->phydro->hbvar.SwapHydroQuantity(pmb->phydro->u, HydroBoundaryQuantity::cons);
+  pmb->phydro->hbvar.SetBoundaries();
+  return TaskStatus::success;
+}
+
+TaskStatus IMCRHydroTaskList::Primitive(MeshBlock *pmb) {
+  Hydro *ph = pmb->phydro;
+  Field *pf = pmb->pfield;
+  PassiveScalars *ps = pmb->pscalars;
+  BoundaryValues *pbval = pmb->pbval;
+  int il = pmb->is, iu = pmb->ie, jl = pmb->js, ju = pmb->je, kl = pmb->ks, ku = pmb->ke;
+  if (pbval->nblevel[1][1][0] != -1) il -= NGHOST;
+  if (pbval->nblevel[1][1][2] != -1) iu += NGHOST;
+  if (pbval->nblevel[1][0][1] != -1) jl -= NGHOST;
+  if (pbval->nblevel[1][2][1] != -1) ju += NGHOST;
+  if (pbval->nblevel[0][1][1] != -1) kl -= NGHOST;
+  if (pbval->nblevel[2][1][1] != -1) ku += NGHOST;
+  pmb->peos->ConservedToPrimitive(ph->u, ph->w, pf->b,
+                                  ph->w1, pf->bcc, pmb->pcoord,
+                                  il, iu, jl, ju, kl, ku);
+  if (NSCALARS > 0) {
+    // r1/r_old for GR is currently unused:
+    pmb->peos->PassiveScalarConservedToPrimitive(ps->s, ph->u, ps->r, ps->r,
+                                                 pmb->pcoord, il, iu, jl, ju, kl, ku);
+  }
+  ph->w.SwapAthenaArray(ph->w1);
+
+  return TaskStatus::success;
+}
+
+TaskStatus IMCRHydroTaskList::PhysicalHydroBoundary(MeshBlock *pmb) {
+  // same as TimeIntegratorTaskList::PhysicalBoundary(), on the primitives
+  pmb->phydro->hbvar.SwapHydroQuantity(pmb->phydro->w, HydroBoundaryQuantity::prim);
+  if (NSCALARS > 0)
+    pmb->pscalars->sbvar.var_cc = &(pmb->pscalars->r);
+  pmb->pbval->ApplyPhysicalBoundaries(time, dt, pmb->pbval->bvars_main_int);
+  return TaskStatus::success;
+}
+
+TaskStatus IMCRHydroTaskList::UpdateOpacity(MeshBlock *pmb) {
+  pmb->pcr->UpdateOpacity(pmb, pmb->pcr->u_cr, pmb->phydro->w, pmb->pfield->bcc);
+  return TaskStatus::success;
+}
+
+TaskStatus IMCRHydroTaskList::AddCRSource(MeshBlock *pmb) {
+  CosmicRay *pcr = pmb->pcr;
+  pcr->pcrintegrator->AddImplicitSourceTerms(pmb, dt, pmb->phydro->u, pmb->phydro->w,
+                                             pmb->pfield->bcc, pcr->u_cr);
+  return TaskStatus::success;
+}
+
+void IMCRHydroTaskList::StartupTaskList(MeshBlock *pmb) {
+  pmb->phydro->hbvar.StartReceiving(BoundaryCommSubset::radhydro);
+  return;
+}
@@ -0,0 +1,160 @@
+//========================================================================================
+// Athena++ astrophysical MHD code
+// Copyright(C) 2014 James M. Stone <jmstone@princeton.edu> and other code contributors
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+//! \file im_crit_task_list.cpp
+//! \brief function implementation for iteration in implicit cosmic ray transport
+
+// C headers
+
+// C++ headers
+#include <iostream>   // endl
+#include <sstream>    // sstream
+#include <stdexcept>  // runtime_error
+#include <string>     // c_str()
+#include <vector>     // vector
+
+// Athena++ headers
+#include "../athena.hpp"
+#include "../bvals/bvals.hpp"
+#include "../cr/cr.hpp"
+#include "../cr/implicit/cr_implicit.hpp"
+#include "../cr/integrators/cr_integrators.hpp"
+#include "../hydro/hydro.hpp"
+#include "../mesh/mesh.hpp"
+#include "./im_cr_task_list.hpp"
+#include "task_timer.hpp"
+
+//----------------------------------------------------------------------------------------
+//! IMCRITTaskList constructor
+
+IMCRITTaskList::IMCRITTaskList(Mesh *pm) {
+  ptimer_ = TaskTimer::Get("IMCRIteration", IMCRITTaskNames::kTaskNames);
+  pmy_mesh = pm;
+  {using namespace IMCRITTaskNames; // NOLINT (build/namespace)
+    AddTask(FLX_AND_SRC,NONE);
+    AddTask(SEND_CR_BND,FLX_AND_SRC);
+    AddTask(RECV_CR_BND,FLX_AND_SRC);
+    AddTask(SETB_CR_BND,(RECV_CR_BND|SEND_CR_BND));
+    if (pm->multilevel) {
+      AddTask(PRLN_CR_BND,SETB_CR_BND);
+      AddTask(CR_PHYS_BND,PRLN_CR_BND);
+    } else {
+      AddTask(CR_PHYS_BND,SETB_CR_BND);
+    }
+    AddTask(CLEAR_CR, CR_PHYS_BND);
+    // check residual does not need ghost zones
+    AddTask(CHK_CR_RES,FLX_AND_SRC);
+  } // end of using namespace block
+}
+
+
+void IMCRITTaskList::AddTask(const TaskID& id, const TaskID& dep) {
+  task_list_.emplace_back();
+  task_list_[ntasks].task_id=id;
+  task_list_[ntasks].dependency=dep;
+
+  using namespace IMCRITTaskNames; // NOLINT (build/namespace)
+  if (id == CLEAR_CR) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (IMRadTaskList::*)(MeshBlock*)>
+        (&IMCRITTaskList::ClearCRBoundary);
+  } else if (id == SEND_CR_BND) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (IMRadTaskList::*)(MeshBlock*)>
+        (&IMCRITTaskList::SendCRBoundary);
+  } else if (id == RECV_CR_BND) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (IMRadTaskList::*)(MeshBlock*)>
+        (&IMCRITTaskList::ReceiveCRBoundary);
+  } else if (id == SETB_CR_BND) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (IMRadTaskList::*)(MeshBlock*)>
+        (&IMCRITTaskList::SetCRBoundary);
+  } else if (id == CR_PHYS_BND) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (IMRadTaskList::*)(MeshBlock*)>
+        (&IMCRITTaskList::PhysicalCRBoundary);
+  } else if (id == PRLN_CR_BND) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (IMRadTaskList::*)(MeshBlock*)>
+        (&IMCRITTaskList::ProlongateCRBoundary);
+  } else if (id == CHK_CR_RES) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (IMRadTaskList::*)(MeshBlock*)>
+        (&IMCRITTaskList::CheckResidual);
+  } else if (id == FLX_AND_SRC) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (IMRadTaskList::*)(MeshBlock*)>
+        (&IMCRITTaskList::AddFluxAndSourceTerms);
+  } else {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in IMCRITTaskList::AddTask" << std::endl
+        << "Invalid Task is specified" << std::endl;
+    ATHENA_ERROR(msg);
+  }
+  ntasks++;
+  return;
+}
+
+TaskStatus IMCRITTaskList::AddFluxAndSourceTerms(MeshBlock *pmb) {
+  CosmicRay *pcr = pmb->pcr;
+  const int &rb_or_not = pmy_mesh->pimcr->rb_or_not;
+
+  if (rb_or_not == 0) {
+    // Jacobi: neighbours from the last iteration
+    pcr->pcrintegrator->ImplicitUpdate(pmb, dt, 0, pmb->phydro->w, pcr->u_cr1,
+                                       pcr->u_cr_old, pcr->u_cr);
+  } else {
+    // red or black cells, neighbours already updated in this sweep
+    pcr->pcrintegrator->ImplicitUpdate(pmb, dt, rb_or_not, pmb->phydro->w, pcr->u_cr1,
+                                       pcr->u_cr, pcr->u_cr);
+  }
+  return TaskStatus::success;
+}
+
+TaskStatus IMCRITTaskList::ClearCRBoundary(MeshBlock *pmb) {
+  pmb->pcr->cr_bvar.ClearBoundary(BoundaryCommSubset::cosmicray);
+  return TaskStatus::success;
+}
+
+TaskStatus IMCRITTaskList::SendCRBoundary(MeshBlock *pmb) {
+  pmb->pcr->cr_bvar.SendBoundaryBuffers();
+  return TaskStatus::success;
+}
+
+TaskStatus IMCRITTaskList::ReceiveCRBoundary(MeshBlock *pmb) {
+  bool ret = pmb->pcr->cr_bvar.ReceiveBoundaryBuffers();
+  if (!ret) {
+    return TaskStatus::fail;
+  }
+  return TaskStatus::success;
+}
+
+TaskStatus IMCRITTaskList::SetCRBoundary(MeshBlock *pmb) {
+  pmb->pcr->cr_bvar.SetBoundaries();
+  return TaskStatus::success;
+}
+
+TaskStatus IMCRITTaskList::ProlongateCRBoundary(MeshBlock *pmb) {
+  std::vector<BoundaryVariable *> bvars_cr = {&(pmb->pcr->cr_bvar)};
+  pmb->pbval->ProlongateBoundaries(time, dt, bvars_cr);
+  return TaskStatus::success;
+}
+
+TaskStatus IMCRITTaskList::PhysicalCRBoundary(MeshBlock *pmb) {
+  std::vector<BoundaryVariable *> bvars_cr = {&(pmb->pcr->cr_bvar)};
+  pmb->pbval->ApplyPhysicalBoundaries(time, dt, bvars_cr);
+  return TaskStatus::success;
+}
+
+TaskStatus IMCRITTaskList::CheckResidual(MeshBlock *pmb) {
+  pmy_mesh->pimcr->CheckResidual(pmb, pmb->pcr->u_cr_old, pmb->pcr->u_cr);
+  return TaskStatus::success;
+}
+
+void IMCRITTaskList::StartupTaskList(MeshBlock *pmb) {
+  pmb->pcr->cr_bvar.StartReceiving(BoundaryCommSubset::cosmicray);
+  return;
+}
@@ -22,11 +22,13 @@
 #include "../nr_radiation/integrators/rad_integrators.hpp"
 #include "../nr_radiation/radiation.hpp"
 #include "./im_rad_task_list.hpp"
+#include "task_timer.hpp"
 
 //----------------------------------------------------------------------------------------
 //! IMRadTaskList constructor
 
 IMRadComptTaskList::IMRadComptTaskList(Mesh *pm) {
+  ptimer_ = TaskTimer::Get("IMRadCompton", IMRadComptTaskNames::kTaskNames);
   pmy_mesh = pm;
   {using namespace IMRadComptTaskNames; // NOLINT (build/namespace)
     AddTask(CAL_COMPT,NONE);
@@ -52,6 +54,7 @@ IMRadComptTaskList::IMRadComptTaskList(Mesh *pm) {
 
 
 void IMRadComptTaskList::AddTask(const TaskID& id, const TaskID& dep) {
+  task_list_.emplace_back();
   task_list_[ntasks].task_id=id;
   task_list_[ntasks].dependency=dep;
 
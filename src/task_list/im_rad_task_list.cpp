@@ -18,6 +18,7 @@
 #include "../mesh/mesh.hpp"
 #include "../nr_radiation/radiation.hpp"
 #include "im_rad_task_list.hpp"
+#include "task_timer.hpp"
 
 #ifdef OPENMP_PARALLEL
 #include <omp.h>
@@ -38,7 +39,9 @@ TaskListStatus IMRadTaskList::DoAllAvailableTasks(MeshBlock *pmb, TaskStates &ts
     if (ts.finished_tasks.IsUnfinished(taski.task_id)) { // task not done
       // check if dependency clear
       if (ts.finished_tasks.CheckDependencies(taski.dependency)) {
+        double tstart = (ptimer_ != nullptr) ? TaskTimer::Now() : 0.0;
         ret = (this->*task_list_[i].TaskFunc)(pmb);
+        if (ptimer_ != nullptr) ptimer_->Record(taski.task_id, pmb->gid, tstart, ret);
         if (ret != TaskStatus::fail) { // success
           ts.num_tasks_left--;
           ts.finished_tasks.SetFinished(taski.task_id);
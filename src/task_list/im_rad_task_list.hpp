@@ -12,6 +12,7 @@
 // C headers
 
 // C++ headers
+#include <vector>  // std::vector
 
 // Athena++ headers
 #include "../athena.hpp"
@@ -23,6 +24,7 @@ class MeshBlock;
 class Radiation;
 class IMRadTaskList;
 class TaskID;
+class TaskTimer;
 
 
 //----------------------------------------------------------------------------------------
@@ -41,7 +43,7 @@ struct IMRadTask {
 
 class IMRadTaskList {
  public:
-  IMRadTaskList() : ntasks(0), task_list_{} {} // 2x direct + zero initialization
+  IMRadTaskList() : ntasks(0), task_list_{}, ptimer_(nullptr) {}
   virtual ~IMRadTaskList() = default;
 
   Mesh *pmy_mesh;
@@ -54,7 +56,8 @@ class IMRadTaskList {
   TaskStatus ProlongateBoundary(MeshBlock *pmb);
 
  protected:
-  IMRadTask task_list_[64*TaskID::kNField_];
+  std::vector<IMRadTask> task_list_;  //!> grown by AddTask()
+  TaskTimer *ptimer_;  //!> task timing of this kind of list, nullptr if disabled
 
  private:
   virtual void AddTask(const TaskID& id, const TaskID& dep) = 0;
@@ -136,6 +139,10 @@ const TaskID RECV_RAD_SH(8); // receive shearing box boundary
 const TaskID CHK_RAD_RES(9); // check residual
 const TaskID FLX_AND_SRC(10);  // calculate the source term and all others together
 
+//! names of the tasks above indexed by ID number, for the task timing report
+const char *const kTaskNames[] = {"NONE", "CLEAR_RAD", "SEND_RAD_BND", "RECV_RAD_BND",
+  "SETB_RAD_BND", "RAD_PHYS_BND", "PRLN_RAD_BND", "SEND_RAD_SH", "RECV_RAD_SH",
+  "CHK_RAD_RES", "FLX_AND_SRC"};
 } // namespace IMRadITTaskNames
 
 namespace IMRadHydroTaskNames {
@@ -151,6 +158,11 @@ const TaskID RECV_HYD_SH(8);  // receive shearing box boundary
 const TaskID UPD_OPA(9);      // check residual
 const TaskID ADD_RAD_SRC(10); // add radiation source term
 const TaskID CONS_TO_PRIM(11);// convert conservative to primitive variables
+
+//! names of the tasks above indexed by ID number, for the task timing report
+const char *const kTaskNames[] = {"NONE", "CLEAR_HYD", "SEND_HYD_BND", "RECV_HYD_BND",
+  "SETB_HYD_BND", "HYD_PHYS_BND", "PRLN_HYD_BND", "SEND_HYD_SH", "RECV_HYD_SH", "UPD_OPA",
+  "ADD_RAD_SRC", "CONS_TO_PRIM"};
 } // namespace IMRadHydroTaskNames
 
 namespace IMRadComptTaskNames {
@@ -165,6 +177,10 @@ const TaskID SEND_RAD_SH(7); // send shearing box boundary
 const TaskID RECV_RAD_SH(8); // receive shearing box boundary
 const TaskID CAL_COMPT(9); // add flux divergence term
 
+//! names of the tasks above indexed by ID number, for the task timing report
+const char *const kTaskNames[] = {"NONE", "CLEAR_RAD", "SEND_RAD_BND", "RECV_RAD_BND",
+  "SETB_RAD_BND", "RAD_PHYS_BND", "PRLN_RAD_BND", "SEND_RAD_SH", "RECV_RAD_SH",
+  "CAL_COMPT"};
 } // namespace IMRadComptTaskNames
 
 #endif // TASK_LIST_IM_RAD_TASK_LIST_HPP_
@@ -26,11 +26,13 @@
 #include "../nr_radiation/radiation.hpp"
 #include "../scalars/scalars.hpp"
 #include "./im_rad_task_list.hpp"
+#include "task_timer.hpp"
 
 //----------------------------------------------------------------------------------------
 //! IMRadTaskList constructor
 
 IMRadHydroTaskList::IMRadHydroTaskList(Mesh *pm) {
+  ptimer_ = TaskTimer::Get("IMRadHydro", IMRadHydroTaskNames::kTaskNames);
   pmy_mesh = pm;
   // Now assemble list of tasks for each stage of time integrator
 
@@ -64,6 +66,7 @@ IMRadHydroTaskList::IMRadHydroTaskList(Mesh *pm) {
 //! value of ntask.
 
 void IMRadHydroTaskList::AddTask(const TaskID& id, const TaskID& dep) {
+  task_list_.emplace_back();
   task_list_[ntasks].task_id=id;
   task_list_[ntasks].dependency=dep;
 
@@ -22,11 +22,13 @@
 #include "../nr_radiation/integrators/rad_integrators.hpp"
 #include "../nr_radiation/radiation.hpp"
 #include "./im_rad_task_list.hpp"
+#include "task_timer.hpp"
 
 //----------------------------------------------------------------------------------------
 //! IMRadTaskList constructor
 
 IMRadITTaskList::IMRadITTaskList(Mesh *pm) {
+  ptimer_ = TaskTimer::Get("IMRadIteration", IMRadITTaskNames::kTaskNames);
   pmy_mesh = pm;
   {using namespace IMRadITTaskNames; // NOLINT (build/namespace)
     AddTask(FLX_AND_SRC,NONE);
@@ -54,6 +56,7 @@ IMRadITTaskList::IMRadITTaskList(Mesh *pm) {
 
 
 void IMRadITTaskList::AddTask(const TaskID& id, const TaskID& dep) {
+  task_list_.emplace_back();
   task_list_[ntasks].task_id=id;
   task_list_[ntasks].dependency=dep;
 
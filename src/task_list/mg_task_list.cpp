@@ -20,15 +20,24 @@
 #include "../mesh/mesh.hpp"
 #include "../multigrid/multigrid.hpp"
 #include "mg_task_list.hpp"
+#include "task_timer.hpp"
 
 using namespace MultigridTaskNames; // NOLINT (build/namespace)
 
+//----------------------------------------------------------------------------------------
+//! MultigridTaskList constructor
+
+MultigridTaskList::MultigridTaskList(MultigridDriver *pmd) :
+    ntasks(0), pmy_mgdriver_(pmd), task_list_{},
+    ptimer_(TaskTimer::Get("Multigrid", kTaskNames)) {}
+
 //----------------------------------------------------------------------------------------
 //! \fn void MultigridTaskList::DoTaskListOneStage(MultigridDriver *pmd)
 //! \brief completes all tasks in this list, will not return until all are tasks done
 
 void MultigridTaskList::DoTaskListOneStage(MultigridDriver *pmd) {
-  int nthreads = pmd->nthreads_;
+  // with fewer blocks than threads, the threads are used inside the blocks instead
+  int nthreads = pmd->fthblock_ ? 1 : pmd->nthreads_;
   int nmg_left = pmd->GetNumMultigrids();
 
   for (auto itr = pmd->vmg_.begin(); itr<pmd->vmg_.end(); itr++) {
@@ -66,7 +75,11 @@ TaskListStatus MultigridTaskList::DoAllAvailableTasks(Multigrid *pmg, TaskStates
     if (ts.finished_tasks.IsUnfinished(taski.task_id)) { // task not done
       // check if dependency clear
       if (ts.finished_tasks.CheckDependencies(taski.dependency)) {
+        double tstart = (ptimer_ != nullptr) ? TaskTimer::Now() : 0.0;
         ret=(this->*task_list_[i].TaskFunc)(pmg);
+        if (ptimer_ != nullptr)
+          ptimer_->Record(taski.task_id, (pmg->pmy_block_ != nullptr)
+                          ? pmg->pmy_block_->gid : -1, tstart, ret);
         if (ret!=TaskStatus::fail) { // success
           ts.num_tasks_left--;
           ts.finished_tasks.SetFinished(taski.task_id);
@@ -93,6 +106,8 @@ TaskListStatus MultigridTaskList::DoAllAvailableTasks(Multigrid *pmg, TaskStates
 //! value of ntask.
 
 void MultigridTaskList::AddMultigridTask(const TaskID& id, const TaskID& dep) {
+  // the list is rebuilt after ClearTaskList(); reuse the Tasks already allocated
+  if (ntasks == static_cast<int>(task_list_.size())) task_list_.emplace_back();
   task_list_[ntasks].task_id=id;
   task_list_[ntasks].dependency=dep;
 
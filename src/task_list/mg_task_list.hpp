@@ -11,6 +11,7 @@
 // C headers
 
 // C++ headers
+#include <vector>  // std::vector
 
 // Athena++ headers
 #include "../athena.hpp"
@@ -22,6 +23,7 @@ class MeshBlock;
 class Multigrid;
 class MultigridDriver;
 class MultigridTaskList;
+class TaskTimer;
 
 //----------------------------------------------------------------------------------------
 //! \struct MGTask
@@ -40,8 +42,7 @@ struct MGTask {
 
 class MultigridTaskList {
  public:
-  explicit MultigridTaskList(MultigridDriver *pmd) : ntasks(0), pmy_mgdriver_(pmd),
-                                                     task_list_{} {}
+  explicit MultigridTaskList(MultigridDriver *pmd);
   // data
   int ntasks;     //!> number of tasks in this list
 
@@ -78,7 +79,8 @@ class MultigridTaskList {
 
  private:
   MultigridDriver* pmy_mgdriver_;
-  MGTask task_list_[64*TaskID::kNField_];
+  std::vector<MGTask> task_list_;  //!> grown by AddMultigridTask()
+  TaskTimer *ptimer_;  //!> task timing of the Multigrid lists, nullptr if disabled
 
   void AddMultigridTask(const TaskID& id, const TaskID& dep);
 };
@@ -137,6 +139,19 @@ const TaskID MG_RESTRICT(46);
 const TaskID MG_PROLONG(47);
 const TaskID MG_FMGPROLONG(48);
 const TaskID MG_CALCFASRHS(49);
+
+//! names of the tasks above indexed by ID number, for the task timing report
+const char *const kTaskNames[] = {"NONE", "MG_STARTRECV0", "MG_STARTRECV1R",
+  "MG_STARTRECV1B", "MG_STARTRECV2R", "MG_STARTRECV2B", "MG_STARTRECVP", "MG_STARTRECVL",
+  "MG_CLEARBND0", "MG_CLEARBND1R", "MG_CLEARBND1B", "MG_CLEARBND2R", "MG_CLEARBND2B",
+  "MG_CLEARBNDP", "MG_CLEARBNDL", "MG_SENDBND0", "MG_SENDBND1R", "MG_SENDBND1B",
+  "MG_SENDBND2R", "MG_SENDBND2B", "MG_SENDBNDP", "MG_SENDBNDL", "MG_RECVBND0",
+  "MG_RECVBND1R", "MG_RECVBND1B", "MG_RECVBND2R", "MG_RECVBND2B", "MG_RECVBNDP",
+  "MG_RECVBNDL", "MG_PRLNGBNDP", "MG_PRLNGFC0", "MG_PRLNGFC1R", "MG_PRLNGFC1B",
+  "MG_PRLNGFC2R", "MG_PRLNGFC2B", "MG_PRLNGFCL", "MG_SMOOTH1R", "MG_SMOOTH1B",
+  "MG_SMOOTH2R", "MG_SMOOTH2B", "MG_PHYSBND0", "MG_PHYSBND1R", "MG_PHYSBND1B",
+  "MG_PHYSBND2R", "MG_PHYSBND2B", "MG_PHYSBNDL", "MG_RESTRICT", "MG_PROLONG",
+  "MG_FMGPROLONG", "MG_CALCFASRHS"};
 } // namespace MultigridTaskNames
 
 #endif // TASK_LIST_MG_TASK_LIST_HPP_
@@ -37,6 +37,7 @@
 #include "../reconstruct/reconstruction.hpp"
 #include "../scalars/scalars.hpp"
 #include "task_list.hpp"
+#include "task_timer.hpp"
 
 //----------------------------------------------------------------------------------------
 //! SuperTimeStepTaskList constructor
@@ -45,6 +46,7 @@ SuperTimeStepTaskList::SuperTimeStepTaskList(
     ParameterInput *pin, Mesh *pm, TimeIntegratorTaskList *ptlist) :
     sts_max_dt_ratio(pin->GetOrAddReal("time", "sts_max_dt_ratio", -1.0)),
     ptlist_(ptlist) {
+  ptimer_ = TaskTimer::Get("SuperTimeStep", HydroIntegratorTaskNames::kTaskNames);
   // Read a flag for shear periodic
   SHEAR_PERIODIC = pm->shear_periodic;
 
@@ -342,6 +344,7 @@ SuperTimeStepTaskList::SuperTimeStepTaskList(
 //! ntask.
 
 void SuperTimeStepTaskList::AddTask(const TaskID& id, const TaskID& dep) {
+  task_list_.emplace_back();
   task_list_[ntasks].task_id = id;
   task_list_[ntasks].dependency = dep;
 
@@ -6,16 +6,21 @@
 //! \file task_id.cpp
 //! \brief implementation of the Task ID class
 
+// C++ headers
+#include <algorithm>  // std::fill(), std::min()
+#include <cstdint>    // std::uint64_t
+#include <vector>     // std::vector
+
+// Athena++ headers
 #include "task_list.hpp"
 
-//! TaskID constructor. Default id = 0.
+//! TaskID constructor. Default id = 0 (no bit set, no words).
 
 TaskID::TaskID(unsigned int id) {
-  for (int i=0; i<kNField_; i++)
-    bitfld_[i] = 0;
   if (id > 0) {
     id--;
     int n=id/64, m=id%64;
+    bitfld_.assign(n+1, 0);
     bitfld_[n] = 1ULL<<m;
   }
 }
@@ -23,11 +28,10 @@ TaskID::TaskID(unsigned int id) {
 
 //----------------------------------------------------------------------------------------
 //! \fn void TaskID::Clear()
-//! \brief Clear all the bits in the Task ID
+//! \brief Clear all the bits in the Task ID, keeping its words
 
 void TaskID::Clear() {
-  for (int i=0; i<kNField_; i++)
-    bitfld_[i] = 0;
+  std::fill(bitfld_.begin(), bitfld_.end(), 0ULL);
 }
 
 //----------------------------------------------------------------------------------------
@@ -36,22 +40,28 @@ void TaskID::Clear() {
 //! called on Task States and returns true if the task is unfinished.
 
 bool TaskID::IsUnfinished(const TaskID& id) const {
-  std::uint64_t fld = (bitfld_[0] & id.bitfld_[0]);
-  for (int i=1; i<kNField_; i++)
+  std::size_t n = std::min(bitfld_.size(), id.bitfld_.size());
+  std::uint64_t fld = 0ULL;
+  for (std::size_t i=0; i<n; i++)
     fld |= (bitfld_[i] & id.bitfld_[i]);
-  return (fld == 0LL);
+  return (fld == 0ULL);
 }
 
 //----------------------------------------------------------------------------------------
 //! \fn bool TaskID::CheckDependencies(const TaskID& dep)
 //! \brief Check if the given dependencies are cleared. This function is to be
 //! called on Task States, and returns true if all the dependencies are clear.
+//! The words are or-ed without branching, so the loop vectorizes.
 
 bool TaskID::CheckDependencies(const TaskID& dep) const {
-  bool ret = ((bitfld_[0] & dep.bitfld_[0]) == dep.bitfld_[0]);
-  for (int i=1; i<kNField_; i++)
-    ret &= ((bitfld_[i] & dep.bitfld_[i]) == dep.bitfld_[i]);
-  return ret;
+  std::size_t n = std::min(bitfld_.size(), dep.bitfld_.size());
+  std::uint64_t missing = 0ULL;
+  for (std::size_t i=0; i<n; i++)
+    missing |= (dep.bitfld_[i] & ~bitfld_[i]);
+  // dependencies beyond the words of the states are unfinished
+  for (std::size_t i=n; i<dep.bitfld_.size(); i++)
+    missing |= dep.bitfld_[i];
+  return (missing == 0ULL);
 }
 
 
@@ -61,19 +71,27 @@ bool TaskID::CheckDependencies(const TaskID& dep) const {
 //! This function is to be called on Task States.
 
 void TaskID::SetFinished(const TaskID& id) {
-  for (int i=0; i<kNField_; i++)
+  if (bitfld_.size() < id.bitfld_.size())
+    bitfld_.resize(id.bitfld_.size(), 0ULL);
+  for (std::size_t i=0; i<id.bitfld_.size(); i++)
     bitfld_[i] |= id.bitfld_[i];
 }
 
 
 //----------------------------------------------------------------------------------------
 //! \fn bool TaskID::operator== (const TaskID& rhs)
-//! \brief overloading operator == for TaskID
+//! \brief overloading operator == for TaskID; missing words compare as 0
 
 bool TaskID::operator== (const TaskID& rhs) const {
-  bool ret = (bitfld_[0] == rhs.bitfld_[0]);
-  for (int i=1; i<kNField_; i++)
-    ret &= (bitfld_[i] == rhs.bitfld_[i]);
+  const std::vector<std::uint64_t> &a = bitfld_, &b = rhs.bitfld_;
+  std::size_t n = std::min(a.size(), b.size());
+  bool ret = true;
+  for (std::size_t i=0; i<n; i++)
+    ret &= (a[i] == b[i]);
+  for (std::size_t i=n; i<a.size(); i++)
+    ret &= (a[i] == 0ULL);
+  for (std::size_t i=n; i<b.size(); i++)
+    ret &= (b[i] == 0ULL);
   return ret;
 }
 
@@ -82,8 +100,25 @@ bool TaskID::operator== (const TaskID& rhs) const {
 //! \brief overloading operator | for TaskID
 
 TaskID TaskID::operator| (const TaskID& rhs) const {
-  TaskID ret;
-  for (int i=0; i<kNField_; i++)
-    ret.bitfld_[i] = (bitfld_[i] | rhs.bitfld_[i]);
+  TaskID ret = (bitfld_.size() >= rhs.bitfld_.size()) ? *this : rhs;
+  const TaskID &other = (bitfld_.size() >= rhs.bitfld_.size()) ? rhs : *this;
+  for (std::size_t i=0; i<other.bitfld_.size(); i++)
+    ret.bitfld_[i] |= other.bitfld_[i];
   return ret;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn int TaskID::GetIDNumber()
+//! \brief number n of the Task ID constructed as TaskID(n), from its lowest set bit.
+//! Returns 0 for an empty ID.
+
+int TaskID::GetIDNumber() const {
+  for (std::size_t i=0; i<bitfld_.size(); i++) {
+    if (bitfld_[i] != 0) {
+      int m = 0;
+      while (((bitfld_[i] >> m) & 1ULL) == 0) m++;
+      return 64*static_cast<int>(i) + m + 1;
+    }
+  }
+  return 0;
+}
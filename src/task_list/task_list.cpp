@@ -10,18 +10,84 @@
 // C headers
 
 // C++ headers
-//#include <vector> // formerly needed for vector of MeshBlock ptrs in DoTaskListOneStage
+#include <algorithm>  // std::upper_bound
+#include <deque>      // std::deque
+#include <vector>     // std::vector
 
 // Athena++ headers
 #include "../athena.hpp"
 #include "../globals.hpp"
 #include "../mesh/mesh.hpp"
 #include "task_list.hpp"
+#include "task_timer.hpp"
 
 #ifdef OPENMP_PARALLEL
 #include <omp.h>
 #endif
 
+namespace {
+//----------------------------------------------------------------------------------------
+//! \class BlockQueue
+//! \brief local indices of the MeshBlocks queued on one thread by the work-stealing
+//!        scheduler. The owner takes MeshBlocks from the front and queues them again at
+//!        the back, so that they take turns as in the polling loop; idle threads steal
+//!        from the back.
+
+class BlockQueue {
+ public:
+  BlockQueue() {
+#ifdef OPENMP_PARALLEL
+    omp_init_lock(&lock_);
+#endif
+  }
+  ~BlockQueue() {
+#ifdef OPENMP_PARALLEL
+    omp_destroy_lock(&lock_);
+#endif
+  }
+  BlockQueue(const BlockQueue &) = delete;
+  BlockQueue &operator=(const BlockQueue &) = delete;
+
+  void Push(int b) {
+    Lock();
+    blocks_.push_back(b);
+    Unlock();
+  }
+  bool Pop(int &b) { return Take(b, true); }
+  bool Steal(int &b) { return Take(b, false); }
+
+ private:
+  std::deque<int> blocks_;
+#ifdef OPENMP_PARALLEL
+  omp_lock_t lock_;
+#endif
+
+  bool Take(int &b, bool front) {
+    Lock();
+    bool found = !blocks_.empty();
+    if (found && front) {
+      b = blocks_.front();
+      blocks_.pop_front();
+    } else if (found) {
+      b = blocks_.back();
+      blocks_.pop_back();
+    }
+    Unlock();
+    return found;
+  }
+  void Lock() {
+#ifdef OPENMP_PARALLEL
+    omp_set_lock(&lock_);
+#endif
+  }
+  void Unlock() {
+#ifdef OPENMP_PARALLEL
+    omp_unset_lock(&lock_);
+#endif
+  }
+};
+} // namespace
+
 //----------------------------------------------------------------------------------------
 //! \fn TaskListStatus TaskList::DoAllAvailableTasks
 //! \brief do all tasks that can be done (are not waiting for a dependency to be
@@ -37,9 +103,11 @@ TaskListStatus TaskList::DoAllAvailableTasks(MeshBlock *pmb, int stage, TaskStat
     if (ts.finished_tasks.IsUnfinished(taski.task_id)) { // task not done
       // check if dependency clear
       if (ts.finished_tasks.CheckDependencies(taski.dependency)) {
+        double tstart = (ptimer_ != nullptr) ? TaskTimer::Now() : 0.0;
         if (taski.lb_time) pmb->StartTimeMeasurement();
         ret = (this->*task_list_[i].TaskFunc)(pmb, stage);
         if (taski.lb_time) pmb->StopTimeMeasurement();
+        if (ptimer_ != nullptr) ptimer_->Record(taski.task_id, pmb->gid, tstart, ret);
         if (ret != TaskStatus::fail) { // success
           ts.num_tasks_left--;
           ts.finished_tasks.SetFinished(taski.task_id);
@@ -59,6 +127,70 @@ TaskListStatus TaskList::DoAllAvailableTasks(MeshBlock *pmb, int stage, TaskStat
   return TaskListStatus::stuck;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn TaskListStatus TaskList::DoRunnableTasks(MeshBlock *pmb, int stage,
+//!                                 TaskStates &ts, int *ndep_left, std::vector<int> &run)
+//! \brief counterpart of DoAllAvailableTasks for the work-stealing scheduler: only the
+//! tasks in run (those whose dependencies are all finished, in list order) are tried,
+//! and a finished task makes its dependents runnable when their last dependency clears.
+//! Returns running if any task finished and stuck if all of them failed, i.e. they wait
+//! for communication.
+
+TaskListStatus TaskList::DoRunnableTasks(MeshBlock *pmb, int stage, TaskStates &ts,
+                                         int *ndep_left, std::vector<int> &run) {
+  if (ts.num_tasks_left == 0) return TaskListStatus::nothing_to_do;
+  bool progress = false;
+
+  std::size_t r = 0;
+  while (r < run.size()) {
+    int i = run[r];
+    Task &taski = task_list_[i];
+    double tstart = (ptimer_ != nullptr) ? TaskTimer::Now() : 0.0;
+    if (taski.lb_time) pmb->StartTimeMeasurement();
+    TaskStatus ret = (this->*taski.TaskFunc)(pmb, stage);
+    if (taski.lb_time) pmb->StopTimeMeasurement();
+    if (ptimer_ != nullptr) ptimer_->Record(taski.task_id, pmb->gid, tstart, ret);
+    if (ret == TaskStatus::fail) {
+      ++r;
+      continue;
+    }
+    ts.num_tasks_left--;
+    ts.finished_tasks.SetFinished(taski.task_id);
+    if (ts.num_tasks_left == 0) return TaskListStatus::complete;
+    run.erase(run.begin() + r);
+    for (int d : dependents_[i]) {
+      if (--ndep_left[d] == 0)
+        run.insert(std::upper_bound(run.begin(), run.end(), d), d);
+    }
+    progress = true;
+    if (ret == TaskStatus::success) return TaskListStatus::running;
+    // next: continue with the tasks after this one, as DoAllAvailableTasks
+    r = std::upper_bound(run.begin(), run.end(), i) - run.begin();
+  }
+  return progress ? TaskListStatus::running : TaskListStatus::stuck;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void TaskList::BuildDependencyGraph()
+//! \brief counts the dependencies of each task in the list and collects the tasks that
+//! depend on each one, for the work-stealing scheduler
+
+void TaskList::BuildDependencyGraph() {
+  ndep_.assign(ntasks, 0);
+  dependents_.assign(ntasks, std::vector<int>());
+  for (int i=0; i<ntasks; ++i) {
+    for (int n=0; n<ntasks; ++n) {
+      // the bit of task n is set in the dependencies of task i
+      if (n != i && !task_list_[i].dependency.IsUnfinished(task_list_[n].task_id)) {
+        ndep_[i]++;
+        dependents_[n].push_back(i);
+      }
+    }
+  }
+  ngraph_ = ntasks;
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void TaskList::DoTaskListOneStage(Mesh *pmesh, int stage)
 //! \brief completes all tasks in this list, will not return until all are tasks done
@@ -66,25 +198,96 @@ TaskListStatus TaskList::DoAllAvailableTasks(MeshBlock *pmb, int stage, TaskStat
 void TaskList::DoTaskListOneStage(Mesh *pmesh, int stage) {
   int nthreads = pmesh->GetNumMeshThreads();
   int nmb = pmesh->nblocal;
+  bool pinned = (pmesh->task_scheduler == TaskScheduler::pinned);
 
   // clear the task states, startup the integrator and initialize mpi calls
+  if (!pinned) {
 #pragma omp parallel for num_threads(nthreads) schedule(dynamic,1)
-  for (int i=0; i<nmb; ++i) {
-    pmesh->my_blocks(i)->tasks.Reset(ntasks);
-    StartupTaskList(pmesh->my_blocks(i), stage);
+    for (int i=0; i<nmb; ++i) {
+      pmesh->my_blocks(i)->tasks.Reset(ntasks);
+      StartupTaskList(pmesh->my_blocks(i), stage);
+    }
   }
 
   int nmb_left = nmb;
-  // cycle through all MeshBlocks and perform all tasks possible
-  while (nmb_left > 0) {
-    //! \note
-    //! KNOWN ISSUE: Workaround for unknown OpenMP race condition. See #183 on GitHub.
+  if (pmesh->task_scheduler == TaskScheduler::polling) {
+    // cycle through all MeshBlocks and perform all tasks possible
+    while (nmb_left > 0) {
+      //! \note
+      //! KNOWN ISSUE: Workaround for unknown OpenMP race condition. See #183 on GitHub.
 #pragma omp parallel for reduction(- : nmb_left) num_threads(nthreads) schedule(dynamic,1)
-    for (int i=0; i<nmb; ++i) {
-      if (DoAllAvailableTasks(pmesh->my_blocks(i), stage, pmesh->my_blocks(i)->tasks)
-          == TaskListStatus::complete) {
-        nmb_left--;
+      for (int i=0; i<nmb; ++i) {
+        if (DoAllAvailableTasks(pmesh->my_blocks(i), stage, pmesh->my_blocks(i)->tasks)
+            == TaskListStatus::complete) {
+          nmb_left--;
+        }
+      }
+    }
+    return;
+  }
+
+  // work-stealing scheduler: every MeshBlock starts with the tasks without dependencies
+  // and is queued on one thread. A thread runs the tasks of the MeshBlocks in its queue,
+  // steals MeshBlocks from the other queues when it runs dry, and only then polls the
+  // MeshBlocks whose runnable tasks all wait for communication. A MeshBlock is held by
+  // at most one thread at a time, so its tasks never run concurrently.
+  // The pinned scheduler queues every MeshBlock on the thread that owns it
+  // (Mesh::GetOwnerThread), which also starts its task list, and never steals, so the
+  // data of a MeshBlock are only used by the thread that allocated them.
+  if (ngraph_ != ntasks) BuildDependencyGraph();
+  ndep_left_.resize(nmb*ntasks);
+  runnable_.resize(nmb);
+  std::vector<BlockQueue> ready(nthreads), waiting(nthreads);
+  for (int b=0; b<nmb; ++b) {
+    runnable_[b].clear();
+    for (int i=0; i<ntasks; ++i) {
+      ndep_left_[b*ntasks+i] = ndep_[i];
+      if (ndep_[i] == 0) runnable_[b].push_back(i);
+    }
+    ready[pinned ? pmesh->GetOwnerThread(b, nmb) : b%nthreads].Push(b);
+  }
+
+#pragma omp parallel num_threads(nthreads)
+  {
+#ifdef OPENMP_PARALLEL
+    int tid = omp_get_thread_num();
+#else
+    int tid = 0;
+#endif
+    if (pinned) {
+      for (int b=0; b<nmb; ++b) {
+        if (pmesh->GetOwnerThread(b, nmb) != tid) continue;
+        pmesh->my_blocks(b)->tasks.Reset(ntasks);
+        StartupTaskList(pmesh->my_blocks(b), stage);
+      }
+      // all receives are posted before any MeshBlock sends
+#pragma omp barrier
+    }
+    int nsteal = pinned ? 1 : nthreads;
+    int left = nmb;
+    while (left > 0) {
+      int b;
+      bool found = ready[tid].Pop(b);
+      for (int n=1; n<nsteal && !found; ++n)
+        found = ready[(tid+n)%nthreads].Steal(b);
+      if (!found) found = waiting[tid].Pop(b);
+      for (int n=1; n<nsteal && !found; ++n)
+        found = waiting[(tid+n)%nthreads].Steal(b);
+      if (found) {
+        MeshBlock *pmb = pmesh->my_blocks(b);
+        TaskListStatus status = DoRunnableTasks(pmb, stage, pmb->tasks,
+                                                &ndep_left_[b*ntasks], runnable_[b]);
+        if (status == TaskListStatus::running) {
+          ready[tid].Push(b);
+        } else if (status == TaskListStatus::stuck) {
+          waiting[tid].Push(b);
+        } else {
+#pragma omp atomic
+          nmb_left--;
+        }
       }
+#pragma omp atomic read
+      left = nmb_left;
     }
   }
   return;
@@ -23,6 +23,7 @@ class Mesh;
 class MeshBlock;
 class TaskList;
 class TaskID;
+class TaskTimer;
 
 //! \todo (felker):
 //! - these 4x declarations can be nested in TaskList if MGTaskList is derived
@@ -39,9 +40,11 @@ enum class TaskStatus {fail, success, next};
 
 //----------------------------------------------------------------------------------------
 //! \class TaskID
-//! \brief generalization of bit fields for Task IDs, status, and dependencies.
+//! \brief generalization of bit fields for Task IDs, status, and dependencies. The
+//! number of 64-bit words grows with the largest ID number set, so the ID numbers are not
+//! limited and the checks only loop over the words in use.
 
-class TaskID {  // POD but not aggregate (there is a user-provided ctor)
+class TaskID {
  public:
   TaskID() = default;
   explicit TaskID(unsigned int id);
@@ -49,13 +52,13 @@ class TaskID {  // POD but not aggregate (there is a user-provided ctor)
   bool IsUnfinished(const TaskID& id) const;
   bool CheckDependencies(const TaskID& dep) const;
   void SetFinished(const TaskID& id);
+  int GetIDNumber() const;
 
   bool operator== (const TaskID& rhs) const;
   TaskID operator| (const TaskID& rhs) const;
 
  private:
-  constexpr static int kNField_ = 2;
-  std::uint64_t bitfld_[kNField_];
+  std::vector<std::uint64_t> bitfld_;  //!> bits beyond the last word are all 0
 
   friend class TaskList;
   friend class MultigridTaskList;
@@ -68,7 +71,7 @@ class TaskID {  // POD but not aggregate (there is a user-provided ctor)
 //! \struct Task
 //! \brief data and function pointer for an individual Task
 
-struct Task { // aggregate and POD
+struct Task { // aggregate
   TaskID task_id;    //!> encodes task with bit positions in HydroIntegratorTaskNames
   TaskID dependency; //!> encodes dependencies to other tasks using
                      //!> HydroIntegratorTaskNames
@@ -80,7 +83,7 @@ struct Task { // aggregate and POD
 //! \struct TaskStates
 //! \brief container for task states on a single MeshBlock
 
-struct TaskStates { // aggregate and POD
+struct TaskStates { // aggregate
   TaskID finished_tasks;
   int indx_first_task, num_tasks_left;
   void Reset(int ntasks) {
@@ -96,7 +99,7 @@ struct TaskStates { // aggregate and POD
 
 class TaskList {
  public:
-  TaskList() : ntasks(0), nstages(0), task_list_{} {} // 2x direct + zero initialization
+  TaskList() : ntasks(0), nstages(0), task_list_{}, ptimer_(nullptr), ngraph_(0) {}
   // rule of five:
   virtual ~TaskList() = default;
 
@@ -110,9 +113,21 @@ class TaskList {
 
  protected:
   //! \todo (felker): rename to avoid confusion with class name
-  Task task_list_[64*TaskID::kNField_];
+  std::vector<Task> task_list_;  //!> grown by AddTask() as the list is assembled
+  TaskTimer *ptimer_;  //!> task timing of this kind of TaskList, nullptr if disabled
 
  private:
+  // dependency graph of task_list_ for the work-stealing scheduler, built on first use
+  int ngraph_;                               //!> ntasks when the graph was built
+  std::vector<int> ndep_;                    //!> number of dependencies of each task
+  std::vector<std::vector<int>> dependents_; //!> tasks depending on each task
+  // per-MeshBlock state of the work-stealing scheduler in the current stage
+  std::vector<int> ndep_left_;               //!> unfinished dependencies, nmb x ntasks
+  std::vector<std::vector<int>> runnable_;   //!> tasks with all dependencies finished
+
+  void BuildDependencyGraph();
+  TaskListStatus DoRunnableTasks(MeshBlock *pmb, int stage, TaskStates &ts,
+                                 int *ndep_left, std::vector<int> &run);
   virtual void AddTask(const TaskID& id, const TaskID& dep) = 0;
   virtual void StartupTaskList(MeshBlock *pmb, int stage) = 0;
 };
@@ -123,6 +138,8 @@ class TaskList {
 
 class TimeIntegratorTaskList : public TaskList {
   friend class IMRadiation;
+  friend class CRSubcycleTaskList;
+  friend class IMCosmicRay;
  public:
   TimeIntegratorTaskList(ParameterInput *pin, Mesh *pm);
 
@@ -143,11 +160,15 @@ class TimeIntegratorTaskList : public TaskList {
   std::string integrator;
   Real cfl_limit; // dt stability limit for the particular time integrator + spatial order
   int nstages_main; // number of stages labeled main_stage
+  int cr_nsubcycle; // number of CR transport substeps per stage
+  bool cr_implicit; // CR transport advanced by IMCosmicRay instead of this list
+  bool interior_first; // interior hydro fluxes computed while ghost zones are in flight
 
   // functions
   TaskStatus ClearAllBoundary(MeshBlock *pmb, int stage);
 
   TaskStatus CalculateHydroFlux(MeshBlock *pmb, int stage);
+  TaskStatus CalculateHydroFluxInterior(MeshBlock *pmb, int stage);
   TaskStatus CalculateEMF(MeshBlock *pmb, int stage);
 
   TaskStatus SendHydroFlux(MeshBlock *pmb, int stage);
@@ -185,6 +206,7 @@ class TimeIntegratorTaskList : public TaskList {
 
   TaskStatus Prolongation(MeshBlock *pmb, int stage);
   TaskStatus Primitives(MeshBlock *pmb, int stage);
+  TaskStatus PrimitivesInterior(MeshBlock *pmb, int stage);
   TaskStatus PhysicalBoundary(MeshBlock *pmb, int stage);
   TaskStatus UserWork(MeshBlock *pmb, int stage);
   TaskStatus NewBlockTimeStep(MeshBlock *pmb, int stage);
@@ -242,6 +264,7 @@ class TimeIntegratorTaskList : public TaskList {
   bool SHEAR_PERIODIC; // flag for shear periodic boundary (true w/ , false w/o)
   IntegratorWeight stage_wghts[MAX_NSTAGE];
 
+  void WeightedAveCRTC(MeshBlock *pmb, int stage);
   void AddTask(const TaskID& id, const TaskID& dep) override;
   void StartupTaskList(MeshBlock *pmb, int stage) override;
 };
@@ -387,5 +410,23 @@ const TaskID RECV_RADSH(73);
 
 const TaskID SRCTERM_IMRAD(74);
 
+const TaskID CONS2PRIM_INT(75);
+const TaskID CALC_HYDFLX_INT(76);
+
+//! names of the tasks above indexed by ID number, for the task timing report
+const char *const kTaskNames[] = {"NONE", "CLEAR_ALLBND", "CALC_HYDFLX", "CALC_FLDFLX",
+  "CALC_RADFLX", "SEND_HYDFLX", "SEND_FLDFLX", "SEND_RADFLX", "SEND_CRTCFLX",
+  "RECV_HYDFLX", "RECV_FLDFLX", "RECV_RADFLX", "RECV_CRTCFLX", "SRC_TERM", "SRCTERM_CRTC",
+  "SRCTERM_RAD", "INT_CRTC", "INT_HYD", "INT_FLD", "INT_RAD", "INT_CHM", "SEND_CRTC",
+  "SEND_HYD", "SEND_FLD", "SEND_RAD", "RECV_CRTC", "RECV_HYD", "RECV_FLD", "RECV_RAD",
+  "SETB_CRTC", "SETB_HYD", "SETB_FLD", "SETB_RAD", "CALC_CRTCFLX", "PROLONG", "CONS2PRIM",
+  "PHY_BVAL", "USERWORK", "NEW_DT", "FLAG_AMR", "SEND_HYDFLXSH", "SEND_HYDSH",
+  "SEND_EMFSH", "SEND_FLDSH", "RECV_HYDFLXSH", "RECV_HYDSH", "RECV_EMFSH", "RECV_FLDSH",
+  "DIFFUSE_HYD", "DIFFUSE_FLD", "CALC_SCLRFLX", "SEND_SCLRFLX", "RECV_SCLRFLX",
+  "INT_SCLR", "SEND_SCLR", "RECV_SCLR", "SETB_SCLR", "DIFFUSE_SCLR", "SEND_SCLRFLXSH",
+  "SEND_SCLRSH", "RECV_SCLRFLXSH", "RECV_SCLRSH", "SEND_HYDORB", "RECV_HYDORB",
+  "CALC_HYDORB", "SEND_FLDORB", "RECV_FLDORB", "CALC_FLDORB", "CRTC_OPACITY",
+  "RAD_MOMOPACITY", "SEND_RADFLXSH", "RECV_RADFLXSH", "SEND_RADSH", "RECV_RADSH",
+  "SRCTERM_IMRAD", "CONS2PRIM_INT", "CALC_HYDFLX_INT"};
 }  // namespace HydroIntegratorTaskNames
 #endif  // TASK_LIST_TASK_LIST_HPP_
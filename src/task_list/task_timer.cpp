@@ -0,0 +1,235 @@
+//========================================================================================
+// Athena++ astrophysical MHD code
+// Copyright(C) 2014 James M. Stone <jmstone@princeton.edu> and other code contributors
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+//! \file task_timer.cpp
+//! \brief implementation of the TaskTimer class
+
+// C headers
+
+// C++ headers
+#include <algorithm>  // std::sort
+#include <cstdio>     // std::fopen(), std::fprintf(), std::fclose()
+#include <ctime>      // clock(), CLOCKS_PER_SEC
+#include <iomanip>    // std::setw()
+#include <iostream>   // std::cout
+#include <sstream>    // std::stringstream
+#include <stdexcept>  // std::runtime_error
+#include <string>     // std::string
+#include <vector>     // std::vector
+
+// Athena++ headers
+#include "../athena.hpp"
+#include "../globals.hpp"
+#include "../parameter_input.hpp"
+#include "task_list.hpp"
+#include "task_timer.hpp"
+
+// MPI/OpenMP headers
+#ifdef MPI_PARALLEL
+#include <mpi.h>
+#endif
+
+#ifdef OPENMP_PARALLEL
+#include <omp.h>
+#endif
+
+bool TaskTimer::enabled_ = false;
+bool TaskTimer::trace_ = false;
+int TaskTimer::max_events_ = 0;
+double TaskTimer::tzero_ = 0.0;
+std::vector<std::unique_ptr<TaskTimer>> TaskTimer::timers_;
+std::vector<std::unique_ptr<std::vector<TaskTimer::TraceEvent>>> TaskTimer::events_;
+
+//----------------------------------------------------------------------------------------
+//! TaskTimer constructor
+
+TaskTimer::TaskTimer(const std::string &list, const char *const *names, int nnames) :
+    list_name_(list), names_(names, names + nnames), time_(nnames, 0.0),
+    ncall_(nnames, 0), nstuck_(nnames, 0) {}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskTimer *TaskTimer::Get(const std::string &list, const char *const *names,
+//!                               int nnames)
+//! \brief returns the TaskTimer shared by the TaskLists of the given kind, creating it on
+//! first use; names are the names of the tasks indexed by ID number. Returns nullptr
+//! if the task timing is disabled, which the TaskLists check before timing a task.
+
+TaskTimer *TaskTimer::Get(const std::string &list, const char *const *names,
+                          int nnames) {
+  if (!enabled_) return nullptr;
+  for (auto &ptimer : timers_) {
+    if (ptimer->list_name_ == list) return ptimer.get();
+  }
+  timers_.emplace_back(new TaskTimer(list, names, nnames));
+  return timers_.back().get();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void TaskTimer::Enable(ParameterInput *pin)
+//! \brief reads the task timing options in <time>; must be called before any TaskList is
+//! constructed. task_trace also writes the timeline and implies task_timing.
+
+void TaskTimer::Enable(ParameterInput *pin) {
+  trace_ = pin->GetOrAddBoolean("time", "task_trace", false);
+  enabled_ = pin->GetOrAddBoolean("time", "task_timing", false) || trace_;
+  max_events_ = pin->GetOrAddInteger("time", "task_trace_events", 100000);
+  tzero_ = Now();
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn double TaskTimer::Now()
+//! \brief wall clock time in seconds
+
+double TaskTimer::Now() {
+#ifdef OPENMP_PARALLEL
+  return omp_get_wtime();
+#elif defined(MPI_PARALLEL)
+  return MPI_Wtime();
+#else
+  return static_cast<double>(clock())/static_cast<double>(CLOCKS_PER_SEC);
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void TaskTimer::Record(const TaskID &id, int gid, double tstart, TaskStatus ret)
+//! \brief adds a call of the task id on MeshBlock gid, started at tstart, which returned
+//! ret. May be called by several threads at once.
+
+void TaskTimer::Record(const TaskID &id, int gid, double tstart, TaskStatus ret) {
+  double tstop = Now();
+  int n = id.GetIDNumber();
+  if (n >= static_cast<int>(time_.size())) return;
+#pragma omp atomic
+  time_[n] += tstop - tstart;
+#pragma omp atomic
+  ncall_[n]++;
+  if (ret == TaskStatus::fail) {
+#pragma omp atomic
+    nstuck_[n]++;
+  } else if (trace_) {
+    std::vector<TraceEvent> *pevents = ThreadEvents();
+    if (static_cast<int>(pevents->size()) < max_events_)
+      pevents->push_back({this, n, gid, tstart, tstop});
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn std::vector<TaskTimer::TraceEvent> *TaskTimer::ThreadEvents()
+//! \brief trace events of the calling thread; the index of its buffer in events_ is the
+//! thread ID in the timeline
+
+std::vector<TaskTimer::TraceEvent> *TaskTimer::ThreadEvents() {
+  static thread_local std::vector<TraceEvent> *pevents = nullptr;
+  if (pevents == nullptr) {
+#pragma omp critical (task_timer_events)
+    {
+      events_.emplace_back(new std::vector<TraceEvent>());
+      pevents = events_.back().get();
+    }
+  }
+  return pevents;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void TaskTimer::Report(ParameterInput *pin)
+//! \brief sums the task timing over ranks and prints the tasks on rank 0, most expensive
+//! first; with task_trace, every rank also writes its timeline. Must be called on all
+//! ranks.
+
+void TaskTimer::Report(ParameterInput *pin) {
+  if (!enabled_) return;
+
+  struct Row {
+    std::string list_name, task;
+    double calls, stuck, time, tmax;
+  };
+  std::vector<Row> rows;
+  double total = 0.0;
+  for (auto &ptimer : timers_) {
+    int n = static_cast<int>(ptimer->names_.size());
+    std::vector<double> local(3*n), sum(3*n), tmax(n);
+    for (int i=0; i<n; ++i) {
+      local[i] = ptimer->time_[i];
+      local[n+i] = static_cast<double>(ptimer->ncall_[i]);
+      local[2*n+i] = static_cast<double>(ptimer->nstuck_[i]);
+    }
+#ifdef MPI_PARALLEL
+    MPI_Reduce(local.data(), sum.data(), 3*n, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(ptimer->time_.data(), tmax.data(), n, MPI_DOUBLE, MPI_MAX, 0,
+               MPI_COMM_WORLD);
+#else
+    sum = local;
+    tmax = ptimer->time_;
+#endif
+    for (int i=0; i<n; ++i) {
+      if (sum[n+i] == 0.0) continue;
+      rows.push_back({ptimer->list_name_, ptimer->names_[i], sum[n+i], sum[2*n+i],
+                      sum[i], tmax[i]});
+      total += sum[i];
+    }
+  }
+
+  if (Globals::my_rank == 0) {
+    std::sort(rows.begin(), rows.end(),
+              [](const Row &a, const Row &b) { return a.time > b.time; });
+    std::cout << std::endl << "Task timing (wall time summed over MeshBlocks, threads"
+              << " and ranks; max rank = largest time on one rank):" << std::endl;
+    std::cout << std::left << std::setw(22) << "list" << std::setw(20) << "task"
+              << std::right << std::setw(12) << "calls" << std::setw(12) << "stuck"
+              << std::setw(14) << "time [s]" << std::setw(14) << "max rank [s]"
+              << std::setw(8) << "%" << std::endl;
+    for (const Row &row : rows) {
+      std::cout << std::left << std::setw(22) << row.list_name
+                << std::setw(20) << row.task
+                << std::right << std::setw(12) << static_cast<std::int64_t>(row.calls)
+                << std::setw(12) << static_cast<std::int64_t>(row.stuck)
+                << std::setw(14) << std::setprecision(6) << row.time
+                << std::setw(14) << row.tmax << std::setw(8) << std::setprecision(3)
+                << 100.0*row.time/(total > 0.0 ? total : 1.0) << std::endl;
+    }
+    std::cout << std::left << std::setw(42) << "total" << std::right << std::setw(38)
+              << std::setprecision(6) << total << std::endl;
+  }
+
+  if (trace_) WriteTrace(pin->GetString("job", "problem_id"));
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void TaskTimer::WriteTrace(const std::string &basename)
+//! \brief writes the task calls of this rank to basename.trace.<rank>.json in the Chrome
+//! trace event format (chrome://tracing, Perfetto), one process per rank and one thread
+//! per OpenMP thread, with times in microseconds from the start of the run
+
+void TaskTimer::WriteTrace(const std::string &basename) {
+  char number[6];
+  std::snprintf(number, sizeof(number), "%05d", Globals::my_rank);
+  std::string fname = basename + ".trace." + number + ".json";
+  FILE *pfile = std::fopen(fname.c_str(), "w");
+  if (pfile == nullptr) {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in function [TaskTimer::WriteTrace]" << std::endl
+        << "Output file '" << fname << "' could not be opened" << std::endl;
+    ATHENA_ERROR(msg);
+  }
+
+  std::fprintf(pfile, "{\"traceEvents\":[\n");
+  std::fprintf(pfile, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+               "\"args\":{\"name\":\"rank %d\"}}", Globals::my_rank, Globals::my_rank);
+  for (std::size_t t=0; t<events_.size(); ++t) {
+    for (const TraceEvent &ev : *events_[t]) {
+      std::fprintf(pfile, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%d,"
+                   "\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"gid\":%d}}",
+                   ev.ptimer->names_[ev.task].c_str(), ev.ptimer->list_name_.c_str(),
+                   Globals::my_rank, static_cast<int>(t), 1.0e6*(ev.tstart - tzero_),
+                   1.0e6*(ev.tstop - ev.tstart), ev.gid);
+    }
+  }
+  std::fprintf(pfile, "\n]}\n");
+  std::fclose(pfile);
+  return;
+}
@@ -0,0 +1,75 @@
+#ifndef TASK_LIST_TASK_TIMER_HPP_
+#define TASK_LIST_TASK_TIMER_HPP_
+//========================================================================================
+// Athena++ astrophysical MHD code
+// Copyright(C) 2014 James M. Stone <jmstone@princeton.edu> and other code contributors
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+//! \file task_timer.hpp
+//! \brief opt-in timing of the tasks of all TaskLists: wall time, number of calls and
+//! number of stuck calls (the task returned fail) of each task on each rank, printed as
+//! a table at the end of the run and optionally written as a Chrome trace timeline.
+
+// C headers
+
+// C++ headers
+#include <cstdint>  // std::int64_t
+#include <memory>   // std::unique_ptr
+#include <string>   // std::string
+#include <vector>   // std::vector
+
+// Athena++ headers
+#include "../athena.hpp"
+#include "task_list.hpp"
+
+// forward declarations
+class ParameterInput;
+
+//----------------------------------------------------------------------------------------
+//! \class TaskTimer
+//! \brief accumulates the timing of the tasks of one kind of TaskList, indexed by the
+//! ID number of the task. All TaskLists of the same kind share one TaskTimer; the
+//! TaskTimers are kept until the end of the run, when Report() sums them over ranks.
+
+class TaskTimer {
+ public:
+  TaskTimer(const std::string &list, const char *const *names, int nnames);
+
+  // TaskTimer of the given TaskList kind, nullptr if the task timing is disabled
+  template <int N>
+  static TaskTimer *Get(const std::string &list, const char *const (&names)[N]) {
+    return Get(list, names, N);
+  }
+  static TaskTimer *Get(const std::string &list, const char *const *names, int nnames);
+  static void Enable(ParameterInput *pin);
+  static void Report(ParameterInput *pin);
+  static double Now();
+
+  void Record(const TaskID &id, int gid, double tstart, TaskStatus ret);
+
+ private:
+  //! \struct TraceEvent
+  //! \brief one completed task call in the timeline
+  struct TraceEvent {
+    const TaskTimer *ptimer;
+    int task, gid;
+    double tstart, tstop;
+  };
+
+  std::string list_name_;            //!> name of the TaskList kind
+  std::vector<std::string> names_;   //!> names of the tasks indexed by ID number
+  std::vector<double> time_;         //!> wall time of all calls of each task
+  std::vector<std::int64_t> ncall_;  //!> number of calls of each task
+  std::vector<std::int64_t> nstuck_; //!> number of calls that returned fail
+
+  static bool enabled_, trace_;
+  static int max_events_;            //!> maximum number of trace events per thread
+  static double tzero_;              //!> start of the timeline
+  static std::vector<std::unique_ptr<TaskTimer>> timers_;
+  static std::vector<std::unique_ptr<std::vector<TraceEvent>>> events_;
+
+  static std::vector<TraceEvent> *ThreadEvents();
+  static void WriteTrace(const std::string &basename);
+};
+
+#endif // TASK_LIST_TASK_TIMER_HPP_
@@ -35,11 +35,13 @@
 #include "../reconstruct/reconstruction.hpp"
 #include "../scalars/scalars.hpp"
 #include "task_list.hpp"
+#include "task_timer.hpp"
 
 //----------------------------------------------------------------------------------------
 //! TimeIntegratorTaskList constructor
 
 TimeIntegratorTaskList::TimeIntegratorTaskList(ParameterInput *pin, Mesh *pm) {
+  ptimer_ = TaskTimer::Get("TimeIntegrator", HydroIntegratorTaskNames::kTaskNames);
   //! \note
   //! First, define each time-integrator by setting weights for each step of
   //! the algorithm and the CFL number stability limit when coupled to the single-stage
@@ -88,6 +90,31 @@ TimeIntegratorTaskList::TimeIntegratorTaskList(ParameterInput *pin, Mesh *pm) {
   // Read a flag for shear periodic
   SHEAR_PERIODIC = pm->shear_periodic;
 
+  // Number of CR transport substeps per stage; all but the last one are taken by
+  // CRSubcycleTaskList before this list runs
+  cr_nsubcycle = CR_ENABLED ? pin->GetOrAddInteger("cr", "nsubcycle", 1) : 1;
+  // With implicit CR transport the CR variables are advanced by IMCosmicRay after each
+  // stage. The CR tasks stay in this list only to exchange the boundaries of u_cr.
+  cr_implicit = CR_ENABLED && pin->GetOrAddBoolean("cr", "implicit", false);
+
+  // Convert the active cells and compute the hydro fluxes of the next stage that do not
+  // depend on the ghost zones while the boundary messages are in flight. Anything that
+  // changes U between the end of one stage and the fluxes of the next is excluded.
+  interior_first = pin->GetOrAddBoolean("time", "interior_first", false);
+  if (interior_first) {
+    std::string xorder = pin->GetOrAddString("time", "xorder", "2");
+    if (xorder == "4" || xorder == "4c" || NSCALARS > 0 || ORBITAL_ADVECTION
+        || SHEAR_PERIODIC || NR_RADIATION_ENABLED || IM_RADIATION_ENABLED
+        || cr_nsubcycle > 1 || cr_implicit) {
+      std::stringstream msg;
+      msg << "### FATAL ERROR in TimeIntegratorTaskList constructor" << std::endl
+          << "interior_first=true does not work with xorder=4, passive scalars, "
+          << "orbital advection, shear periodic boundaries, radiation, or subcycled or "
+          << "implicit CR transport" << std::endl;
+      ATHENA_ERROR(msg);
+    }
+  }
+
   if (integrator == "rk4" || integrator == "ssprk5_4") {
     // shear periodic not work with rk4 or ssprk5_4
     if (SHEAR_PERIODIC) {
@@ -1042,6 +1069,20 @@ TimeIntegratorTaskList::TimeIntegratorTaskList(ParameterInput *pin, Mesh *pm) {
       }
     }
 
+    // convert the active cells and compute the interior fluxes of the next stage once
+    // they are sent; CONS2PRIM then only converts the ghost zones
+    TaskID int_flux = NONE;
+    if (interior_first) {
+      TaskID sent = SEND_HYD;
+      if (MAGNETIC_FIELDS_ENABLED)
+        sent = (sent|SEND_FLD);
+      if (pm->multilevel)
+        sent = (sent|SEND_HYDFLX);
+      AddTask(CONS2PRIM_INT,sent);
+      AddTask(CALC_HYDFLX_INT,CONS2PRIM_INT);
+      int_flux = CALC_HYDFLX_INT;
+    }
+
     if (MAGNETIC_FIELDS_ENABLED) { // MHD
       // compute MHD fluxes, integrate field
       AddTask(CALC_FLDFLX,CALC_HYDFLX);
@@ -1103,7 +1144,7 @@ TimeIntegratorTaskList::TimeIntegratorTaskList(ParameterInput *pin, Mesh *pm) {
         }
 
         AddTask(PROLONG,setb);
-        AddTask(CONS2PRIM,PROLONG);
+        AddTask(CONS2PRIM,(PROLONG|int_flux));
       } else {
         if (SHEAR_PERIODIC) {
           if (NSCALARS > 0) {
@@ -1115,7 +1156,7 @@ TimeIntegratorTaskList::TimeIntegratorTaskList(ParameterInput *pin, Mesh *pm) {
           if (NSCALARS > 0) {
             AddTask(CONS2PRIM,(SETB_HYD|SETB_FLD|SETB_SCLR));
           } else {
-            AddTask(CONS2PRIM,(SETB_HYD|SETB_FLD));
+            AddTask(CONS2PRIM,(SETB_HYD|SETB_FLD|int_flux));
           }
         }
       }
@@ -1147,7 +1188,7 @@ TimeIntegratorTaskList::TimeIntegratorTaskList(ParameterInput *pin, Mesh *pm) {
           setb=(setb|SEND_CRTC|SETB_CRTC);
 
         AddTask(PROLONG,setb);
-        AddTask(CONS2PRIM,PROLONG);
+        AddTask(CONS2PRIM,(PROLONG|int_flux));
       } else {
         if (SHEAR_PERIODIC) {
           if (NSCALARS > 0) {
@@ -1159,7 +1200,7 @@ TimeIntegratorTaskList::TimeIntegratorTaskList(ParameterInput *pin, Mesh *pm) {
           if (NSCALARS > 0) {
             AddTask(CONS2PRIM,(SETB_HYD|SETB_SCLR));
           } else {
-            AddTask(CONS2PRIM,SETB_HYD);
+            AddTask(CONS2PRIM,(SETB_HYD|int_flux));
           }
         }
       }
@@ -1210,6 +1251,7 @@ TimeIntegratorTaskList::TimeIntegratorTaskList(ParameterInput *pin, Mesh *pm) {
 //!  ntask.
 
 void TimeIntegratorTaskList::AddTask(const TaskID& id, const TaskID& dep) {
+  task_list_.emplace_back();
   task_list_[ntasks].task_id = id;
   task_list_[ntasks].dependency = dep;
   //! \todo (felker):
@@ -1355,6 +1397,16 @@ void TimeIntegratorTaskList::AddTask(const TaskID& id, const TaskID& dep) {
         static_cast<TaskStatus (TaskList::*)(MeshBlock*,int)>
         (&TimeIntegratorTaskList::Primitives);
     task_list_[ntasks].lb_time = true;
+  } else if (id == CONS2PRIM_INT) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (TaskList::*)(MeshBlock*,int)>
+        (&TimeIntegratorTaskList::PrimitivesInterior);
+    task_list_[ntasks].lb_time = true;
+  } else if (id == CALC_HYDFLX_INT) {
+    task_list_[ntasks].TaskFunc=
+        static_cast<TaskStatus (TaskList::*)(MeshBlock*,int)>
+        (&TimeIntegratorTaskList::CalculateHydroFluxInterior);
+    task_list_[ntasks].lb_time = true;
   } else if (id == PHY_BVAL) {
     task_list_[ntasks].TaskFunc=
         static_cast<TaskStatus (TaskList::*)(MeshBlock*,int)>
@@ -1638,7 +1690,8 @@ void TimeIntegratorTaskList::StartupTaskList(MeshBlock *pmb, int stage) {
         pmb->pnrrad->ir2 = pmb->pnrrad->ir;
     }
 
-    if (CR_ENABLED) {
+    // with subcycled CR transport the registers are set up by CRSubcycleTaskList
+    if (CR_ENABLED && cr_nsubcycle == 1 && !cr_implicit) {
       pmb->pcr->u_cr1.ZeroClear();
       if (integrator == "ssprk5_4")
         pmb->pcr->u_cr2 = pmb->pcr->u_cr;
@@ -1699,6 +1752,10 @@ TaskStatus TimeIntegratorTaskList::CalculateHydroFlux(MeshBlock *pmb, int stage)
     if (stage_wghts[stage-1].main_stage) {
       if ((integrator == "vl2") && (stage-stage_wghts[0].orbital_stage == 1)) {
         phydro->CalculateFluxes(phydro->w,  pfield->b,  pfield->bcc, 1);
+      } else if (interior_first && stage > 1) {
+        // the interior fluxes were computed by CALC_HYDFLX_INT in the previous stage
+        phydro->CalculateFluxes(phydro->w,  pfield->b,  pfield->bcc, pmb->precon->xorder,
+                                FluxRegion::boundary);
       } else {
         phydro->CalculateFluxes(phydro->w,  pfield->b,  pfield->bcc, pmb->precon->xorder);
       }
@@ -1708,6 +1765,28 @@ TaskStatus TimeIntegratorTaskList::CalculateHydroFlux(MeshBlock *pmb, int stage)
   return TaskStatus::fail;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus TimeIntegratorTaskList::CalculateHydroFluxInterior(MeshBlock *pmb,
+//!                                                                   int stage)
+//! \brief computes the interior hydro fluxes of the next stage from the primitives of
+//! the active cells in w1 (set by PrimitivesInterior), while the ghost zones are being
+//! exchanged. Must finish before CONS2PRIM swaps w and w1.
+
+TaskStatus TimeIntegratorTaskList::CalculateHydroFluxInterior(MeshBlock *pmb,
+                                                              int stage) {
+  Hydro *phydro = pmb->phydro;
+  Field *pfield = pmb->pfield;
+
+  if (stage <= nstages) {
+    if (stage < nstages && stage_wghts[stage].main_stage) {
+      phydro->CalculateFluxes(phydro->w1, pfield->b, pfield->bcc, pmb->precon->xorder,
+                              FluxRegion::interior);
+    }
+    return TaskStatus::next;
+  }
+  return TaskStatus::fail;
+}
+
 //----------------------------------------------------------------------------------------
 // Functions to calculates EMFs
 
@@ -2218,9 +2297,26 @@ TaskStatus TimeIntegratorTaskList::Primitives(MeshBlock *pmb, int stage) {
     // Newton-Raphson solver in GR EOS uses the following abscissae:
     // stage=1: W at t^n and
     // stage=2: W at t^{n+1/2} (VL2) or t^{n+1} (RK2)
-    pmb->peos->ConservedToPrimitive(ph->u, ph->w, pf->b,
-                                    ph->w1, pf->bcc, pmb->pcoord,
-                                    il, iu, jl, ju, kl, ku);
+    if (interior_first) {
+      // the active cells were converted by PrimitivesInterior(); convert the slabs of
+      // ghost cells below and above them in x3, x2 and x1
+      int is = pmb->is, ie = pmb->ie, js = pmb->js, je = pmb->je, ks = pmb->ks,
+          ke = pmb->ke;
+      auto ghost_c2p = [&](int i0, int i1, int j0, int j1, int k0, int k1) {
+        pmb->peos->ConservedToPrimitive(ph->u, ph->w, pf->b, ph->w1, pf->bcc,
+                                        pmb->pcoord, i0, i1, j0, j1, k0, k1);
+      };
+      if (kl < ks) ghost_c2p(il, iu, jl, ju, kl, ks-1);
+      if (ke < ku) ghost_c2p(il, iu, jl, ju, ke+1, ku);
+      if (jl < js) ghost_c2p(il, iu, jl, js-1, ks, ke);
+      if (je < ju) ghost_c2p(il, iu, je+1, ju, ks, ke);
+      if (il < is) ghost_c2p(il, is-1, js, je, ks, ke);
+      if (ie < iu) ghost_c2p(ie+1, iu, js, je, ks, ke);
+    } else {
+      pmb->peos->ConservedToPrimitive(ph->u, ph->w, pf->b,
+                                      ph->w1, pf->bcc, pmb->pcoord,
+                                      il, iu, jl, ju, kl, ku);
+    }
     if (pmb->porb->orbital_advection_defined) {
       pmb->porb->ResetOrbitalSystemConversionFlag();
     }
@@ -2275,6 +2371,24 @@ TaskStatus TimeIntegratorTaskList::Primitives(MeshBlock *pmb, int stage) {
 }
 
 
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus TimeIntegratorTaskList::PrimitivesInterior(MeshBlock *pmb, int stage)
+//! \brief converts the active cells into w1 once they have been sent to the neighbors,
+//! for the interior fluxes of the next stage; CONS2PRIM converts the ghost zones
+
+TaskStatus TimeIntegratorTaskList::PrimitivesInterior(MeshBlock *pmb, int stage) {
+  Hydro *ph = pmb->phydro;
+  Field *pf = pmb->pfield;
+
+  if (stage <= nstages) {
+    pmb->peos->ConservedToPrimitive(ph->u, ph->w, pf->b, ph->w1, pf->bcc, pmb->pcoord,
+                                    pmb->is, pmb->ie, pmb->js, pmb->je, pmb->ks, pmb->ke);
+    return TaskStatus::next;
+  }
+  return TaskStatus::fail;
+}
+
+
 TaskStatus TimeIntegratorTaskList::PhysicalBoundary(MeshBlock *pmb, int stage) {
   Hydro *ph = pmb->phydro;
   PassiveScalars *ps = pmb->pscalars;
@@ -2907,7 +3021,7 @@ TaskStatus TimeIntegratorTaskList::CalculateCRTCFlux(MeshBlock *pmb, int stage)
   Field *pf = pmb->pfield;
 
   if (stage <= nstages) {
-    if (stage_wghts[stage-1].main_stage) {
+    if (stage_wghts[stage-1].main_stage && !cr_implicit) {
       if ((stage == 1) && (integrator == "vl2")) {
         if (CR_ENABLED)
           pcr->pcrintegrator->CalculateFluxes(phydro->w, pf->bcc, pcr->u_cr, 1);
@@ -2931,32 +3045,21 @@ TaskStatus TimeIntegratorTaskList::IntegrateCRTC(MeshBlock *pmb, int stage) {
   CosmicRay *pcr = pmb->pcr;
 
   if (stage <= nstages) {
-    if (stage_wghts[stage-1].main_stage) {
-      Real ave_wghts[5];
-      ave_wghts[0] = 1.0;
-      ave_wghts[1] = stage_wghts[stage-1].delta;
-      ave_wghts[2] = 0.0;
-      ave_wghts[3] = 0.0;
-      ave_wghts[4] = 0.0;
-      if (CR_ENABLED) {
-        pmb->WeightedAve(pcr->u_cr1, pcr->u_cr, pcr->u_cr2, pcr->u_cr2, pcr->u_cr2,
-                         ave_wghts);
-      }
-      ave_wghts[0] = stage_wghts[stage-1].gamma_1;
-      ave_wghts[1] = stage_wghts[stage-1].gamma_2;
-      ave_wghts[2] = stage_wghts[stage-1].gamma_3;
-      if (ave_wghts[0] == 0.0 && ave_wghts[1] == 1.0 && ave_wghts[2] == 0.0) {
-        if (CR_ENABLED)
-          pcr->u_cr1.SwapAthenaArray(pcr->u_cr);
+    if (stage_wghts[stage-1].main_stage && !cr_implicit) {
+      // with subcycling this is the last CR substep of the stage, and the registers
+      // were already averaged before the first one
+      const Real wght = stage_wghts[stage-1].beta*pmb->pmy_mesh->dt/cr_nsubcycle;
+      if (CR_ENABLED && cr_nsubcycle == 1 && pcr->pcrintegrator->uniform_cartesian) {
+        const Real ave_wghts[4] = {stage_wghts[stage-1].delta,
+                                   stage_wghts[stage-1].gamma_1,
+                                   stage_wghts[stage-1].gamma_2,
+                                   stage_wghts[stage-1].gamma_3};
+        pcr->pcrintegrator->WeightedAveFluxDivergence(ave_wghts, wght);
       } else {
-        // ave_wghts[3] and ave_wght[4] = 0
+        if (cr_nsubcycle == 1)
+          WeightedAveCRTC(pmb, stage);
         if (CR_ENABLED)
-          pmb->WeightedAve(pcr->u_cr, pcr->u_cr1, pcr->u_cr2, pcr->u_cr2, pcr->u_cr2,
-                           ave_wghts);
-      }
-      const Real wght = stage_wghts[stage-1].beta*pmb->pmy_mesh->dt;
-      if (CR_ENABLED) {
-        pcr->pcrintegrator->FluxDivergence(wght, pcr->u_cr);
+          pcr->pcrintegrator->FluxDivergence(wght, pcr->u_cr);
       }
     }
     return TaskStatus::next;
@@ -2964,6 +3067,37 @@ TaskStatus TimeIntegratorTaskList::IntegrateCRTC(MeshBlock *pmb, int stage) {
   return TaskStatus::fail;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void TimeIntegratorTaskList::WeightedAveCRTC(MeshBlock *pmb, int stage)
+//! \brief low-storage register update of the CR variables at the start of a stage
+
+void TimeIntegratorTaskList::WeightedAveCRTC(MeshBlock *pmb, int stage) {
+  CosmicRay *pcr = pmb->pcr;
+  Real ave_wghts[5];
+  ave_wghts[0] = 1.0;
+  ave_wghts[1] = stage_wghts[stage-1].delta;
+  ave_wghts[2] = 0.0;
+  ave_wghts[3] = 0.0;
+  ave_wghts[4] = 0.0;
+  if (CR_ENABLED) {
+    pmb->WeightedAve(pcr->u_cr1, pcr->u_cr, pcr->u_cr2, pcr->u_cr2, pcr->u_cr2,
+                     ave_wghts);
+  }
+  ave_wghts[0] = stage_wghts[stage-1].gamma_1;
+  ave_wghts[1] = stage_wghts[stage-1].gamma_2;
+  ave_wghts[2] = stage_wghts[stage-1].gamma_3;
+  if (ave_wghts[0] == 0.0 && ave_wghts[1] == 1.0 && ave_wghts[2] == 0.0) {
+    if (CR_ENABLED)
+      pcr->u_cr1.SwapAthenaArray(pcr->u_cr);
+  } else {
+    // ave_wghts[3] and ave_wght[4] = 0
+    if (CR_ENABLED)
+      pmb->WeightedAve(pcr->u_cr, pcr->u_cr1, pcr->u_cr2, pcr->u_cr2, pcr->u_cr2,
+                       ave_wghts);
+  }
+  return;
+}
+
 TaskStatus TimeIntegratorTaskList::SendCRTCFlux(MeshBlock *pmb, int stage) {
   if (stage <= nstages) {
     if (stage_wghts[stage-1].main_stage) {
@@ -3063,11 +3197,30 @@ TaskStatus TimeIntegratorTaskList::AddSourceTermsCRTC(MeshBlock *pmb, int stage)
   Field *pf = pmb->pfield;
 
   if (stage <= nstages) {
-    if (stage_wghts[stage-1].main_stage) {
+    if (stage_wghts[stage-1].main_stage && !cr_implicit) {
       // Real t_start_stage = pmb->pmy_mesh->time
       //                      + stage_wghts[(stage-1)].sbeta*pmb->pmy_mesh->dt;
       // Scaled coefficient for RHS update
-      Real dt = (stage_wghts[(stage-1)].beta)*(pmb->pmy_mesh->dt);
+      Real dt = (stage_wghts[(stage-1)].beta)*(pmb->pmy_mesh->dt)/cr_nsubcycle;
+
+      // Add the momentum and energy exchanged in the earlier CR substeps of this stage
+      if (CR_ENABLED && cr_nsubcycle > 1) {
+        AthenaArray<Real> &du = pcr->u_hydro_sub;
+        for (int k=pmb->ks; k<=pmb->ke; ++k) {
+          for (int j=pmb->js; j<=pmb->je; ++j) {
+#pragma omp simd
+            for (int i=pmb->is; i<=pmb->ie; ++i) {
+              ph->u(IM1,k,j,i) += du(IM1,k,j,i);
+              ph->u(IM2,k,j,i) += du(IM2,k,j,i);
+              ph->u(IM3,k,j,i) += du(IM3,k,j,i);
+              if (NON_BAROTROPIC_EOS) {
+                Real e_new = ph->u(IEN,k,j,i) + du(IEN,k,j,i);
+                if (e_new > 0.0) ph->u(IEN,k,j,i) = e_new;
+              }
+            }
+          }
+        }
+      }
 
       // Evaluate the time-dependent source terms
       // Both u and ir are partially updated, only w is from the beginning of the step
@@ -0,0 +1,214 @@
+//========================================================================================
+// Athena++ astrophysical MHD code
+// Copyright(C) 2014 James M. Stone <jmstone@princeton.edu> and other code contributors
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+//! \file point_sources.cpp
+//! \brief implements functions in class PointSources
+
+// C headers
+
+// C++ headers
+#include <algorithm>  // min, max
+#include <cstdint>    // int64_t
+#include <cstdio>     // fopen, fwrite, fclose
+#include <cstring>    // memcpy
+#include <sstream>    // stringstream
+#include <stdexcept>  // runtime_error
+#include <string>
+
+// Athena++ headers
+#include "../athena.hpp"
+#include "../athena_arrays.hpp"
+#include "../coordinates/coordinates.hpp"
+#include "../globals.hpp"
+#include "../mesh/mesh.hpp"
+#include "point_sources.hpp"
+
+namespace {
+// one log record: time, id, x1, x2, x3
+constexpr std::size_t kRecordSize = 4*sizeof(double) + sizeof(std::int64_t);
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn PointSources::PointSources(Mesh *pm, Real width)
+//! \brief constructor, width is the side length of the deposition cube
+
+PointSources::PointSources(Mesh *pm, Real width) :
+    pmy_mesh_(pm), width_(width), plog_(nullptr), nbuffer_(0) {
+  if (!(width_ > 0.0)) {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in PointSources::PointSources" << std::endl
+        << "The deposition width must be positive, width = " << width_ << std::endl;
+    ATHENA_ERROR(msg);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn PointSources::~PointSources()
+//! \brief destructor, flushes and closes the log
+
+PointSources::~PointSources() {
+  FlushLog();
+  if (plog_ != nullptr) std::fclose(plog_);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void PointSources::Reset()
+//! \brief removes all the sites
+
+void PointSources::Reset() {
+  x_.clear();
+  id_.clear();
+  bins_.clear();
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void PointSources::Add(Real x1, Real x2, Real x3, std::int64_t id)
+//! \brief adds a site; id is only used in the log
+
+void PointSources::Add(Real x1, Real x2, Real x3, std::int64_t id) {
+  x_.push_back(x1);
+  x_.push_back(x2);
+  x_.push_back(x3);
+  id_.push_back(id);
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void PointSources::BinByMeshBlock()
+//! \brief finds the MeshBlocks overlapped by the cube of each site in the MeshBlockTree
+
+void PointSources::BinByMeshBlock() {
+  bins_.clear();
+  Real h = 0.5*width_;
+  RegionSize box;
+  for (int m = 0; m < GetNumSources(); ++m) {
+    box.x1min = x_[3*m] - h;
+    box.x1max = x_[3*m] + h;
+    box.x2min = x_[3*m+1] - h;
+    box.x2max = x_[3*m+1] + h;
+    box.x3min = x_[3*m+2] - h;
+    box.x3max = x_[3*m+2] + h;
+    pmy_mesh_->FindMeshBlocksInBox(box, &locs_);
+    for (const LogicalLocation &loc : locs_)
+      bins_[loc].push_back(m);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void PointSources::Deposit(MeshBlock *pmb, Real amount, AthenaArray<Real> &u,
+//!                                int n) const
+//! \brief adds amount per site into u(n), spread uniformly over the cube of the site.
+//!  MeshBlocks created by a refinement after BinByMeshBlock() check all the sites.
+
+void PointSources::Deposit(MeshBlock *pmb, Real amount, AthenaArray<Real> &u,
+                           int n) const {
+  auto bin = bins_.find(pmb->loc);
+  if (bin != bins_.end()) {
+    for (int m : bin->second)
+      DepositSite(pmb, m, amount, u, n);
+  } else {
+    for (int m = 0; m < GetNumSources(); ++m)
+      DepositSite(pmb, m, amount, u, n);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void PointSources::DepositSite(MeshBlock *pmb, int m, Real amount,
+//!                                    AthenaArray<Real> &u, int n) const
+//! \brief deposits site m into the cells of pmb covered by its cube, in proportion to
+//!  the covered fraction of the cube. Collapsed dimensions are not weighted.
+
+void PointSources::DepositSite(MeshBlock *pmb, int m, Real amount,
+                               AthenaArray<Real> &u, int n) const {
+  Coordinates *pco = pmb->pcoord;
+  Real h = 0.5*width_;
+  Real x1l = x_[3*m] - h, x1u = x_[3*m] + h;
+  Real x2l = x_[3*m+1] - h, x2u = x_[3*m+1] + h;
+  Real x3l = x_[3*m+2] - h, x3u = x_[3*m+2] + h;
+
+  int il = pmb->is, iu = pmb->ie;
+  while (il <= iu && pco->x1f(il+1) <= x1l) ++il;
+  while (iu >= il && pco->x1f(iu) >= x1u) --iu;
+  int jl = pmb->js, ju = pmb->je;
+  if (pmb->block_size.nx2 > 1) {
+    while (jl <= ju && pco->x2f(jl+1) <= x2l) ++jl;
+    while (ju >= jl && pco->x2f(ju) >= x2u) --ju;
+  }
+  int kl = pmb->ks, ku = pmb->ke;
+  if (pmb->block_size.nx3 > 1) {
+    while (kl <= ku && pco->x3f(kl+1) <= x3l) ++kl;
+    while (ku >= kl && pco->x3f(ku) >= x3u) --ku;
+  }
+  if (il > iu || jl > ju || kl > ku) return;
+
+  for (int k=kl; k<=ku; ++k) {
+    Real f3 = 1.0;
+    if (pmb->block_size.nx3 > 1)
+      f3 = (std::min(pco->x3f(k+1), x3u) - std::max(pco->x3f(k), x3l))/width_;
+    for (int j=jl; j<=ju; ++j) {
+      Real f2 = 1.0;
+      if (pmb->block_size.nx2 > 1)
+        f2 = (std::min(pco->x2f(j+1), x2u) - std::max(pco->x2f(j), x2l))/width_;
+      for (int i=il; i<=iu; ++i) {
+        Real f1 = (std::min(pco->x1f(i+1), x1u) - std::max(pco->x1f(i), x1l))/width_;
+        u(n,k,j,i) += amount*f1*f2*f3/pco->GetCellVolume(k,j,i);
+      }
+    }
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void PointSources::OpenLog(const std::string &filename, int nbuffer)
+//! \brief opens (appends to) the binary log on rank 0, written every nbuffer records
+
+void PointSources::OpenLog(const std::string &filename, int nbuffer) {
+  nbuffer_ = std::max(nbuffer, 1);
+  if (Globals::my_rank != 0) return;
+  if ((plog_ = std::fopen(filename.c_str(), "ab")) == nullptr) {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in PointSources::OpenLog" << std::endl
+        << "Log file '" << filename << "' could not be opened" << std::endl;
+    ATHENA_ERROR(msg);
+  }
+  buffer_.reserve(nbuffer_*kRecordSize);
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void PointSources::LogSources(Real time)
+//! \brief appends the current sites to the log buffer, each as the native-endian record
+//!  (double time, int64 id, double x1, double x2, double x3)
+
+void PointSources::LogSources(Real time) {
+  if (plog_ == nullptr) return;
+  for (int m = 0; m < GetNumSources(); ++m) {
+    double rec[4] = {static_cast<double>(time), static_cast<double>(x_[3*m]),
+                     static_cast<double>(x_[3*m+1]), static_cast<double>(x_[3*m+2])};
+    std::size_t pos = buffer_.size();
+    buffer_.resize(pos + kRecordSize);
+    std::memcpy(&buffer_[pos], &rec[0], sizeof(double));
+    std::memcpy(&buffer_[pos + sizeof(double)], &id_[m], sizeof(std::int64_t));
+    std::memcpy(&buffer_[pos + sizeof(double) + sizeof(std::int64_t)], &rec[1],
+                3*sizeof(double));
+  }
+  if (buffer_.size() >= nbuffer_*kRecordSize) FlushLog();
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void PointSources::FlushLog()
+//! \brief writes the buffered records
+
+void PointSources::FlushLog() {
+  if (plog_ == nullptr || buffer_.empty()) return;
+  std::fwrite(buffer_.data(), 1, buffer_.size(), plog_);
+  std::fflush(plog_);
+  buffer_.clear();
+  return;
+}
@@ -0,0 +1,69 @@
+#ifndef UTILS_POINT_SOURCES_HPP_
+#define UTILS_POINT_SOURCES_HPP_
+//========================================================================================
+// Athena++ astrophysical MHD code
+// Copyright(C) 2014 James M. Stone <jmstone@princeton.edu> and other code contributors
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+//! \file point_sources.hpp
+//! \brief defines class PointSources
+//!   Deposits point sources (e.g. supernovae) uniformly into a cube around each site.
+//!   The sites are binned by the MeshBlocks their cubes overlap using the MeshBlockTree,
+//!   so that each MeshBlock only loops over the cells covered by its own sources, and
+//!   they can be logged to a buffered binary file.
+
+// C headers
+
+// C++ headers
+#include <cstdint>  // std::int64_t
+#include <cstdio>   // FILE
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Athena++ headers
+#include "../athena.hpp"
+#include "../athena_arrays.hpp"
+#include "../mesh/meshblock_tree.hpp"
+
+class Mesh;
+class MeshBlock;
+
+class PointSources {
+ public:
+  PointSources(Mesh *pm, Real width);
+  ~PointSources();
+
+  // functions on every rank, with the same sites
+  void Reset();
+  void Add(Real x1, Real x2, Real x3, std::int64_t id = -1);
+  void BinByMeshBlock();
+  int GetNumSources() const { return static_cast<int>(id_.size()); }
+
+  // deposit amount per source into u(n) of one MeshBlock; thread safe
+  void Deposit(MeshBlock *pmb, Real amount, AthenaArray<Real> &u, int n) const;
+
+  // buffered binary log of (time, id, x1, x2, x3) records, written by rank 0
+  void OpenLog(const std::string &filename, int nbuffer);
+  void LogSources(Real time);
+  void FlushLog();
+
+ private:
+  Mesh *pmy_mesh_;
+  Real width_;              // side length of the deposition cube
+  std::vector<Real> x_;     // coordinates of the sites, 3 per site
+  std::vector<std::int64_t> id_;
+  // sites overlapping each MeshBlock; keyed by location so that it stays valid for the
+  // MeshBlocks that survive a refinement between binning and deposition
+  std::unordered_map<LogicalLocation, std::vector<int>, LogicalLocationHash> bins_;
+  std::vector<LogicalLocation> locs_;
+
+  std::FILE *plog_;
+  int nbuffer_;
+  std::vector<char> buffer_;
+
+  void DepositSite(MeshBlock *pmb, int m, Real amount, AthenaArray<Real> &u,
+                   int n) const;
+};
+
+#endif // UTILS_POINT_SOURCES_HPP_
@@ -53,6 +53,11 @@ void ShowConfig() {
   }
   if (CR_ENABLED) {
     std::cout<<"  Cosmic Ray Transport:       ON" << std::endl;
+    if (CR_FLOAT_COEFFICIENTS || SINGLE_PRECISION_ENABLED) {
+      std::cout<<"  CR coefficient precision:   single" << std::endl;
+    } else {
+      std::cout<<"  CR coefficient precision:   double" << std::endl;
+    }
   } else {
     std::cout<<"  Cosmic Ray Transport:       OFF" << std::endl;
   }
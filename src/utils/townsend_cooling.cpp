@@ -0,0 +1,69 @@
+//========================================================================================
+// Athena++ astrophysical MHD code
+// Copyright(C) 2014 James M. Stone <jmstone@princeton.edu> and other code contributors
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+//! \file townsend_cooling.cpp
+//! \brief implements the constructor of class TownsendCooling
+
+// C headers
+
+// C++ headers
+#include <cmath>      // abs, exp, log
+#include <sstream>    // stringstream
+#include <stdexcept>  // runtime_error
+
+// Athena++ headers
+#include "../athena.hpp"
+#include "townsend_cooling.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \fn TownsendCooling::TownsendCooling(Real tmin, Real tmax, int nbins,
+//!                                      const std::function<Real(Real)> &lambda)
+//! \brief tabulates lambda and integrates Y(T) bin by bin down from tmax
+
+TownsendCooling::TownsendCooling(Real tmin, Real tmax, int nbins,
+                                 const std::function<Real(Real)> &lambda) :
+    nbins_(nbins), nsearch_(0), tmin_(tmin), ltmin_(), inv_dlt_(), y_norm_() {
+  if (!(tmin > 0.0) || !(tmax > tmin) || nbins < 1) {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in TownsendCooling::TownsendCooling" << std::endl
+        << "Invalid table: tmin = " << tmin << ", tmax = " << tmax
+        << ", nbins = " << nbins << std::endl;
+    ATHENA_ERROR(msg);
+  }
+  ltmin_ = std::log(tmin);
+  const Real dlt = (std::log(tmax) - ltmin_)/nbins;
+  inv_dlt_ = 1.0/dlt;
+  while ((1 << nsearch_) < nbins_) ++nsearch_;
+
+  t_.resize(nbins_+1);
+  y_.resize(nbins_+1);
+  beta_.resize(nbins_);
+  a_.resize(nbins_);
+  rb_.resize(nbins_);
+  std::vector<Real> lam(nbins_+1);
+  for (int k=0; k<=nbins_; ++k) {
+    t_[k] = (k == nbins_) ? tmax : tmin*std::exp(k*dlt);
+    lam[k] = lambda(t_[k]);
+    if (!(lam[k] > 0.0)) {
+      std::stringstream msg;
+      msg << "### FATAL ERROR in TownsendCooling::TownsendCooling" << std::endl
+          << "The cooling function must be positive, Lambda(" << t_[k] << ") = "
+          << lam[k] << std::endl;
+      ATHENA_ERROR(msg);
+    }
+  }
+
+  y_norm_ = lam[nbins_]/t_[nbins_];
+  y_[nbins_] = 0.0;
+  for (int k=nbins_-1; k>=0; --k) {
+    Real b = 1.0 - std::log(lam[k+1]/lam[k])*inv_dlt_;
+    // Lambda ~ T in the bin: the logarithmic limit is reached to round-off
+    if (std::abs(b) < 1.0e-8) b = (b < 0.0) ? -1.0e-8 : 1.0e-8;
+    beta_[k] = b;
+    a_[k] = y_norm_*t_[k]/lam[k];
+    rb_[k] = std::exp(b*dlt);
+    y_[k] = y_[k+1] + a_[k]*(rb_[k] - 1.0)/b;
+  }
+}
@@ -0,0 +1,80 @@
+#ifndef UTILS_TOWNSEND_COOLING_HPP_
+#define UTILS_TOWNSEND_COOLING_HPP_
+//========================================================================================
+// Athena++ astrophysical MHD code
+// Copyright(C) 2014 James M. Stone <jmstone@princeton.edu> and other code contributors
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+//! \file townsend_cooling.hpp
+//! \brief defines class TownsendCooling
+//!   Exact integration of radiative cooling, dT/dt = -c*Lambda(T), with the scheme of
+//!   Townsend (2009, ApJS 181, 391). Lambda(T) is tabulated on a logarithmic grid and
+//!   taken to be a power law in each bin, so that the temporal evolution function
+//!     Y(T) = (Lambda(T_N)/T_N) int_T^T_N dT'/Lambda(T')
+//!   and its inverse are analytic in each bin. One step of any length is then
+//!     T^{n+1} = Y^{-1}(Y(T^n) + (Lambda(T_N)/T_N)*c*dt),
+//!   with a direct index into the table for Y and a fixed-length bisection for Y^{-1},
+//!   so Integrate() has no data dependent loops and vectorizes over cells.
+
+// C headers
+
+// C++ headers
+#include <algorithm>   // max, min
+#include <cmath>       // exp, log, pow
+#include <functional>  // function
+#include <vector>
+
+// Athena++ headers
+#include "../athena.hpp"  // Real
+
+class TownsendCooling {
+ public:
+  // tabulates lambda(T) at nbins+1 temperatures from tmin to tmax, in any units;
+  // lambda must be positive above tmin
+  TownsendCooling(Real tmin, Real tmax, int nbins,
+                  const std::function<Real(Real)> &lambda);
+
+  Real GetTmin() const { return tmin_; }
+  Real GetTmax() const { return t_.back(); }
+
+  // the new temperature after cooling for a time dt at the rate dT/dt = -c*Lambda(T),
+  // given c_dt = c*dt. There is no cooling below tmin; above tmax the last power law
+  // is extrapolated.
+  inline Real Integrate(Real temp, Real c_dt) const {
+    const Real y = Y(temp) + y_norm_*c_dt;
+    const Real tnew = (y >= y_[0]) ? tmin_ : InvY(y);
+    return (temp > tmin_) ? std::max(tnew, tmin_) : temp;
+  }
+
+ private:
+  int nbins_, nsearch_;     // number of bins, bisection steps of InvY()
+  Real tmin_, ltmin_, inv_dlt_;
+  Real y_norm_;             // Lambda(T_N)/T_N
+  std::vector<Real> t_;     // bin edges T_k
+  std::vector<Real> y_;     // Y(T_k)
+  std::vector<Real> beta_;  // 1 - power law index of the bin
+  std::vector<Real> a_;     // y_norm*T_k/Lambda(T_k)
+  std::vector<Real> rb_;    // (T_{k+1}/T_k)^beta
+
+  inline Real Y(Real temp) const {
+    temp = std::max(temp, tmin_);
+    int k = static_cast<int>((std::log(temp) - ltmin_)*inv_dlt_);
+    k = std::min(std::max(k, 0), nbins_ - 1);
+    const Real b = beta_[k];
+    return y_[k+1] + a_[k]*(rb_[k] - std::pow(temp/t_[k], b))/b;
+  }
+
+  // Y is decreasing: the bin is the last k with Y(T_k) > y, for y < Y(T_0)
+  inline Real InvY(Real y) const {
+    int k = 0;
+    for (int s = 0, step = (1 << nsearch_) >> 1; s < nsearch_; ++s, step >>= 1) {
+      const int m = std::min(k + step, nbins_ - 1);
+      k = (y_[m] > y) ? m : k;
+    }
+    const Real b = beta_[k];
+    const Real arg = std::max(rb_[k] - b*(y - y_[k+1])/a_[k], static_cast<Real>(0.0));
+    return t_[k]*std::pow(arg, 1.0/b);
+  }
+};
+
+#endif // UTILS_TOWNSEND_COOLING_HPP_
@@ -35,13 +35,64 @@ void Ludcmp_nr(int n, AthenaArray<Real> &a, AthenaArray<int> &indx,
 void Lubksb_nr(int n, AthenaArray<Real> &a, AthenaArray<int> &indx,
                AthenaArray<Real> &b);
 
-void RotateVec(const Real sint, const Real cost,
-                 const Real sinp, const Real cosp,
-                    Real &v1, Real &v2, Real &v3);
+//----------------------------------------------------------------------------------------
+//! \fn void RotateVec(sint, cost, sinp, cosp, v1, v2, v3)
+//! \brief rotate (v1,v2,v3) into the frame where B is along the first axis, given
+//! sin/cos of the polar (theta) and azimuthal (phi) angles of B. Defined inline so
+//! that the per-cell CR kernels calling it can be vectorized.
+
+inline void RotateVec(const Real sint, const Real cost,
+                      const Real sinp, const Real cosp,
+                      Real &v1, Real &v2, Real &v3) {
+  // The two rotation matrix
+  //R_1=
+  //[cos_p  sin_p 0]
+  //[-sin_p cos_p 0]
+  //[0       0    1]
+
+  //R_2=
+  //[sin_t  0 cos_t]
+  //[0      1    0]
+  //[-cos_t 0 sin_t]
+
+  // First apply R1, then apply R2
+  Real newv1 =  cosp * v1 + sinp * v2;
+  v2 = -sinp * v1 + cosp * v2;
+
+  // now apply R2
+  v1 =  sint * newv1 + cost * v3;
+  Real newv3 = -cost * newv1 + sint * v3;
+  v3 = newv3;
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void InvRotateVec(sint, cost, sinp, cosp, v1, v2, v3)
+//! \brief inverse of RotateVec(): rotate (v1,v2,v3) from the B frame back to the
+//! coordinate frame
+
+inline void InvRotateVec(const Real sint, const Real cost,
+                         const Real sinp, const Real cosp,
+                         Real &v1, Real &v2, Real &v3) {
+  //R_1^-1=
+  //[cos_p  -sin_p 0]
+  //[sin_p cos_p 0]
+  //[0       0    1]
+
+  //R_2^-1=
+  //[sin_t  0 -cos_t]
+  //[0      1    0]
+  //[cos_t 0 sin_t]
+
+  // First apply R2^-1, then apply R1^-1
+  Real newv1 = sint * v1 - cost * v3;
+  v3 = cost * v1 + sint * v3;
 
-void InvRotateVec(const Real sint, const Real cost,
-                 const Real sinp, const Real cosp,
-                 Real &v1, Real &v2, Real &v3);
+  // now apply R1^-1
+  v1 = cosp * newv1 - sinp * v2;
+  Real newv2 = sinp * newv1 + cosp * v2;
+  v2 = newv2;
+}
 
 
 //----------------------------------------------------------------------------------------
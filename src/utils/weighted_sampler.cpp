@@ -0,0 +1,114 @@
+//========================================================================================
+// Athena++ astrophysical MHD code
+// Copyright(C) 2014 James M. Stone <jmstone@princeton.edu> and other code contributors
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+//! \file weighted_sampler.cpp
+//! \brief implements functions in class WeightedSampler
+
+// C headers
+
+// C++ headers
+#include <algorithm>  // upper_bound
+#include <sstream>    // stringstream
+#include <stdexcept>  // runtime_error
+
+// Athena++ headers
+#include "../athena.hpp"
+#include "weighted_sampler.hpp"
+
+#ifdef MPI_PARALLEL
+#include <mpi.h>
+#endif
+
+//----------------------------------------------------------------------------------------
+//! \fn void WeightedSampler::Reset()
+//! \brief removes all the points but keeps the storage
+
+void WeightedSampler::Reset() {
+  cdf_.clear();
+  x_.clear();
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void WeightedSampler::Add(Real weight, Real x1, Real x2, Real x3)
+//! \brief adds a point on this rank with the (non-negative) weight
+
+void WeightedSampler::Add(Real weight, Real x1, Real x2, Real x3) {
+  double sum = cdf_.empty() ? 0.0 : cdf_.back();
+  cdf_.push_back(sum + weight);
+  x_.push_back(x1);
+  x_.push_back(x2);
+  x_.push_back(x3);
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void WeightedSampler::Draw(int n, const Real *u, Real *x1, Real *x2, Real *x3,
+//!                                std::int64_t *index)
+//! \brief draws n points from all the ranks, given n uniform deviates u in [0,1) that
+//!  must be the same on every rank. The coordinates (and optionally the global index in
+//!  the rank order) of the points are returned on every rank.
+//!
+//! Deviate m selects the point at the cumulative weight u[m]*W, where W is the total
+//! weight. It is owned by the last rank with a positive weight whose prefix sum does
+//! not exceed it, so every draw has exactly one owner even when the prefix sums are
+//! rounded, and only the owner searches its local cumulative weights.
+
+void WeightedSampler::Draw(int n, const Real *u, Real *x1, Real *x2, Real *x3,
+                           std::int64_t *index) {
+  int rank = 0;
+  double local[2] = {cdf_.empty() ? 0.0 : cdf_.back(), static_cast<double>(cdf_.size())};
+  double offset[2] = {0.0, 0.0};
+  double total = local[0];
+#ifdef MPI_PARALLEL
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Exscan(local, offset, 2, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  if (rank == 0) { // the result of MPI_Exscan is undefined on rank 0
+    offset[0] = 0.0;
+    offset[1] = 0.0;
+  }
+  MPI_Allreduce(MPI_IN_PLACE, &total, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+#endif
+  if (n <= 0) return;
+  if (!(total > 0.0)) {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in WeightedSampler::Draw" << std::endl
+        << "No point with a positive weight to draw from." << std::endl;
+    ATHENA_ERROR(msg);
+  }
+
+  owner_.assign(n, -1);
+  if (local[0] > 0.0) {
+    for (int m = 0; m < n; ++m) {
+      if (u[m]*total >= offset[0]) owner_[m] = rank;
+    }
+  }
+#ifdef MPI_PARALLEL
+  MPI_Allreduce(MPI_IN_PLACE, owner_.data(), n, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+#endif
+
+  picked_.assign(4*n, 0.0);
+  for (int m = 0; m < n; ++m) {
+    if (owner_[m] != rank) continue;
+    double t = u[m]*total - offset[0];
+    std::int64_t p = std::upper_bound(cdf_.begin(), cdf_.end(), t) - cdf_.begin();
+    p = std::min(p, static_cast<std::int64_t>(cdf_.size()) - 1);
+    picked_[4*m]   = x_[3*p];
+    picked_[4*m+1] = x_[3*p+1];
+    picked_[4*m+2] = x_[3*p+2];
+    picked_[4*m+3] = offset[1] + static_cast<double>(p);
+  }
+#ifdef MPI_PARALLEL
+  MPI_Allreduce(MPI_IN_PLACE, picked_.data(), 4*n, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+#endif
+
+  for (int m = 0; m < n; ++m) {
+    x1[m] = static_cast<Real>(picked_[4*m]);
+    x2[m] = static_cast<Real>(picked_[4*m+1]);
+    x3[m] = static_cast<Real>(picked_[4*m+2]);
+    if (index != nullptr) index[m] = static_cast<std::int64_t>(picked_[4*m+3]);
+  }
+  return;
+}
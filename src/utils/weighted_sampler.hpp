@@ -0,0 +1,42 @@
+#ifndef UTILS_WEIGHTED_SAMPLER_HPP_
+#define UTILS_WEIGHTED_SAMPLER_HPP_
+//========================================================================================
+// Athena++ astrophysical MHD code
+// Copyright(C) 2014 James M. Stone <jmstone@princeton.edu> and other code contributors
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+//! \file weighted_sampler.hpp
+//! \brief defines class WeightedSampler
+//!   Draws points (e.g. cell centers) with probability proportional to a weight, where
+//!   the points are distributed over the MPI ranks. Each rank keeps only the cumulative
+//!   weights of its own points; the draws are resolved with the per-rank partial sums
+//!   and an MPI_Exscan prefix, so that only the chosen points are communicated.
+
+// C headers
+
+// C++ headers
+#include <cstdint>  // std::int64_t
+#include <vector>
+
+// Athena++ headers
+#include "../athena.hpp"  // Real
+
+class WeightedSampler {
+ public:
+  WeightedSampler() = default;
+
+  void Reset();
+  void Add(Real weight, Real x1, Real x2, Real x3);
+  std::int64_t GetNumPoints() const { return static_cast<std::int64_t>(cdf_.size()); }
+  // collective: every rank must call it with the same n and u
+  void Draw(int n, const Real *u, Real *x1, Real *x2, Real *x3,
+            std::int64_t *index = nullptr);
+
+ private:
+  std::vector<double> cdf_;     // local cumulative weights
+  std::vector<Real> x_;         // coordinates of the local points, 3 per point
+  std::vector<int> owner_;      // work arrays for Draw(), reused between calls
+  std::vector<double> picked_;
+};
+
+#endif // UTILS_WEIGHTED_SAMPLER_HPP_
@@ -0,0 +1,86 @@
+# Regression test and benchmark of the built-in cosmic ray AMR refinement criterion
+#
+# Follows a CR Gaussian diffusing while it is advected along x (1D cr_diffusion problem
+# on [-4,4]) on a uniform coarse mesh, a uniform fine mesh, and an adaptive mesh with the
+# root resolution of the coarse one and the finest resolution of the fine one, refined
+# by <cr> amr_refine. The moving front is refined and derefined throughout the run, so
+# the adaptive run exercises the conservative prolongation and restriction of the CR
+# variables and the CR flux correction. Its error must match the fine one at a fraction
+# of its cell updates; the cost of each run is reported.
+
+# Modules
+import logging
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../../vis/python')
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name based on module
+
+_cases = {'coarse': ['mesh/nx1=256'],
+          'fine': ['mesh/nx1=1024'],
+          'amr': ['mesh/nx1=256', 'mesh/refinement=adaptive', 'mesh/numlevel=3',
+                  'cr/amr_refine=true']}
+_order = ['coarse', 'fine', 'amr']
+_stats = {}
+
+
+# Prepare Athena++
+def prepare(**kwargs):
+    logger.debug('Running test ' + __name__)
+    athena.configure('cr',
+                     prob='cr_diffusion',
+                     coord='cartesian', **kwargs)
+    athena.make()
+
+
+# Run Athena++
+def run(**kwargs):
+    arguments = ['mesh/x1min=-4.0', 'mesh/x1max=4.0',
+                 'mesh/ix1_bc=periodic', 'mesh/ox1_bc=periodic',
+                 'mesh/nx2=1', 'mesh/ix2_bc=periodic', 'mesh/ox2_bc=periodic',
+                 'meshblock/nx1=16', 'meshblock/nx2=1',
+                 'problem/direction=0', 'problem/v0=1', 'time/ncycle_out=0']
+    for case in _order:
+        _stats[case] = run_stats('cosmic_ray/athinput.cr_diffusion',
+                                 arguments + _cases[case])
+
+
+# Run and return the zone-cycles, the cpu time and the zone-cycles per cpu second
+def run_stats(input_filename, arguments):
+    stats = {}
+    for line in athena.run_output(input_filename, arguments).splitlines():
+        for key in ['zone-cycles', 'cpu time used', 'zone-cycles/cpu_second']:
+            if line.startswith(key + ' '):
+                stats[key] = float(line.split('=')[1])
+    return stats
+
+
+# Analyze outputs
+def analyze():
+    filename = 'bin/diffusion_error.dat'
+    data = []
+    with open(filename, 'r') as f:
+        for line in f.readlines():
+            if line.split()[0][0] == '#':
+                continue
+            data.append([float(val) for val in line.split()])
+    errors = dict(zip(_order, [row[8] for row in data[-len(_order):]]))
+
+    for case in _order:
+        logger.info('%s: error=%g zone-cycles=%g cpu time=%g zone-cycles/cpu_second=%g',
+                    case, errors[case], _stats[case]['zone-cycles'],
+                    _stats[case]['cpu time used'],
+                    _stats[case]['zone-cycles/cpu_second'])
+
+    analyze_status = True
+    if errors['amr'] > 1.1 * errors['fine']:
+        logger.warning('adaptive error %g is not close to the fine error %g',
+                       errors['amr'], errors['fine'])
+        analyze_status = False
+    if errors['amr'] > 0.5 * errors['coarse']:
+        logger.warning('adaptive error %g is not below the coarse error %g',
+                       errors['amr'], errors['coarse'])
+        analyze_status = False
+    if _stats['amr']['zone-cycles'] > 0.6 * _stats['fine']['zone-cycles']:
+        logger.warning('the adaptive mesh did not save cell updates over the fine one')
+        analyze_status = False
+    return analyze_status
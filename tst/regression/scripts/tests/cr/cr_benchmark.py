@@ -0,0 +1,71 @@
+# Accuracy and throughput table of the cosmic ray transport configurations
+#
+# Runs the 3D oblique cosmic ray diffusion problem (with streaming and the CR source
+# terms) once per CRIntegrator configuration and records the error against the analytic
+# solution and the zone-cycles/cpu_second of each run. Configurations that only change
+# the implementation (pencil packing, flux divergence) must reproduce the reference error;
+# those that change the time discretization (subcycling, implicit transport) must stay
+# within a factor of it.
+
+# Modules
+import logging
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../../vis/python')
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name based on module
+
+# (name, arguments, accepted error relative to the reference: exact match if None)
+_configs = [('reference', [], None),
+            ('pack_pencils', ['cr/pack_pencils=true'], None),
+            ('general_divergence', ['cr/uniform_divergence=false'], None),
+            ('nsubcycle=2', ['cr/nsubcycle=2'], 2.0),
+            ('implicit', ['cr/implicit=true'], 2.0)]
+_rtol = 1.0e-5  # the error file has six significant digits
+_zone_cycles = {}
+
+
+# Prepare Athena++
+def prepare(**kwargs):
+    logger.debug('Running test ' + __name__)
+    athena.configure('b', 'cr',
+                     prob='cr_diffusion',
+                     coord='cartesian', **kwargs)
+    athena.make()
+
+
+# Run Athena++
+def run(**kwargs):
+    for name, arguments, _ in _configs:
+        _zone_cycles[name] = athena.run_timed('cosmic_ray/athinput.cr_diffusion_3d',
+                                              ['time/ncycle_out=0'] + arguments)
+
+
+# Analyze outputs
+def analyze():
+    errors = []
+    with open('bin/diffusion_error.dat', 'r') as f:
+        for line in f.readlines():
+            if line.split()[0][0] == '#':
+                continue
+            errors.append(float(line.split()[8]))
+    if len(errors) != len(_configs):
+        logger.warning('%d errors for %d configurations', len(errors), len(_configs))
+        return False
+
+    analyze_status = True
+    ref_error, ref_speed = errors[0], _zone_cycles['reference']
+    logger.info('%-20s %14s %24s %8s', 'configuration', 'error',
+                'zone-cycles/cpu_second', 'speedup')
+    for (name, _, factor), error in zip(_configs, errors):
+        speed = _zone_cycles[name]
+        logger.info('%-20s %14.6e %24.6e %8.3f', name, error, speed, speed / ref_speed)
+        if factor is None:
+            if abs(error - ref_error) > _rtol * ref_error:
+                logger.warning('%s changed the error: %g (reference %g)',
+                               name, error, ref_error)
+                analyze_status = False
+        elif error > factor * ref_error:
+            logger.warning('%s is less accurate than expected: %g (reference %g)',
+                           name, error, ref_error)
+            analyze_status = False
+    return analyze_status
@@ -0,0 +1,120 @@
+# Regression test for the exact integration of radiative cooling in the CR pgens
+#
+# Lets a uniform, static box of the cr_turb problem cool with the Inoue (2006) cooling
+# function in code units (cooling=1) and with the Koyama & Inutsuka (2002) one in cgs
+# units (cooling=2). The gas temperature recovered from the history totals must follow
+# a fine RK4 integration of the cooling and heating equation.
+
+# Modules
+import logging
+import math
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../../vis/python')
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name based on module
+
+_gamma = 5.0 / 3.0
+_nH = 3.0
+_cs = 7.04  # initial sqrt(p/d), about 8400 K
+_tlim = {1: 5.0, 2: 0.1}
+_rtol = 5.0e-3
+_temps = {}
+
+# cooling=1: code units, T = p/d
+_Heat = 3.68962948e+01
+_T_floor = 1.65087995e-01
+
+# cooling=2: cgs units, with the default unit conversions of the pgen
+_k_b = 1.381e-16
+_unit_E = 1.67e-24 * 1.4 * 1.0e10
+_unit_t = 3.086e18 / 1.0e5
+
+
+# Prepare Athena++
+def prepare(**kwargs):
+    logger.debug('Running test ' + __name__)
+    athena.configure('cr',
+                     prob='cr_turb',
+                     coord='cartesian', **kwargs)
+    athena.make()
+
+
+# Run Athena++
+def run(**kwargs):
+    arguments = ['problem/turb_flag=0', 'problem/nH={0}'.format(_nH),
+                 'hydro/iso_sound_speed={0}'.format(_cs),
+                 'output1/dt=0.005', 'output2/dt=-1', 'output3/dt=-1',
+                 'time/integrator=rk1', 'time/ncycle_out=0', 'mesh/num_threads=1',
+                 'mesh/nx1=8', 'mesh/nx2=8', 'mesh/nx3=1',
+                 'meshblock/nx1=8', 'meshblock/nx2=8', 'meshblock/nx3=1']
+    for flag in _tlim:
+        athena.run('cosmic_ray/athinput.cr_turb',
+                   arguments + ['problem/cooling={0}'.format(flag),
+                                'time/tlim={0}'.format(_tlim[flag])])
+        _temps[flag] = read_temperatures('bin/cr_turb.hst')
+
+
+# Read the (time, mean temperature) pairs from the history totals of a static box
+def read_temperatures(filename):
+    columns, temps = {}, []
+    with open(filename, 'r') as f:
+        for line in f.readlines():
+            if line.startswith('# [1]'):
+                columns = {entry.split('=')[1]: n
+                           for n, entry in enumerate(line[1:].split())}
+                temps = []
+            elif line[0] != '#':
+                vals = [float(val) for val in line.split()]
+                temps.append((vals[columns['time']], (_gamma - 1.0)
+                              * vals[columns['tot-E']] / vals[columns['mass']]))
+    return temps
+
+
+# dT/dt in code units for each cooling function
+def rate(flag, temp):
+    if flag == 1:
+        if temp <= _T_floor:
+            return (_gamma - 1.0) * _Heat
+        lamb = (3.65e5 * math.exp(-9.77320931e+02 / (temp + 1.23815996e+01))
+                + 3.95e-1 * math.exp(-7.59404778e-01 / temp))
+        return (_gamma - 1.0) * _Heat * (1.0 - _nH * lamb)
+    scale = _unit_E / (1.5 * _k_b * (_gamma - 1.0))  # code T to K
+    temp_k = temp * scale
+    dedt = 2.0e-26
+    if temp_k > 20.0:
+        dedt -= 2.0e-26 * _nH * (1.0e7 * math.exp(-1.184e5 / (temp_k + 1.0e3))
+                                 + 1.4e-2 * math.sqrt(temp_k) * math.exp(-92.0 / temp_k))
+    return dedt / (1.5 * _k_b) * _unit_t / scale
+
+
+# Temperature at each time of the list, by RK4 with a small step
+def reference(flag, times):
+    temp, t, nstep = _cs**2, 0.0, 200
+    result = []
+    for tout in times:
+        h = (tout - t) / nstep
+        for n in range(nstep):
+            k1 = rate(flag, temp)
+            k2 = rate(flag, temp + 0.5 * h * k1)
+            k3 = rate(flag, temp + 0.5 * h * k2)
+            k4 = rate(flag, temp + h * k3)
+            temp += h * (k1 + 2.0 * k2 + 2.0 * k3 + k4) / 6.0
+        t = tout
+        result.append(temp)
+    return result
+
+
+# Analyze outputs
+def analyze():
+    analyze_status = True
+    for flag in _tlim:
+        times = [t for t, _ in _temps[flag]]
+        ref = reference(flag, times)
+        errs = [abs(temp - r) / r for (_, temp), r in zip(_temps[flag], ref)]
+        logger.info('cooling=%d: T %g -> %g (ref %g), max relative error %g', flag,
+                    _temps[flag][0][1], _temps[flag][-1][1], ref[-1], max(errs))
+        if max(errs) > _rtol:
+            logger.warning('cooling=%d: temperature does not follow the reference',
+                           flag)
+            analyze_status = False
+    return analyze_status
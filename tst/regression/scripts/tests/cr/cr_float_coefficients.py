@@ -0,0 +1,72 @@
+# Regression test for the single precision storage of the CR coefficient arrays
+#
+# Runs the 3D oblique cosmic ray diffusion problem with the default build and with
+# -crfloat, which stores sigma_diff, sigma_adv, v_adv, b_angle and b_grad_pc as float
+# while u_cr and the transport arithmetic stay in double. The error against the
+# analytic solution must not change beyond the rounding of the coefficients, and the
+# memory footprint reported at the end of the run must halve for those arrays.
+
+# Modules
+import logging
+import os
+import scripts.utils.athena as athena
+from shutil import move
+import sys
+sys.path.insert(0, '../../vis/python')
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name based on module
+
+_builds = ['double', 'float']
+_rtol = 1.0e-4
+_errors = {}
+_bytes = {}
+
+
+# Prepare Athena++
+def prepare(**kwargs):
+    logger.debug('Running test ' + __name__)
+    athena.configure('b', 'cr',
+                     prob='cr_diffusion',
+                     coord='cartesian', **kwargs)
+    athena.make()
+    move(os.path.join('bin', 'athena'), os.path.join('bin', 'athena_double'))
+    athena.configure('b', 'cr', 'crfloat',
+                     prob='cr_diffusion',
+                     coord='cartesian', **kwargs)
+    athena.make()
+    move(os.path.join('bin', 'athena'), os.path.join('bin', 'athena_float'))
+
+
+# Run Athena++
+def run(**kwargs):
+    arguments = ['time/ncycle_out=0']
+    for build in _builds:
+        move(os.path.join('bin', 'athena_' + build), os.path.join('bin', 'athena'))
+        output = athena.run_output('cosmic_ray/athinput.cr_diffusion_3d', arguments)
+        move(os.path.join('bin', 'athena'), os.path.join('bin', 'athena_' + build))
+        for line in output.splitlines():
+            if line.startswith('CR coefficient storage'):
+                _bytes[build] = [int(val) for val in line.split() if val.isdigit()]
+        with open('bin/diffusion_error.dat', 'r') as f:
+            _errors[build] = float(f.readlines()[-1].split()[8])
+
+
+# Analyze outputs
+def analyze():
+    analyze_status = True
+    for build in _builds:
+        logger.info('%s coefficients: error %.7e, bytes per MeshBlock %s',
+                    build, _errors[build], _bytes.get(build))
+    if abs(_errors['float'] - _errors['double']) > _rtol * _errors['double']:
+        logger.warning('float coefficients changed the error: %g %g',
+                       _errors['float'], _errors['double'])
+        analyze_status = False
+    if 'double' not in _bytes or 'float' not in _bytes:
+        logger.warning('missing CR coefficient memory report')
+        return False
+    # [coefficients, u_cr]: only the coefficient arrays shrink
+    if (2 * _bytes['float'][0] != _bytes['double'][0]
+            or _bytes['float'][1] != _bytes['double'][1]):
+        logger.warning('unexpected CR coefficient storage: %s (double %s)',
+                       _bytes['float'], _bytes['double'])
+        analyze_status = False
+    return analyze_status
@@ -0,0 +1,58 @@
+# Regression test for the hybrid two-moment/Multigrid cosmic ray transport
+#
+# Diffuses a Gaussian CR profile on a 32^3 periodic box with an optical depth of about
+# 60 per cell, once with the explicit two-moment transport everywhere (hybrid_tau=0)
+# and once with the hybrid transport, where every cell is optically thick and the
+# diffusion is done by the CR diffusion Multigrid solver. The hybrid run must match the
+# analytic solution about as well as the explicit one, while taking far fewer cycles
+# since it is no longer limited by the vmax CFL condition.
+
+# Modules
+import logging
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../../vis/python')
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name based on module
+
+_taus = [0, 10]
+_errors = {}
+_cycles = {}
+
+
+# Prepare Athena++
+def prepare(**kwargs):
+    logger.debug('Running test ' + __name__)
+    athena.configure('b', 'cr', 'crdiff',
+                     prob='cr_diffusion',
+                     coord='cartesian', **kwargs)
+    athena.make()
+
+
+# Run Athena++
+def run(**kwargs):
+    for tau in _taus:
+        output = athena.run_output('cosmic_ray/athinput.cr_diffusion_hybrid',
+                                   ['time/ncycle_out=0',
+                                    'cr/hybrid_tau={0}'.format(tau)])
+        for line in output.splitlines():
+            if line.startswith('time=') and 'cycle=' in line:
+                _cycles[tau] = int(line.split('cycle=')[1].split()[0])
+        with open('bin/diffusion_error.dat', 'r') as f:
+            _errors[tau] = float(f.readlines()[-1].split()[8])
+
+
+# Analyze outputs
+def analyze():
+    analyze_status = True
+    explicit, hybrid = _taus
+    for tau in _taus:
+        logger.info('hybrid_tau=%g: %d cycles, error %g', tau, _cycles[tau], _errors[tau])
+    if _errors[hybrid] > 2.0 * _errors[explicit] + 1.0e-4:
+        logger.warning('the hybrid transport is less accurate than expected: %g (%g)',
+                       _errors[hybrid], _errors[explicit])
+        analyze_status = False
+    if 10 * _cycles[hybrid] > _cycles[explicit]:
+        logger.warning('the hybrid transport is still limited by vmax: %d cycles (%d)',
+                       _cycles[hybrid], _cycles[explicit])
+        analyze_status = False
+    return analyze_status
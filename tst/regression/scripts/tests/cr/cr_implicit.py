@@ -0,0 +1,67 @@
+# Regression test for the implicit cosmic ray transport
+#
+# Runs the 3D cosmic ray diffusion test with cr/implicit=true, where the time step is
+# set by the gas alone instead of vmax, so the runs take a few cycles instead of ~50.
+# The L1 errors are compared against values recorded when the implicit mode was added
+# (at a tolerance loose enough for the iteration residual), and the Jacobi and
+# red-black iterations must converge to the same answer.
+
+# Modules
+import logging
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../../vis/python')
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name based on module
+
+# reference L1 errors for (direction, v0, vflx, red_or_black)
+_cases = [(0, 1, 1, 1, 1.915425e-02),
+          (1, 1, 1, 1, 2.697559e-02),
+          (2, 1, 1, 1, 4.514409e-02),
+          (0, 0, 0, 1, 1.805377e-02),
+          (0, 1, 1, 0, 1.915413e-02)]
+_rtol = 1.0e-3
+
+
+# Prepare Athena++
+def prepare(**kwargs):
+    logger.debug('Running test ' + __name__)
+    athena.configure('b', 'cr',
+                     prob='cr_diffusion',
+                     coord='cartesian', **kwargs)
+    athena.make()
+
+
+# Run Athena++
+def run(**kwargs):
+    for direction, v0, vflx, rb, _ in _cases:
+        arguments = ['problem/direction={0}'.format(direction),
+                     'problem/v0={0}'.format(v0),
+                     'cr/vflx={0}'.format(vflx),
+                     'cr/implicit=true',
+                     'cr/red_or_black={0}'.format(rb)]
+        athena.run('cosmic_ray/athinput.cr_diffusion_3d', arguments)
+
+
+# Analyze outputs
+def analyze():
+    filename = 'bin/diffusion_error.dat'
+    data = []
+    with open(filename, 'r') as f:
+        for line in f.readlines():
+            if line.split()[0][0] == '#':
+                continue
+            data.append([float(val) for val in line.split()])
+
+    analyze_status = True
+    for n, (direction, v0, vflx, rb, ref) in enumerate(_cases):
+        err = data[n][8]
+        if abs(err - ref) > _rtol * ref:
+            logger.warning('error changed for direction=%d v0=%d vflx=%d '
+                           'red_or_black=%d: %g (ref %g)',
+                           direction, v0, vflx, rb, err, ref)
+            analyze_status = False
+    if abs(data[4][8] - data[0][8]) > 1.0e-4 * data[0][8]:
+        logger.warning('Jacobi and red-black iterations differ: %g %g',
+                       data[4][8], data[0][8])
+        analyze_status = False
+    return analyze_status
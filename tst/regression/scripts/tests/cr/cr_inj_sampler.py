@@ -0,0 +1,81 @@
+# Regression test for the distributed supernova site sampler of the cr_inj problem
+#
+# Runs a few cycles of the CR injection problem with mass weighted supernova sites on
+# 16 MeshBlocks, with 1 and 4 MPI ranks and the same seed. The sites are drawn from the
+# per-rank cumulative weights, so they must not depend on the decomposition: the
+# injections.bin logs of both runs must be identical, every site must lie in the
+# injection layer, and the deposited energies (in the history totals) must agree.
+
+# Modules
+import logging
+import os
+import scripts.utils.athena as athena
+import struct
+import sys
+sys.path.insert(0, '../../vis/python')
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name based on module
+
+_nranks = [1, 4]
+_injH = 100.0
+_sites = {}
+_totals = {}
+
+
+# Prepare Athena++
+def prepare(**kwargs):
+    logger.debug('Running test ' + __name__)
+    athena.configure('b', 'cr', 'mpi',
+                     prob='cr_inj', nghost=2,
+                     coord='cartesian', **kwargs)
+    athena.make()
+
+
+# Run Athena++
+def run(**kwargs):
+    arguments = ['output2/dt=-1', 'output3/dt=-1', 'time/nlim=4',
+                 'time/ncycle_out=0',
+                 'mesh/nx1=20', 'mesh/nx2=40', 'mesh/nx3=20',
+                 'meshblock/nx1=10', 'meshblock/nx2=10', 'meshblock/nx3=10',
+                 'problem/SNRate=2e5', 'problem/InjH={0}'.format(_injH),
+                 'problem/massWeight=1', 'problem/seed_inj=2324619875']
+    for nproc in _nranks:
+        if os.path.isfile('bin/injections.bin'):
+            os.remove('bin/injections.bin')
+        athena.mpirun(kwargs['mpirun_cmd'], kwargs['mpirun_opts'], nproc,
+                      'cosmic_ray/athinput.cr_inj', arguments)
+        _sites[nproc] = read_injections('bin/injections.bin')
+        with open('bin/cr_inj.hst', 'r') as f:
+            _totals[nproc] = [float(val) for val in f.readlines()[-1].split()]
+        os.remove('bin/cr_inj.hst')
+
+
+# Read the (time, id, x1, x2, x3) records of the binary injection log
+def read_injections(filename):
+    with open(filename, 'rb') as f:
+        data = f.read()
+    return [struct.unpack_from('=dqddd', data, n) for n in range(0, len(data), 40)]
+
+
+# Analyze outputs
+def analyze():
+    analyze_status = True
+    ref = _sites[_nranks[0]]
+    logger.info('%d supernova sites drawn', len(ref))
+    if len(ref) == 0:
+        logger.warning('no supernova site drawn')
+        return False
+    for site in ref:
+        if abs(site[3]) > _injH:
+            logger.warning('site outside the injection layer: %s', site)
+            analyze_status = False
+    for nproc in _nranks[1:]:
+        if _sites[nproc] != ref:
+            logger.warning('sites drawn with %d ranks differ from 1 rank', nproc)
+            analyze_status = False
+        # the summation order differs, and zero totals only agree to round-off
+        if any(abs(t - r) > 1.0e-10 * abs(r) + 1.0e-10
+               for t, r in zip(_totals[nproc], _totals[_nranks[0]])):
+            logger.warning('history totals with %d ranks differ from 1 rank: %s %s',
+                           nproc, _totals[nproc], _totals[_nranks[0]])
+            analyze_status = False
+    return analyze_status
@@ -0,0 +1,74 @@
+# Regression test for the cosmic ray transport with MPI and OpenMP
+#
+# Runs the cr_transport_tst problem (diffusion, streaming and the CR source terms on 4
+# MeshBlocks) with a hybrid MPI/OpenMP build on 1 rank, 4 ranks, 2 ranks x 2 threads and
+# 1 rank x 4 threads. The history of every run must agree with the serial one up to the
+# summation order of the totals.
+
+# Modules
+import logging
+import os
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../../vis/python')
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name based on module
+
+# (MPI ranks, OpenMP threads per rank)
+_layouts = [(1, 1), (4, 1), (2, 2), (1, 4)]
+_rtol = 1.0e-12
+_history = {}
+
+
+# Prepare Athena++
+def prepare(**kwargs):
+    logger.debug('Running test ' + __name__)
+    athena.configure('b', 'cr', 'mpi', 'omp',
+                     prob='cr_transport_tst',
+                     coord='cartesian', **kwargs)
+    athena.make()
+
+
+# Run Athena++
+def run(**kwargs):
+    for nproc, nthreads in _layouts:
+        athena.mpirun(kwargs['mpirun_cmd'], kwargs['mpirun_opts'], nproc,
+                      'cosmic_ray/athinput.cr_transport',
+                      ['time/ncycle_out=0', 'mesh/num_threads={0}'.format(nthreads)])
+        _history[(nproc, nthreads)] = read_history('bin/crtr.hst')
+        os.remove('bin/crtr.hst')
+
+
+# Read the history file into a list of {column name: value} rows
+def read_history(filename):
+    columns, rows = {}, []
+    with open(filename, 'r') as f:
+        for line in f.readlines():
+            if line.startswith('# [1]'):
+                columns = {entry.split('=')[1]: n
+                           for n, entry in enumerate(line[1:].split())}
+                rows = []
+            elif line[0] != '#':
+                vals = [float(val) for val in line.split()]
+                rows.append({name: vals[n] for name, n in columns.items()})
+    return rows
+
+
+# Analyze outputs
+def analyze():
+    analyze_status = True
+    ref = _history[_layouts[0]]
+    for layout in _layouts[1:]:
+        hst = _history[layout]
+        if len(hst) != len(ref):
+            logger.warning('%d ranks x %d threads: %d history rows, expected %d',
+                           layout[0], layout[1], len(hst), len(ref))
+            analyze_status = False
+            continue
+        for row, row_ref in zip(hst, ref):
+            for name in ['dt', 'mass', 'tot-E', 'Ec']:
+                if abs(row[name] - row_ref[name]) > _rtol * abs(row_ref[name]):
+                    logger.warning('%d ranks x %d threads: %s differs at t=%g: %.16e %.16e',
+                                   layout[0], layout[1], name, row_ref['time'],
+                                   row[name], row_ref[name])
+                    analyze_status = False
+    return analyze_status
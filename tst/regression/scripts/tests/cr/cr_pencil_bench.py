@@ -0,0 +1,61 @@
+# Benchmark of the packed-pencil storage mode of the cosmic ray integrator
+#
+# Runs a few cycles of the 3D oblique cosmic ray diffusion problem on a single 128^3
+# MeshBlock, once reading the CR opacities, angles and moments directly from the
+# 4D CosmicRay arrays and once through the aligned pencil scratch (cr/pack_pencils).
+# Both runs must give the same answer; the throughput of each is reported.
+
+# Modules
+import logging
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../../vis/python')
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name based on module
+
+_modes = ['false', 'true']
+_zone_cycles = {}
+
+
+# Prepare Athena++
+def prepare(**kwargs):
+    logger.debug('Running test ' + __name__)
+    athena.configure('b', 'cr',
+                     prob='cr_diffusion',
+                     coord='cartesian', **kwargs)
+    athena.make()
+
+
+# Run Athena++
+def run(**kwargs):
+    arguments = ['mesh/nx1=128', 'mesh/nx2=128', 'mesh/nx3=128',
+                 'mesh/x3min=-1.0', 'mesh/x3max=1.0',
+                 'meshblock/nx1=128', 'meshblock/nx2=128', 'meshblock/nx3=128',
+                 'time/nlim=3', 'time/ncycle_out=0']
+    for mode in _modes:
+        _zone_cycles[mode] = athena.run_timed('cosmic_ray/athinput.cr_diffusion_3d',
+                                              arguments
+                                              + ['cr/pack_pencils=' + mode])
+
+
+# Analyze outputs
+def analyze():
+    filename = 'bin/diffusion_error.dat'
+    data = []
+    with open(filename, 'r') as f:
+        for line in f.readlines():
+            if line.split()[0][0] == '#':
+                continue
+            data.append([float(val) for val in line.split()])
+
+    analyze_status = True
+    if data[0][8] != data[1][8]:
+        logger.warning('packed pencils changed the solution: %g %g',
+                       data[0][8], data[1][8])
+        analyze_status = False
+
+    direct, packed = _zone_cycles['false'], _zone_cycles['true']
+    logger.info('128^3 CR zone-cycles/cpu_second: direct=%g packed=%g ratio=%g',
+                direct, packed, packed / direct)
+    if packed < direct:
+        logger.warning('packed pencils are slower than direct access on this host')
+    return analyze_status
@@ -0,0 +1,77 @@
+# Regression test for restarting the cosmic ray transport
+#
+# Runs the cr_transport_tst problem to the end with a restart dump at half time, then
+# restarts from that dump and runs to the end again. The restarted run must reproduce
+# the history of the uninterrupted one after the restart time. The restarted run appends
+# its rows (without a new header) to the history file of the uninterrupted one.
+
+# Modules
+import logging
+import os
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../../vis/python')
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name based on module
+
+_rtol = 1.0e-12
+_history = {}
+
+
+# Prepare Athena++
+def prepare(**kwargs):
+    logger.debug('Running test ' + __name__)
+    athena.configure('b', 'cr',
+                     prob='cr_transport_tst',
+                     coord='cartesian', **kwargs)
+    athena.make()
+
+
+# Run Athena++
+def run(**kwargs):
+    athena.run('cosmic_ray/athinput.cr_transport',
+               ['time/ncycle_out=0', 'output2/dt=0.05'])
+    athena.restart('crtr.00001.rst', ['time/ncycle_out=0'])
+    rows = read_history('bin/crtr.hst')
+    os.remove('bin/crtr.hst')
+    # the appended rows start where the time decreases
+    n = next((n for n in range(1, len(rows)) if rows[n]['time'] < rows[n-1]['time']),
+             len(rows))
+    _history['full'], _history['restart'] = rows[:n], rows[n:]
+
+
+# Read the history file into a list of {column name: value} rows
+def read_history(filename):
+    columns, rows = {}, []
+    with open(filename, 'r') as f:
+        for line in f.readlines():
+            if line.startswith('# [1]'):
+                columns = {entry.split('=')[1]: n
+                           for n, entry in enumerate(line[1:].split())}
+                rows = []
+            elif line[0] != '#':
+                vals = [float(val) for val in line.split()]
+                rows.append({name: vals[n] for name, n in columns.items()})
+    return rows
+
+
+# Analyze outputs
+def analyze():
+    analyze_status = True
+    full = {row['time']: row for row in _history['full']}
+    restart = _history['restart']
+    if len(restart) == 0:
+        logger.warning('no history rows after the restart')
+        return False
+    for row in restart:
+        if row['time'] not in full:
+            logger.warning('history row at t=%.16e missing from the full run', row['time'])
+            analyze_status = False
+            continue
+        for name in ['mass', 'tot-E', 'Ec', 'Fc1']:
+            ref = full[row['time']][name]
+            if abs(row[name] - ref) > _rtol * max(abs(ref), abs(row['Ec'])):
+                logger.warning('%s differs after the restart at t=%g: %.16e %.16e',
+                               name, row['time'], row[name], ref)
+                analyze_status = False
+    logger.info('%d history rows reproduced after the restart', len(restart))
+    return analyze_status
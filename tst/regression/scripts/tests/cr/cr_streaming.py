@@ -0,0 +1,75 @@
+# Regression test for cosmic ray streaming and the CR-gas source terms
+#
+# Runs the cr_transport_tst problem, a Gaussian CR profile along a uniform magnetic field
+# in a periodic 3D box, once with pure diffusion (vs_flag=0) and once with streaming at
+# the Alfven speed (vs_flag=1), both with the CR source terms enabled. The sum of the gas
+# and CR energies must be conserved to round-off in both runs, and streaming must
+# transfer a finite fraction of the CR energy to the gas.
+
+# Modules
+import logging
+import os
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../../vis/python')
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name based on module
+
+_flags = [0, 1]
+_rtol = 1.0e-10
+_history = {}
+
+
+# Prepare Athena++
+def prepare(**kwargs):
+    logger.debug('Running test ' + __name__)
+    athena.configure('b', 'cr',
+                     prob='cr_transport_tst',
+                     coord='cartesian', **kwargs)
+    athena.make()
+
+
+# Run Athena++
+def run(**kwargs):
+    for flag in _flags:
+        athena.run('cosmic_ray/athinput.cr_transport',
+                   ['time/ncycle_out=0', 'cr/vs_flag={0}'.format(flag)])
+        _history[flag] = read_history('bin/crtr.hst')
+        os.remove('bin/crtr.hst')
+
+
+# Read the history file into a list of {column name: value} rows
+def read_history(filename):
+    columns, rows = {}, []
+    with open(filename, 'r') as f:
+        for line in f.readlines():
+            if line.startswith('# [1]'):
+                columns = {entry.split('=')[1]: n
+                           for n, entry in enumerate(line[1:].split())}
+                rows = []
+            elif line[0] != '#':
+                vals = [float(val) for val in line.split()]
+                rows.append({name: vals[n] for name, n in columns.items()})
+    return rows
+
+
+# Analyze outputs
+def analyze():
+    analyze_status = True
+    loss = {}
+    for flag in _flags:
+        hst = _history[flag]
+        etot0 = hst[0]['tot-E'] + hst[0]['Ec']
+        etot1 = hst[-1]['tot-E'] + hst[-1]['Ec']
+        loss[flag] = 1.0 - hst[-1]['Ec'] / hst[0]['Ec']
+        logger.info('vs_flag=%d: CR energy loss %g, total energy change %g',
+                    flag, loss[flag], etot1 / etot0 - 1.0)
+        if abs(etot1 - etot0) > _rtol * abs(etot0):
+            logger.warning('vs_flag=%d: total energy not conserved: %.16e %.16e',
+                           flag, etot0, etot1)
+            analyze_status = False
+    # the streaming losses heat the gas; diffusion only does work on it
+    if not loss[1] > 10.0 * abs(loss[0]):
+        logger.warning('streaming did not heat the gas: CR energy loss %g (diffusion %g)',
+                       loss[1], loss[0])
+        analyze_status = False
+    return analyze_status
@@ -0,0 +1,59 @@
+# Regression test for subcycled cosmic ray transport
+#
+# Runs the static 3D cosmic ray diffusion test once with the CR tasks integrated at
+# the MHD time step limited by vmax (cr/nsubcycle=1) and once with four CR substeps
+# per stage, which lets the MHD time step grow by the same factor. The L1 errors
+# against the analytic solution must agree, and must match the value recorded for the
+# unsubcycled run.
+
+# Modules
+import logging
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../../vis/python')
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name based on module
+
+_nsubcycle = [1, 4]
+_ref = 2.905368e-02
+_rtol = 1.0e-5
+_subcycle_rtol = 0.05
+
+
+# Prepare Athena++
+def prepare(**kwargs):
+    logger.debug('Running test ' + __name__)
+    athena.configure('b', 'cr',
+                     prob='cr_diffusion',
+                     coord='cartesian', **kwargs)
+    athena.make()
+
+
+# Run Athena++
+def run(**kwargs):
+    for n in _nsubcycle:
+        arguments = ['problem/v0=0', 'cr/vflx=0',
+                     'cr/nsubcycle={0}'.format(n)]
+        athena.run('cosmic_ray/athinput.cr_diffusion_3d', arguments)
+
+
+# Analyze outputs
+def analyze():
+    filename = 'bin/diffusion_error.dat'
+    data = []
+    with open(filename, 'r') as f:
+        for line in f.readlines():
+            if line.split()[0][0] == '#':
+                continue
+            data.append([float(val) for val in line.split()])
+
+    analyze_status = True
+    err = data[0][8]
+    if abs(err - _ref) > _rtol * _ref:
+        logger.warning('error changed without subcycling: %g (ref %g)', err, _ref)
+        analyze_status = False
+    for n, row in zip(_nsubcycle[1:], data[1:]):
+        if abs(row[8] - err) > _subcycle_rtol * err:
+            logger.warning('error with nsubcycle=%d differs: %g (nsubcycle=1: %g)',
+                           n, row[8], err)
+            analyze_status = False
+    return analyze_status
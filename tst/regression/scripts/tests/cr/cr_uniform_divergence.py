@@ -0,0 +1,63 @@
+# Benchmark of the fused cosmic ray flux divergence on uniform Cartesian meshes
+#
+# Runs a few cycles of the 3D oblique cosmic ray diffusion problem on a single 128^3
+# MeshBlock, once with the general flux divergence (face areas, cell volumes and a
+# separate register update) and once with the single-pass uniform Cartesian kernel
+# (cr/uniform_divergence). Both runs must agree to round-off; the throughput of each
+# is reported.
+
+# Modules
+import logging
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../../vis/python')
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name based on module
+
+_modes = ['false', 'true']
+_zone_cycles = {}
+_rtol = 1.0e-10
+
+
+# Prepare Athena++
+def prepare(**kwargs):
+    logger.debug('Running test ' + __name__)
+    athena.configure('b', 'cr',
+                     prob='cr_diffusion',
+                     coord='cartesian', **kwargs)
+    athena.make()
+
+
+# Run Athena++
+def run(**kwargs):
+    arguments = ['mesh/nx1=128', 'mesh/nx2=128', 'mesh/nx3=128',
+                 'mesh/x3min=-1.0', 'mesh/x3max=1.0',
+                 'meshblock/nx1=128', 'meshblock/nx2=128', 'meshblock/nx3=128',
+                 'time/nlim=3', 'time/ncycle_out=0']
+    for mode in _modes:
+        _zone_cycles[mode] = athena.run_timed('cosmic_ray/athinput.cr_diffusion_3d',
+                                              arguments
+                                              + ['cr/uniform_divergence=' + mode])
+
+
+# Analyze outputs
+def analyze():
+    filename = 'bin/diffusion_error.dat'
+    data = []
+    with open(filename, 'r') as f:
+        for line in f.readlines():
+            if line.split()[0][0] == '#':
+                continue
+            data.append([float(val) for val in line.split()])
+
+    analyze_status = True
+    if abs(data[1][8] - data[0][8]) > _rtol * abs(data[0][8]):
+        logger.warning('the uniform flux divergence changed the solution: %g %g',
+                       data[0][8], data[1][8])
+        analyze_status = False
+
+    general, uniform = _zone_cycles['false'], _zone_cycles['true']
+    logger.info('128^3 CR zone-cycles/cpu_second: general=%g uniform=%g ratio=%g',
+                general, uniform, uniform / general)
+    if uniform < general:
+        logger.warning('the uniform flux divergence is slower on this host')
+    return analyze_status
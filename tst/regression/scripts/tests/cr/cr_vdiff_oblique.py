@@ -0,0 +1,60 @@
+# Regression test for the cosmic ray diffusion velocity kernel
+#
+# Runs the 3D cosmic ray diffusion test with a magnetic field that is oblique to the
+# grid, so that the diffusion speed is computed along all three directions, rotated
+# out of the field frame and combined with streaming and the CR sound speed. The L1
+# errors against the isotropic analytic solution are not small, but they are
+# deterministic: they are compared against values recorded with the original
+# per-direction implementation of CRIntegrator::CalculateFluxes.
+
+# Modules
+import logging
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../../vis/python')
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name based on module
+
+# reference L1 errors for (direction, v0, vflx)
+_cases = [(0, 1, 1, 9.430307e-02),
+          (1, 1, 1, 3.125861e-02),
+          (2, 1, 1, 5.916326e-02),
+          (0, 0, 0, 2.905368e-02)]
+_rtol = 1.0e-5
+
+
+# Prepare Athena++
+def prepare(**kwargs):
+    logger.debug('Running test ' + __name__)
+    athena.configure('b', 'cr',
+                     prob='cr_diffusion',
+                     coord='cartesian', **kwargs)
+    athena.make()
+
+
+# Run Athena++
+def run(**kwargs):
+    for direction, v0, vflx, _ in _cases:
+        arguments = ['problem/direction={0}'.format(direction),
+                     'problem/v0={0}'.format(v0),
+                     'cr/vflx={0}'.format(vflx)]
+        athena.run('cosmic_ray/athinput.cr_diffusion_3d', arguments)
+
+
+# Analyze outputs
+def analyze():
+    filename = 'bin/diffusion_error.dat'
+    data = []
+    with open(filename, 'r') as f:
+        for line in f.readlines():
+            if line.split()[0][0] == '#':
+                continue
+            data.append([float(val) for val in line.split()])
+
+    analyze_status = True
+    for n, (direction, v0, vflx, ref) in enumerate(_cases):
+        err = data[n][8]
+        if abs(err - ref) > _rtol * ref:
+            logger.warning('error changed for direction=%d v0=%d vflx=%d: %g (ref %g)',
+                           direction, v0, vflx, err, ref)
+            analyze_status = False
+    return analyze_status
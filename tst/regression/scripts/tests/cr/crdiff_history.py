@@ -0,0 +1,85 @@
+# Regression test for the batched history reductions and the history block function
+#
+# Runs two cycles of the cosmic ray diffusion Multigrid problem on 8 MeshBlocks with 1
+# and 4 MPI ranks. The history file carries the built-in CR diffusion energy total
+# (Ecr) and the extrema of the CR energy density, filled by the block function of the
+# pgen and reduced with the max and min operations. Both runs must agree up to the
+# summation order of the totals, and the volume-averaged energy must lie between the
+# extrema.
+
+# Modules
+import logging
+import os
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../../vis/python')
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name based on module
+
+_nranks = [1, 4]
+_rtol = 1.0e-12
+_history = {}
+
+
+# Prepare Athena++
+def prepare(**kwargs):
+    logger.debug('Running test ' + __name__)
+    athena.configure('b', 'crdiff', 'mpi',
+                     prob='cr_diffusion_mg',
+                     coord='cartesian', **kwargs)
+    athena.make()
+
+
+# Run Athena++
+def run(**kwargs):
+    arguments = ['output1/file_type=hst', 'time/nlim=2',
+                 'meshblock/nx1=32', 'meshblock/nx2=32', 'meshblock/nx3=32']
+    for nproc in _nranks:
+        athena.mpirun(kwargs['mpirun_cmd'], kwargs['mpirun_opts'], nproc,
+                      'cosmic_ray/athinput.cr_diffusion_mg', arguments)
+        _history[nproc] = read_history('bin/MGCRDiffusion.hst')
+        os.remove('bin/MGCRDiffusion.hst')
+
+
+# Read the history file into a list of {column name: value} rows
+def read_history(filename):
+    columns, rows = {}, []
+    with open(filename, 'r') as f:
+        for line in f.readlines():
+            if line.startswith('# [1]'):
+                columns = {entry.split('=')[1]: n
+                           for n, entry in enumerate(line[1:].split())}
+                rows = []
+            elif line[0] != '#':
+                vals = [float(val) for val in line.split()]
+                rows.append({name: vals[n] for name, n in columns.items()})
+    return rows
+
+
+# Analyze outputs
+def analyze():
+    analyze_status = True
+    ref = _history[_nranks[0]]
+    if len(ref) == 0 or any(name not in ref[0] for name in ['Ecr', 'ecr-max', 'ecr-min']):
+        logger.warning('missing CR diffusion columns in the history file')
+        return False
+    volume = 1.0
+    for row in ref:
+        mean = row['Ecr'] / volume
+        logger.info('t=%g: Ecr=%g, ecr min %g max %g',
+                    row['time'], row['Ecr'], row['ecr-min'], row['ecr-max'])
+        if not row['ecr-min'] <= mean <= row['ecr-max']:
+            logger.warning('t=%g: mean CR energy outside of the extrema', row['time'])
+            analyze_status = False
+    for nproc in _nranks[1:]:
+        hst = _history[nproc]
+        if len(hst) != len(ref):
+            logger.warning('%d ranks: %d history rows, expected %d',
+                           nproc, len(hst), len(ref))
+            return False
+        for row, row_ref in zip(hst, ref):
+            for name in ['Ecr', 'ecr-max', 'ecr-min', 'mass']:
+                if abs(row[name] - row_ref[name]) > _rtol * abs(row_ref[name]):
+                    logger.warning('%d ranks: %s differs at t=%g: %.16e %.16e', nproc,
+                                   name, row['time'], row[name], row_ref[name])
+                    analyze_status = False
+    return analyze_status
@@ -0,0 +1,56 @@
+# Regression test for the Krylov outer iteration of the CR diffusion Multigrid solver
+#
+# Solves one implicit step of the anisotropic (Dpara/Dperp = 100) cosmic ray diffusion
+# problem with a fixed number of iterations, once with the plain Multigrid iteration
+# and once each with BiCGStab and GMRES preconditioned with the same V-cycle. The
+# Krylov solvers must reach a much smaller defect with the same number of V-cycles.
+
+# Modules
+import logging
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../../vis/python')
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name based on module
+
+_solvers = ['mg', 'bicgstab', 'gmres']
+_defects = {}
+
+
+# Prepare Athena++
+def prepare(**kwargs):
+    logger.debug('Running test ' + __name__)
+    athena.configure('b', 'crdiff',
+                     prob='cr_diffusion_mg',
+                     coord='cartesian', **kwargs)
+    athena.make()
+
+
+# Run Athena++
+def run(**kwargs):
+    arguments = ['output1/file_type=hst', 'crdiffusion/niteration=10',
+                 'crdiffusion/show_defect=true']
+    for solver in _solvers:
+        output = athena.run_output('cosmic_ray/athinput.cr_diffusion_mg',
+                                   arguments + ['crdiffusion/solver=' + solver])
+        for line in output.splitlines():
+            if line.startswith('Multigrid defect L2-norm'):
+                _defects[solver] = float(line.split(':')[1])
+            elif 'final defect L2-norm' in line:
+                _defects[solver] = float(line.split('=')[-1])
+
+
+# Analyze outputs
+def analyze():
+    analyze_status = True
+    for solver in _solvers:
+        if solver not in _defects:
+            logger.warning('no defect reported by solver=%s', solver)
+            return False
+    logger.info('defect after 10 V-cycles: mg=%g bicgstab=%g gmres=%g',
+                _defects['mg'], _defects['bicgstab'], _defects['gmres'])
+    for solver in ['bicgstab', 'gmres']:
+        if not _defects[solver] < 0.1 * _defects['mg']:
+            logger.warning('%s does not improve on the Multigrid iteration: %g (mg %g)',
+                           solver, _defects[solver], _defects['mg'])
+            analyze_status = False
+    return analyze_status
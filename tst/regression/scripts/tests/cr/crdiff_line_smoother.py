@@ -0,0 +1,69 @@
+# Regression test for the zebra line smoother of the CR diffusion Multigrid solver
+#
+# Solves one implicit step of the cosmic ray diffusion problem with the magnetic field
+# along x1 and Dpara/Dperp = 1e4, using 10 Multigrid iterations with either the
+# red-black Jacobi or the line smoother, at two resolutions. The line smoother must
+# reach a much smaller defect than red-black, and its defect must not degrade with
+# resolution more than the initial defect does.
+
+# Modules
+import logging
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../../vis/python')
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name based on module
+
+_smoothers = ['jacobi-rb', 'line']
+_resolutions = [32, 64]
+_defects = {}
+
+
+# Prepare Athena++
+def prepare(**kwargs):
+    logger.debug('Running test ' + __name__)
+    athena.configure('b', 'crdiff',
+                     prob='cr_diffusion_mg',
+                     coord='cartesian', **kwargs)
+    athena.make()
+
+
+# Run Athena++
+def run(**kwargs):
+    arguments = ['output1/file_type=hst', 'crdiffusion/niteration=10',
+                 'crdiffusion/mgmode=MGI', 'crdiffusion/omega=1.0',
+                 'crdiffusion/Dpara=10000.0', 'crdiffusion/show_defect=true',
+                 'problem/b2=0.0']
+    for smoother in _smoothers:
+        for nx in _resolutions:
+            mesh = ['{0}/nx{1}={2}'.format(block, d, nx)
+                    for block in ['mesh', 'meshblock'] for d in [1, 2, 3]]
+            output = athena.run_output('cosmic_ray/athinput.cr_diffusion_mg',
+                                       arguments + mesh
+                                       + ['crdiffusion/smoother=' + smoother])
+            for line in output.splitlines():
+                if line.startswith('Multigrid defect L2-norm'):
+                    _defects[(smoother, nx)] = float(line.split(':')[1])
+
+
+# Analyze outputs
+def analyze():
+    analyze_status = True
+    for smoother in _smoothers:
+        for nx in _resolutions:
+            if (smoother, nx) not in _defects:
+                logger.warning('no defect reported by smoother=%s nx=%d', smoother, nx)
+                return False
+            logger.info('defect after 10 V-cycles: smoother=%s nx=%d %g',
+                        smoother, nx, _defects[(smoother, nx)])
+    for nx in _resolutions:
+        if not _defects[('line', nx)] < 1.0e-3 * _defects[('jacobi-rb', nx)]:
+            logger.warning('line smoother does not improve on red-black at nx=%d: '
+                           '%g (jacobi-rb %g)', nx, _defects[('line', nx)],
+                           _defects[('jacobi-rb', nx)])
+            analyze_status = False
+    # the initial defect doubles with resolution in this problem
+    if not _defects[('line', 64)] < 4.0 * _defects[('line', 32)]:
+        logger.warning('line smoother convergence depends on resolution: %g %g',
+                       _defects[('line', 32)], _defects[('line', 64)])
+        analyze_status = False
+    return analyze_status
@@ -0,0 +1,69 @@
+# Regression test for the conditional matrix rebuild of the CR diffusion Multigrid solver
+#
+# Runs a few cycles of the cosmic ray diffusion problem on 8 MeshBlocks, where neither
+# the field nor the density changes, once rebuilding the matrices every cycle and once
+# with crdiffusion/matrix_tolerance set. With the tolerance the matrices must be built
+# only on the first cycle, and the defects must be identical to the rebuilt ones.
+
+# Modules
+import logging
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../../vis/python')
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name based on module
+
+_tolerances = [0.0, 1.0e-2]
+_ncycle = 4
+_rebuilt = {}
+_defects = {}
+
+
+# Prepare Athena++
+def prepare(**kwargs):
+    logger.debug('Running test ' + __name__)
+    athena.configure('b', 'crdiff',
+                     prob='cr_diffusion_mg',
+                     coord='cartesian', **kwargs)
+    athena.make()
+
+
+# Run Athena++
+def run(**kwargs):
+    arguments = ['output1/file_type=hst', 'time/nlim={0}'.format(_ncycle),
+                 'crdiffusion/show_defect=true',
+                 'meshblock/nx1=32', 'meshblock/nx2=32', 'meshblock/nx3=32']
+    for tol in _tolerances:
+        output = athena.run_output('cosmic_ray/athinput.cr_diffusion_mg',
+                                   arguments
+                                   + ['crdiffusion/matrix_tolerance={0}'.format(tol)])
+        _rebuilt[tol] = []
+        _defects[tol] = []
+        for line in output.splitlines():
+            if line.startswith('Multigrid matrix rebuilt on'):
+                _rebuilt[tol].append(int(line.split()[4]))
+            elif line.startswith('Multigrid defect L2-norm'):
+                _defects[tol].append(float(line.split(':')[1]))
+
+
+# Analyze outputs
+def analyze():
+    analyze_status = True
+    for tol in _tolerances:
+        if len(_rebuilt[tol]) != _ncycle or len(_defects[tol]) != _ncycle:
+            logger.warning('matrix_tolerance=%g: expected %d solves, found %d',
+                           tol, _ncycle, len(_defects[tol]))
+            return False
+        logger.info('matrix_tolerance=%g: blocks rebuilt %s', tol, _rebuilt[tol])
+    if _rebuilt[0.0] != [8] * _ncycle:
+        logger.warning('matrices not rebuilt every cycle without a tolerance: %s',
+                       _rebuilt[0.0])
+        analyze_status = False
+    if _rebuilt[1.0e-2] != [8] + [0] * (_ncycle - 1):
+        logger.warning('matrices rebuilt although the coefficients are unchanged: %s',
+                       _rebuilt[1.0e-2])
+        analyze_status = False
+    if _defects[0.0] != _defects[1.0e-2]:
+        logger.warning('reused matrices change the solution: %s %s',
+                       _defects[0.0], _defects[1.0e-2])
+        analyze_status = False
+    return analyze_status
@@ -0,0 +1,62 @@
+# Regression test for the OpenMP threading of the CR diffusion Multigrid solver
+#
+# Runs two cycles of the cosmic ray diffusion problem with crdiffusion/num_threads = 1
+# and 4, once on a single MeshBlock, where the threads work inside the MeshBlock, and
+# once on 8 MeshBlocks, where they work over the MeshBlocks. The defects must agree
+# with the single-thread ones up to the summation order of the norm.
+
+# Modules
+import logging
+import os
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../../vis/python')
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name based on module
+
+_blocks = [64, 32]
+_threads = [1, 4]
+_defects = {}
+
+
+# Prepare Athena++
+def prepare(**kwargs):
+    logger.debug('Running test ' + __name__)
+    athena.configure('b', 'crdiff', 'omp',
+                     prob='cr_diffusion_mg',
+                     coord='cartesian', **kwargs)
+    athena.make()
+
+
+# Run Athena++
+def run(**kwargs):
+    os.environ['OMP_NUM_THREADS'] = str(max(_threads))
+    arguments = ['output1/file_type=hst', 'time/nlim=2', 'crdiffusion/show_defect=true']
+    for nb in _blocks:
+        for nth in _threads:
+            mesh = ['meshblock/nx{0}={1}'.format(d, nb) for d in [1, 2, 3]]
+            output = athena.run_output('cosmic_ray/athinput.cr_diffusion_mg',
+                                       arguments + mesh
+                                       + ['crdiffusion/num_threads={0}'.format(nth)])
+            _defects[(nb, nth)] = [float(line.split(':')[1])
+                                   for line in output.splitlines()
+                                   if line.startswith('Multigrid defect L2-norm')]
+
+
+# Analyze outputs
+def analyze():
+    analyze_status = True
+    for nb in _blocks:
+        ref = _defects[(nb, 1)]
+        if len(ref) != 2:
+            logger.warning('meshblock nx=%d: expected 2 solves, found %d', nb, len(ref))
+            return False
+        for nth in _threads[1:]:
+            defs = _defects[(nb, nth)]
+            logger.info('meshblock nx=%d, %d threads: %s (1 thread %s)',
+                        nb, nth, defs, ref)
+            if len(defs) != len(ref) or any(abs(d - r) > 1.0e-12 * r
+                                            for d, r in zip(defs, ref)):
+                logger.warning('meshblock nx=%d: defects with %d threads differ',
+                               nb, nth)
+                analyze_status = False
+    return analyze_status
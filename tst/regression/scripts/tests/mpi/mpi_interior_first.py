@@ -0,0 +1,63 @@
+# Regression test for the interior-first hydro fluxes with MPI
+#
+# Runs the 3D MHD linear wave problem with SMR on 2 ranks with time/interior_first=false
+# and true, for two integrators and reconstructions. The interior fluxes of each stage
+# are computed while the ghost zones are exchanged, which must not change the result:
+# each pair of runs must give exactly the same L1 error.
+
+# Modules
+import logging
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../../vis/python')
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name based on module
+
+# (integrator, xorder, interior_first)
+_runs = [('vl2', '2', 'false'), ('vl2', '2', 'true'),
+         ('rk3', '2c', 'false'), ('rk3', '2c', 'true')]
+
+
+# Prepare Athena++
+def prepare(**kwargs):
+    logger.debug('Running test ' + __name__)
+    athena.configure('b', 'mpi', prob='linear_wave', coord='cartesian',
+                     flux='hlld', **kwargs)
+    athena.make()
+
+
+# Run Athena++
+def run(**kwargs):
+    arguments = ['time/ncycle_out=0', 'output2/dt=-1', 'time/tlim=0.5',
+                 'problem/wave_flag=0', 'problem/vflow=0.0', 'problem/compute_error=true',
+                 'mesh/refinement=static',
+                 'mesh/nx1=32', 'mesh/nx2=16', 'mesh/nx3=16',
+                 'meshblock/nx1=8', 'meshblock/nx2=8', 'meshblock/nx3=8']
+    for integrator, xorder, interior_first in _runs:
+        athena.mpirun(kwargs['mpirun_cmd'], kwargs['mpirun_opts'], 2,
+                      'mhd/athinput.linear_wave3d',
+                      arguments + ['time/integrator=' + integrator,
+                                   'time/xorder=' + xorder,
+                                   'time/interior_first=' + interior_first])
+    return 'skip_lcov'
+
+
+# Analyze outputs
+def analyze():
+    errors = []
+    with open('bin/linearwave-errors.dat', 'r') as f:
+        for line in f.readlines():
+            if line.split()[0][0] == '#':
+                continue
+            errors.append(float(line.split()[4]))
+    if len(errors) != len(_runs):
+        logger.warning('%d errors for %d runs', len(errors), len(_runs))
+        return False
+
+    analyze_status = True
+    for n in range(0, len(_runs), 2):
+        integrator, xorder, _ = _runs[n]
+        if errors[n+1] != errors[n]:
+            logger.warning('interior_first changed the error with %s, xorder=%s: %g %g',
+                           integrator, xorder, errors[n+1], errors[n])
+            analyze_status = False
+    return analyze_status
@@ -0,0 +1,67 @@
+# Benchmark of the TaskList schedulers with OpenMP
+#
+# Runs the 3D MHD linear wave problem on 64 MeshBlocks per rank with the polling loop
+# over all MeshBlocks (mesh/task_scheduler=polling), with the work-stealing scheduler
+# (mesh/task_scheduler=stealing) and with MeshBlocks pinned to the threads that allocate
+# them (mesh/task_scheduler=pinned), on 1 and 2 threads. All runs must give the same L1
+# error; the zone-cycles/omp_wsecond of each run is reported.
+
+# Modules
+import logging
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../../vis/python')
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name based on module
+
+# (scheduler, OpenMP threads)
+_runs = [('polling', 1), ('stealing', 1), ('pinned', 1),
+         ('polling', 2), ('stealing', 2), ('pinned', 2)]
+_zone_cycles = {}
+
+
+# Prepare Athena++
+def prepare(**kwargs):
+    logger.debug('Running test ' + __name__)
+    athena.configure('b', 'omp', prob='linear_wave', coord='cartesian',
+                     flux='hlld', **kwargs)
+    athena.make()
+
+
+# Run Athena++
+def run(**kwargs):
+    arguments = ['time/ncycle_out=0', 'output2/dt=-1', 'time/tlim=0.5',
+                 'problem/wave_flag=0', 'problem/vflow=0.0', 'problem/compute_error=true',
+                 'mesh/nx1=32', 'mesh/nx2=32', 'mesh/nx3=32',
+                 'meshblock/nx1=8', 'meshblock/nx2=8', 'meshblock/nx3=8']
+    for scheduler, nthreads in _runs:
+        output = athena.run_output('mhd/athinput.linear_wave3d',
+                                   arguments + ['mesh/task_scheduler=' + scheduler,
+                                                'mesh/num_threads={0}'.format(nthreads)])
+        for line in output.splitlines():
+            if line.startswith('zone-cycles/omp_wsecond'):
+                _zone_cycles[(scheduler, nthreads)] = float(line.split('=')[1])
+
+
+# Analyze outputs
+def analyze():
+    errors = []
+    with open('bin/linearwave-errors.dat', 'r') as f:
+        for line in f.readlines():
+            if line.split()[0][0] == '#':
+                continue
+            errors.append(float(line.split()[4]))
+    if len(errors) != len(_runs):
+        logger.warning('%d errors for %d runs', len(errors), len(_runs))
+        return False
+
+    analyze_status = True
+    for (scheduler, nthreads), error in zip(_runs, errors):
+        speed = _zone_cycles[(scheduler, nthreads)]
+        ref = _zone_cycles[('polling', nthreads)]
+        logger.info('%-8s %d threads: zone-cycles/omp_wsecond=%g (%.3f of polling)',
+                    scheduler, nthreads, speed, speed / ref)
+        if error != errors[0]:
+            logger.warning('%s scheduler on %d threads changed the error: %g %g',
+                           scheduler, nthreads, error, errors[0])
+            analyze_status = False
+    return analyze_status
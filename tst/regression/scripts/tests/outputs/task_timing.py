@@ -0,0 +1,74 @@
+# Regression test for the task timing report and timeline
+#
+# Runs the cr_transport_tst problem for a fixed number of cycles with time/task_timing
+# and time/task_trace, then checks the number of calls of a few tasks in the table printed
+# at the end of the run and that the Chrome trace has one event per successful call.
+
+# Modules
+import json
+import logging
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../../vis/python')
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name based on module
+
+_nlim = 10
+_nblocks = 4  # 64 x 8 x 8 cells in 16 x 8 x 8 MeshBlocks
+_nstages = 2  # vl2 integrator
+_table = {}
+
+
+# Prepare Athena++
+def prepare(**kwargs):
+    logger.debug('Running test ' + __name__)
+    athena.configure('b', 'cr',
+                     prob='cr_transport_tst',
+                     coord='cartesian', **kwargs)
+    athena.make()
+
+
+# Run Athena++
+def run(**kwargs):
+    output = athena.run_output('cosmic_ray/athinput.cr_transport',
+                               ['time/ncycle_out=0', 'time/nlim={0}'.format(_nlim),
+                                'time/task_timing=true', 'time/task_trace=true'])
+    in_table = False
+    for line in output.splitlines():
+        if line.startswith('Task timing'):
+            in_table = True
+        elif in_table and line.startswith('total'):
+            in_table = False
+        elif in_table and not line.startswith('list'):
+            cols = line.split()
+            _table[(cols[0], cols[1])] = {'calls': int(cols[2]), 'stuck': int(cols[3]),
+                                          'time': float(cols[4])}
+
+
+# Analyze outputs
+def analyze():
+    analyze_status = True
+    if len(_table) == 0:
+        logger.warning('no task timing table in the output')
+        return False
+
+    # tasks that never wait are called once per MeshBlock and stage
+    ncalls = _nblocks * _nstages * _nlim
+    for task in ['CALC_HYDFLX', 'CALC_CRTCFLX', 'INT_HYD', 'INT_CRTC']:
+        row = _table.get(('TimeIntegrator', task))
+        if row is None or row['calls'] != ncalls or row['stuck'] != 0:
+            logger.warning('%s: %s, expected %d calls', task, row, ncalls)
+            analyze_status = False
+
+    with open('bin/crtr.trace.00000.json', 'r') as f:
+        events = json.load(f)['traceEvents']
+    for (lst, task), row in _table.items():
+        n = len([ev for ev in events if ev.get('cat') == lst and ev['name'] == task])
+        if n != row['calls'] - row['stuck']:
+            logger.warning('%d trace events of %s %s for %d successful calls',
+                           n, lst, task, row['calls'] - row['stuck'])
+            analyze_status = False
+    if any(ev['ph'] == 'X' and (ev['ts'] < 0 or ev['dur'] < 0) for ev in events):
+        logger.warning('negative time in the trace')
+        analyze_status = False
+    logger.info('%d tasks timed, %d trace events', len(_table), len(events))
+    return analyze_status
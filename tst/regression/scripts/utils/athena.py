@@ -114,6 +114,38 @@ def run(input_filename, arguments, lcov_test_suffix=None):
         os.chdir(current_dir)
 
 
+# Function for running Athena++ and returning its standard output
+def run_output(input_filename, arguments):
+    current_dir = os.getcwd()
+    os.chdir('bin')
+    logger = logging.getLogger('athena.run')
+    try:
+        input_filename_full = '../' + athena_rel_path + 'inputs/' + \
+                              input_filename
+        run_command = ['./athena', '-i', input_filename_full]
+        cmd = run_command + arguments + global_run_args
+        logger.debug('Executing (output): ' + ' '.join(cmd))
+        try:
+            output = subprocess.check_output(cmd, universal_newlines=True)
+        except subprocess.CalledProcessError as err:
+            raise AthenaError('Return code {0} from command \'{1}\''
+                              .format(err.returncode, ' '.join(err.cmd)))
+        for line in output.splitlines():
+            logger.info(line)
+        return output
+    finally:
+        os.chdir(current_dir)
+
+
+# Function for running Athena++ and returning its zone-cycles/cpu_second
+def run_timed(input_filename, arguments):
+    zone_cycles = None
+    for line in run_output(input_filename, arguments).splitlines():
+        if line.startswith('zone-cycles/cpu_second'):
+            zone_cycles = float(line.split('=')[1])
+    return zone_cycles
+
+
 def restart(input_filename, arguments):
     current_dir = os.getcwd()
     os.chdir('bin')